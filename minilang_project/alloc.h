@@ -0,0 +1,46 @@
+#ifndef MINILANG_ALLOC_H
+#define MINILANG_ALLOC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* malloc(), calloc() and realloc() that exit rather than return NULL,
+ * with
+ *
+ *   minilang: out of memory for ALLOC_WHAT
+ *
+ * where the file defines ALLOC_WHAT before including this, as "syntax
+ * tree" say, and a tool built on its own may define ALLOC_PROGRAM to put
+ * its name in place of minilang's.  A size of 0 is taken as 1, so that
+ * NULL only ever means failure.  Static, so that each file has its own
+ * message. */
+
+#ifndef ALLOC_PROGRAM
+#define ALLOC_PROGRAM "minilang"
+#endif
+
+static inline void *alloc_check(void *p)
+{
+    if (!p) {
+        fprintf(stderr, ALLOC_PROGRAM ": out of memory for " ALLOC_WHAT "\n");
+        exit(1);
+    }
+    return p;
+}
+
+static inline void *xmalloc(size_t size)
+{
+    return alloc_check(malloc(size ? size : 1));
+}
+
+static inline void *xcalloc(size_t count, size_t size)
+{
+    return alloc_check(calloc(count ? count : 1, size));
+}
+
+static inline void *xrealloc(void *p, size_t size)
+{
+    return alloc_check(realloc(p, size ? size : 1));
+}
+
+#endif
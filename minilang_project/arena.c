@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+#define ARENA_FIRST_CHUNK   (64 * 1024)
+#define ARENA_MAX_CHUNK     (64 * 1024 * 1024)
+
+struct arena_chunk {
+    struct arena_chunk *prev;
+    size_t size;
+    _Alignas(16) char data[];
+};
+
+void arena_init(struct arena *arena)
+{
+    arena->next = NULL;
+    arena->end = NULL;
+    arena->chunk = NULL;
+    arena->bytes = 0;
+}
+
+/* Start a new chunk big enough for `size`, which is already rounded. */
+void *arena_alloc_slow(struct arena *arena, size_t size)
+{
+    size_t chunk_size = arena->chunk ? arena->chunk->size * 2
+                                     : ARENA_FIRST_CHUNK;
+    struct arena_chunk *chunk;
+
+    if (chunk_size > ARENA_MAX_CHUNK)
+        chunk_size = ARENA_MAX_CHUNK;
+    if (chunk_size < size)
+        chunk_size = size;
+    chunk = malloc(sizeof *chunk + chunk_size);
+    if (!chunk) {
+        fprintf(stderr, "minilang: out of memory for arena\n");
+        exit(1);
+    }
+    chunk->prev = arena->chunk;
+    chunk->size = chunk_size;
+    arena->chunk = chunk;
+    arena->next = chunk->data + size;
+    arena->end = chunk->data + chunk_size;
+    arena->bytes += size;
+    return chunk->data;
+}
+
+void arena_free(struct arena *arena)
+{
+    struct arena_chunk *chunk = arena->chunk;
+
+    while (chunk) {
+        struct arena_chunk *prev = chunk->prev;
+
+        free(chunk);
+        chunk = prev;
+    }
+    arena_init(arena);
+}
@@ -0,0 +1,42 @@
+#ifndef MINILANG_ARENA_H
+#define MINILANG_ARENA_H
+
+#include <stddef.h>
+
+/* Bump allocator for things that all die together, such as the nodes of
+ * one AST.
+ *
+ * Allocation moves a pointer through the current chunk; a new chunk,
+ * twice the size of the last, is taken from malloc() only when that one
+ * is full.  Nothing is freed on its own: arena_free() releases the chunks,
+ * of which there are a handful however many objects were allocated.
+ * Zero-initialise or arena_init() before use. */
+struct arena_chunk;
+
+struct arena {
+    char *next;
+    char *end;
+    struct arena_chunk *chunk;  /* most recent; they form a list */
+    size_t bytes;               /* allocated so far, for statistics */
+};
+
+void arena_init(struct arena *arena);
+void arena_free(struct arena *arena);
+
+void *arena_alloc_slow(struct arena *arena, size_t size);
+
+/* `size` bytes aligned for any scalar type, uninitialised.  Never NULL:
+ * running out of memory is fatal. */
+static inline void *arena_alloc(struct arena *arena, size_t size)
+{
+    char *p = arena->next;
+
+    size = (size + 7) & ~(size_t) 7;
+    if ((size_t) (arena->end - p) < size)
+        return arena_alloc_slow(arena, size);
+    arena->next = p + size;
+    arena->bytes += size;
+    return p;
+}
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdlib.h>
+
+#define ALLOC_WHAT "syntax tree"
+#include "alloc.h"
+
+#include "ast.h"
+#include "intern.h"
+
+const char *const ast_names[AST_KIND_COUNT] = {
+    [AST_PROGRAM]  = "program",
+    [AST_FUNCTION] = "function",
+    [AST_BLOCK]    = "block",
+    [AST_DECL]     = "decl",
+    [AST_ASSIGN]   = "assign",
+    [AST_IF]       = "if",
+    [AST_WHILE]    = "while",
+    [AST_FOR]      = "for",
+    [AST_PRINT]    = "print",
+    [AST_RETURN]   = "return",
+    [AST_EXPR]     = "expr",
+    [AST_EMPTY]    = "empty",
+    [AST_BINARY]   = "binary",
+    [AST_NEG]      = "neg",
+    [AST_NAME]     = "name",
+    [AST_NUMBER]   = "number",
+    [AST_STRING]   = "string",
+};
+
+static void print_node(FILE *out, const struct ast *ast, uint32_t node,
+                       int depth, ast_note_fn *note, const void *arg)
+{
+    const struct token *tok = NULL;
+    const char *text;
+    uint32_t child;
+    size_t len;
+
+    /* the program and what stands in for a missing part may have no
+     * token of their own */
+    if (ast->token[node] < ast->tokens->count)
+        tok = &ast->tokens->data[ast->token[node]];
+    fprintf(out, "%*s%s", depth * 2, "", ast_names[ast->kind[node]]);
+    switch (ast->kind[node]) {
+    case AST_FUNCTION:
+    case AST_DECL:
+    case AST_BINARY:
+        fprintf(out, " %s", token_text[tok->kind]);
+        break;
+    case AST_NAME:
+        text = symbol_name(tok->value, &len);
+        fprintf(out, " %.*s", (int) len, text);
+        break;
+    case AST_STRING:
+        text = symbol_name(tok->value, &len);
+        fprintf(out, " \"%.*s\"", (int) len, text);
+        break;
+    case AST_NUMBER: {
+        const struct number *num = &ast->tokens->numbers[tok->value];
+        char buf[NUMBER_FORMAT_SIZE];
+
+        if (num->type == NUMBER_FLOAT)
+            number_format(buf, num->as.f);
+        else
+            snprintf(buf, sizeof buf, "%lld", (long long) num->as.i);
+        fprintf(out, " %s", buf);
+        break;
+    }
+    default:
+        break;
+    }
+    if (note)
+        note(out, node, arg);
+    fputc('\n', out);
+    for (child = ast->child[node]; child; child = ast->next[child])
+        print_node(out, ast, child, depth + 1, note, arg);
+}
+
+void ast_print(FILE *out, const struct ast *ast)
+{
+    ast_print_notes(out, ast, NULL, NULL);
+}
+
+void ast_print_notes(FILE *out, const struct ast *ast, ast_note_fn *note,
+                     const void *arg)
+{
+    if (ast->root)
+        print_node(out, ast, ast->root, 0, note, arg);
+}
+
+static void resize(struct ast *ast, uint32_t capacity)
+{
+    ast->kind = xrealloc(ast->kind, capacity * sizeof *ast->kind);
+    ast->token = xrealloc(ast->token, capacity * sizeof *ast->token);
+    ast->child = xrealloc(ast->child, capacity * sizeof *ast->child);
+    ast->next = xrealloc(ast->next, capacity * sizeof *ast->next);
+    ast->capacity = capacity;
+}
+
+/* Room for about as many nodes as there are tokens, which is more than
+ * the parser makes of any real source. */
+void ast_init(struct ast *ast, const struct token_buffer *tokens)
+{
+    ast->kind = NULL;
+    ast->token = NULL;
+    ast->child = NULL;
+    ast->next = NULL;
+    ast->count = 1;
+    ast->capacity = 0;
+    ast->root = AST_NONE;
+    ast->tokens = tokens;
+    resize(ast, (uint32_t) tokens->count + 64);
+    ast->kind[AST_NONE] = AST_EMPTY;
+    ast->token[AST_NONE] = 0;
+    ast->child[AST_NONE] = AST_NONE;
+    ast->next[AST_NONE] = AST_NONE;
+}
+
+void ast_grow(struct ast *ast)
+{
+    if (ast->capacity > UINT32_MAX / 2) {
+        fprintf(stderr, "minilang: syntax tree too large\n");
+        exit(1);
+    }
+    resize(ast, ast->capacity * 2);
+}
+
+void ast_shrink(struct ast *ast)
+{
+    resize(ast, ast->count);
+}
+
+void ast_free(struct ast *ast)
+{
+    free(ast->kind);
+    free(ast->token);
+    free(ast->child);
+    free(ast->next);
+    ast->kind = NULL;
+    ast->token = NULL;
+    ast->child = NULL;
+    ast->next = NULL;
+    ast->count = 0;
+    ast->capacity = 0;
+    ast->root = AST_NONE;
+}
@@ -0,0 +1,116 @@
+#ifndef MINILANG_AST_H
+#define MINILANG_AST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "token.h"
+
+/* Syntax tree of a MiniLang source.
+ *
+ * Nodes are numbered, and stored as parallel arrays indexed by number
+ * rather than as structs linked by pointers: a node is its kind, the
+ * index of the token it comes from, its first child and its next sibling,
+ * 13 bytes where a node of pointers takes 24, and a pass that only looks
+ * at one field reads only that array.  Number 0 (AST_NONE) is no node.
+ * Nodes are numbered in the order the parser makes them: a statement
+ * before its parts, an operator after its operands.  Either way every
+ * subtree is a contiguous range of numbers, so walking the tree walks the
+ * arrays front to back, apart from short hops within a subtree.
+ *
+ * What the children are depends on the kind:
+ *
+ *   AST_PROGRAM    functions and statements
+ *   AST_FUNCTION   NAME, BLOCK; token: the type keyword ("int main {")
+ *   AST_BLOCK      statements
+ *   AST_DECL       NAME [, initial value]; token: the type keyword
+ *   AST_ASSIGN     NAME, value
+ *   AST_IF         condition, then [, else]
+ *   AST_WHILE      condition, body
+ *   AST_FOR        init, condition, step, body; missing ones are EMPTY
+ *   AST_PRINT      value
+ *   AST_RETURN     [value]
+ *   AST_EXPR       expression, as a statement
+ *   AST_EMPTY      nothing (also stands in for what failed to parse)
+ *   AST_BINARY     left, right; token: the operator
+ *   AST_NEG        operand
+ *   AST_NAME       none; the token's value is the symbol
+ *   AST_NUMBER     none; the token's value indexes the numbers
+ *   AST_STRING     none; the token's value is the text's symbol
+ *
+ * Names, numbers and strings are read through the token buffer, so the
+ * tree needs neither the source nor copies of its text. */
+enum ast_kind {
+    AST_PROGRAM,
+    AST_FUNCTION,
+    AST_BLOCK,
+    AST_DECL,
+    AST_ASSIGN,
+    AST_IF,
+    AST_WHILE,
+    AST_FOR,
+    AST_PRINT,
+    AST_RETURN,
+    AST_EXPR,
+    AST_EMPTY,
+    AST_BINARY,
+    AST_NEG,
+    AST_NAME,
+    AST_NUMBER,
+    AST_STRING,
+    AST_KIND_COUNT
+};
+
+#define AST_NONE 0
+
+struct ast {
+    uint8_t *kind;
+    uint32_t *token;
+    uint32_t *child;
+    uint32_t *next;
+    uint32_t count;         /* nodes, counting the unused number 0 */
+    uint32_t capacity;
+    uint32_t root;
+    const struct token_buffer *tokens;
+};
+
+/* Bytes one node takes in the arrays. */
+#define AST_NODE_BYTES  (sizeof(uint8_t) + 3 * sizeof(uint32_t))
+
+extern const char *const ast_names[AST_KIND_COUNT];
+
+/* One node per line, children indented under their parent. */
+void ast_print(FILE *out, const struct ast *ast);
+
+/* As ast_print(), with note() called to add to the end of each line. */
+typedef void ast_note_fn(FILE *out, uint32_t node, const void *arg);
+
+void ast_print_notes(FILE *out, const struct ast *ast, ast_note_fn *note,
+                     const void *arg);
+
+void ast_init(struct ast *ast, const struct token_buffer *tokens);
+void ast_free(struct ast *ast);
+
+void ast_grow(struct ast *ast);
+
+/* Number of a new node with no children or siblings. */
+static inline uint32_t ast_add(struct ast *ast, enum ast_kind kind,
+                               uint32_t token)
+{
+    uint32_t n;
+
+    if (ast->count == ast->capacity)
+        ast_grow(ast);
+    n = ast->count++;
+    ast->kind[n] = (uint8_t) kind;
+    ast->token[n] = token;
+    ast->child[n] = AST_NONE;
+    ast->next[n] = AST_NONE;
+    return n;
+}
+
+/* Give back the room reserved for nodes that were not made. */
+void ast_shrink(struct ast *ast);
+
+#endif
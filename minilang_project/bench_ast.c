@@ -0,0 +1,222 @@
+/* Syntax tree traversal benchmark: the flat tree of ast.h against the same
+ * tree built from pointer-linked nodes, the layout it replaced.
+ *
+ *   bench_ast FILE...
+ *
+ * Each file is lexed and parsed, and the tree is copied into nodes of
+ * { kind, token, child pointer, sibling pointer } allocated from an arena
+ * in the same order, so both trees have the same shape and node order and
+ * differ only in layout.  Two passes are timed on each:
+ *
+ *   walk   depth-first visit of every node, as a checker or code
+ *          generator makes, folding kind and token into a checksum
+ *   kinds  count the nodes of each kind, a pass that needs no structure:
+ *          the pointer tree still has to be walked, the flat one is a
+ *          scan of the kind array
+ *
+ * One tab-separated line per file gives the node count, bytes per node of
+ * each layout, and nanoseconds per node of each pass (best of several
+ * rounds). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arena.h"
+#include "ast.h"
+#include "dfalex.h"
+#include "diag.h"
+#include "parse.h"
+#include "source.h"
+
+#define ROUNDS          7
+#define MIN_ROUND_NS    50000000.0      /* repeat a pass until this long */
+
+struct ptr_node {
+    uint32_t kind;
+    uint32_t token;
+    struct ptr_node *child;
+    struct ptr_node *next;
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/* Copy of `ast` as pointer-linked nodes; returns the root. */
+static struct ptr_node *copy_tree(const struct ast *ast, struct arena *arena)
+{
+    struct ptr_node **nodes = malloc(ast->count * sizeof *nodes);
+    struct ptr_node *root;
+    uint32_t i;
+
+    if (!nodes) {
+        fprintf(stderr, "bench_ast: out of memory\n");
+        exit(1);
+    }
+    nodes[AST_NONE] = NULL;
+    for (i = 1; i < ast->count; i++)
+        nodes[i] = arena_alloc(arena, sizeof **nodes);
+    for (i = 1; i < ast->count; i++) {
+        nodes[i]->kind = ast->kind[i];
+        nodes[i]->token = ast->token[i];
+        nodes[i]->child = nodes[ast->child[i]];
+        nodes[i]->next = nodes[ast->next[i]];
+    }
+    root = nodes[ast->root];
+    free(nodes);
+    return root;
+}
+
+static uint64_t walk_ptr(const struct ptr_node *node)
+{
+    uint64_t sum = 0;
+
+    for (; node; node = node->next)
+        sum += node->kind * 31u + node->token + walk_ptr(node->child);
+    return sum;
+}
+
+static uint64_t walk_flat(const struct ast *ast, uint32_t node)
+{
+    uint64_t sum = 0;
+
+    for (; node; node = ast->next[node])
+        sum += ast->kind[node] * 31u + ast->token[node] +
+               walk_flat(ast, ast->child[node]);
+    return sum;
+}
+
+static void kinds_ptr(const struct ptr_node *node, uint64_t *counts)
+{
+    for (; node; node = node->next) {
+        counts[node->kind]++;
+        kinds_ptr(node->child, counts);
+    }
+}
+
+static void kinds_flat(const struct ast *ast, uint64_t *counts)
+{
+    uint32_t i;
+
+    for (i = 1; i < ast->count; i++)
+        counts[ast->kind[i]]++;
+}
+
+enum pass { WALK_PTR, WALK_FLAT, KINDS_PTR, KINDS_FLAT, PASS_COUNT };
+
+/* Best nanoseconds per node of a pass; `check` gets a value that depends
+ * on its result, so that it is not optimised away and the two layouts can
+ * be checked against each other. */
+static double time_pass(enum pass pass, const struct ast *ast,
+                        const struct ptr_node *root, uint64_t *check)
+{
+    double best = 0;
+    int round;
+
+    for (round = 0; round < ROUNDS; round++) {
+        uint64_t counts[AST_KIND_COUNT];
+        double start = now_ns(), t;
+        long reps = 0;
+
+        do {
+            uint64_t sum = 0;
+
+            memset(counts, 0, sizeof counts);
+            switch (pass) {
+            case WALK_PTR:
+                sum = walk_ptr(root);
+                break;
+            case WALK_FLAT:
+                sum = walk_flat(ast, ast->root);
+                break;
+            case KINDS_PTR:
+                kinds_ptr(root, counts);
+                break;
+            case KINDS_FLAT:
+                kinds_flat(ast, counts);
+                break;
+            case PASS_COUNT:
+                break;
+            }
+            *check = sum + counts[AST_NAME] * 7 + counts[AST_BINARY];
+            reps++;
+            t = now_ns() - start;
+        } while (t < MIN_ROUND_NS);
+        t /= (double) reps * (double) (ast->count - 1);
+        if (round == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+static int bench_file(const char *path)
+{
+    struct source src;
+    struct token_buffer tokens;
+    struct line_index lines;
+    struct arena arena;
+    struct ptr_node *root;
+    struct ast ast;
+    uint64_t check[PASS_COUNT];
+    double ns[PASS_COUNT];
+    int pass;
+
+    if (source_open(&src, path) != 0) {
+        fprintf(stderr, "bench_ast: ");
+        perror(path);
+        return 1;
+    }
+    token_buffer_init(&tokens);
+    dfa_lex(src.data, src.len, &tokens);
+    line_index_init(&lines, src.data, src.len);
+    diag_begin(path, &lines);
+    parse(&tokens, (uint32_t) src.len, &ast);
+    diag_end();
+    line_index_free(&lines);
+    if (ast.count < 2) {
+        fprintf(stderr, "bench_ast: %s: empty tree\n", path);
+        return 1;
+    }
+
+    arena_init(&arena);
+    root = copy_tree(&ast, &arena);
+    for (pass = 0; pass < PASS_COUNT; pass++)
+        ns[pass] = time_pass((enum pass) pass, &ast, root, &check[pass]);
+    if (check[WALK_PTR] != check[WALK_FLAT] ||
+        check[KINDS_PTR] != check[KINDS_FLAT]) {
+        fprintf(stderr, "bench_ast: %s: the two trees differ\n", path);
+        return 1;
+    }
+
+    printf("%s\t%lu\t%.1f\t%.1f\t%.2f\t%.2f\t%.2f\t%.2f\n", path,
+           (unsigned long) (ast.count - 1), (double) AST_NODE_BYTES,
+           (double) arena.bytes / (double) (ast.count - 1),
+           ns[WALK_PTR], ns[WALK_FLAT], ns[KINDS_PTR], ns[KINDS_FLAT]);
+    arena_free(&arena);
+    ast_free(&ast);
+    token_buffer_free(&tokens);
+    source_close(&src);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int status = 0;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: bench_ast FILE...\n");
+        return 2;
+    }
+    printf("file\tnodes\tflat_bytes_per_node\tptr_bytes_per_node"
+           "\twalk_ptr_ns\twalk_flat_ns\tkinds_ptr_ns\tkinds_flat_ns\n");
+    for (i = 1; i < argc; i++)
+        status |= bench_file(argv[i]);
+    return status;
+}
@@ -0,0 +1,134 @@
+#!/bin/sh
+# Superinstructions: runs each program in bench/ on the VM with and
+# without them (`minilang --run` and `--run --no-fuse`), checks that both
+# print the same thing and prints one tab-separated line per program: the
+# loop iterations (back_jumps), the instructions dispatched and those per
+# iteration without and with fusing, and the best run_seconds of REPEAT
+# runs of each.  Dispatches are counted in a run of their own, since
+# counting slows the VM down.
+#
+#   ./bench_fuse.sh [-o results.tsv] [-b baseline.tsv] [-t percent]
+#                   [program.minilang...]
+#   ./bench_fuse.sh -p [program.minilang...]
+#
+# Programs default to bench/*.minilang.  -o and -b work as in
+# bench_lex.sh, on fused_seconds.  -p prints the static profile that
+# chose the superinstructions instead: the sequences of instructions in
+# the unfused code of all the programs together, heaviest first (see
+# profile_print() in fuse.h).
+
+MINILANG=${MINILANG:-./minilang}
+REPEAT=${REPEAT:-3}
+
+out=
+baseline=
+tolerance=10
+profile=
+while getopts o:b:t:p opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    p) profile=1 ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[-p] [program.minilang...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || set -- bench/*.minilang
+
+if [ -n "$profile" ]; then
+    printf '%s\t%s\t%s\n' weight count sequence
+    for file; do
+        "$MINILANG" --emit=profile --no-fuse "$file" || exit 1
+    done | awk -F '\t' '
+        { weight[$3] += $1; count[$3] += $2 }
+        END {
+            for (s in weight)
+                printf "%.0f\t%d\t%s\n", weight[s], count[s], s
+        }' | sort -t "$(printf '\t')" -k1,1nr -k2,2nr
+    exit
+fi
+
+results=$(mktemp) || exit 1
+plain_out=$(mktemp) || exit 1
+fused_out=$(mktemp) || exit 1
+trap 'rm -f "$results" "$plain_out" "$fused_out"' EXIT
+
+# Prints the least run_seconds of REPEAT runs of $1 with the options that
+# follow, and leaves what the program printed in $2.
+measure() {
+    file=$1
+    output=$2
+    shift 2
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --run "$@" "$file" 2>&1 > "$output" |
+            grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (line == "" || v["run_seconds"] + 0 < best + 0) {
+            best = v["run_seconds"]
+            line = best
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+# Prints the dispatches and back_jumps of one counting run.
+count() {
+    "$MINILANG" --stats --run --count-dispatches "$@" 2>&1 > /dev/null |
+        awk '/^minilang: stats:/ {
+            for (i = 3; i <= NF; i++) {
+                split($i, kv, "=")
+                v[kv[1]] = kv[2]
+            }
+            print v["dispatches"], v["back_jumps"]
+        }'
+}
+
+printf '%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n' program iterations \
+    plain_dispatches fused_dispatches plain_per_iteration \
+    fused_per_iteration plain_seconds fused_seconds speedup | tee "$results"
+for file; do
+    plain=$(measure "$file" "$plain_out" --no-fuse) &&
+        fused=$(measure "$file" "$fused_out") &&
+        plain_counts=$(count --no-fuse "$file") &&
+        fused_counts=$(count "$file") || {
+        echo "$0: running $file failed" >&2
+        exit 1
+    }
+    if ! cmp -s "$plain_out" "$fused_out"; then
+        echo "$0: $file: fused and unfused code disagree" >&2
+        exit 1
+    fi
+    echo "$(basename "$file" .minilang) $plain_counts $fused_counts" \
+        "$plain $fused" | awk '{
+        printf "%s\t%d\t%d\t%d\t%.2f\t%.2f\t%s\t%s\t%.2f\n", $1, $3, $2, $4,
+               ($3 > 0 ? $2 / $3 : 0), ($3 > 0 ? $4 / $3 : 0), $6, $7,
+               ($7 > 0 ? $6 / $7 : 0)
+    }' | tee -a "$results"
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1] = $8; next }
+        $1 in base {
+            old = base[$1]
+            change = (old > 0) ? ($8 - old) / old * 100 : 0
+            if (change > tol) {
+                printf "regression: %s: %.3f s, was %.3f (%+.1f%%)\n",
+                       $1, $8, old, change > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
@@ -0,0 +1,122 @@
+#!/bin/sh
+# Lexer throughput: generates corpora of each mix (see gen_corpus.c) at
+# each size, lexes them with every engine, and prints one tab-separated
+# line per run with the figures from `minilang --stats`.  The best of
+# REPEAT runs is kept.
+#
+#   ./bench_lex.sh [-o results.tsv] [-b baseline.tsv] [-t percent] [size...]
+#
+# Sizes default to 1k 1m 64m; anything gen_corpus accepts works, up to 1g.
+# With -b, each run is compared with the line of the same mix, size and
+# engine in an earlier results file, and the script fails if MB/s dropped
+# by more than the tolerance (default 10 percent).
+#
+# Engines: flex is the minilang.l scanner, table the one that runs the
+# tables lexgen builds from minilang.l, dfa-j1 the hand-coded one on one
+# thread, dfa the hand-coded one on every CPU.  Corpora are cached in
+# CORPUS_DIR, so only the first run pays for generating them.
+#
+# Tokens are written in the binary format unless EMIT=tokens, which prints
+# them as text: then dfa on more than one CPU lexes on one thread while the
+# other prints, and total_seconds (lexing and writing) is the figure to
+# compare with dfa-j1, which does one after the other.
+
+MINILANG=${MINILANG:-./minilang}
+GEN_CORPUS=${GEN_CORPUS:-./gen_corpus}
+CORPUS_DIR=${CORPUS_DIR:-corpus}
+REPEAT=${REPEAT:-3}
+MIXES=${MIXES:-"balanced comments identifiers numbers strings unicode"}
+ENGINES=${ENGINES:-"flex table dfa-j1 dfa"}
+EMIT=${EMIT:-tokens-bin}
+
+out=
+baseline=
+tolerance=10
+while getopts o:b:t: opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[size...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+sizes=${*:-"1k 1m 64m"}
+
+mkdir -p "$CORPUS_DIR" || exit 1
+results=$(mktemp) || exit 1
+trap 'rm -f "$results"' EXIT
+
+# Prints the --stats fields of the fastest of REPEAT runs.
+measure() {
+    engine=$1
+    file=$2
+    case $engine in
+    flex)   set -- --engine=flex -j 1 ;;
+    table)  set -- --engine=table -j 1 ;;
+    dfa-j1) set -- --engine=dfa -j 1 ;;
+    dfa)    set -- --engine=dfa ;;
+    *)      echo "$0: unknown engine $engine" >&2; exit 2 ;;
+    esac
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --emit="$EMIT" "$@" "$file" 2>&1 > /dev/null |
+            grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (v["mb_per_s"] + 0 > best + 0) {
+            best = v["mb_per_s"]
+            line = v["bytes"] "\t" v["tokens"] "\t" v["seconds"] "\t" \
+                   v["mb_per_s"] "\t" v["tokens_per_s"] "\t" \
+                   v["cycles_per_byte"] "\t" v["peak_rss_kb"] "\t" \
+                   v["total_seconds"]
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+printf '%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n' mix size engine bytes \
+    tokens seconds mb_per_s tokens_per_s cycles_per_byte peak_rss_kb \
+    total_seconds | tee "$results"
+for size in $sizes; do
+    for mix in $MIXES; do
+        file=$CORPUS_DIR/$mix-$size.minilang
+        if [ ! -f "$file" ]; then
+            "$GEN_CORPUS" --mix="$mix" "$size" > "$file.tmp" &&
+                mv "$file.tmp" "$file" || exit 1
+        fi
+        for engine in $ENGINES; do
+            fields=$(measure "$engine" "$file") || {
+                echo "$0: $engine failed on $file" >&2
+                exit 1
+            }
+            printf '%s\t%s\t%s\t%s\n' "$mix" "$size" "$engine" "$fields" |
+                tee -a "$results"
+        done
+    done
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1 "\t" $2 "\t" $3] = $7; next }
+        ($1 "\t" $2 "\t" $3) in base {
+            old = base[$1 "\t" $2 "\t" $3]
+            change = (old > 0) ? ($7 - old) / old * 100 : 0
+            if (change < -tol) {
+                printf "regression: %s %s %s: %.2f MB/s, was %.2f" \
+                       " (%.1f%%)\n", $1, $2, $3, $7, old, change \
+                       > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
@@ -0,0 +1,166 @@
+#!/bin/sh
+# The native backend: compiles each program in bench/ to an object
+# (`minilang --emit=obj`), links it with the runtime, checks that it
+# prints what the VM does and prints one tab-separated line per program:
+# the functions compiled and the bytes of code, the seconds the backend
+# took, and the best run_seconds of REPEAT runs on the VM and natively.
+#
+#   ./bench_native.sh [-o results.tsv] [-b baseline.tsv] [-t percent]
+#                     [program.minilang...]
+#   ./bench_native.sh -f count
+#
+# Programs default to bench/*.minilang.  -o and -b work as in
+# bench_lex.sh, on native_seconds of the run.  -f times compiling instead:
+# a program of `count` generated functions, each a loop with a branch,
+# ints, floats and prints, to an object, the best of REPEAT, as functions
+# per second from the source and from the IR.  CC is the compiler that
+# links, with the flags in CFLAGS.
+
+MINILANG=${MINILANG:-./minilang}
+REPEAT=${REPEAT:-3}
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+out=
+baseline=
+tolerance=10
+functions=
+while getopts o:b:t:f: opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    f) functions=$OPTARG ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[-f count] [program.minilang...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || set -- bench/*.minilang
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Prints the key=value pairs of the first stats line of the command, one
+# per line.
+stats() {
+    "$@" 2>&1 > /dev/null | awk '/^minilang: stats:/ {
+        for (i = 3; i <= NF; i++)
+            print $i
+        exit
+    }'
+}
+
+if [ -n "$functions" ]; then
+    awk -v n="$functions" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "int f%d {\n    int s = 0;\n    float x = 0.5;\n", i
+            printf "    for (int i = 0; i < %d; i = i + 1) {\n", i + 10
+            printf "        if (i - i / 3 * 3 == 0) {\n"
+            printf "            s = s + i * %d;\n", i
+            printf "        } else {\n            x = x * 1.5 + i;\n"
+            printf "        }\n    }\n    print(s);\n    print(x);\n}\n"
+        }
+        print "int main {\n    print(0);\n}"
+    }' > "$dir/functions.minilang" || exit 1
+    printf '%s\t%s\t%s\t%s\t%s\n' functions native_seconds functions_per_s \
+        backend_functions_per_s code_bytes
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        stats "$MINILANG" --stats --emit=obj "$dir/functions.minilang" |
+            tr '\n' ' ' || exit 1
+        echo
+        i=$((i + 1))
+    done | awk '{
+        for (i = 1; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (best == "" || v["functions_per_s"] + 0 > best + 0) {
+            best = v["functions_per_s"]
+            backend = 0
+            if (v["native_seconds"] > 0)
+                backend = v["functions"] / v["native_seconds"]
+            line = sprintf("%d\t%s\t%s\t%.0f\t%d", v["functions"],
+                           v["native_seconds"], best, backend,
+                           v["code_bytes"])
+        }
+    } END { if (line == "") exit 1; print line }'
+    exit
+fi
+
+runtime="native.c runtime.c number.c arena.c"
+for file in $runtime; do
+    $CC $CFLAGS -c -o "$dir/$(basename "$file" .c).o" "$file" || exit 1
+done
+
+# Prints the least run_seconds of REPEAT runs of the command, and leaves
+# what it printed in $1.
+measure() {
+    output=$1
+    shift
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        MINILANG_STATS=1 "$@" 2>&1 > "$output" |
+            grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (line == "" || v["run_seconds"] + 0 < best + 0) {
+            best = v["run_seconds"]
+            line = best
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+results=$dir/results.tsv
+printf '%s\t%s\t%s\t%s\t%s\t%s\t%s\n' program functions code_bytes \
+    compile_seconds vm_seconds native_seconds speedup | tee "$results"
+for file; do
+    name=$(basename "$file" .minilang)
+    compiled=$(stats "$MINILANG" --stats --emit=obj "$file") &&
+        "$MINILANG" --emit=obj "$file" > "$dir/$name.o" &&
+        $CC $CFLAGS -o "$dir/$name" "$dir/$name.o" "$dir/native.o" \
+            "$dir/runtime.o" "$dir/number.o" "$dir/arena.o" -lm &&
+        vm=$(measure "$dir/vm.out" "$MINILANG" --stats --run "$file") &&
+        native=$(measure "$dir/native.out" "$dir/$name") || {
+        echo "$0: running $file failed" >&2
+        exit 1
+    }
+    if ! cmp -s "$dir/vm.out" "$dir/native.out"; then
+        echo "$0: $file: the VM and the native code disagree" >&2
+        exit 1
+    fi
+    echo "$compiled" | awk -v name="$name" -v vm="$vm" -v native="$native" '
+        {
+            split($0, kv, "=")
+            v[kv[1]] = kv[2]
+        } END {
+            printf "%s\t%d\t%d\t%s\t%s\t%s\t%.2f\n", name, v["functions"],
+                   v["code_bytes"], v["native_seconds"], vm, native,
+                   (native > 0 ? vm / native : 0)
+        }' | tee -a "$results"
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1] = $6; next }
+        $1 in base {
+            old = base[$1]
+            change = (old > 0) ? ($6 - old) / old * 100 : 0
+            if (change > tol) {
+                printf "regression: %s: %.3f s, was %.3f (%+.1f%%)\n",
+                       $1, $6, old, change > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
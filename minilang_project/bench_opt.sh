@@ -0,0 +1,163 @@
+#!/bin/sh
+# The optimizer: runs each program in bench/ on the VM without any passes
+# and with the default pipeline (`minilang --run --passes=` and `--run`),
+# checks that both print the same thing and prints one tab-separated line
+# per program: the IR instructions before and after the passes, the
+# instructions dispatched without and with them, and the best run_seconds
+# of REPEAT runs of each.  Dispatches are counted in a run of their own,
+# since counting slows the VM down.
+#
+#   ./bench_opt.sh [-o results.tsv] [-b baseline.tsv] [-t percent]
+#                  [program.minilang...]
+#   ./bench_opt.sh -p [program.minilang...]
+#
+# Programs default to bench/*.minilang.  -o and -b work as in
+# bench_lex.sh, on opt_seconds.  -p prints what each pass did instead,
+# summed over the programs: its seconds, the instructions it took away
+# (or added, below 0) and the count it reports (see opt_stats_print() in
+# opt.h).
+
+MINILANG=${MINILANG:-./minilang}
+REPEAT=${REPEAT:-3}
+
+out=
+baseline=
+tolerance=10
+passes=
+while getopts o:b:t:p opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    p) passes=1 ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[-p] [program.minilang...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || set -- bench/*.minilang
+
+if [ -n "$passes" ]; then
+    printf '%s\t%s\t%s\t%s\t%s\n' pass runs seconds removed changes
+    for file; do
+        "$MINILANG" --stats --emit=ir "$file" 2>&1 > /dev/null |
+            grep '^minilang: pass:' || exit 1
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        name = v["name"]
+        if (!(name in runs))
+            order[n++] = name
+        runs[name] += v["runs"]
+        seconds[name] += v["seconds"]
+        removed[name] += v["insns_before"] - v["insns_after"]
+        # the last field is the count the pass reports
+        split($NF, kv, "=")
+        changes[name] += kv[2]
+    } END {
+        for (i = 0; i < n; i++)
+            printf "%s\t%d\t%.6f\t%d\t%d\n", order[i], runs[order[i]],
+                   seconds[order[i]], removed[order[i]], changes[order[i]]
+    }'
+    exit
+fi
+
+results=$(mktemp) || exit 1
+plain_out=$(mktemp) || exit 1
+opt_out=$(mktemp) || exit 1
+trap 'rm -f "$results" "$plain_out" "$opt_out"' EXIT
+
+# Prints the least run_seconds of REPEAT runs of $1 with the options that
+# follow, and leaves what the program printed in $2.
+measure() {
+    file=$1
+    output=$2
+    shift 2
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --run "$@" "$file" 2>&1 > "$output" |
+            grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (line == "" || v["run_seconds"] + 0 < best + 0) {
+            best = v["run_seconds"]
+            line = best
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+# Prints the dispatches of one counting run.
+count() {
+    "$MINILANG" --stats --run --count-dispatches "$@" 2>&1 > /dev/null |
+        awk '/^minilang: stats:/ {
+            for (i = 3; i <= NF; i++) {
+                split($i, kv, "=")
+                v[kv[1]] = kv[2]
+            }
+            print v["dispatches"]
+        }'
+}
+
+# Prints the IR instructions of all frames before the first pass and
+# after the last.
+size() {
+    "$MINILANG" --stats --emit=ir "$1" 2>&1 > /dev/null |
+        awk '/^minilang: pass:/ {
+            for (i = 3; i <= NF; i++) {
+                split($i, kv, "=")
+                v[kv[1]] = kv[2]
+            }
+            if (before == "")
+                before = v["insns_before"]
+            after = v["insns_after"]
+        } END { print before, after }'
+}
+
+printf '%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n' program ir_before ir_after \
+    plain_dispatches opt_dispatches plain_seconds opt_seconds speedup |
+    tee "$results"
+for file; do
+    plain=$(measure "$file" "$plain_out" --passes=) &&
+        opt=$(measure "$file" "$opt_out") &&
+        plain_counts=$(count --passes= "$file") &&
+        opt_counts=$(count "$file") &&
+        sizes=$(size "$file") || {
+        echo "$0: running $file failed" >&2
+        exit 1
+    }
+    if ! cmp -s "$plain_out" "$opt_out"; then
+        echo "$0: $file: optimized and unoptimized code disagree" >&2
+        exit 1
+    fi
+    echo "$(basename "$file" .minilang) $sizes $plain_counts $opt_counts" \
+        "$plain $opt" | awk '{
+        printf "%s\t%d\t%d\t%d\t%d\t%s\t%s\t%.2f\n", $1, $2, $3, $4, $5,
+               $6, $7, ($7 > 0 ? $6 / $7 : 0)
+    }' | tee -a "$results"
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1] = $7; next }
+        $1 in base {
+            old = base[$1]
+            change = (old > 0) ? ($7 - old) / old * 100 : 0
+            if (change > tol) {
+                printf "regression: %s: %.3f s, was %.3f (%+.1f%%)\n",
+                       $1, $7, old, change > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
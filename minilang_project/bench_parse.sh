@@ -0,0 +1,119 @@
+#!/bin/sh
+# Parser throughput: generates corpora of each mix (see gen_corpus.c) at
+# each size, parses them with `minilang --emit=ast --stats` and prints one
+# tab-separated line per run with the parse figures, the best of REPEAT
+# runs.  Lexing and printing the tree are not counted, except in the last
+# columns, the front end's latency: lex_seconds, front_seconds (lexing
+# and then parsing, -j 1) and piped_seconds (the two overlapped, -j 2),
+# which on two free cores should come down toward the larger of
+# lex_seconds and parse_seconds.
+#
+#   ./bench_parse.sh [-o results.tsv] [-b baseline.tsv] [-t percent] [size...]
+#
+# Sizes default to 1m 64m.  -o and -b work as in bench_lex.sh, on
+# parse_mb_per_s; corpora are shared with it through CORPUS_DIR.
+
+MINILANG=${MINILANG:-./minilang}
+GEN_CORPUS=${GEN_CORPUS:-./gen_corpus}
+CORPUS_DIR=${CORPUS_DIR:-corpus}
+REPEAT=${REPEAT:-3}
+MIXES=${MIXES:-"balanced comments identifiers numbers strings unicode"}
+
+out=
+baseline=
+tolerance=10
+while getopts o:b:t: opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[size...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+sizes=${*:-"1m 64m"}
+
+mkdir -p "$CORPUS_DIR" || exit 1
+results=$(mktemp) || exit 1
+trap 'rm -f "$results"' EXIT
+
+# Prints the --stats fields of the fastest of REPEAT parses.
+measure() {
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --emit=ast --max-errors=0 -j 1 "$1" 2>&1 \
+            > /dev/null | grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (v["parse_mb_per_s"] + 0 > best + 0) {
+            best = v["parse_mb_per_s"]
+            line = v["bytes"] "\t" v["tokens"] "\t" v["nodes"] "\t" \
+                   v["parse_seconds"] "\t" v["parse_mb_per_s"] "\t" \
+                   (v["parse_seconds"] > 0 ? \
+                    sprintf("%.0f", v["nodes"] / v["parse_seconds"]) : 0) \
+                   "\t" v["peak_rss_kb"] "\t" v["seconds"] "\t" \
+                   v["front_seconds"]
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+# Prints the shortest front_seconds of REPEAT pipelined parses.
+measure_piped() {
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --emit=ast --max-errors=0 -j 2 "$1" 2>&1 \
+            > /dev/null | grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (best == "" || v["front_seconds"] + 0 < best + 0)
+            best = v["front_seconds"]
+    } END { if (best == "") exit 1; print best }'
+}
+
+printf '%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n' mix size bytes \
+    tokens nodes parse_seconds parse_mb_per_s nodes_per_s peak_rss_kb \
+    lex_seconds front_seconds piped_seconds | tee "$results"
+for size in $sizes; do
+    for mix in $MIXES; do
+        file=$CORPUS_DIR/$mix-$size.minilang
+        if [ ! -f "$file" ]; then
+            "$GEN_CORPUS" --mix="$mix" "$size" > "$file.tmp" &&
+                mv "$file.tmp" "$file" || exit 1
+        fi
+        fields=$(measure "$file") && piped=$(measure_piped "$file") || {
+            echo "$0: parsing $file failed" >&2
+            exit 1
+        }
+        printf '%s\t%s\t%s\t%s\n' "$mix" "$size" "$fields" "$piped" |
+            tee -a "$results"
+    done
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1 "\t" $2] = $7; next }
+        ($1 "\t" $2) in base {
+            old = base[$1 "\t" $2]
+            change = (old > 0) ? ($7 - old) / old * 100 : 0
+            if (change < -tol) {
+                printf "regression: %s %s: %.2f MB/s, was %.2f (%.1f%%)\n",
+                       $1, $2, $7, old, change > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
@@ -0,0 +1,223 @@
+/* Incremental re-lexing test and benchmark: relex() (relex.h) against
+ * lexing the whole edited source again.
+ *
+ *   bench_relex [--edits=N] [--max-edit=N] [--seed=N] FILE...
+ *
+ * Each file is lexed with dfa_lex(), then edited N times (default 1000)
+ * at random offsets: up to --max-edit bytes (default 8) removed and as
+ * many inserted, most of them ones tokens start, end or are made of, so
+ * edits open and close comments and strings, split and join tokens.
+ * After each edit the old tokens are brought up to date with relex() and
+ * the edited source is lexed again with dfa_lex(), and the two token
+ * streams, number values included, must be the same: the first edit
+ * where they are not is reported with the seed that reproduces it, and
+ * the exit status is 1.
+ *
+ * One tab-separated line per file gives its bytes, the edits, the tokens
+ * relex() replaced on average, and the median microseconds per edit of
+ * relex() and of the full lex. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ALLOC_PROGRAM "bench_relex"
+#define ALLOC_WHAT "edits"
+#include "alloc.h"
+
+#include "dfalex.h"
+#include "relex.h"
+#include "source.h"
+
+static uint64_t rng_state;
+
+/* xorshift64*, as gen_corpus uses. */
+static uint64_t rng(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static size_t below(size_t n)
+{
+    return (size_t) (rng() % n);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+static double median(double *v, size_t n)
+{
+    qsort(v, n, sizeof *v, compare_doubles);
+    return n ? v[n / 2] : 0;
+}
+
+/* An inserted byte: mostly one that starts, ends or makes up a token. */
+static char edit_byte(void)
+{
+    static const char token_bytes[] = "/*\"\n \t0123456789.=<>!+-;,{}()_az";
+
+    if (below(8) == 0)
+        return (char) below(256);
+    return token_bytes[below(sizeof token_bytes - 1)];
+}
+
+/* Whether relex() left what dfa_lex() gives: returns the index of the
+ * first token or number that differs, or -1. */
+static long differs(const struct token_buffer *a, const struct token_buffer *b)
+{
+    size_t i;
+
+    for (i = 0; i < a->count && i < b->count; i++) {
+        if (memcmp(&a->data[i], &b->data[i], sizeof *a->data) != 0)
+            return (long) i;
+    }
+    if (a->count != b->count)
+        return (long) i;
+    for (i = 0; i < a->number_count && i < b->number_count; i++) {
+        if (a->numbers[i].type != b->numbers[i].type ||
+            a->numbers[i].offset != b->numbers[i].offset ||
+            memcmp(&a->numbers[i].as, &b->numbers[i].as,
+                   sizeof a->numbers[i].as) != 0)
+            return (long) i;
+    }
+    return a->number_count != b->number_count ? (long) i : -1;
+}
+
+static int bench_file(const char *path, size_t edits, size_t max_edit,
+                      uint64_t seed)
+{
+    struct source file;
+    struct token_buffer tokens, full;
+    double *relex_ns = xmalloc(edits * sizeof *relex_ns);
+    double *full_ns = xmalloc(edits * sizeof *full_ns);
+    double replaced = 0;
+    char *src;
+    size_t len, capacity, n;
+    int status = 0;
+
+    if (source_open(&file, path) != 0) {
+        fprintf(stderr, "bench_relex: ");
+        perror(path);
+        free(relex_ns);
+        free(full_ns);
+        return 1;
+    }
+    /* An editable copy, with room for every edit to grow it and the two
+     * NUL bytes past the end a source has. */
+    len = file.len;
+    capacity = len + edits * max_edit + 2;
+    src = xmalloc(capacity);
+    memcpy(src, file.data, len);
+    memset(src + len, 0, capacity - len);
+    source_close(&file);
+
+    rng_state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    token_buffer_init(&tokens);
+    token_buffer_init(&full);
+    dfa_lex(src, len, &tokens);
+    for (n = 0; n < edits; n++) {
+        struct edit edit;
+        struct relex_range changed;
+        double t;
+        long at;
+        size_t i;
+
+        edit.offset = below(len + 1);
+        edit.removed = below(max_edit + 1);
+        if (edit.removed > len - edit.offset)
+            edit.removed = len - edit.offset;
+        edit.inserted = below(max_edit + 1);
+        memmove(src + edit.offset + edit.inserted,
+                src + edit.offset + edit.removed,
+                len - edit.offset - edit.removed);
+        for (i = 0; i < edit.inserted; i++)
+            src[edit.offset + i] = edit_byte();
+        len = len - edit.removed + edit.inserted;
+        src[len] = src[len + 1] = '\0';
+
+        t = now_ns();
+        relex(&tokens, src, len, &edit, &changed);
+        relex_ns[n] = now_ns() - t;
+        replaced += (double) changed.removed;
+
+        full.count = 0;
+        full.number_count = 0;
+        t = now_ns();
+        dfa_lex(src, len, &full);
+        full_ns[n] = now_ns() - t;
+
+        at = differs(&tokens, &full);
+        if (at >= 0) {
+            fprintf(stderr, "bench_relex: %s: --seed=%llu edit %lu (%lu bytes"
+                    " at %lu replaced by %lu): relex() differs from a full"
+                    " lex at token or number %ld\n", path,
+                    (unsigned long long) seed, (unsigned long) n + 1,
+                    (unsigned long) edit.removed, (unsigned long) edit.offset,
+                    (unsigned long) edit.inserted, at);
+            status = 1;
+            break;
+        }
+    }
+    if (status == 0)
+        printf("%s\t%lu\t%lu\t%.1f\t%.2f\t%.2f\n", path, (unsigned long) len,
+               (unsigned long) edits, replaced / (double) edits,
+               median(relex_ns, edits) / 1e3, median(full_ns, edits) / 1e3);
+    token_buffer_free(&tokens);
+    token_buffer_free(&full);
+    free(src);
+    free(relex_ns);
+    free(full_ns);
+    return status;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bench_relex [--edits=N] [--max-edit=N]"
+                    " [--seed=N] FILE...\n");
+}
+
+int main(int argc, char **argv)
+{
+    size_t edits = 1000, max_edit = 8;
+    uint64_t seed = 1;
+    int status = 0;
+    int i;
+
+    for (i = 1; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+        if (strncmp(argv[i], "--edits=", 8) == 0) {
+            edits = strtoul(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "--max-edit=", 11) == 0) {
+            max_edit = strtoul(argv[i] + 11, NULL, 10);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (i == argc || edits == 0) {
+        usage();
+        return 2;
+    }
+    printf("file\tbytes\tedits\ttokens_replaced\trelex_us\tfull_lex_us\n");
+    for (; i < argc; i++)
+        status |= bench_file(argv[i], edits, max_edit, seed);
+    return status;
+}
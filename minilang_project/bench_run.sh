@@ -0,0 +1,103 @@
+#!/bin/sh
+# Interpreter speed: runs each program in bench/ with the tree walker
+# (`minilang --run=tree`), the VM on tagged registers and generic opcodes
+# (`--run=generic`) and the VM on typed opcodes (`--run`), checks that all
+# three print the same thing and prints one tab-separated line per
+# program with the best run_seconds of REPEAT runs of each, the speedup
+# of the VM over the tree walker and that of typed opcodes over generic
+# ones.  Parsing, checking and compiling are not counted.
+#
+#   ./bench_run.sh [-o results.tsv] [-b baseline.tsv] [-t percent]
+#                  [program.minilang...]
+#
+# Programs default to bench/*.minilang.  -o and -b work as in
+# bench_lex.sh, on vm_seconds: a run more than -t percent slower than the
+# baseline is a regression.
+
+MINILANG=${MINILANG:-./minilang}
+REPEAT=${REPEAT:-3}
+
+out=
+baseline=
+tolerance=10
+while getopts o:b:t: opt; do
+    case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    *) echo "usage: $0 [-o results.tsv] [-b baseline.tsv] [-t percent]" \
+            "[program.minilang...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || set -- bench/*.minilang
+
+results=$(mktemp) || exit 1
+tree_out=$(mktemp) || exit 1
+generic_out=$(mktemp) || exit 1
+vm_out=$(mktemp) || exit 1
+trap 'rm -f "$results" "$tree_out" "$generic_out" "$vm_out"' EXIT
+
+# Prints the least run_seconds of REPEAT runs of $2 with --run=$1 and
+# leaves what the program printed in $3.
+measure() {
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        "$MINILANG" --stats --run="$1" "$2" 2>&1 > "$3" |
+            grep '^minilang: stats:' || exit 1
+        i=$((i + 1))
+    done | awk '{
+        for (i = 3; i <= NF; i++) {
+            split($i, kv, "=")
+            v[kv[1]] = kv[2]
+        }
+        if (line == "" || v["run_seconds"] + 0 < best + 0) {
+            best = v["run_seconds"]
+            line = best
+        }
+    } END { if (line == "") exit 1; print line }'
+}
+
+# $1 / $2, to two places.
+ratio() {
+    awk -v x="$1" -v y="$2" 'BEGIN { printf "%.2f", (y > 0 ? x / y : 0) }'
+}
+
+printf '%s\t%s\t%s\t%s\t%s\t%s\n' program tree_seconds generic_seconds \
+    vm_seconds speedup typed_speedup | tee "$results"
+for file; do
+    tree=$(measure tree "$file" "$tree_out") &&
+        generic=$(measure generic "$file" "$generic_out") &&
+        vm=$(measure vm "$file" "$vm_out") || {
+        echo "$0: running $file failed" >&2
+        exit 1
+    }
+    if ! cmp -s "$tree_out" "$vm_out" || ! cmp -s "$generic_out" "$vm_out"
+    then
+        echo "$0: $file: the tree walker and the VM disagree" >&2
+        exit 1
+    fi
+    printf '%s\t%s\t%s\t%s\t%s\t%s\n' "$(basename "$file" .minilang)" \
+        "$tree" "$generic" "$vm" "$(ratio "$tree" "$vm")" \
+        "$(ratio "$generic" "$vm")" | tee -a "$results"
+done
+
+if [ -n "$out" ]; then
+    cp "$results" "$out" || exit 1
+fi
+if [ -n "$baseline" ]; then
+    awk -F '\t' -v tol="$tolerance" '
+        FNR == 1 { next }
+        NR == FNR { base[$1] = $4; next }
+        $1 in base {
+            old = base[$1]
+            change = (old > 0) ? ($4 - old) / old * 100 : 0
+            if (change > tol) {
+                printf "regression: %s: %.3f s, was %.3f (%+.1f%%)\n",
+                       $1, $4, old, change > "/dev/stderr"
+                failed = 1
+            }
+        }
+        END { exit failed }' "$baseline" "$results" || exit 1
+fi
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Thread scaling: lexes the given files with the flex scanner, then with
+# the hand-coded one at -j 1, 2, 4, ... 64, and prints wall-clock time and
+# speedup over flex.  Several files are spread across threads; a single
+# large file is split into chunks.
+#
+#   ./bench_threads.sh corpus/*.minilang
+
+if [ $# -eq 0 ]; then
+    echo "usage: $0 file..." >&2
+    exit 2
+fi
+
+MINILANG=${MINILANG:-./minilang}
+
+run() {
+    start=$(date +%s.%N)
+    "$MINILANG" --emit=tokens-bin "$@" > /dev/null || exit 1
+    end=$(date +%s.%N)
+    echo "$start $end" | awk '{ print $2 - $1 }'
+}
+
+base=$(run --engine=flex -j 1 "$@")
+printf 'flex        %8.3f s\n' "$base"
+for j in 1 2 4 8 16 32 64; do
+    t=$(run -j "$j" "$@")
+    echo "$j $t $base" |
+        awk '{ printf "%2d threads  %8.3f s  %6.2fx\n", $1, $2, $3 / $2 }'
+done
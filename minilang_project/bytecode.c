@@ -0,0 +1,729 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "bytecode"
+#include "alloc.h"
+
+#include "bytecode.h"
+#include "diag.h"
+#include "intern.h"
+#include "live.h"
+#include "moves.h"
+
+const char *const opcode_names[OP_COUNT] = {
+#define OPCODE_NAME(name, text, format) text,
+    OPCODES(OPCODE_NAME)
+#undef OPCODE_NAME
+};
+
+const unsigned char opcode_formats[OP_COUNT] = {
+#define OPCODE_FORMAT(name, text, format) format,
+    OPCODES(OPCODE_FORMAT)
+#undef OPCODE_FORMAT
+};
+
+
+/* A jump to a block, its target set once every block has its place. */
+struct fixup {
+    uint32_t at;
+    uint32_t block;
+};
+
+/* A conditional jump to the copies of an edge, laid out after the rest. */
+struct trampoline {
+    uint32_t at;
+    uint32_t from;
+    uint32_t to;
+};
+
+/* A group of values that share a register, from where it is first used
+ * to where it is last. */
+struct interval {
+    struct live_interval live;
+    uint32_t reg;           /* once scan() has given it one */
+};
+
+struct compiler {
+    const struct ir_func *f;
+    struct program *prog;
+    struct code *code;
+    uint64_t *keys;             /* of each constant, beside its value */
+    uint32_t *table;            /* constant index + 1 by key, 0 for none */
+    uint32_t table_size;        /* a power of two */
+    int generic;                /* to the _any opcodes */
+    uint32_t *reg;              /* of each value */
+    uint32_t *start;            /* of each block in the code */
+    struct fixup *fixups;
+    uint32_t fixup_count;
+    uint32_t fixup_capacity;
+    struct moves moves;
+    uint32_t move_offset;       /* of the copies emit_moves() makes */
+    struct trampoline *trampolines;
+    uint32_t trampoline_count;
+    uint32_t trampoline_capacity;
+    uint32_t scratch;           /* for a cycle of copies */
+    int scratch_used;
+    const struct live *live;
+    struct interval *held;      /* of the variables, by register */
+    uint32_t held_count;
+};
+
+static uint32_t emit(struct compiler *c, enum opcode op, uint32_t a,
+                     uint32_t b, uint32_t cc, uint32_t offset)
+{
+    struct code *code = c->code;
+    struct insn *insn;
+
+    if (code->count == code->capacity) {
+        code->capacity = code->capacity ? code->capacity * 2 : 256;
+        code->insns = xrealloc(code->insns,
+                               code->capacity * sizeof *code->insns);
+        code->offsets = xrealloc(code->offsets,
+                                 code->capacity * sizeof *code->offsets);
+    }
+    insn = &code->insns[code->count];
+    insn->op = (uint16_t) op;
+    insn->a = (uint16_t) a;
+    insn->b = (uint16_t) b;
+    insn->c = (uint16_t) cc;
+    code->offsets[code->count] = offset;
+    return code->count++;
+}
+
+static void set_target(struct compiler *c, uint32_t at, uint32_t target)
+{
+    c->code->insns[at].b = (uint16_t) target;
+    c->code->insns[at].c = (uint16_t) (target >> 16);
+}
+
+static void jump_to(struct compiler *c, enum opcode op, uint32_t reg,
+                    uint32_t block, uint32_t offset)
+{
+    if (c->fixup_count == c->fixup_capacity) {
+        c->fixup_capacity = c->fixup_capacity ? c->fixup_capacity * 2 : 64;
+        c->fixups = xrealloc(c->fixups,
+                             c->fixup_capacity * sizeof *c->fixups);
+    }
+    c->fixups[c->fixup_count].at = emit(c, op, reg, 0, 0, offset);
+    c->fixups[c->fixup_count++].block = block;
+}
+
+static uint64_t hash_key(enum type type, uint64_t key)
+{
+    key = (key ^ type) * UINT64_C(0x9E3779B97F4A7C15);
+    return key ^ key >> 29;
+}
+
+static void grow_table(struct compiler *c)
+{
+    uint32_t size = c->table_size ? c->table_size * 2 : 64;
+    uint32_t i;
+
+    free(c->table);
+    c->table = xrealloc(NULL, size * sizeof *c->table);
+    memset(c->table, 0, size * sizeof *c->table);
+    c->table_size = size;
+    for (i = 0; i < c->code->constant_count; i++) {
+        uint32_t h = (uint32_t) hash_key(
+            (enum type) c->code->constant_types[i], c->keys[i]);
+
+        while (c->table[h & (size - 1)])
+            h++;
+        c->table[h & (size - 1)] = i + 1;
+    }
+}
+
+/* Index of a constant in the frame's plus 1, or 0 if it has none; then
+ * *at is where in the table to add it.  `key` is what tells constants of
+ * a type apart: the bits of a number, the symbol of a string. */
+static uint32_t find_constant(struct compiler *c, enum type type,
+                              uint64_t key, uint32_t *at)
+{
+    const struct code *code = c->code;
+    uint32_t h, i;
+
+    if (code->constant_count * 2 >= c->table_size)
+        grow_table(c);
+    for (h = (uint32_t) hash_key(type, key);; h++) {
+        i = c->table[h & (c->table_size - 1)];
+        if (!i || (code->constant_types[i - 1] == type &&
+                   c->keys[i - 1] == key))
+            break;
+    }
+    *at = h & (c->table_size - 1);
+    return i;
+}
+
+/* Register of a constant, added to the frame's if it is new. */
+static uint32_t constant(struct compiler *c, enum type type, uint64_t key,
+                         union value value)
+{
+    struct code *code = c->code;
+    uint32_t at;
+    uint32_t i = find_constant(c, type, key, &at);
+
+    if (i)
+        return code->variables + i - 1;
+    if (code->constant_count == code->constant_capacity) {
+        code->constant_capacity = code->constant_capacity
+                                  ? code->constant_capacity * 2 : 64;
+        code->constants = xrealloc(code->constants, code->constant_capacity *
+                                                    sizeof *code->constants);
+        code->constant_types = xrealloc(code->constant_types,
+                                        code->constant_capacity);
+        c->keys = xrealloc(c->keys, code->constant_capacity * sizeof *c->keys);
+    }
+    i = code->constant_count++;
+    code->constants[i] = value;
+    code->constant_types[i] = (uint8_t) type;
+    c->keys[i] = key;
+    c->table[at] = i + 1;
+    return code->variables + i;
+}
+
+/* A string constant, whose text is copied in only the first time. */
+static uint32_t string_constant(struct compiler *c, uint32_t symbol)
+{
+    union value value;
+    uint32_t at;
+    uint32_t i = find_constant(c, TYPE_STRING, symbol, &at);
+    const char *text;
+    size_t len;
+
+    if (i)
+        return c->code->variables + i - 1;
+    text = symbol_name(symbol, &len);
+    value.s = str_make(&c->prog->strings, text, len);
+    return constant(c, TYPE_STRING, symbol, value);
+}
+
+/* The opcode of an IR instruction by the type of its operands. */
+static const unsigned char typed_ops[IR_OP_COUNT][TYPE_COUNT] = {
+    [IR_COPY] = {[TYPE_INT] = OP_MOVE, [TYPE_FLOAT] = OP_MOVE,
+                 [TYPE_STRING] = OP_MOVE},
+    [IR_I2F] = {[TYPE_INT] = OP_I2F},
+    [IR_F2I] = {[TYPE_FLOAT] = OP_F2I},
+    [IR_NEG] = {[TYPE_INT] = OP_NEG_I64, [TYPE_FLOAT] = OP_NEG_F64},
+    [IR_ADD] = {[TYPE_INT] = OP_ADD_I64, [TYPE_FLOAT] = OP_ADD_F64,
+                [TYPE_STRING] = OP_CONCAT_STR},
+    [IR_SUB] = {[TYPE_INT] = OP_SUB_I64, [TYPE_FLOAT] = OP_SUB_F64},
+    [IR_MUL] = {[TYPE_INT] = OP_MUL_I64, [TYPE_FLOAT] = OP_MUL_F64},
+    [IR_DIV] = {[TYPE_INT] = OP_DIV_I64, [TYPE_FLOAT] = OP_DIV_F64},
+    [IR_REM] = {[TYPE_INT] = OP_REM_I64},
+    [IR_EQ] = {[TYPE_INT] = OP_EQ_I64, [TYPE_FLOAT] = OP_EQ_F64,
+               [TYPE_STRING] = OP_EQ_STR},
+    [IR_NE] = {[TYPE_INT] = OP_NE_I64, [TYPE_FLOAT] = OP_NE_F64,
+               [TYPE_STRING] = OP_NE_STR},
+    [IR_LT] = {[TYPE_INT] = OP_LT_I64, [TYPE_FLOAT] = OP_LT_F64,
+               [TYPE_STRING] = OP_LT_STR},
+    [IR_LE] = {[TYPE_INT] = OP_LE_I64, [TYPE_FLOAT] = OP_LE_F64,
+               [TYPE_STRING] = OP_LE_STR},
+    [IR_GT] = {[TYPE_INT] = OP_GT_I64, [TYPE_FLOAT] = OP_GT_F64,
+               [TYPE_STRING] = OP_GT_STR},
+    [IR_GE] = {[TYPE_INT] = OP_GE_I64, [TYPE_FLOAT] = OP_GE_F64,
+               [TYPE_STRING] = OP_GE_STR},
+    [IR_PRINT] = {[TYPE_INT] = OP_PRINT_I64, [TYPE_FLOAT] = OP_PRINT_F64,
+                  [TYPE_STRING] = OP_PRINT_STR},
+};
+
+static const unsigned char generic_ops[IR_OP_COUNT] = {
+    [IR_COPY] = OP_MOVE_ANY, [IR_I2F] = OP_I2F_ANY, [IR_F2I] = OP_F2I_ANY,
+    [IR_NEG] = OP_NEG_ANY, [IR_ADD] = OP_ADD_ANY, [IR_SUB] = OP_SUB_ANY,
+    [IR_MUL] = OP_MUL_ANY, [IR_DIV] = OP_DIV_ANY, [IR_REM] = OP_REM_ANY,
+    [IR_EQ] = OP_EQ_ANY, [IR_NE] = OP_NE_ANY, [IR_LT] = OP_LT_ANY,
+    [IR_LE] = OP_LE_ANY, [IR_GT] = OP_GT_ANY, [IR_GE] = OP_GE_ANY,
+    [IR_PRINT] = OP_PRINT_ANY,
+};
+
+static enum opcode opcode_of(const struct compiler *c, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+
+    if (c->generic)
+        return (enum opcode) generic_ops[f->op[insn]];
+    return (enum opcode) typed_ops[f->op[insn]][f->type[f->a[insn]]];
+}
+
+/* ---- registers ---- */
+
+
+static int by_reg(const void *a, const void *b)
+{
+    const struct interval *x = a, *y = b;
+
+    if (x->reg != y->reg)
+        return (x->reg > y->reg) - (x->reg < y->reg);
+    return (x->live.lo > y->live.lo) - (x->live.lo < y->live.lo);
+}
+
+/* Linear scan (Poletto and Sarkar): the intervals by where they start,
+ * each taking a register one that has ended gave back, the last given
+ * back first, or a new one.  Sets reg[] of each interval's value and
+ * returns how many registers there are. */
+static uint32_t scan(struct interval *items, uint32_t n, uint32_t *reg)
+{
+    uint32_t *heap = xrealloc(NULL, n * sizeof *heap);
+    uint32_t *free_regs = xrealloc(NULL, n * sizeof *free_regs);
+    uint32_t heap_count = 0, free_count = 0, count = 0, i, k, child, x;
+
+    qsort(items, n, sizeof *items, live_by_lo);
+    for (i = 0; i < n; i++) {
+        /* give back the registers of what ended, by a heap on hi */
+        while (heap_count && items[heap[0]].live.hi <= items[i].live.lo) {
+            free_regs[free_count++] = items[heap[0]].reg;
+            x = heap[--heap_count];
+            for (k = 0; (child = 2 * k + 1) < heap_count; k = child) {
+                if (child + 1 < heap_count &&
+                    items[heap[child + 1]].live.hi <
+                    items[heap[child]].live.hi)
+                    child++;
+                if (items[heap[child]].live.hi >= items[x].live.hi)
+                    break;
+                heap[k] = heap[child];
+            }
+            heap[k] = x;
+        }
+        items[i].reg = free_count ? free_regs[--free_count] : count++;
+        reg[items[i].live.value] = items[i].reg;
+        for (k = heap_count++; k > 0 && items[heap[(k - 1) / 2]].live.hi >
+                                        items[i].live.hi; k = (k - 1) / 2)
+            heap[k] = heap[(k - 1) / 2];
+        heap[k] = i;
+    }
+    free(free_regs);
+    free(heap);
+    return count;
+}
+
+/* Registers for every value of the frame: variables first, that is the
+ * values live across an instruction that does not use them, one per
+ * group coalesced (see live.h); then the constants; then temporaries,
+ * the values used once, by an instruction of the same block, which is
+ * what fuse() takes for one. */
+static void assign(struct compiler *c, const struct live *l,
+                   const struct live_groups *g)
+{
+    const struct ir_func *f = c->f;
+    struct code *code = c->code;
+    struct interval *vars = xrealloc(NULL, f->count * sizeof *vars);
+    struct interval *temps = xrealloc(NULL, f->count * sizeof *temps);
+    unsigned char *is_temp = xcalloc(f->count, 1);
+    uint32_t var_count = 0, temp_count = 0, v, t, insn;
+    union value value;
+    uint64_t bits;
+
+    for (v = 0; v < f->count; v++) {
+        if (!f->block[v] || f->op[v] >= IR_PRINT || f->op[v] == IR_CONST ||
+            g->leader[v] != v)
+            continue;
+        is_temp[v] = !l->global[v] && l->uses[v] == 1 &&
+                     f->op[v] != IR_PHI;
+        if (is_temp[v]) {
+            temps[temp_count].live.lo = g->lo[v];
+            temps[temp_count].live.hi = g->hi[v];
+            temps[temp_count++].live.value = v;
+        } else {
+            vars[var_count].live.lo = g->lo[v];
+            vars[var_count].live.hi = g->hi[v];
+            vars[var_count++].live.value = v;
+        }
+    }
+    code->variables = scan(vars, var_count, c->reg);
+    t = scan(temps, temp_count, c->reg);
+    qsort(vars, var_count, sizeof *vars, by_reg);
+    c->held = vars;
+    c->held_count = var_count;
+
+    c->table_size = 0;
+    free(c->table);
+    c->table = NULL;
+    grow_table(c);
+    for (insn = f->blocks[IR_ENTRY].first; insn; insn = f->next[insn]) {
+        if (f->op[insn] != IR_CONST)
+            continue;
+        bits = ir_const_bits(f, insn);
+        if (f->type[insn] == TYPE_STRING) {
+            c->reg[insn] = string_constant(c, f->a[insn]);
+        } else {
+            memcpy(&value, &bits, sizeof value);
+            c->reg[insn] = constant(c, (enum type) f->type[insn], bits,
+                                    value);
+        }
+    }
+    for (v = 0; v < f->count; v++) {
+        if (!f->block[v] || f->op[v] >= IR_PRINT || f->op[v] == IR_CONST)
+            continue;
+        if (is_temp[g->leader[v]])
+            c->reg[v] = code->variables + code->constant_count +
+                        c->reg[g->leader[v]];
+        else
+            c->reg[v] = c->reg[g->leader[v]];
+    }
+    c->scratch = code->variables + code->constant_count + t;
+    code->registers = c->scratch;
+    free(is_temp);
+    free(temps);
+}
+
+/* Whether variable register r holds a value at position pos, as far as
+ * the groups' spans tell. */
+static int held(const struct compiler *c, uint32_t r, uint32_t pos)
+{
+    uint32_t lo = 0, hi = c->held_count, mid;
+
+    /* the first span of a later register or starting after pos */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (c->held[mid].reg < r ||
+            (c->held[mid].reg == r && c->held[mid].live.lo <= pos))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo && c->held[lo - 1].reg == r && c->held[lo - 1].live.hi > pos;
+}
+
+/* ---- code ---- */
+
+static uint32_t place(void *arg, uint32_t value)
+{
+    const struct compiler *c = arg;
+
+    return c->reg[value];
+}
+
+/* The copies the phis of `to` take on the edge from `from`; returns how
+ * many there are, in c->moves. */
+static uint32_t edge_moves(struct compiler *c, uint32_t from, uint32_t to)
+{
+    return moves_edge(&c->moves, c->f, from, to, place, c);
+}
+
+static void emit_move(void *arg, const struct move *m)
+{
+    struct compiler *c = arg;
+
+    if (m->dst == c->scratch)
+        c->scratch_used = 1;
+    emit(c, c->generic ? OP_MOVE_ANY : OP_MOVE, m->dst, m->src, 0,
+         c->move_offset);
+}
+
+/* The copies in c->moves, made one at a time as if all at once (see
+ * moves.h); a cycle of them is broken through the scratch register. */
+static void emit_moves(struct compiler *c, uint32_t offset)
+{
+    c->move_offset = offset;
+    moves_emit(&c->moves, c->scratch, emit_move, c);
+}
+
+/* The copies of the edge and the jump along it, which is not needed to
+ * the block laid out next. */
+static void edge(struct compiler *c, uint32_t from, uint32_t to,
+                 uint32_t offset)
+{
+    edge_moves(c, from, to);
+    emit_moves(c, offset);
+    if (c->f->blocks[from].next != to)
+        jump_to(c, OP_JMP, 0, to, offset);
+}
+
+/* Whether the copies in c->moves, onto one edge out of `block`, may be
+ * made before its branch `insn`, and before the instruction `last` just
+ * before that (the compare, mostly, which the VM fuses with the branch)
+ * unless that is IR_NONE: nothing those read or write is overwritten,
+ * and neither is what is live into `other`, the block the branch may go
+ * to instead. */
+static int hoistable(const struct compiler *c, uint32_t insn, uint32_t last,
+                     uint32_t other)
+{
+    const struct ir_func *f = c->f;
+    uint32_t i, dst, cond = c->reg[f->a[insn]];
+
+    for (i = 0; i < c->moves.count; i++) {
+        dst = c->moves.list[i].dst;
+        if (dst == cond || held(c, dst, c->live->from[other]) ||
+            (last && (c->moves.list[i].src == cond ||
+                      dst == c->reg[f->a[last]] ||
+                      dst == c->reg[f->b[last]])))
+            return 0;
+    }
+    return 1;
+}
+
+static void branch(struct compiler *c, uint32_t block, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+    const struct ir_block *b = &f->blocks[block];
+    uint32_t cond = c->reg[f->a[insn]], offset = f->offset[insn];
+    uint32_t next = b->next, yes = b->succ[0], no = b->succ[1];
+    int yes_moves = edge_moves(c, block, yes) != 0;
+    int no_moves = edge_moves(c, block, no) != 0;
+    enum opcode jmpif, jmpifnot;
+
+    if (c->generic) {
+        jmpif = OP_JMPIF_ANY;
+        jmpifnot = OP_JMPIFNOT_ANY;
+    } else if (f->type[f->a[insn]] == TYPE_FLOAT) {
+        jmpif = OP_JMPIF_F64;
+        jmpifnot = OP_JMPIFNOT_F64;
+    } else {
+        jmpif = OP_JMPIF_I64;
+        jmpifnot = OP_JMPIFNOT_I64;
+    }
+    c->moves.count = 0;
+    /* the copies of a loop's edge back, made before the test, leave the
+     * way out to fall through without a jump back after them */
+    if (yes_moves != no_moves && (yes_moves ? yes : no) != next &&
+        (yes_moves ? no : yes) == next) {
+        uint32_t last = f->prev[insn] == f->a[insn] &&
+                        f->op[f->a[insn]] >= IR_EQ &&
+                        f->op[f->a[insn]] <= IR_GE ? f->a[insn] : IR_NONE;
+        struct insn saved;
+
+        edge_moves(c, block, yes_moves ? yes : no);
+        if (hoistable(c, insn, last, next)) {
+            if (last)
+                saved = c->code->insns[--c->code->count];
+            emit_moves(c, offset);
+            if (last)
+                emit(c, (enum opcode) saved.op, saved.a, saved.b, saved.c,
+                     f->offset[last]);
+            if (yes_moves)
+                jump_to(c, jmpif, cond, yes, offset);
+            else
+                jump_to(c, jmpifnot, cond, no, offset);
+            return;
+        }
+        c->moves.count = 0;
+    }
+    /* one edge falls through, or goes on after its copies; the other is
+     * taken by the conditional jump, which goes through a trampoline if
+     * both have copies */
+    if (!no_moves && (no != next || yes_moves)) {
+        jump_to(c, jmpifnot, cond, no, offset);
+        edge(c, block, yes, offset);
+    } else if (!yes_moves) {
+        jump_to(c, jmpif, cond, yes, offset);
+        edge(c, block, no, offset);
+    } else {
+        if (c->trampoline_count == c->trampoline_capacity) {
+            c->trampoline_capacity = c->trampoline_capacity
+                                     ? c->trampoline_capacity * 2 : 16;
+            c->trampolines = xrealloc(c->trampolines,
+                                      c->trampoline_capacity *
+                                      sizeof *c->trampolines);
+        }
+        c->trampolines[c->trampoline_count].at =
+            emit(c, jmpif, cond, 0, 0, offset);
+        c->trampolines[c->trampoline_count].from = block;
+        c->trampolines[c->trampoline_count++].to = yes;
+        edge(c, block, no, offset);
+    }
+}
+
+static void block_code(struct compiler *c, uint32_t block)
+{
+    const struct ir_func *f = c->f;
+    uint32_t insn, *reg = c->reg;
+
+    c->start[block] = c->code->count;
+    for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+        switch (f->op[insn]) {
+        case IR_CONST:
+        case IR_PHI:
+            break;
+        case IR_COPY:
+            if (reg[insn] != reg[f->a[insn]])
+                emit(c, opcode_of(c, insn), reg[insn], reg[f->a[insn]], 0,
+                     f->offset[insn]);
+            break;
+        case IR_I2F:
+        case IR_F2I:
+        case IR_NEG:
+            emit(c, opcode_of(c, insn), reg[insn], reg[f->a[insn]], 0,
+                 f->offset[insn]);
+            break;
+        case IR_PRINT:
+            emit(c, opcode_of(c, insn), reg[f->a[insn]], 0, 0,
+                 f->offset[insn]);
+            break;
+        case IR_JMP:
+            edge(c, block, f->blocks[block].succ[0], f->offset[insn]);
+            break;
+        case IR_BR:
+            branch(c, block, insn);
+            break;
+        case IR_RET:
+            emit(c, OP_RETURN, 0, 0, 0, f->offset[insn]);
+            break;
+        default:
+            emit(c, opcode_of(c, insn), reg[insn], reg[f->a[insn]],
+                 reg[f->b[insn]], f->offset[insn]);
+            break;
+        }
+    }
+}
+
+/* Lower one frame of the IR into `code`. */
+static int frame(struct compiler *c, const struct ir_func *f,
+                 struct code *code)
+{
+    struct live l;
+    struct live_groups g;
+    uint32_t block, i;
+
+    memset(code, 0, sizeof *code);
+    c->f = f;
+    c->code = code;
+    c->reg = xrealloc(NULL, f->count * sizeof *c->reg);
+    c->start = xrealloc(NULL, f->block_count * sizeof *c->start);
+    c->fixup_count = 0;
+    c->trampoline_count = 0;
+    c->scratch_used = 0;
+
+    live_build(f, &l);
+    live_coalesce(f, &l, &g);
+    assign(c, &l, &g);
+    live_groups_free(&g);
+    c->live = &l;
+
+    for (block = IR_ENTRY; block; block = f->blocks[block].next)
+        block_code(c, block);
+    live_free(&l);
+    free(c->held);
+    for (i = 0; i < c->trampoline_count; i++) {
+        struct trampoline *t = &c->trampolines[i];
+
+        set_target(c, t->at, code->count);
+        edge_moves(c, t->from, t->to);
+        emit_moves(c, code->offsets[t->at]);
+        jump_to(c, OP_JMP, 0, t->to, code->offsets[t->at]);
+    }
+    for (i = 0; i < c->fixup_count; i++)
+        set_target(c, c->fixups[i].at, c->start[c->fixups[i].block]);
+    if (c->scratch_used)
+        code->registers++;
+    free(c->start);
+    free(c->reg);
+    if (code->registers > CODE_MAX_REGISTERS) {
+        diag_error(f->end_offset, "too many variables and values in one"
+                   " function (%lu registers, at most %lu)",
+                   (unsigned long) code->registers,
+                   (unsigned long) CODE_MAX_REGISTERS);
+        return 1;
+    }
+    return 0;
+}
+
+int compile(const struct ir_program *ir, int generic, struct program *prog)
+{
+    struct compiler c;
+    int status;
+
+    memset(&c, 0, sizeof c);
+    c.prog = prog;
+    c.generic = generic;
+    prog->generic = generic;
+    arena_init(&prog->strings);
+
+    status = frame(&c, &ir->funcs[0], &prog->top);
+    prog->has_main = ir->main != 0;
+    if (prog->has_main)
+        status |= frame(&c, &ir->funcs[ir->main], &prog->main);
+    else
+        memset(&prog->main, 0, sizeof prog->main);
+    free(c.keys);
+    free(c.table);
+    free(c.fixups);
+    moves_free(&c.moves);
+    free(c.trampolines);
+    return status;
+}
+
+static void code_free(struct code *code)
+{
+    free(code->insns);
+    free(code->offsets);
+    free(code->constants);
+    free(code->constant_types);
+    memset(code, 0, sizeof *code);
+}
+
+void program_free(struct program *prog)
+{
+    code_free(&prog->top);
+    code_free(&prog->main);
+    arena_free(&prog->strings);
+}
+
+static void print_constant(FILE *out, enum type type, union value value)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+
+    switch (type) {
+    case TYPE_INT:
+        fprintf(out, "int %lld", (long long) value.i);
+        break;
+    case TYPE_FLOAT:
+        number_format(buf, value.f);
+        fprintf(out, "float %s", buf);
+        break;
+    default:
+        fprintf(out, "string \"%.*s\"", (int) value.s->len, value.s->text);
+        break;
+    }
+}
+
+static void print_code(FILE *out, const char *name, const struct code *code)
+{
+    uint32_t i;
+
+    fprintf(out, "%s: %lu registers, %lu variables, %lu constants\n", name,
+            (unsigned long) code->registers, (unsigned long) code->variables,
+            (unsigned long) code->constant_count);
+    for (i = 0; i < code->constant_count; i++) {
+        fprintf(out, "        r%lu = ", (unsigned long) (code->variables + i));
+        print_constant(out, (enum type) code->constant_types[i],
+                       code->constants[i]);
+        fputc('\n', out);
+    }
+    for (i = 0; i < code->count; i++) {
+        const struct insn *insn = &code->insns[i];
+
+        fprintf(out, "  %4lu  %-13s", (unsigned long) i,
+                opcode_names[insn->op]);
+        switch (opcode_formats[insn->op]) {
+        case FORMAT_AB:
+            fprintf(out, "r%u, r%u", insn->a, insn->b);
+            break;
+        case FORMAT_ABC:
+            fprintf(out, "r%u, r%u, r%u", insn->a, insn->b, insn->c);
+            break;
+        case FORMAT_A:
+            fprintf(out, "r%u", insn->a);
+            break;
+        case FORMAT_J:
+            fprintf(out, "%lu", (unsigned long) insn_target(insn));
+            break;
+        case FORMAT_AJ:
+            fprintf(out, "r%u, %lu", insn->a,
+                    (unsigned long) insn_target(insn));
+            break;
+        case FORMAT_ABR:
+            fprintf(out, "r%u, r%u, %lu", insn->a, insn->b,
+                    (unsigned long) insn_branch(insn, i));
+            break;
+        default:
+            break;
+        }
+        fputc('\n', out);
+    }
+}
+
+void program_print(FILE *out, const struct program *prog)
+{
+    print_code(out, "top", &prog->top);
+    if (prog->has_main)
+        print_code(out, "main", &prog->main);
+}
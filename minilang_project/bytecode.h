@@ -0,0 +1,203 @@
+#ifndef MINILANG_BYTECODE_H
+#define MINILANG_BYTECODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "check.h"
+#include "ir.h"
+#include "runtime.h"
+
+/* Register bytecode for the VM (see vm.h).
+ *
+ * An instruction is an opcode and three 16-bit operands, a, b and c, most
+ * often registers: "add_i64 a, b, c" sets register a to b + c.  A jump
+ * keeps the index of the instruction it goes to in b and c together.
+ * Every operand is a register, constants too: a frame's registers are its
+ * variables, then its constants, which the VM copies in when the frame
+ * starts, then the temporaries that hold the parts of expressions.
+ *
+ * The code is compiled from the IR (ir.h), after the optimizer.  Each
+ * value gets a register by linear scan over where it is live (live.h):
+ * a variable is a value live across an instruction that does not use it,
+ * and a phi shares one with its operands where they are never live at
+ * once, so that the loop around them copies nothing; a temporary is a
+ * value used once, in the block it is made in.  Edges into a phi whose
+ * operand is in another register copy it there; on a branch, the edge
+ * with the copies is the one that falls through, and if both have some,
+ * one goes through a trampoline after the rest of the code.
+ *
+ * Every value has a static type, so the compiler picks the opcode for it:
+ * add_i64, add_f64 or concat_str for `+`, and the IR has an explicit i2f
+ * before an int meets a float.  A register is then only
+ * ever read as the type it was written as, and the VM keeps no types.
+ * The _any opcodes are the other way to do it, for comparison
+ * (--run=generic): registers carry their type with them and one opcode
+ * serves every type, testing them as it runs.  A frame uses one set or
+ * the other, never both.  The compiler never emits the superinstructions
+ * after return; fuse() makes them from the code it did emit.
+ *
+ *   FORMAT_AB     a, b
+ *   FORMAT_ABC    a, b, c
+ *   FORMAT_A      a
+ *   FORMAT_J      target
+ *   FORMAT_AJ     a, target
+ *   FORMAT_ABR    a, b, target as a distance from here in c, signed
+ *   FORMAT_NONE   nothing */
+enum format {
+    FORMAT_AB,
+    FORMAT_ABC,
+    FORMAT_A,
+    FORMAT_J,
+    FORMAT_AJ,
+    FORMAT_ABR,
+    FORMAT_NONE
+};
+
+#define OPCODES(X) \
+    X(MOVE,         "move",         FORMAT_AB)    /* a = b */             \
+    X(I2F,          "i2f",          FORMAT_AB)    /* a = float of b */    \
+    X(F2I,          "f2i",          FORMAT_AB)    /* a = int of b */      \
+    X(NEG_I64,      "neg_i64",      FORMAT_AB)    /* a = -b */            \
+    X(NEG_F64,      "neg_f64",      FORMAT_AB)                            \
+    X(ADD_I64,      "add_i64",      FORMAT_ABC)   /* a = b + c */         \
+    X(SUB_I64,      "sub_i64",      FORMAT_ABC)                           \
+    X(MUL_I64,      "mul_i64",      FORMAT_ABC)                           \
+    X(DIV_I64,      "div_i64",      FORMAT_ABC)                           \
+    X(ADD_F64,      "add_f64",      FORMAT_ABC)                           \
+    X(SUB_F64,      "sub_f64",      FORMAT_ABC)                           \
+    X(MUL_F64,      "mul_f64",      FORMAT_ABC)                           \
+    X(DIV_F64,      "div_f64",      FORMAT_ABC)                           \
+    X(CONCAT_STR,   "concat_str",   FORMAT_ABC)   /* a = b c joined */    \
+    X(EQ_I64,       "eq_i64",       FORMAT_ABC)   /* a = b == c: 0, 1 */ \
+    X(NE_I64,       "ne_i64",       FORMAT_ABC)                           \
+    X(LT_I64,       "lt_i64",       FORMAT_ABC)                           \
+    X(LE_I64,       "le_i64",       FORMAT_ABC)                           \
+    X(GT_I64,       "gt_i64",       FORMAT_ABC)                           \
+    X(GE_I64,       "ge_i64",       FORMAT_ABC)                           \
+    X(EQ_F64,       "eq_f64",       FORMAT_ABC)                           \
+    X(NE_F64,       "ne_f64",       FORMAT_ABC)                           \
+    X(LT_F64,       "lt_f64",       FORMAT_ABC)                           \
+    X(LE_F64,       "le_f64",       FORMAT_ABC)                           \
+    X(GT_F64,       "gt_f64",       FORMAT_ABC)                           \
+    X(GE_F64,       "ge_f64",       FORMAT_ABC)                           \
+    X(EQ_STR,       "eq_str",       FORMAT_ABC)                           \
+    X(NE_STR,       "ne_str",       FORMAT_ABC)                           \
+    X(LT_STR,       "lt_str",       FORMAT_ABC)                           \
+    X(LE_STR,       "le_str",       FORMAT_ABC)                           \
+    X(GT_STR,       "gt_str",       FORMAT_ABC)                           \
+    X(GE_STR,       "ge_str",       FORMAT_ABC)                           \
+    X(JMP,          "jmp",          FORMAT_J)                             \
+    X(JMPIF_I64,    "jmpif_i64",    FORMAT_AJ)    /* jump if a != 0 */    \
+    X(JMPIFNOT_I64, "jmpifnot_i64", FORMAT_AJ)    /* jump if a == 0 */    \
+    X(JMPIF_F64,    "jmpif_f64",    FORMAT_AJ)                            \
+    X(JMPIFNOT_F64, "jmpifnot_f64", FORMAT_AJ)                            \
+    X(PRINT_I64,    "print_i64",    FORMAT_A)                             \
+    X(PRINT_F64,    "print_f64",    FORMAT_A)                             \
+    X(PRINT_STR,    "print_str",    FORMAT_A)                             \
+    X(RETURN,       "return",       FORMAT_NONE)  /* end of the frame */  \
+    X(JEQ_I64,      "jeq_i64",      FORMAT_ABR)   /* jump if a == b */    \
+    X(JNE_I64,      "jne_i64",      FORMAT_ABR)                           \
+    X(JLT_I64,      "jlt_i64",      FORMAT_ABR)                           \
+    X(JLE_I64,      "jle_i64",      FORMAT_ABR)                           \
+    X(JGT_I64,      "jgt_i64",      FORMAT_ABR)                           \
+    X(JGE_I64,      "jge_i64",      FORMAT_ABR)                           \
+    X(JEQ_F64,      "jeq_f64",      FORMAT_ABR)                           \
+    X(JNE_F64,      "jne_f64",      FORMAT_ABR)                           \
+    X(JLT_F64,      "jlt_f64",      FORMAT_ABR)                           \
+    X(JLE_F64,      "jle_f64",      FORMAT_ABR)                           \
+    X(JGT_F64,      "jgt_f64",      FORMAT_ABR)                           \
+    X(JGE_F64,      "jge_f64",      FORMAT_ABR)                           \
+    X(JNLT_F64,     "jnlt_f64",     FORMAT_ABR)   /* jump if !(a < b) */  \
+    X(JNLE_F64,     "jnle_f64",     FORMAT_ABR)                           \
+    X(JNGT_F64,     "jngt_f64",     FORMAT_ABR)                           \
+    X(JNGE_F64,     "jnge_f64",     FORMAT_ABR)                           \
+    X(INC_JLT_I64,  "inc_jlt_i64",  FORMAT_ABR)   /* ++a < b: jump */ \
+    X(REM_I64,      "rem_i64",      FORMAT_ABC)   /* a = b - b / c * c */ \
+    X(MOVE_ANY,     "move_any",     FORMAT_AB)                            \
+    X(I2F_ANY,      "i2f_any",      FORMAT_AB)                            \
+    X(F2I_ANY,      "f2i_any",      FORMAT_AB)                            \
+    X(NEG_ANY,      "neg_any",      FORMAT_AB)                            \
+    X(ADD_ANY,      "add_any",      FORMAT_ABC)   /* or joins strings */ \
+    X(SUB_ANY,      "sub_any",      FORMAT_ABC)                           \
+    X(MUL_ANY,      "mul_any",      FORMAT_ABC)                           \
+    X(DIV_ANY,      "div_any",      FORMAT_ABC)                           \
+    X(REM_ANY,      "rem_any",      FORMAT_ABC)   /* of ints only */      \
+    X(EQ_ANY,       "eq_any",       FORMAT_ABC)                           \
+    X(NE_ANY,       "ne_any",       FORMAT_ABC)                           \
+    X(LT_ANY,       "lt_any",       FORMAT_ABC)                           \
+    X(LE_ANY,       "le_any",       FORMAT_ABC)                           \
+    X(GT_ANY,       "gt_any",       FORMAT_ABC)                           \
+    X(GE_ANY,       "ge_any",       FORMAT_ABC)                           \
+    X(JMPIF_ANY,    "jmpif_any",    FORMAT_AJ)                            \
+    X(JMPIFNOT_ANY, "jmpifnot_any", FORMAT_AJ)                            \
+    X(PRINT_ANY,    "print_any",    FORMAT_A)
+
+enum opcode {
+#define OPCODE_ENUM(name, text, format) OP_##name,
+    OPCODES(OPCODE_ENUM)
+#undef OPCODE_ENUM
+    OP_COUNT
+};
+
+struct insn {
+    uint16_t op;
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+};
+
+/* Registers a frame may have, so that each fits an operand. */
+#define CODE_MAX_REGISTERS  65536
+
+static inline uint32_t insn_target(const struct insn *insn)
+{
+    return insn->b | (uint32_t) insn->c << 16;
+}
+
+/* Where an instruction of FORMAT_ABR at index `at` jumps to. */
+static inline uint32_t insn_branch(const struct insn *insn, uint32_t at)
+{
+    return at + (uint32_t) (int32_t) (int16_t) insn->c;
+}
+
+/* The bytecode of one frame: the statements outside functions, or a
+ * function.  offsets[] has the source offset of each instruction, for
+ * runtime errors. */
+struct code {
+    struct insn *insns;
+    uint32_t *offsets;
+    uint32_t count;
+    uint32_t capacity;
+    union value *constants;
+    uint8_t *constant_types;        /* enum type */
+    uint32_t constant_count;
+    uint32_t constant_capacity;
+    uint32_t variables;             /* registers before the constants */
+    uint32_t registers;             /* all of them */
+};
+
+/* What --run runs: the statements outside functions, then main if there
+ * is one.  No other function can run, since nothing calls them. */
+struct program {
+    struct code top;
+    struct code main;
+    int has_main;
+    struct arena strings;           /* the literals */
+    int generic;                    /* the _any opcodes */
+};
+
+extern const char *const opcode_names[OP_COUNT];
+extern const unsigned char opcode_formats[OP_COUNT];
+
+/* Compile the IR of a program, to the _any opcodes if `generic`.
+ * Returns 0, or 1 after reporting an error through diag_error() if a
+ * frame needs more than CODE_MAX_REGISTERS. */
+int compile(const struct ir_program *ir, int generic, struct program *prog);
+void program_free(struct program *prog);
+
+/* Listing of every frame: its registers, constants and instructions. */
+void program_print(FILE *out, const struct program *prog);
+
+#endif
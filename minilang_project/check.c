@@ -0,0 +1,534 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "type checker"
+#include "alloc.h"
+
+#include "check.h"
+#include "diag.h"
+#include "intern.h"
+
+const char *const type_names[TYPE_COUNT] = {
+    [TYPE_NONE]   = "none",
+    [TYPE_INT]    = "int",
+    [TYPE_FLOAT]  = "float",
+    [TYPE_STRING] = "string",
+    [TYPE_ERROR]  = "error",
+};
+
+/* A declared variable.  `hides` is the binding of the same name it hides
+ * until its scope ends, 0 for none. */
+struct binding {
+    uint32_t symbol;
+    uint32_t hides;
+    uint32_t slot;
+    uint32_t type;
+};
+
+/* Where the enclosing scope started and which slot it would use next. */
+struct scope {
+    uint32_t start;
+    uint32_t next_slot;
+};
+
+struct checker {
+    const struct ast *ast;
+    const struct token *tokens;
+    const struct number *numbers;
+    struct sema *sema;
+    uint32_t *innermost;        /* per symbol: its binding, 0 for none */
+    uint32_t *reported;         /* per symbol: frame it was last reported
+                                 * undeclared in */
+    uint32_t *defined;          /* per symbol: the function of that name */
+    uint32_t main_symbol;
+    struct binding *bindings;   /* a stack; number 0 is unused */
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t scope;             /* first binding of the innermost scope */
+    uint32_t frame_base;        /* first binding of the current frame */
+    uint32_t frame;             /* frames checked so far, this one too */
+    uint32_t next_slot;
+    uint32_t frame_size;
+    enum type result;           /* what a return in this frame returns */
+};
+
+static void statement(struct checker *c, uint32_t node);
+static enum type expression(struct checker *c, uint32_t node);
+
+static const struct token *token_of(const struct checker *c, uint32_t node)
+{
+    return &c->tokens[c->ast->token[node]];
+}
+
+static uint32_t symbol_of(const struct checker *c, uint32_t node)
+{
+    return token_of(c, node)->value;
+}
+
+static const char *name_of(const struct checker *c, uint32_t node, int *len)
+{
+    size_t n;
+    const char *text = symbol_name(symbol_of(c, node), &n);
+
+    *len = (int) n;
+    return text;
+}
+
+static int numeric(enum type t)
+{
+    return t == TYPE_INT || t == TYPE_FLOAT;
+}
+
+/* Whether a value of type `from` may be stored where `to` is expected,
+ * converting between int and float as needed. */
+static int assignable(enum type to, enum type from)
+{
+    return to == from || to == TYPE_ERROR || from == TYPE_ERROR ||
+           (numeric(to) && numeric(from));
+}
+
+/* Type named by a declaration's keyword. */
+static enum type declared_type(const struct checker *c, uint32_t node)
+{
+    switch (token_of(c, node)->kind) {
+    case TOKEN_INT:
+        return TYPE_INT;
+    case TOKEN_FLOAT:
+        return TYPE_FLOAT;
+    default:
+        return TYPE_STRING;
+    }
+}
+
+static struct scope open_scope(struct checker *c)
+{
+    struct scope outer = { c->scope, c->next_slot };
+
+    c->scope = c->count;
+    return outer;
+}
+
+static void close_scope(struct checker *c, struct scope outer)
+{
+    while (c->count > c->scope) {
+        const struct binding *b = &c->bindings[--c->count];
+
+        c->innermost[b->symbol] = b->hides;
+    }
+    c->scope = outer.start;
+    c->next_slot = outer.next_slot;
+}
+
+/* Bind the name `name` of declaration `decl` in the innermost scope. */
+static void declare(struct checker *c, uint32_t name, enum type type,
+                    uint32_t decl)
+{
+    uint32_t symbol, hides;
+    struct binding *b;
+    int len;
+    const char *text;
+
+    if (c->ast->kind[name] != AST_NAME)
+        return;
+    symbol = symbol_of(c, name);
+    hides = c->innermost[symbol];
+    if (hides >= c->scope) {
+        text = name_of(c, name, &len);
+        diag_error(token_of(c, name)->offset,
+                   "'%.*s' is already declared in this scope", len, text);
+    }
+    if (c->count == c->capacity) {
+        c->capacity *= 2;
+        c->bindings = xrealloc(c->bindings,
+                               c->capacity * sizeof *c->bindings);
+    }
+    b = &c->bindings[c->count];
+    b->symbol = symbol;
+    b->hides = hides;
+    b->slot = c->next_slot++;
+    b->type = type;
+    c->innermost[symbol] = c->count++;
+    if (c->next_slot > c->frame_size)
+        c->frame_size = c->next_slot;
+    c->sema->slot[name] = b->slot;
+    c->sema->slot[decl] = b->slot;
+    c->sema->type[name] = (uint8_t) type;
+    c->sema->variables++;
+}
+
+/* Type of the variable `node` names, resolving it to its slot.  A name
+ * that is not declared is reported once per frame. */
+static enum type variable(struct checker *c, uint32_t node, int assigned)
+{
+    uint32_t symbol = symbol_of(c, node);
+    uint32_t b = c->innermost[symbol];
+    const char *text;
+    int len;
+
+    if (b >= c->frame_base) {
+        c->sema->slot[node] = c->bindings[b].slot;
+        return (enum type) c->bindings[b].type;
+    }
+    if (c->reported[symbol] != c->frame) {
+        c->reported[symbol] = c->frame;
+        text = name_of(c, node, &len);
+        if (assigned)
+            diag_error(token_of(c, node)->offset,
+                       "undeclared variable '%.*s'; declare it with its"
+                       " type, as in 'int %.*s'", len, text, len, text);
+        else
+            diag_error(token_of(c, node)->offset,
+                       "undeclared variable '%.*s'", len, text);
+    }
+    return TYPE_ERROR;
+}
+
+static enum type binary(struct checker *c, uint32_t node)
+{
+    uint32_t left_node = c->ast->child[node];
+    enum type left = expression(c, left_node);
+    enum type right = expression(c, c->ast->next[left_node]);
+    enum token_kind op = (enum token_kind) token_of(c, node)->kind;
+
+    if (left == TYPE_ERROR || right == TYPE_ERROR)
+        return TYPE_ERROR;
+    switch (op) {
+    case TOKEN_PLUS:
+        if (left == TYPE_STRING && right == TYPE_STRING)
+            return TYPE_STRING;
+        /* fall through */
+    case TOKEN_MINUS:
+    case TOKEN_MUL:
+    case TOKEN_DIV:
+        if (numeric(left) && numeric(right))
+            return left == TYPE_FLOAT || right == TYPE_FLOAT ? TYPE_FLOAT
+                                                             : TYPE_INT;
+        break;
+    default:
+        if ((numeric(left) && numeric(right)) ||
+            (left == TYPE_STRING && right == TYPE_STRING))
+            return TYPE_INT;
+        break;
+    }
+    diag_error(token_of(c, node)->offset, "'%s' cannot take %s and %s",
+               token_text[op], type_names[left], type_names[right]);
+    return TYPE_ERROR;
+}
+
+static enum type expression(struct checker *c, uint32_t node)
+{
+    const struct ast *ast = c->ast;
+    enum type t;
+
+    switch (ast->kind[node]) {
+    case AST_NAME:
+        t = variable(c, node, 0);
+        break;
+    case AST_NUMBER:
+        t = c->numbers[token_of(c, node)->value].type == NUMBER_FLOAT
+            ? TYPE_FLOAT : TYPE_INT;
+        break;
+    case AST_STRING:
+        t = TYPE_STRING;
+        break;
+    case AST_NEG:
+        t = expression(c, ast->child[node]);
+        if (t == TYPE_STRING) {
+            diag_error(token_of(c, node)->offset, "cannot negate a string");
+            t = TYPE_ERROR;
+        }
+        break;
+    case AST_BINARY:
+        t = binary(c, node);
+        break;
+    default:
+        /* AST_EMPTY, where an expression failed to parse */
+        t = TYPE_ERROR;
+        break;
+    }
+    c->sema->type[node] = (uint8_t) t;
+    return t;
+}
+
+static void condition(struct checker *c, uint32_t node)
+{
+    if (expression(c, node) == TYPE_STRING)
+        diag_error(token_of(c, node)->offset,
+                   "condition is a string, not a number");
+}
+
+/* A statement in a scope of its own: the body of if, while or for. */
+static void scoped(struct checker *c, uint32_t node)
+{
+    struct scope outer = open_scope(c);
+
+    statement(c, node);
+    close_scope(c, outer);
+}
+
+static void declaration(struct checker *c, uint32_t node)
+{
+    const struct ast *ast = c->ast;
+    uint32_t name = ast->child[node];
+    uint32_t init = ast->next[name];
+    enum type type = declared_type(c, node);
+    enum type t;
+    const char *text;
+    int len;
+
+    /* the initial value cannot see the name it initialises */
+    if (init) {
+        t = expression(c, init);
+        if (!assignable(type, t) && ast->kind[name] == AST_NAME) {
+            text = name_of(c, name, &len);
+            diag_error(token_of(c, init)->offset,
+                       "cannot initialise %s '%.*s' with %s",
+                       type_names[type], len, text, type_names[t]);
+        }
+    }
+    declare(c, name, type, node);
+}
+
+static void assignment(struct checker *c, uint32_t node)
+{
+    const struct ast *ast = c->ast;
+    uint32_t target = ast->child[node];
+    enum type type, value;
+    const char *text;
+    int len;
+
+    if (ast->kind[target] != AST_NAME) {
+        /* the parser has reported it */
+        expression(c, target);
+        expression(c, ast->next[target]);
+        return;
+    }
+    /* the target first, so that "i = i + 1" with no i says how to
+     * declare it */
+    type = variable(c, target, 1);
+    c->sema->type[target] = (uint8_t) type;
+    value = expression(c, ast->next[target]);
+    if (!assignable(type, value)) {
+        text = name_of(c, target, &len);
+        diag_error(token_of(c, node)->offset,
+                   "cannot assign %s to %s '%.*s'", type_names[value],
+                   type_names[type], len, text);
+    }
+}
+
+static void statement(struct checker *c, uint32_t node)
+{
+    const struct ast *ast = c->ast;
+    uint32_t child = ast->child[node];
+    struct scope outer;
+    enum type t;
+
+    switch (ast->kind[node]) {
+    case AST_BLOCK:
+        outer = open_scope(c);
+        for (; child && !diag_stopped(); child = ast->next[child])
+            statement(c, child);
+        close_scope(c, outer);
+        break;
+    case AST_DECL:
+        declaration(c, node);
+        break;
+    case AST_ASSIGN:
+        assignment(c, node);
+        break;
+    case AST_IF:
+        condition(c, child);
+        scoped(c, ast->next[child]);
+        if (ast->next[ast->next[child]])
+            scoped(c, ast->next[ast->next[child]]);
+        break;
+    case AST_WHILE:
+        condition(c, child);
+        scoped(c, ast->next[child]);
+        break;
+    case AST_FOR: {
+        uint32_t cond = ast->next[child];
+        uint32_t step = ast->next[cond];
+
+        outer = open_scope(c);
+        statement(c, child);
+        if (ast->kind[cond] != AST_EMPTY)
+            condition(c, cond);
+        statement(c, step);
+        scoped(c, ast->next[step]);
+        close_scope(c, outer);
+        break;
+    }
+    case AST_PRINT:
+        expression(c, child);
+        break;
+    case AST_RETURN:
+        if (!child)
+            break;
+        t = expression(c, child);
+        if (!assignable(c->result, t))
+            diag_error(token_of(c, node)->offset,
+                       "returning %s from a function that returns %s",
+                       type_names[t], type_names[c->result]);
+        break;
+    case AST_EXPR:
+        expression(c, child);
+        break;
+    default:
+        break;
+    }
+}
+
+/* A new frame, for a function or the statements outside functions;
+ * returns what to restore once it is checked. */
+struct frame {
+    struct scope scope;
+    uint32_t frame_base;
+    uint32_t frame_size;
+    enum type result;
+};
+
+static struct frame enter_frame(struct checker *c, enum type result)
+{
+    struct frame outer;
+
+    outer.scope = open_scope(c);
+    outer.frame_base = c->frame_base;
+    outer.frame_size = c->frame_size;
+    outer.result = c->result;
+    c->frame++;
+    c->frame_base = c->count;
+    c->next_slot = 0;
+    c->frame_size = 0;
+    c->result = result;
+    return outer;
+}
+
+/* Leave a frame; returns the slots it needed. */
+static uint32_t leave_frame(struct checker *c, struct frame outer)
+{
+    uint32_t size = c->frame_size;
+
+    close_scope(c, outer.scope);
+    c->frame_base = outer.frame_base;
+    c->frame_size = outer.frame_size;
+    c->result = outer.result;
+    return size;
+}
+
+static void function(struct checker *c, uint32_t node)
+{
+    const struct ast *ast = c->ast;
+    uint32_t name = ast->child[node];
+    struct frame outer;
+    const char *text;
+    int len;
+
+    c->sema->functions++;
+    if (ast->kind[name] == AST_NAME) {
+        uint32_t symbol = symbol_of(c, name);
+
+        if (c->defined[symbol]) {
+            text = name_of(c, name, &len);
+            diag_error(token_of(c, name)->offset,
+                       "function '%.*s' is already defined", len, text);
+        } else {
+            c->defined[symbol] = node;
+            if (symbol == c->main_symbol)
+                c->sema->main = node;
+        }
+    }
+    outer = enter_frame(c, declared_type(c, node));
+    statement(c, ast->next[name]);
+    c->sema->slot[node] = leave_frame(c, outer);
+}
+
+void check(const struct ast *ast, struct sema *sema)
+{
+    struct checker c;
+    struct frame outer;
+    uint32_t main_symbol = intern("main", 4);
+    uint32_t symbols = symbol_count() + 1;
+    uint32_t node;
+
+    sema->type = xcalloc(ast->count, sizeof *sema->type);
+    sema->slot = xcalloc(ast->count, sizeof *sema->slot);
+    memset(sema->slot, 0xff, ast->count * sizeof *sema->slot);
+    sema->main = AST_NONE;
+    sema->functions = 0;
+    sema->variables = 0;
+    if (!ast->root)
+        return;
+
+    c.ast = ast;
+    c.tokens = ast->tokens->data;
+    c.numbers = ast->tokens->numbers;
+    c.sema = sema;
+    c.innermost = xcalloc(symbols, sizeof *c.innermost);
+    c.reported = xcalloc(symbols, sizeof *c.reported);
+    c.defined = xcalloc(symbols, sizeof *c.defined);
+    c.main_symbol = main_symbol;
+    c.capacity = 64;
+    c.bindings = xcalloc(c.capacity, sizeof *c.bindings);
+    c.count = 1;
+    c.scope = 1;
+    c.frame_base = 1;
+    c.frame = 0;
+    c.next_slot = 0;
+    c.frame_size = 0;
+    c.result = TYPE_NONE;
+
+    /* the statements outside functions make up one more frame, whose
+     * return is the program's */
+    outer = enter_frame(&c, TYPE_INT);
+    for (node = ast->child[ast->root]; node && !diag_stopped();
+         node = ast->next[node]) {
+        if (ast->kind[node] == AST_FUNCTION)
+            function(&c, node);
+        else
+            statement(&c, node);
+    }
+    sema->slot[ast->root] = leave_frame(&c, outer);
+
+    free(c.innermost);
+    free(c.reported);
+    free(c.defined);
+    free(c.bindings);
+}
+
+void sema_free(struct sema *sema)
+{
+    free(sema->type);
+    free(sema->slot);
+    sema->type = NULL;
+    sema->slot = NULL;
+}
+
+struct annotated {
+    const struct ast *ast;
+    const struct sema *sema;
+};
+
+static void note(FILE *out, uint32_t node, const void *arg)
+{
+    const struct annotated *a = arg;
+    uint32_t slot = a->sema->slot[node];
+    enum type type = (enum type) a->sema->type[node];
+
+    if (slot != SLOT_NONE) {
+        if (a->ast->kind[node] == AST_FUNCTION ||
+            a->ast->kind[node] == AST_PROGRAM)
+            fprintf(out, " frame=%lu", (unsigned long) slot);
+        else
+            fprintf(out, " slot=%lu", (unsigned long) slot);
+    }
+    if (type != TYPE_NONE)
+        fprintf(out, " : %s", type_names[type]);
+}
+
+void sema_print(FILE *out, const struct ast *ast, const struct sema *sema)
+{
+    struct annotated a = { ast, sema };
+
+    ast_print_notes(out, ast, note, &a);
+}
@@ -0,0 +1,71 @@
+#ifndef MINILANG_CHECK_H
+#define MINILANG_CHECK_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ast.h"
+
+/* Name resolution and type checking of a parsed source.
+ *
+ * Every expression has a static type, fixed by the declarations:
+ *
+ *   + - * /        int with int is int, float with int or float is float,
+ *                  string + string is string (concatenation)
+ *   == != < ...    two numbers or two strings; the result is int, 0 or 1
+ *   -x             int or float
+ *
+ * An int is converted to float, and a float to int (truncating), where a
+ * value is assigned, declared or returned; the consumer of the tree sees
+ * both types and makes the conversion.  Conditions are numbers, true when
+ * not zero.  print takes a value of any type.
+ *
+ * Each function, and the statements outside any function, has a frame of
+ * variable slots numbered from 0.  A declaration takes the next free slot
+ * until the end of its scope, after which the slot is reused, so a frame
+ * needs as many slots as the most variables ever in scope at once.  Blocks,
+ * for statements and the bodies of if, while and for are scopes; a name
+ * may be declared again in an inner scope, hiding the outer one, but not
+ * twice in the same scope.  A function sees only its own variables: there
+ * is no storage shared between frames.
+ *
+ * The symbol table is an array indexed by interned symbol id holding the
+ * innermost binding of each name, and a stack of bindings that records
+ * which one each hides, so looking a name up is one load and leaving a
+ * scope pops what it declared. */
+enum type {
+    TYPE_NONE,          /* statements, and names that are not variables */
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_STRING,
+    TYPE_ERROR,         /* after an error; checks against it all pass */
+    TYPE_COUNT
+};
+
+#define SLOT_NONE UINT32_MAX
+
+/* What the checker works out, in arrays indexed by node number like the
+ * tree's own.  type[] is each expression's type.  slot[] is the frame
+ * slot of the variable an AST_NAME refers to or an AST_DECL declares, and
+ * for AST_FUNCTION and AST_PROGRAM the number of slots their frame needs;
+ * SLOT_NONE elsewhere, and for names that are not declared. */
+struct sema {
+    uint8_t *type;
+    uint32_t *slot;
+    uint32_t main;          /* the function called main, or AST_NONE */
+    uint32_t functions;
+    uint32_t variables;     /* declarations */
+};
+
+extern const char *const type_names[TYPE_COUNT];
+
+/* Errors are reported through diag_error(), so call it between
+ * diag_begin() and diag_end().  The parts of a tree that failed to parse
+ * have TYPE_ERROR, so they cause no further errors. */
+void check(const struct ast *ast, struct sema *sema);
+void sema_free(struct sema *sema);
+
+/* The tree as ast_print() prints it, with types, slots and frame sizes. */
+void sema_print(FILE *out, const struct ast *ast, const struct sema *sema);
+
+#endif
@@ -0,0 +1,344 @@
+#include <string.h>
+
+#include "dfalex.h"
+#include "intern.h"
+#include "keyword.h"
+#include "simd.h"
+#include "utf8.h"
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+/* What a token starting with a given byte can be. */
+enum char_class {
+    CC_OTHER = 0,   /* only the {invalid}+ rule matches */
+    CC_HIGH,        /* 0x80-0xff: a Unicode identifier, or {invalid}+ */
+    CC_SPACE,       /* [ \t\n] */
+    CC_LETTER,      /* {letter}: identifiers and keywords */
+    CC_DIGIT,       /* {number} */
+    CC_QUOTE,       /* {string}, or a lone '"' */
+    CC_SLASH,       /* "/", "//" or a block comment */
+    CC_OP,          /* = ! < > and their "=" forms */
+    CC_PUNCT        /* single-byte operators and punctuation */
+};
+
+static const unsigned char char_class[256] = {
+    [' '] = CC_SPACE, ['\t'] = CC_SPACE, ['\n'] = CC_SPACE,
+    ['a'] = CC_LETTER, ['b'] = CC_LETTER, ['c'] = CC_LETTER,
+    ['d'] = CC_LETTER, ['e'] = CC_LETTER, ['f'] = CC_LETTER,
+    ['g'] = CC_LETTER, ['h'] = CC_LETTER, ['i'] = CC_LETTER,
+    ['j'] = CC_LETTER, ['k'] = CC_LETTER, ['l'] = CC_LETTER,
+    ['m'] = CC_LETTER, ['n'] = CC_LETTER, ['o'] = CC_LETTER,
+    ['p'] = CC_LETTER, ['q'] = CC_LETTER, ['r'] = CC_LETTER,
+    ['s'] = CC_LETTER, ['t'] = CC_LETTER, ['u'] = CC_LETTER,
+    ['v'] = CC_LETTER, ['w'] = CC_LETTER, ['x'] = CC_LETTER,
+    ['y'] = CC_LETTER, ['z'] = CC_LETTER,
+    ['A'] = CC_LETTER, ['B'] = CC_LETTER, ['C'] = CC_LETTER,
+    ['D'] = CC_LETTER, ['E'] = CC_LETTER, ['F'] = CC_LETTER,
+    ['G'] = CC_LETTER, ['H'] = CC_LETTER, ['I'] = CC_LETTER,
+    ['J'] = CC_LETTER, ['K'] = CC_LETTER, ['L'] = CC_LETTER,
+    ['M'] = CC_LETTER, ['N'] = CC_LETTER, ['O'] = CC_LETTER,
+    ['P'] = CC_LETTER, ['Q'] = CC_LETTER, ['R'] = CC_LETTER,
+    ['S'] = CC_LETTER, ['T'] = CC_LETTER, ['U'] = CC_LETTER,
+    ['V'] = CC_LETTER, ['W'] = CC_LETTER, ['X'] = CC_LETTER,
+    ['Y'] = CC_LETTER, ['Z'] = CC_LETTER, ['_'] = CC_LETTER,
+    ['0'] = CC_DIGIT, ['1'] = CC_DIGIT, ['2'] = CC_DIGIT,
+    ['3'] = CC_DIGIT, ['4'] = CC_DIGIT, ['5'] = CC_DIGIT,
+    ['6'] = CC_DIGIT, ['7'] = CC_DIGIT, ['8'] = CC_DIGIT,
+    ['9'] = CC_DIGIT,
+    ['"'] = CC_QUOTE,
+    ['/'] = CC_SLASH,
+    ['='] = CC_OP, ['!'] = CC_OP, ['<'] = CC_OP, ['>'] = CC_OP,
+    ['+'] = CC_PUNCT, ['-'] = CC_PUNCT, ['*'] = CC_PUNCT,
+    ['('] = CC_PUNCT, [')'] = CC_PUNCT, ['{'] = CC_PUNCT,
+    ['}'] = CC_PUNCT, [';'] = CC_PUNCT, [','] = CC_PUNCT,
+    [0x80 ... 0xff] = CC_HIGH,
+};
+
+/* Token for a lone CC_OP or CC_PUNCT byte. */
+static const unsigned char single_kind[256] = {
+    ['='] = TOKEN_ASSIGN, ['!'] = TOKEN_UNKNOWN,
+    ['<'] = TOKEN_LT,     ['>'] = TOKEN_GT,
+    ['+'] = TOKEN_PLUS,   ['-'] = TOKEN_MINUS,    ['*'] = TOKEN_MUL,
+    ['('] = TOKEN_LPAREN, [')'] = TOKEN_RPAREN,
+    ['{'] = TOKEN_LBRACE, ['}'] = TOKEN_RBRACE,
+    [';'] = TOKEN_SEMICOLON, [','] = TOKEN_COMMA,
+};
+
+/* Token for a CC_OP byte followed by '='. */
+static const unsigned char op_eq_kind[256] = {
+    ['='] = TOKEN_EQ, ['!'] = TOKEN_NEQ, ['<'] = TOKEN_LTE, ['>'] = TOKEN_GTE,
+};
+
+static int is_ident(unsigned char c)
+{
+    return char_class[c] == CC_LETTER || char_class[c] == CC_DIGIT;
+}
+
+static int is_digit(unsigned char c)
+{
+    return char_class[c] == CC_DIGIT;
+}
+
+/* Length of the non-ASCII character at s[pos] if it can start / continue
+ * an identifier, else 0. */
+static size_t xid_start_at(const unsigned char *s, size_t pos, size_t len)
+{
+    uint32_t cp;
+    size_t n = utf8_decode(s, pos, len, &cp);
+
+    return n && xid_start(cp) ? n : 0;
+}
+
+static size_t xid_continue_at(const unsigned char *s, size_t pos, size_t len)
+{
+    uint32_t cp;
+    size_t n = utf8_decode(s, pos, len, &cp);
+
+    return n && xid_continue(cp) ? n : 0;
+}
+
+/* End of the run of bytes that start no token beginning at s[pos]:
+ * {invalid} ASCII bytes, characters that cannot start an identifier, and
+ * bytes that are not well-formed UTF-8, each taken on its own. */
+static size_t span_invalid(const unsigned char *s, size_t pos, size_t len)
+{
+    while (pos < len) {
+        if (char_class[s[pos]] == CC_OTHER) {
+            pos++;
+        } else if (char_class[s[pos]] == CC_HIGH) {
+            uint32_t cp;
+            size_t n = utf8_decode(s, pos, len, &cp);
+
+            if (n && xid_start(cp))
+                break;
+            pos += n ? n : 1;
+        } else {
+            break;
+        }
+    }
+    return pos;
+}
+
+/* Scanning kernels.  Each takes the position just past the bytes already
+ * known to match and returns the end of the run: the first byte that is not
+ * whitespace / an identifier character / a digit, or the '*' of the first
+ * comment terminator.  Comment kernels return `len` when there is none.
+ * The vector versions fall back to the scalar ones for the last partial
+ * block, so they never read past the end of the source. */
+
+static inline size_t span_space_scalar(const unsigned char *s, size_t pos,
+                                       size_t len)
+{
+    while (pos < len && char_class[s[pos]] == CC_SPACE)
+        pos++;
+    return pos;
+}
+
+static inline size_t span_ident_scalar(const unsigned char *s, size_t pos,
+                                       size_t len)
+{
+    while (pos < len && is_ident(s[pos]))
+        pos++;
+    return pos;
+}
+
+static inline size_t span_digits_scalar(const unsigned char *s, size_t pos,
+                                        size_t len)
+{
+    while (pos < len && is_digit(s[pos]))
+        pos++;
+    return pos;
+}
+
+static inline size_t find_comment_end_scalar(const unsigned char *s,
+                                             size_t pos, size_t len)
+{
+    while (pos + 1 < len) {
+        const unsigned char *star = memchr(s + pos, '*', len - pos - 1);
+
+        if (!star)
+            break;
+        pos = (size_t) (star - s);
+        if (s[pos + 1] == '/')
+            return pos;
+        pos++;
+    }
+    return len;
+}
+
+#define LEX_FN              dfa_lex_scalar
+#define LEX_TARGET
+#define SPAN_SPACE          span_space_scalar
+#define SPAN_IDENT          span_ident_scalar
+#define SPAN_DIGITS         span_digits_scalar
+#define FIND_COMMENT_END    find_comment_end_scalar
+#include "dfalex_body.h"
+
+#if SIMD_X86
+
+/* SSE4.2: PCMPISTRI against a set of bytes or ranges, with negative
+ * polarity so the returned index is the first byte outside the set.  A NUL
+ * in the source ends the implicit-length compare, which is fine: NUL is in
+ * none of the sets. */
+#define SSE42_SPAN(name, ...)                                               \
+    static inline TARGET_SSE42 size_t name##_sse42(const unsigned char *s,   \
+                                                   size_t pos, size_t len)   \
+    {                                                                       \
+        const __m128i set = _mm_setr_epi8(__VA_ARGS__);                     \
+                                                                            \
+        while (pos + 16 <= len) {                                           \
+            __m128i chunk = _mm_loadu_si128((const __m128i *) (s + pos));   \
+            int i = _mm_cmpistri(set, chunk, SSE42_MODE_##name);            \
+                                                                            \
+            if (i < 16)                                                     \
+                return pos + (size_t) i;                                    \
+            pos += 16;                                                      \
+        }                                                                   \
+        return name##_scalar(s, pos, len);                                  \
+    }
+
+#define SSE42_MODE_span_space \
+    (_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY)
+#define SSE42_MODE_span_ident \
+    (_SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY)
+#define SSE42_MODE_span_digits SSE42_MODE_span_ident
+
+SSE42_SPAN(span_space, ' ', '\t', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+SSE42_SPAN(span_ident, 'a', 'z', 'A', 'Z', '0', '9', '_', '_',
+           0, 0, 0, 0, 0, 0, 0, 0)
+SSE42_SPAN(span_digits, '0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+
+static inline TARGET_SSE42 size_t find_comment_end_sse42(const unsigned char *s,
+                                                         size_t pos, size_t len)
+{
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    while (pos + 17 <= len) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (s + pos));
+        __m128i b = _mm_loadu_si128((const __m128i *) (s + pos + 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, star),
+                                                   _mm_cmpeq_epi8(b, slash)));
+
+        if (mask)
+            return pos + (size_t) __builtin_ctz((unsigned) mask);
+        pos += 16;
+    }
+    return find_comment_end_scalar(s, pos, len);
+}
+
+#define LEX_FN              dfa_lex_sse42
+#define LEX_TARGET          TARGET_SSE42
+#define SPAN_SPACE          span_space_sse42
+#define SPAN_IDENT          span_ident_sse42
+#define SPAN_DIGITS         span_digits_sse42
+#define FIND_COMMENT_END    find_comment_end_sse42
+#include "dfalex_body.h"
+
+/* AVX2: classify 32 bytes at a time into a bit mask of run members, then
+ * the first clear bit ends the run.  in_range() is the usual unsigned range
+ * check done with a signed compare after biasing by 128. */
+static inline TARGET_AVX2 __m256i in_range(__m256i c, char lo, int n)
+{
+    __m256i t = _mm256_sub_epi8(c, _mm256_set1_epi8((char) (lo + 128)));
+
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (n - 128)), t);
+}
+
+static inline TARGET_AVX2 uint32_t space_mask(__m256i c)
+{
+    __m256i m = _mm256_or_si256(
+        _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')),
+        _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\t')),
+                        _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'))));
+
+    return (uint32_t) _mm256_movemask_epi8(m);
+}
+
+static inline TARGET_AVX2 uint32_t ident_mask(__m256i c)
+{
+    __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i m = _mm256_or_si256(
+        in_range(lower, 'a', 26),
+        _mm256_or_si256(in_range(c, '0', 10),
+                        _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_'))));
+
+    return (uint32_t) _mm256_movemask_epi8(m);
+}
+
+static inline TARGET_AVX2 uint32_t digit_mask(__m256i c)
+{
+    return (uint32_t) _mm256_movemask_epi8(in_range(c, '0', 10));
+}
+
+#define AVX2_SPAN(name, classify)                                           \
+    static inline TARGET_AVX2 size_t name##_avx2(const unsigned char *s,     \
+                                                 size_t pos, size_t len)     \
+    {                                                                       \
+        while (pos + 32 <= len) {                                           \
+            __m256i c = _mm256_loadu_si256((const __m256i *) (s + pos));    \
+            uint32_t stop = ~classify(c);                                   \
+                                                                            \
+            if (stop)                                                       \
+                return pos + (size_t) __builtin_ctz(stop);                  \
+            pos += 32;                                                      \
+        }                                                                   \
+        return name##_sse42(s, pos, len);                                   \
+    }
+
+AVX2_SPAN(span_space, space_mask)
+AVX2_SPAN(span_ident, ident_mask)
+AVX2_SPAN(span_digits, digit_mask)
+
+static inline TARGET_AVX2 size_t find_comment_end_avx2(const unsigned char *s,
+                                                       size_t pos, size_t len)
+{
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+
+    while (pos + 33 <= len) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) (s + pos));
+        __m256i b = _mm256_loadu_si256((const __m256i *) (s + pos + 1));
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, star),
+                             _mm256_cmpeq_epi8(b, slash)));
+
+        if (mask)
+            return pos + (size_t) __builtin_ctz(mask);
+        pos += 32;
+    }
+    return find_comment_end_sse42(s, pos, len);
+}
+
+#define LEX_FN              dfa_lex_avx2
+#define LEX_TARGET          TARGET_AVX2
+#define SPAN_SPACE          span_space_avx2
+#define SPAN_IDENT          span_ident_avx2
+#define SPAN_DIGITS         span_digits_avx2
+#define FIND_COMMENT_END    find_comment_end_avx2
+#include "dfalex_body.h"
+
+#endif /* SIMD_X86 */
+
+size_t dfa_lex_range(const char *src, size_t len, size_t pos, size_t stop,
+                     struct token_buffer *out)
+{
+#if SIMD_X86
+    switch (simd_level()) {
+    case SIMD_AVX2:
+        return dfa_lex_avx2(src, len, pos, stop, out);
+    case SIMD_SSE42:
+        return dfa_lex_sse42(src, len, pos, stop, out);
+    case SIMD_SCALAR:
+        break;
+    }
+#endif
+    return dfa_lex_scalar(src, len, pos, stop, out);
+}
+
+void dfa_lex(const char *src, size_t len, struct token_buffer *out)
+{
+    dfa_lex_range(src, len, 0, len, out);
+}
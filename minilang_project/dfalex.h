@@ -0,0 +1,26 @@
+#ifndef MINILANG_DFALEX_H
+#define MINILANG_DFALEX_H
+
+#include <stddef.h>
+
+#include "token.h"
+
+/* Hand-coded scanner for the rules in minilang.l.
+ *
+ * Produces exactly the tokens the flex scanner does (longest match,
+ * earliest rule wins, unmatched bytes become TOKEN_UNKNOWN, see enum
+ * token_error), but works on a source that is already in memory and
+ * dispatches on a byte-class table instead of walking the compressed flex
+ * tables one byte at a time.
+ *
+ * Unlike the flex scanner it keeps no global state, so any number of
+ * threads can lex different sources at once. */
+void dfa_lex(const char *src, size_t len, struct token_buffer *out);
+
+/* Lex the tokens of src[0, len) that start in [pos, stop), assuming a token
+ * starts at pos.  The last token (or comment) may run past stop; returns
+ * the offset just after it, where the next token would start. */
+size_t dfa_lex_range(const char *src, size_t len, size_t pos, size_t stop,
+                     struct token_buffer *out);
+
+#endif
@@ -0,0 +1,134 @@
+/* Scanner body for dfalex.c, included once per instruction set.  The
+ * includer defines LEX_FN, LEX_TARGET and the SPAN_* / FIND_COMMENT_END
+ * kernels; they are undefined again at the end. */
+
+static LEX_TARGET size_t LEX_FN(const char *src, size_t len, size_t pos,
+                               size_t stop, struct token_buffer *out)
+{
+    const unsigned char *s = (const unsigned char *) src;
+    size_t comment_end = 0;     /* result of the last terminator search */
+    struct intern_cache cache;
+
+    memset(&cache, 0, sizeof cache);
+
+    while (pos < stop) {
+        size_t start = pos;
+        unsigned char c = s[pos];
+        enum token_kind kind;
+        uint32_t value = SYMBOL_NONE;
+        size_t n;
+
+        switch (char_class[c]) {
+        case CC_SPACE:
+            pos = SPAN_SPACE(s, pos + 1, len);
+            continue;
+
+        case CC_HIGH:
+            n = xid_start_at(s, pos, len);
+            if (n == 0) {
+                pos = span_invalid(s, pos, len);
+                kind = TOKEN_UNKNOWN;
+                break;
+            }
+            /* an identifier: the rest is as after an ASCII letter */
+            pos += n - 1;
+            /* fall through */
+        case CC_LETTER:
+            pos = SPAN_IDENT(s, pos + 1, len);
+            while (pos < len && char_class[s[pos]] == CC_HIGH &&
+                   (n = xid_continue_at(s, pos, len)) != 0)
+                pos = SPAN_IDENT(s, pos + n, len);
+            kind = keyword_kind(src + start, pos - start);
+            if (kind == TOKEN_IDENTIFIER)
+                value = intern_cached(&cache, src + start, pos - start);
+            break;
+
+        case CC_DIGIT:
+            pos = SPAN_DIGITS(s, pos + 1, len);
+            if (pos + 1 < len && s[pos] == '.' && is_digit(s[pos + 1]))
+                pos = SPAN_DIGITS(s, pos + 2, len);
+            kind = TOKEN_NUMBER;
+            value = token_buffer_add_number(out, src + start, (uint32_t) start,
+                                            (uint32_t) (pos - start));
+            break;
+
+        case CC_QUOTE:
+            pos++;
+            while (pos < len && s[pos] != '"' && s[pos] != '\n')
+                pos++;
+            if (pos < len && s[pos] == '"') {
+                pos++;
+                kind = TOKEN_STRING_LITERAL;
+                value = intern_cached(&cache, src + start + 1,
+                                      pos - start - 2);
+            } else {
+                /* no closing quote on this line: back up to the '"' */
+                pos = start + 1;
+                kind = TOKEN_UNKNOWN;
+                value = TOKEN_ERROR_STRING;
+            }
+            break;
+
+        case CC_SLASH:
+            if (pos + 1 < len && s[pos + 1] == '/') {
+                /* the C library's memchr is already vectorised */
+                const unsigned char *nl = memchr(s + pos, '\n', len - pos);
+
+                pos = nl ? (size_t) (nl - s) : len;
+                continue;
+            }
+            if (pos + 1 < len && s[pos + 1] == '*') {
+                /* A search that started earlier and ended at or after
+                 * pos + 2 found the first terminator from here too.  This
+                 * keeps a run of unterminated comment openers linear. */
+                if (comment_end < pos + 2)
+                    comment_end = FIND_COMMENT_END(s, pos + 2, len);
+                if (comment_end < len) {
+                    pos = comment_end + 2;
+                    continue;
+                }
+                /* unterminated: the opener is an error token and the
+                 * comment runs to the end of the source */
+                token_buffer_push(out, TOKEN_UNKNOWN, (uint32_t) start, 2,
+                                  TOKEN_ERROR_COMMENT);
+                pos = len;
+                continue;
+            }
+            pos++;
+            kind = TOKEN_DIV;
+            break;
+
+        case CC_OP:
+            if (pos + 1 < len && s[pos + 1] == '=') {
+                pos += 2;
+                kind = (enum token_kind) op_eq_kind[c];
+            } else {
+                pos++;
+                kind = (enum token_kind) single_kind[c];
+            }
+            break;
+
+        case CC_PUNCT:
+            pos++;
+            kind = (enum token_kind) single_kind[c];
+            break;
+
+        default:
+            /* one token for the whole run, so that binary input does not
+             * turn into a token per byte */
+            pos = span_invalid(s, pos, len);
+            kind = TOKEN_UNKNOWN;
+            break;
+        }
+        token_buffer_push(out, kind, (uint32_t) start, (uint32_t) (pos - start),
+                          value);
+    }
+    return pos;
+}
+
+#undef LEX_FN
+#undef LEX_TARGET
+#undef SPAN_SPACE
+#undef SPAN_IDENT
+#undef SPAN_DIGITS
+#undef FIND_COMMENT_END
@@ -0,0 +1,250 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "diag.h"
+#include "utf8.h"
+
+#define DEFAULT_LIMIT   20
+
+/* A message waiting for diag_end(): where, and its text in `text`. */
+struct message {
+    uint32_t offset;
+    size_t start;
+};
+
+static unsigned long errors;
+static unsigned long limit = DEFAULT_LIMIT;
+
+static const char *path;
+static struct line_index *lines;
+static unsigned long file_errors;
+static int stopped;
+
+static struct message *messages;
+static size_t message_count;
+static size_t message_capacity;
+static char *text;
+static size_t text_len;
+static size_t text_capacity;
+static char *out;
+static size_t out_len;
+static size_t out_capacity;
+
+/* The invalid-byte run not reported yet, if pending_length > 0, and what
+ * it starts with: a character of pending_char_len bytes, or a byte that is
+ * none (pending_char -1), or nothing known (pending_byte -1 too). */
+static uint32_t pending_offset;
+static uint32_t pending_length;
+static int pending_byte;
+static long pending_char;
+static uint32_t pending_char_len;
+
+static void *grow(void *p, size_t *capacity, size_t need, size_t size)
+{
+    size_t n = *capacity ? *capacity : 16;
+
+    while (n < need)
+        n *= 2;
+    p = realloc(p, n * size);
+    if (!p) {
+        fprintf(stderr, "minilang: out of memory for diagnostics\n");
+        exit(1);
+    }
+    *capacity = n;
+    return p;
+}
+
+/* Count an error; 0 if it is one too many to show. */
+static int count(void)
+{
+    errors++;
+    if (limit && ++file_errors > limit) {
+        stopped = 1;
+        return 0;
+    }
+    return 1;
+}
+
+static void store(uint32_t offset, const char *fmt, va_list ap)
+{
+    va_list copy;
+    int n;
+
+    if (message_count == message_capacity)
+        messages = grow(messages, &message_capacity, message_count + 1,
+                        sizeof *messages);
+    va_copy(copy, ap);
+    n = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    if (n < 0)
+        n = 0;
+    if (text_len + (size_t) n + 1 > text_capacity)
+        text = grow(text, &text_capacity, text_len + (size_t) n + 1, 1);
+    vsnprintf(text + text_len, (size_t) n + 1, fmt, ap);
+    messages[message_count].offset = offset;
+    messages[message_count].start = text_len;
+    message_count++;
+    text_len += (size_t) n + 1;
+}
+
+static void out_printf(const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(out + out_len, out_capacity - out_len, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return;
+    if (out_len + (size_t) n + 1 > out_capacity) {
+        out = grow(out, &out_capacity, out_len + (size_t) n + 1, 1);
+        va_start(ap, fmt);
+        vsnprintf(out + out_len, out_capacity - out_len, fmt, ap);
+        va_end(ap);
+    }
+    out_len += (size_t) n;
+}
+
+static void store_printf(uint32_t offset, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    store(offset, fmt, ap);
+    va_end(ap);
+}
+
+static void flush_invalid(void)
+{
+    uint32_t length = pending_length;
+    long c = pending_char;
+
+    if (length == 0)
+        return;
+    pending_length = 0;
+    if (length > pending_char_len)
+        store_printf(pending_offset, "%lu invalid bytes",
+                     (unsigned long) length);
+    else if (c > ' ' && c < 0x7f)
+        store_printf(pending_offset, "invalid character '%c'", (int) c);
+    else if (c >= 0x80)
+        store_printf(pending_offset, "invalid character U+%04lX", c);
+    else if (pending_byte >= 0)
+        store_printf(pending_offset, "invalid byte 0x%02x",
+                     (unsigned) pending_byte);
+    else
+        store_printf(pending_offset, "invalid byte");
+}
+
+/* Errors come in source order except for the odd whole-source check made
+ * before lexing, so an insertion sort has next to nothing to move. */
+static void sort_messages(void)
+{
+    size_t i, j;
+
+    for (i = 1; i < message_count; i++) {
+        struct message m = messages[i];
+
+        for (j = i; j > 0 && messages[j - 1].offset > m.offset; j--)
+            messages[j] = messages[j - 1];
+        messages[j] = m;
+    }
+}
+
+void diag_begin(const char *source_path, struct line_index *source_lines)
+{
+    path = source_path;
+    lines = source_lines;
+    file_errors = 0;
+    stopped = 0;
+    message_count = 0;
+    text_len = 0;
+    pending_length = 0;
+}
+
+void diag_error(uint32_t offset, const char *fmt, ...)
+{
+    va_list ap;
+
+    flush_invalid();
+    if (!count())
+        return;
+    va_start(ap, fmt);
+    store(offset, fmt, ap);
+    va_end(ap);
+}
+
+void diag_invalid(uint32_t offset, uint32_t length, const char *text)
+{
+    uint32_t cp;
+    size_t n;
+
+    if (pending_length && pending_offset + pending_length == offset) {
+        pending_length += length;
+        return;
+    }
+    flush_invalid();
+    if (!count())
+        return;
+    pending_offset = offset;
+    pending_length = length;
+    pending_byte = -1;
+    pending_char = -1;
+    pending_char_len = 1;
+    if (text) {
+        pending_byte = (unsigned char) text[0];
+        n = utf8_decode((const unsigned char *) text, 0, length, &cp);
+        if (n) {
+            pending_char = (long) cp;
+            pending_char_len = (uint32_t) n;
+        }
+    }
+}
+
+int diag_stopped(void)
+{
+    return stopped;
+}
+
+void diag_end(void)
+{
+    size_t i;
+
+    flush_invalid();
+    sort_messages();
+    out_len = 0;
+    for (i = 0; i < message_count; i++) {
+        const struct message *m = &messages[i];
+
+        if (lines) {
+            uint32_t line, column;
+
+            line_index_lookup(lines, m->offset, &line, &column);
+            out_printf("minilang: %s:%lu:%lu: %s\n", path,
+                       (unsigned long) line, (unsigned long) column,
+                       text + m->start);
+        } else {
+            out_printf("minilang: %s: offset %lu: %s\n", path,
+                       (unsigned long) m->offset, text + m->start);
+        }
+    }
+    if (stopped)
+        out_printf("minilang: %s: too many errors, stopping\n", path);
+    /* stderr is unbuffered: one write for the lot */
+    if (out_len)
+        fwrite(out, 1, out_len, stderr);
+    message_count = 0;
+    text_len = 0;
+}
+
+void diag_set_limit(unsigned long max)
+{
+    limit = max;
+}
+
+unsigned long diag_error_count(void)
+{
+    return errors;
+}
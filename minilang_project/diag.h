@@ -0,0 +1,39 @@
+#ifndef MINILANG_DIAG_H
+#define MINILANG_DIAG_H
+
+#include <stdint.h>
+
+#include "lines.h"
+
+/* Errors are collected per source between diag_begin() and diag_end(),
+ * which writes them to stderr in one go as
+ *
+ *   minilang: path:line:column: message
+ *
+ * `lines` locates the offsets; when the source is not in memory (flex
+ * streaming standard input) it is NULL and byte offsets are printed
+ * instead.  Locations are only worked out in diag_end(), so the source may
+ * be scanned (and temporarily modified, as flex does) until then.  Only
+ * one thread may report at a time; lexer threads leave reporting to the
+ * thread that prints their tokens. */
+void diag_begin(const char *path, struct line_index *lines);
+void diag_end(void);
+
+void diag_error(uint32_t offset, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Report `length` bytes at `offset` that start no token; `text` is them,
+ * or NULL when the source is not at hand.  Runs reported one right after
+ * the other are merged into a single error. */
+void diag_invalid(uint32_t offset, uint32_t length, const char *text);
+
+/* Errors allowed per source, 0 for no limit.  The error after the last
+ * one allowed is not shown; from then on diag_stopped() is true and the
+ * caller should give up on the source, so that garbage input fails fast
+ * rather than producing a token and an error for every few bytes. */
+void diag_set_limit(unsigned long limit);
+int diag_stopped(void);
+
+unsigned long diag_error_count(void);
+
+#endif
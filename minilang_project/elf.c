@@ -0,0 +1,252 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "object code"
+#include "alloc.h"
+
+#include "elf.h"
+
+/* Section header indices, in the order elf_write() lays them out. */
+enum {
+    SEC_NULL,
+    SEC_TEXT,
+    SEC_RODATA,
+    SEC_RELA,
+    SEC_SYMTAB,
+    SEC_STRTAB,
+    SEC_SHSTRTAB,
+    SEC_NOTE,
+    SEC_COUNT
+};
+
+#define HEADER_SIZE     64
+#define SECTION_SIZE    64
+#define SYMBOL_SIZE     24
+#define RELA_SIZE       24
+
+size_t elf_put(struct elf_bytes *b, const void *data, size_t len)
+{
+    size_t at = b->len;
+
+    if (b->len + len > b->capacity) {
+        while (b->len + len > b->capacity)
+            b->capacity = b->capacity ? b->capacity * 2 : 4096;
+        b->data = xrealloc(b->data, b->capacity);
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    return at;
+}
+
+size_t elf_align(struct elf_bytes *b, size_t align, unsigned char fill)
+{
+    while (b->len % align)
+        elf_put(b, &fill, 1);
+    return b->len;
+}
+
+static void put8(struct elf_bytes *b, unsigned v)
+{
+    unsigned char c = (unsigned char) v;
+
+    elf_put(b, &c, 1);
+}
+
+static void put16(struct elf_bytes *b, uint16_t v)
+{
+    unsigned char c[2] = {(unsigned char) v, (unsigned char) (v >> 8)};
+
+    elf_put(b, c, 2);
+}
+
+static void put32(struct elf_bytes *b, uint32_t v)
+{
+    put16(b, (uint16_t) v);
+    put16(b, (uint16_t) (v >> 16));
+}
+
+static void put64(struct elf_bytes *b, uint64_t v)
+{
+    put32(b, (uint32_t) v);
+    put32(b, (uint32_t) (v >> 32));
+}
+
+void elf_init(struct elf_object *obj)
+{
+    memset(obj, 0, sizeof *obj);
+    elf_put(&obj->strtab, "", 1);
+    elf_symbol(obj, NULL, 0, ELF_TEXT, 0, 0, 0);
+    elf_symbol(obj, NULL, 0, ELF_RODATA, 0, 0, 0);
+}
+
+void elf_free(struct elf_object *obj)
+{
+    free(obj->text.data);
+    free(obj->rodata.data);
+    free(obj->strtab.data);
+    free(obj->symbols);
+    free(obj->relocs);
+    memset(obj, 0, sizeof *obj);
+}
+
+uint32_t elf_symbol(struct elf_object *obj, const char *name, size_t len,
+                    enum elf_section section, uint64_t value, int global,
+                    int function)
+{
+    struct elf_symbol *sym;
+
+    if (obj->symbol_count == obj->symbol_capacity) {
+        obj->symbol_capacity = obj->symbol_capacity
+                               ? obj->symbol_capacity * 2 : 16;
+        obj->symbols = xrealloc(obj->symbols,
+                                obj->symbol_capacity * sizeof *obj->symbols);
+    }
+    sym = &obj->symbols[obj->symbol_count];
+    sym->name = 0;
+    if (name) {
+        sym->name = (uint32_t) elf_put(&obj->strtab, name, len);
+        elf_put(&obj->strtab, "", 1);
+    }
+    sym->section = section;
+    sym->value = value;
+    sym->size = 0;
+    sym->global = global;
+    sym->function = function;
+    return obj->symbol_count++;
+}
+
+void elf_reloc(struct elf_object *obj, uint64_t offset, uint32_t symbol,
+               uint32_t type, int64_t addend)
+{
+    struct elf_reloc *r;
+
+    if (obj->reloc_count == obj->reloc_capacity) {
+        obj->reloc_capacity = obj->reloc_capacity
+                              ? obj->reloc_capacity * 2 : 64;
+        obj->relocs = xrealloc(obj->relocs,
+                               obj->reloc_capacity * sizeof *obj->relocs);
+    }
+    r = &obj->relocs[obj->reloc_count++];
+    r->offset = offset;
+    r->symbol = symbol;
+    r->type = type;
+    r->addend = addend;
+}
+
+static void section(struct elf_bytes *b, uint32_t name, uint32_t type,
+                    uint64_t flags, uint64_t offset, uint64_t size,
+                    uint32_t link, uint32_t info, uint64_t align,
+                    uint64_t entsize)
+{
+    put32(b, name);
+    put32(b, type);
+    put64(b, flags);
+    put64(b, 0);            /* address: none until linked */
+    put64(b, offset);
+    put64(b, size);
+    put32(b, link);
+    put32(b, info);
+    put64(b, align);
+    put64(b, entsize);
+}
+
+int elf_write(FILE *out, const struct elf_object *obj)
+{
+    static const unsigned char zero[HEADER_SIZE];
+    static const char shstrtab[] =
+        "\0.text\0.rodata\0.rela.text\0.symtab\0.strtab\0.shstrtab\0"
+        ".note.GNU-stack";
+    /* offsets of the names above */
+    enum { N_TEXT = 1, N_RODATA = 7, N_RELA = 15, N_SYMTAB = 26,
+           N_STRTAB = 34, N_SHSTRTAB = 42, N_NOTE = 52 };
+    struct elf_bytes b = {0};
+    uint32_t *index = xrealloc(NULL, obj->symbol_count * sizeof *index);
+    uint64_t text, rodata, rela, symtab, strtab, names, headers;
+    uint32_t i, n, first_global = 1, pass;
+    int status = 0;
+
+    /* the null symbol, then the locals, then the globals */
+    n = 1;
+    for (pass = 0; pass < 2; pass++) {
+        if (pass == 1)
+            first_global = n;
+        for (i = 0; i < obj->symbol_count; i++)
+            if (obj->symbols[i].global == (int) pass)
+                index[i] = n++;
+    }
+
+    elf_put(&b, zero, HEADER_SIZE);     /* the file header goes here */
+    text = elf_put(&b, obj->text.data, obj->text.len);
+    elf_align(&b, 16, 0);
+    rodata = elf_put(&b, obj->rodata.data, obj->rodata.len);
+    elf_align(&b, 8, 0);
+    rela = b.len;
+    for (i = 0; i < obj->reloc_count; i++) {
+        const struct elf_reloc *r = &obj->relocs[i];
+
+        put64(&b, r->offset);
+        put64(&b, (uint64_t) index[r->symbol] << 32 | r->type);
+        put64(&b, (uint64_t) r->addend);
+    }
+    symtab = b.len;
+    elf_put(&b, zero, SYMBOL_SIZE);
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < obj->symbol_count; i++) {
+            const struct elf_symbol *s = &obj->symbols[i];
+            unsigned type = s->function ? 2 : 0;   /* STT_FUNC, NOTYPE */
+
+            if (s->global != (int) pass)
+                continue;
+            if (i == ELF_TEXT_SYMBOL || i == ELF_RODATA_SYMBOL)
+                type = 3;                           /* STT_SECTION */
+            put32(&b, s->name);
+            put8(&b, pass << 4 | type);             /* binding, type */
+            put8(&b, 0);                            /* default visibility */
+            put16(&b, s->section == ELF_TEXT ? SEC_TEXT
+                      : s->section == ELF_RODATA ? SEC_RODATA : 0);
+            put64(&b, s->value);
+            put64(&b, s->size);
+        }
+    }
+    strtab = elf_put(&b, obj->strtab.data, obj->strtab.len);
+    names = elf_put(&b, shstrtab, sizeof shstrtab);
+    elf_align(&b, 8, 0);
+    headers = b.len;
+    elf_put(&b, zero, SECTION_SIZE);
+    section(&b, N_TEXT, 1, 6, text, obj->text.len, 0, 0, 16, 0);
+    section(&b, N_RODATA, 1, 2, rodata, obj->rodata.len, 0, 0, 16, 0);
+    section(&b, N_RELA, 4, 0x40, rela, (uint64_t) obj->reloc_count *
+            RELA_SIZE, SEC_SYMTAB, SEC_TEXT, 8, RELA_SIZE);
+    section(&b, N_SYMTAB, 2, 0, symtab, (uint64_t) n * SYMBOL_SIZE,
+            SEC_STRTAB, first_global, 8, SYMBOL_SIZE);
+    section(&b, N_STRTAB, 3, 0, strtab, obj->strtab.len, 0, 0, 1, 0);
+    section(&b, N_SHSTRTAB, 3, 0, names, sizeof shstrtab, 0, 0, 1, 0);
+    section(&b, N_NOTE, 1, 0, b.len, 0, 0, 0, 1, 0);
+
+    /* the file header, over the space kept for it; the buffer is long
+     * enough, so this only overwrites */
+    n = (uint32_t) b.len;
+    b.len = 0;
+    elf_put(&b, "\177ELF\2\1\1", 7);    /* 64-bit, little-endian, v1 */
+    elf_put(&b, "\0\0\0\0\0\0\0\0\0", 9);
+    put16(&b, 1);                       /* ET_REL */
+    put16(&b, 62);                      /* EM_X86_64 */
+    put32(&b, 1);
+    put64(&b, 0);                       /* entry */
+    put64(&b, 0);                       /* program headers: none */
+    put64(&b, headers);
+    put32(&b, 0);                       /* flags */
+    put16(&b, HEADER_SIZE);
+    put16(&b, 0);
+    put16(&b, 0);
+    put16(&b, SECTION_SIZE);
+    put16(&b, SEC_COUNT);
+    put16(&b, SEC_SHSTRTAB);
+    b.len = n;
+
+    if (fwrite(b.data, 1, b.len, out) != b.len)
+        status = -1;
+    free(b.data);
+    free(index);
+    return status;
+}
@@ -0,0 +1,86 @@
+#ifndef MINILANG_ELF_H
+#define MINILANG_ELF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* An ELF64 relocatable object for x86-64, as `cc -c` leaves one: code in
+ * .text, constants in .rodata, a symbol for each function the code
+ * defines and each it calls, and a relocation wherever it refers to one
+ * or to .rodata.  It is built in memory and written whole by elf_write(),
+ * field by field in little-endian order, so writing it needs neither the
+ * host's <elf.h> nor an assembler; linking it is the system linker's job.
+ *
+ * Symbols are numbered in the order they are made, from
+ * ELF_TEXT_SYMBOL and ELF_RODATA_SYMBOL, which stand for the sections
+ * themselves; elf_write() puts the local ones before the global ones, as
+ * the format wants, and renumbers the relocations to match. */
+enum elf_section {
+    ELF_UNDEF,              /* defined in another object */
+    ELF_TEXT,
+    ELF_RODATA
+};
+
+#define ELF_TEXT_SYMBOL     0
+#define ELF_RODATA_SYMBOL   1
+
+/* Relocation types: the 32-bit distance from the end of the field to the
+ * symbol plus the addend, for a call (through the PLT should the linker
+ * want one) or a load. */
+#define ELF_R_PC32      2
+#define ELF_R_PLT32     4
+
+struct elf_bytes {
+    unsigned char *data;
+    size_t len;
+    size_t capacity;
+};
+
+struct elf_symbol {
+    uint32_t name;          /* in strtab; 0 for a section's own */
+    enum elf_section section;
+    uint64_t value;         /* offset in the section */
+    uint64_t size;
+    int global;
+    int function;
+};
+
+struct elf_reloc {
+    uint64_t offset;        /* of the field, in .text */
+    uint32_t symbol;
+    uint32_t type;
+    int64_t addend;
+};
+
+struct elf_object {
+    struct elf_bytes text;
+    struct elf_bytes rodata;
+    struct elf_bytes strtab;
+    struct elf_symbol *symbols;
+    uint32_t symbol_count;
+    uint32_t symbol_capacity;
+    struct elf_reloc *relocs;
+    uint32_t reloc_count;
+    uint32_t reloc_capacity;
+};
+
+void elf_init(struct elf_object *obj);
+void elf_free(struct elf_object *obj);
+
+/* Append `len` bytes; returns where they went. */
+size_t elf_put(struct elf_bytes *b, const void *data, size_t len);
+
+/* Pad with `fill` to a multiple of `align`; returns the new length. */
+size_t elf_align(struct elf_bytes *b, size_t align, unsigned char fill);
+
+uint32_t elf_symbol(struct elf_object *obj, const char *name, size_t len,
+                    enum elf_section section, uint64_t value, int global,
+                    int function);
+void elf_reloc(struct elf_object *obj, uint64_t offset, uint32_t symbol,
+               uint32_t type, int64_t addend);
+
+/* Returns 0, or -1 if writing failed. */
+int elf_write(FILE *out, const struct elf_object *obj);
+
+#endif
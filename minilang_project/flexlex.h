@@ -0,0 +1,25 @@
+#ifndef MINILANG_FLEXLEX_H
+#define MINILANG_FLEXLEX_H
+
+#include <stdio.h>
+
+#include "token.h"
+
+/* Run the flex scanner generated from minilang.l over `in`.  Tokens are
+ * appended to `out`, or printed one per line as they are matched when
+ * `out` is NULL; in that case errors are reported against `name` (see
+ * diag.h) as they are seen, including input that is not UTF-8.  When
+ * collecting, the input is still checked, and the offset of its first
+ * byte that is not well-formed UTF-8, or UINT64_MAX, is stored in
+ * `*bad_utf8` (unless that is NULL) for the caller to report, since the
+ * input is gone by then.  Returns the number of source bytes consumed. */
+uint32_t flex_lex(FILE *in, const char *name, struct token_buffer *out,
+                  uint64_t *bad_utf8);
+
+/* Same, but scan `len` bytes in place without copying them into flex's
+ * own buffer.  buf[len] and buf[len + 1] must be NUL, and the scanner
+ * writes into `buf` while it runs. */
+uint32_t flex_lex_buffer(char *buf, size_t len, const char *name,
+                         struct token_buffer *out);
+
+#endif
@@ -0,0 +1,348 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "bytecode"
+#include "alloc.h"
+
+#include "fuse.h"
+
+/* Loops nested deeper than this weigh no more. */
+#define PROFILE_MAX_DEPTH   6
+
+struct gram {
+    uint64_t key;               /* the opcodes, 16 bits each, first high */
+    double weight;
+    uint64_t count;
+};
+
+static int is_jump(enum opcode op)
+{
+    return opcode_formats[op] == FORMAT_J || opcode_formats[op] == FORMAT_AJ ||
+           opcode_formats[op] == FORMAT_ABR;
+}
+
+/* Where the jump at index `i` goes. */
+static uint32_t target_of(const struct code *code, uint32_t i)
+{
+    const struct insn *insn = &code->insns[i];
+
+    return opcode_formats[insn->op] == FORMAT_ABR ? insn_branch(insn, i)
+                                                  : insn_target(insn);
+}
+
+/* Marks in `target` every instruction some jump goes to. */
+static void find_targets(const struct code *code, unsigned char *target)
+{
+    uint32_t i;
+
+    memset(target, 0, code->count + 1);
+    for (i = 0; i < code->count; i++)
+        if (is_jump((enum opcode) code->insns[i].op))
+            target[target_of(code, i)] = 1;
+}
+
+/* The number of loops around each instruction: those between a backward
+ * jump and its target. */
+static void loop_depths(const struct code *code, uint32_t *depth)
+{
+    uint32_t i, to;
+
+    memset(depth, 0, (code->count + 1) * sizeof *depth);
+    for (i = 0; i < code->count; i++) {
+        if (!is_jump((enum opcode) code->insns[i].op))
+            continue;
+        to = target_of(code, i);
+        if (to <= i) {
+            depth[to]++;
+            depth[i + 1]--;
+        }
+    }
+    for (i = 1; i < code->count; i++)
+        depth[i] += depth[i - 1];
+}
+
+/* Compare-and-branch by comparison: the jump if it holds, and the one if
+ * it does not.  An int comparison that fails is the opposite one; a float
+ * comparison with a NaN is neither, so those have opcodes of their own. */
+static const unsigned short branch_ops[OP_COUNT][2] = {
+    [OP_EQ_I64] = {OP_JEQ_I64, OP_JNE_I64},
+    [OP_NE_I64] = {OP_JNE_I64, OP_JEQ_I64},
+    [OP_LT_I64] = {OP_JLT_I64, OP_JGE_I64},
+    [OP_LE_I64] = {OP_JLE_I64, OP_JGT_I64},
+    [OP_GT_I64] = {OP_JGT_I64, OP_JLE_I64},
+    [OP_GE_I64] = {OP_JGE_I64, OP_JLT_I64},
+    [OP_EQ_F64] = {OP_JEQ_F64, OP_JNE_F64},
+    [OP_NE_F64] = {OP_JNE_F64, OP_JEQ_F64},
+    [OP_LT_F64] = {OP_JLT_F64, OP_JNLT_F64},
+    [OP_LE_F64] = {OP_JLE_F64, OP_JNLE_F64},
+    [OP_GT_F64] = {OP_JGT_F64, OP_JNGT_F64},
+    [OP_GE_F64] = {OP_JGE_F64, OP_JNGE_F64},
+};
+
+struct fuser {
+    const struct code *code;
+    const unsigned char *target;
+    uint32_t temps;             /* the first temporary */
+};
+
+/* Whether instruction i + k, for k up to len - 1, may be fused into the
+ * one before: it is there and nothing jumps to it. */
+static int fusable(const struct fuser *f, uint32_t i, uint32_t len)
+{
+    uint32_t k;
+
+    if (i + len > f->code->count)
+        return 0;
+    for (k = 1; k < len; k++)
+        if (f->target[i + k])
+            return 0;
+    return 1;
+}
+
+/* Whether the jump at `from` to `to` fits a FORMAT_ABR distance. */
+static int near(uint32_t from, uint32_t to)
+{
+    int64_t d = (int64_t) to - from;
+
+    return d >= INT16_MIN && d <= INT16_MAX;
+}
+
+static int is_int_one(const struct code *code, uint32_t reg)
+{
+    uint32_t k = reg - code->variables;
+
+    return reg >= code->variables && k < code->constant_count &&
+           code->constant_types[k] == TYPE_INT && code->constants[k].i == 1;
+}
+
+/* A comparison into a temporary and the branch on it, at i: sets *op to
+ * the compare-and-branch that does both, or returns 0. */
+static int match_branch(const struct fuser *f, uint32_t i, enum opcode *op)
+{
+    const struct insn *cmp = &f->code->insns[i];
+    const struct insn *jmp = cmp + 1;
+    int negated;
+
+    if (!fusable(f, i, 2) || !branch_ops[cmp->op][0] || cmp->a < f->temps ||
+        jmp->a != cmp->a || !near(i, insn_target(jmp)))
+        return 0;
+    if (jmp->op == OP_JMPIF_I64)
+        negated = 0;
+    else if (jmp->op == OP_JMPIFNOT_I64)
+        negated = 1;
+    else
+        return 0;
+    *op = (enum opcode) branch_ops[cmp->op][negated];
+    return 1;
+}
+
+/* `i = i + 1; if (i < n) goto top` at i: returns whether it is there and
+ * sets *n. */
+static int match_inc_jlt(const struct fuser *f, uint32_t i, uint32_t *n)
+{
+    const struct code *code = f->code;
+    const struct insn *add = &code->insns[i];
+    const struct insn *cmp = add + 1;
+    const struct insn *jmp = add + 2;
+    uint32_t var = add->a;
+
+    if (!fusable(f, i, 3) || add->op != OP_ADD_I64 ||
+        !((add->b == var && is_int_one(code, add->c)) ||
+          (add->c == var && is_int_one(code, add->b))) ||
+        cmp->a < f->temps || jmp->op != OP_JMPIF_I64 || jmp->a != cmp->a ||
+        !near(i, insn_target(jmp)))
+        return 0;
+    if (cmp->op == OP_LT_I64 && cmp->b == var)
+        *n = cmp->c;
+    else if (cmp->op == OP_GT_I64 && cmp->c == var)
+        *n = cmp->b;
+    else
+        return 0;
+    return *n != var;
+}
+
+/* `x - x / k * k` at i, its quotient in a temporary; the multiply may
+ * have its operands either way round. */
+static int match_rem(const struct fuser *f, uint32_t i)
+{
+    const struct insn *div = &f->code->insns[i];
+    const struct insn *mul = div + 1;
+    const struct insn *sub = div + 2;
+    uint32_t t = div->a;
+
+    return fusable(f, i, 3) && div->op == OP_DIV_I64 && t >= f->temps &&
+           t != div->b && t != div->c && mul->op == OP_MUL_I64 &&
+           mul->a == t && ((mul->b == t && mul->c == div->c) ||
+                           (mul->c == t && mul->b == div->c)) &&
+           sub->op == OP_SUB_I64 && sub->b == div->b && sub->c == t;
+}
+
+static void fuse_code(struct code *code)
+{
+    struct fuser f;
+    unsigned char *target = xmalloc(code->count + 1);
+    uint32_t *map = xmalloc((code->count + 1) * sizeof *map);
+    uint32_t *to = xmalloc((code->count + 1) * sizeof *to);
+    struct insn *insns = code->insns;
+    uint32_t i, n = 0, len, reg;
+    enum opcode op;
+
+    find_targets(code, target);
+    f.code = code;
+    f.target = target;
+    f.temps = code->variables + code->constant_count;
+
+    /* in place: the fused code is never longer */
+    for (i = 0; i < code->count; i += len) {
+        struct insn insn = insns[i];
+
+        len = 1;
+        to[n] = UINT32_MAX;
+        if (match_rem(&f, i)) {
+            insn.op = OP_REM_I64;
+            insn.a = insns[i + 2].a;
+            len = 3;
+        } else if (match_inc_jlt(&f, i, &reg)) {
+            insn.op = OP_INC_JLT_I64;
+            insn.b = (uint16_t) reg;
+            to[n] = insn_target(&insns[i + 2]);
+            len = 3;
+        } else if (match_branch(&f, i, &op)) {
+            insn.op = (uint16_t) op;
+            insn.a = insns[i].b;
+            insn.b = insns[i].c;
+            to[n] = insn_target(&insns[i + 1]);
+            len = 2;
+        }
+        for (reg = 0; reg < len; reg++)
+            map[i + reg] = n;
+        code->offsets[n] = code->offsets[i];
+        insns[n++] = insn;
+    }
+    map[code->count] = n;
+
+    /* then the targets, by where the instructions went */
+    for (i = 0; i < n; i++) {
+        struct insn *insn = &insns[i];
+        uint32_t at;
+
+        if (to[i] != UINT32_MAX) {
+            insn->c = (uint16_t) (int16_t) ((int32_t) map[to[i]] -
+                                            (int32_t) i);
+        } else if (is_jump((enum opcode) insn->op)) {
+            at = map[insn_target(insn)];
+            insn->b = (uint16_t) at;
+            insn->c = (uint16_t) (at >> 16);
+        }
+    }
+    code->count = n;
+    free(to);
+    free(map);
+    free(target);
+}
+
+void fuse(struct program *prog)
+{
+    if (prog->generic)
+        return;
+    fuse_code(&prog->top);
+    if (prog->has_main)
+        fuse_code(&prog->main);
+}
+
+/* Appends to grams every sequence of `len` instructions of `code` that
+ * run one after the other: none but the first is jumped to, and none but
+ * the last ends in an unconditional jump. */
+static size_t collect(const struct code *code, unsigned len,
+                      struct gram *grams, size_t n, const unsigned char *target,
+                      const uint32_t *depth)
+{
+    uint32_t i, k;
+
+    for (i = 0; i + len <= code->count; i++) {
+        uint64_t key = 0;
+        double weight = 1;
+
+        for (k = 0; k < len; k++) {
+            enum opcode op = (enum opcode) code->insns[i + k].op;
+
+            if ((k > 0 && target[i + k]) ||
+                (k + 1 < len && (op == OP_JMP || op == OP_RETURN)))
+                break;
+            key = key << 16 | op;
+        }
+        if (k < len)
+            continue;
+        for (k = 0; k < depth[i] && k < PROFILE_MAX_DEPTH; k++)
+            weight *= 10;
+        grams[n].key = key | (uint64_t) len << 48;
+        grams[n].weight = weight;
+        grams[n].count = 1;
+        n++;
+    }
+    return n;
+}
+
+static int by_key(const void *a, const void *b)
+{
+    const struct gram *x = a, *y = b;
+
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+static int by_weight(const void *a, const void *b)
+{
+    const struct gram *x = a, *y = b;
+
+    if (x->weight != y->weight)
+        return x->weight < y->weight ? 1 : -1;
+    if (x->count != y->count)
+        return x->count < y->count ? 1 : -1;
+    return by_key(a, b);
+}
+
+static size_t profile_code(const struct code *code, struct gram *grams,
+                           size_t n)
+{
+    unsigned char *target = xmalloc(code->count + 1);
+    uint32_t *depth = xmalloc((code->count + 1) * sizeof *depth);
+
+    find_targets(code, target);
+    loop_depths(code, depth);
+    n = collect(code, 2, grams, n, target, depth);
+    n = collect(code, 3, grams, n, target, depth);
+    free(depth);
+    free(target);
+    return n;
+}
+
+void profile_print(FILE *out, const struct program *prog)
+{
+    size_t max = 2 * (size_t) (prog->top.count + prog->main.count);
+    struct gram *grams = xmalloc(max * sizeof *grams);
+    size_t n, i, j;
+    unsigned len, k;
+
+    n = profile_code(&prog->top, grams, 0);
+    if (prog->has_main)
+        n = profile_code(&prog->main, grams, n);
+    qsort(grams, n, sizeof *grams, by_key);
+    for (i = 0, j = 0; i < n; i++) {
+        if (j > 0 && grams[j - 1].key == grams[i].key) {
+            grams[j - 1].weight += grams[i].weight;
+            grams[j - 1].count += grams[i].count;
+        } else {
+            grams[j++] = grams[i];
+        }
+    }
+    qsort(grams, j, sizeof *grams, by_weight);
+    for (i = 0; i < j; i++) {
+        len = (unsigned) (grams[i].key >> 48);
+        fprintf(out, "%.0f\t%llu\t", grams[i].weight,
+                (unsigned long long) grams[i].count);
+        for (k = len; k-- > 0;)
+            fprintf(out, "%s%c", opcode_names[grams[i].key >> 16 * k & 0xFFFF],
+                    k ? ' ' : '\n');
+    }
+    free(grams);
+}
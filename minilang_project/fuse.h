@@ -0,0 +1,27 @@
+#ifndef MINILANG_FUSE_H
+#define MINILANG_FUSE_H
+
+#include <stdio.h>
+
+#include "bytecode.h"
+
+/* Superinstructions: one instruction where the compiler made two or three
+ * that often run together, so that the VM dispatches once instead.
+ *
+ * The sequences fused are the ones profile_print() finds most often in
+ * loops across the programs in bench/: an int comparison and the branch
+ * on its result become one compare-and-branch, j<cmp>_i64, and the end of
+ * a counted loop, `i = i + 1; if (i < n) goto top`, becomes inc_jlt_i64.
+ * Fused branches keep their target as a signed 16-bit distance in c; one
+ * that is further away is left as it was.  Only typed code is fused. */
+void fuse(struct program *prog);
+
+/* Static profile of the code: every run of two and three instructions
+ * that execute one after the other, with how often it occurs and a
+ * weight that estimates how often it runs, 10 to the power of the number
+ * of loops around it.  One line per sequence, heaviest first:
+ *
+ *   weight <tab> count <tab> op op [op] */
+void profile_print(FILE *out, const struct program *prog);
+
+#endif
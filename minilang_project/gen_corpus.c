@@ -0,0 +1,466 @@
+/* Synthetic MiniLang corpus generator for lexer benchmarks.
+ *
+ *   gen_corpus [--mix=NAME] [--seed=N] SIZE > corpus.minilang
+ *
+ * Writes about SIZE bytes (a suffix of k, m or g multiplies by 1024) of
+ * syntactically plausible MiniLang: functions full of declarations,
+ * assignments, loops, conditions and prints, with comments in between.
+ * The mix sets how often each kind of statement appears and how long
+ * comments and names run:
+ *
+ *   balanced     roughly what hand-written code looks like
+ *   comments     mostly line and block comments
+ *   identifiers  long expressions over many distinct names
+ *   numbers      integer and float literals, a few just under INT64_MAX
+ *   strings      prints of string literals of varying length
+ *   unicode      balanced, with a third of the names and words non-ASCII
+ *   bytes        not MiniLang at all: random bytes, most of them ones
+ *                tokens start, end or are made of, for testing lexers
+ *
+ * The output depends only on the mix, the seed and SIZE, so a corpus can
+ * be regenerated instead of stored. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME_POOL 4096
+
+enum stmt {
+    STMT_DECL,
+    STMT_ASSIGN,
+    STMT_PRINT,
+    STMT_IF,
+    STMT_FOR,
+    STMT_LINE_COMMENT,
+    STMT_BLOCK_COMMENT,
+    STMT_KIND_COUNT
+};
+
+struct mix {
+    const char *name;
+    unsigned weight[STMT_KIND_COUNT];
+    unsigned comment_words;     /* typical words per comment */
+    unsigned expr_terms;        /* typical operands per expression */
+    unsigned string_words;      /* typical words per string literal */
+    unsigned number_percent;    /* operands that are literals, not names */
+    unsigned unicode_percent;   /* names and words that are not ASCII */
+    int bytes;                  /* random bytes instead of statements */
+};
+
+static const struct mix mixes[] = {
+    { "balanced",    { 20, 30, 15, 10, 8, 12, 5 }, 8, 3, 3, 30, 0, 0 },
+    { "comments",    { 5, 5, 5, 2, 2, 41, 40 }, 24, 2, 3, 30, 0, 0 },
+    { "identifiers", { 15, 60, 5, 10, 10, 0, 0 }, 8, 8, 2, 5, 0, 0 },
+    { "numbers",     { 40, 45, 5, 5, 5, 0, 0 }, 8, 6, 2, 90, 0, 0 },
+    { "strings",     { 10, 10, 70, 5, 5, 0, 0 }, 8, 2, 12, 30, 0, 0 },
+    { "unicode",     { 20, 30, 15, 10, 8, 12, 5 }, 8, 3, 3, 30, 33, 0 },
+    { "bytes",       { 0 }, 0, 0, 0, 0, 0, 1 },
+};
+
+static const char *const words[] = {
+    "the", "value", "of", "count", "is", "updated", "here", "before",
+    "loop", "starts", "total", "result", "check", "bounds", "and", "index",
+    "return", "early", "when", "input", "empty", "otherwise", "keep", "going",
+    "note", "this", "may", "overflow", "for", "large", "sizes", "TODO",
+};
+
+static const char *const unicode_words[] = {
+    "größe", "café", "naïve", "значение", "пока", "値", "合計", "→",
+    "λόγος", "€", "✓", "çok", "für", "über", "ñandú", "ångström",
+};
+
+static const char *const syllables[] = {
+    "ba", "co", "de", "fi", "go", "hu", "ka", "lo", "ma", "ne", "pi", "ro",
+    "sa", "tu", "vi", "xe", "zo", "qu", "st", "tr", "cnt", "idx", "tmp", "val",
+};
+
+/* All XID_Start, so any of them may begin a name. */
+static const char *const unicode_syllables[] = {
+    "ä", "ö", "é", "ç", "ñ", "ß", "λ", "μ", "σ", "дом", "ключ", "名", "前",
+    "変", "数", "값",
+};
+
+static uint64_t rng_state;
+
+/* xorshift64*: fast, and the same sequence everywhere. */
+static uint64_t rng(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static unsigned below(unsigned n)
+{
+    return (unsigned) (rng() % n);
+}
+
+/* Around `typical`, never 0. */
+static unsigned around(unsigned typical)
+{
+    return 1 + below(2 * typical);
+}
+
+static char *out;
+static size_t out_len;
+static size_t out_capacity;
+static uint64_t written;
+
+static void flush(void)
+{
+    if (fwrite(out, 1, out_len, stdout) != out_len) {
+        perror("gen_corpus: writing corpus");
+        exit(1);
+    }
+    written += out_len;
+    out_len = 0;
+}
+
+static void put(const char *s, size_t len)
+{
+    if (out_len + len > out_capacity)
+        flush();
+    memcpy(out + out_len, s, len);
+    out_len += len;
+}
+
+static void put_str(const char *s)
+{
+    put(s, strlen(s));
+}
+
+static void indent(unsigned depth)
+{
+    static const char spaces[] = "                                ";
+    unsigned n = depth * 4;
+
+    put(spaces, n < sizeof spaces - 1 ? n : sizeof spaces - 1);
+}
+
+/* What the bytes mix mostly draws from: the characters of the operators
+ * and punctuation, comment and string delimiters, digits, name
+ * characters and line ends, so the lexer meets every kind of token and
+ * every way of cutting one short. */
+static const char token_bytes[] = "/*\"\n\n \t\r0123456789..=<>!+-;,{}()_azAZ";
+
+static void random_bytes(uint64_t size)
+{
+    while (written + out_len < size) {
+        unsigned pick = below(16);
+        char c;
+
+        if (pick < 9) {
+            c = token_bytes[below(sizeof token_bytes - 1)];
+            put(&c, 1);
+        } else if (pick < 11) {
+            put_str(syllables[below(sizeof syllables / sizeof *syllables)]);
+        } else if (pick < 12) {
+            put_str(unicode_syllables[below(sizeof unicode_syllables /
+                                            sizeof *unicode_syllables)]);
+        } else {
+            c = (char) below(256);
+            put(&c, 1);
+        }
+    }
+}
+
+static char names[NAME_POOL][32];
+
+static void make_names(const struct mix *mix)
+{
+    size_t i;
+
+    for (i = 0; i < NAME_POOL; i++) {
+        unsigned parts = 1 + below(3);
+        char *p = names[i];
+
+        if (below(8) == 0)
+            *p++ = '_';
+        while (parts--) {
+            const char *s;
+
+            if (mix->unicode_percent && below(100) < mix->unicode_percent)
+                s = unicode_syllables[below(sizeof unicode_syllables /
+                                            sizeof *unicode_syllables)];
+            else
+                s = syllables[below(sizeof syllables / sizeof *syllables)];
+
+            memcpy(p, s, strlen(s));
+            p += strlen(s);
+        }
+        if (below(3) == 0)
+            *p++ = (char) ('0' + below(10));
+        *p = '\0';
+    }
+}
+
+/* Skewed towards the front of the pool, as real code reuses a few names
+ * far more than the rest. */
+static void name(void)
+{
+    put_str(names[below(below(NAME_POOL) + 1)]);
+}
+
+static void number(void)
+{
+    char buf[32];
+    unsigned kind = below(20);
+
+    if (kind == 0)
+        snprintf(buf, sizeof buf, "%llu",
+                 (unsigned long long) (INT64_MAX - (rng() >> 40)));
+    else if (kind < 8)
+        snprintf(buf, sizeof buf, "%u.%u", below(1000), below(100000));
+    else if (kind < 12)
+        snprintf(buf, sizeof buf, "%llu",
+                 (unsigned long long) (rng() >> (below(60) + 4)));
+    else
+        snprintf(buf, sizeof buf, "%u", below(100));
+    put_str(buf);
+}
+
+static void sentence(const struct mix *mix, unsigned count)
+{
+    while (count--) {
+        if (mix->unicode_percent && below(100) < mix->unicode_percent)
+            put_str(unicode_words[below(sizeof unicode_words /
+                                        sizeof *unicode_words)]);
+        else
+            put_str(words[below(sizeof words / sizeof *words)]);
+        if (count)
+            put(" ", 1);
+    }
+}
+
+static void operand(const struct mix *mix)
+{
+    if (below(100) < mix->number_percent)
+        number();
+    else
+        name();
+}
+
+static void expression(const struct mix *mix)
+{
+    static const char *const ops[] = { " + ", " - ", " * ", " / " };
+    unsigned terms = around(mix->expr_terms);
+
+    operand(mix);
+    while (--terms) {
+        put_str(ops[below(4)]);
+        if (below(6) == 0) {
+            put("(", 1);
+            operand(mix);
+            put_str(ops[below(4)]);
+            operand(mix);
+            put(")", 1);
+        } else {
+            operand(mix);
+        }
+    }
+}
+
+static void condition(const struct mix *mix)
+{
+    static const char *const ops[] = {
+        " == ", " != ", " >= ", " <= ", " > ", " < "
+    };
+
+    name();
+    put_str(ops[below(6)]);
+    operand(mix);
+}
+
+static void statement(const struct mix *mix, unsigned depth);
+
+static void block(const struct mix *mix, unsigned depth)
+{
+    unsigned n = 1 + below(4);
+
+    put_str(" {\n");
+    while (n--)
+        statement(mix, depth + 1);
+    indent(depth);
+    put_str("}\n");
+}
+
+static void statement(const struct mix *mix, unsigned depth)
+{
+    static const char *const types[] = { "int", "float", "string" };
+    unsigned total = 0, pick, kind;
+
+    for (kind = 0; kind < STMT_KIND_COUNT; kind++)
+        total += mix->weight[kind];
+    pick = below(total);
+    for (kind = 0; pick >= mix->weight[kind]; kind++)
+        pick -= mix->weight[kind];
+    /* Keep nesting shallow so every statement kind stays reachable. */
+    if (depth > 3 && (kind == STMT_IF || kind == STMT_FOR))
+        kind = STMT_ASSIGN;
+
+    indent(depth);
+    switch ((enum stmt) kind) {
+    case STMT_DECL:
+        put_str(types[below(3)]);
+        put(" ", 1);
+        name();
+        put_str(" = ");
+        expression(mix);
+        put_str(";\n");
+        break;
+    case STMT_ASSIGN:
+        name();
+        put_str(" = ");
+        expression(mix);
+        put_str(";\n");
+        break;
+    case STMT_PRINT:
+        put_str("print(");
+        if (below(4) == 0) {
+            name();
+        } else {
+            put("\"", 1);
+            sentence(mix, around(mix->string_words));
+            put("\"", 1);
+        }
+        put_str(");\n");
+        break;
+    case STMT_IF:
+        put_str("if (");
+        condition(mix);
+        put(")", 1);
+        block(mix, depth);
+        if (below(2)) {
+            indent(depth);
+            put_str("else");
+            block(mix, depth);
+        }
+        break;
+    case STMT_FOR:
+        put_str("for (");
+        name();
+        put_str(" = 0; ");
+        condition(mix);
+        put_str("; ");
+        name();
+        put_str(" = ");
+        name();
+        put_str(" + 1)");
+        block(mix, depth);
+        break;
+    case STMT_LINE_COMMENT:
+        put_str("// ");
+        sentence(mix, around(mix->comment_words));
+        put("\n", 1);
+        break;
+    case STMT_BLOCK_COMMENT:
+        put_str("/* ");
+        sentence(mix, around(mix->comment_words));
+        if (below(2)) {
+            put("\n", 1);
+            indent(depth);
+            put_str(" * ");
+            sentence(mix, around(mix->comment_words));
+            put("\n", 1);
+            indent(depth);
+        } else {
+            put(" ", 1);
+        }
+        put_str("*/\n");
+        break;
+    case STMT_KIND_COUNT:
+        break;
+    }
+}
+
+static int parse_size(const char *s, uint64_t *size)
+{
+    char *end;
+    unsigned long long n = strtoull(s, &end, 10);
+
+    switch (*end) {
+    case 'g': case 'G': n <<= 10; /* fall through */
+    case 'm': case 'M': n <<= 10; /* fall through */
+    case 'k': case 'K': n <<= 10; end++; break;
+    }
+    if (end == s || *end != '\0' || n == 0)
+        return -1;
+    *size = n;
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: gen_corpus [--mix=balanced|comments|identifiers"
+                    "|numbers|strings|unicode|bytes] [--seed=N] SIZE\n");
+}
+
+int main(int argc, char **argv)
+{
+    const struct mix *mix = &mixes[0];
+    uint64_t size = 0;
+    uint64_t seed = 1;
+    unsigned function = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--mix=", 6) == 0) {
+            size_t m;
+
+            for (m = 0; m < sizeof mixes / sizeof *mixes; m++) {
+                if (strcmp(argv[i] + 6, mixes[m].name) == 0)
+                    break;
+            }
+            if (m == sizeof mixes / sizeof *mixes) {
+                usage();
+                return 2;
+            }
+            mix = &mixes[m];
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (size == 0 && parse_size(argv[i], &size) == 0) {
+            continue;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (size == 0) {
+        usage();
+        return 2;
+    }
+
+    out_capacity = 1 << 16;
+    out = malloc(out_capacity);
+    if (!out) {
+        fprintf(stderr, "gen_corpus: out of memory\n");
+        return 1;
+    }
+    rng_state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    make_names(mix);
+
+    if (mix->bytes)
+        random_bytes(size);
+    while (written + out_len < size) {
+        unsigned n = 4 + below(12);
+
+        if (function++ > 0)
+            put("\n", 1);
+        put_str("int ");
+        name();
+        put_str(" {\n");
+        while (n-- && written + out_len < size)
+            statement(mix, 1);
+        put_str("}\n");
+    }
+    flush();
+    free(out);
+    if (fflush(stdout) != 0) {
+        perror("gen_corpus: writing corpus");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# Writes xid_table.h, the XID_Start / XID_Continue bitmaps utf8.c looks
+# identifier characters up in, from the Unicode database Python was built
+# with:
+#
+#   python3 gen_xid.py > xid_table.h
+#
+# Code points are split into pages of 256; xid_page maps a page to one of
+# the distinct bitmaps in xid_bits, 32 bytes of XID_Start followed by 32 of
+# XID_Continue.  Most pages are all clear or all set, so the whole table is
+# about 11 KB.
+
+import sys
+import unicodedata
+
+PAGE = 256
+
+
+def is_start(c):
+    # str.isidentifier() is XID_Start plus '_' for the first character
+    return c != 0x5F and chr(c).isidentifier()
+
+
+def is_continue(c):
+    return ("a" + chr(c)).isidentifier()
+
+
+def bitmap(page, test):
+    out = bytearray(PAGE // 8)
+    for i in range(PAGE):
+        c = page * PAGE + i
+        if not 0xD800 <= c < 0xE000 and test(c):
+            out[i >> 3] |= 1 << (i & 7)
+    return bytes(out)
+
+
+def main():
+    pages = 0x110000 // PAGE
+    while pages > 0 and not any(bitmap(pages - 1, is_continue)):
+        pages -= 1
+    index = []
+    bits = {}
+    for page in range(pages):
+        key = bitmap(page, is_start) + bitmap(page, is_continue)
+        index.append(bits.setdefault(key, len(bits)))
+    if len(bits) > 256:
+        sys.exit("gen_xid.py: too many distinct pages for a byte index")
+
+    w = sys.stdout.write
+    w("/* Generated by gen_xid.py from Unicode %s; do not edit. */\n\n"
+      % unicodedata.unidata_version)
+    w("#define XID_PAGES %d\n\n" % pages)
+    w("static const unsigned char xid_page[XID_PAGES] = {\n")
+    for i in range(0, len(index), 16):
+        w("    " + ", ".join("%3d" % n for n in index[i:i + 16]) + ",\n")
+    w("};\n\n")
+    w("static const unsigned char xid_bits[%d][%d] = {\n"
+      % (len(bits), 2 * PAGE // 8))
+    for key in bits:
+        w("    {\n")
+        for i in range(0, len(key), 16):
+            w("        " + ", ".join("0x%02x" % b for b in key[i:i + 16])
+              + ",\n")
+        w("    },\n")
+    w("};\n")
+
+
+main()
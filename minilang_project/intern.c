@@ -0,0 +1,215 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+#define SHARD_BITS      6
+#define SHARD_COUNT     (1u << SHARD_BITS)
+
+/* Symbols are numbered globally and looked up through a two-level table,
+ * so a page never moves once it is published. */
+#define PAGE_BITS       14
+#define PAGE_SIZE       (1u << PAGE_BITS)
+#define PAGE_COUNT      (1u << (32 - PAGE_BITS))
+
+#define ARENA_BLOCK     65536
+
+struct symbol {
+    const char *name;
+    uint32_t len;
+    uint32_t hash;
+};
+
+/* Open-addressing slot; id is SYMBOL_NONE when the slot is empty. */
+struct slot {
+    uint32_t hash;
+    uint32_t id;
+};
+
+struct shard {
+    pthread_mutex_t lock;
+    struct slot *slots;
+    size_t mask;
+    size_t used;
+    char *arena;
+    size_t arena_left;
+};
+
+static struct shard shards[SHARD_COUNT];
+static pthread_once_t shards_once = PTHREAD_ONCE_INIT;
+
+static _Atomic(struct symbol *) pages[PAGE_COUNT];
+static pthread_mutex_t pages_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_uint next_id = 1;
+
+static void out_of_memory(void)
+{
+    fprintf(stderr, "minilang: out of memory for symbol table\n");
+    exit(1);
+}
+
+static void init_shards(void)
+{
+    size_t i;
+
+    for (i = 0; i < SHARD_COUNT; i++)
+        pthread_mutex_init(&shards[i].lock, NULL);
+}
+
+/* FNV-1a; names are short, so a byte loop is as fast as anything. */
+static uint32_t hash_bytes(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char) s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static struct symbol *symbol_at(uint32_t id)
+{
+    return &atomic_load_explicit(&pages[id >> PAGE_BITS],
+                                 memory_order_acquire)[id & (PAGE_SIZE - 1)];
+}
+
+/* Entry for a freshly allocated id, publishing its page if needed. */
+static struct symbol *new_symbol(uint32_t id)
+{
+    _Atomic(struct symbol *) *page = &pages[id >> PAGE_BITS];
+
+    if (!atomic_load_explicit(page, memory_order_acquire)) {
+        pthread_mutex_lock(&pages_lock);
+        if (!atomic_load_explicit(page, memory_order_relaxed)) {
+            struct symbol *p = calloc(PAGE_SIZE, sizeof *p);
+
+            if (!p)
+                out_of_memory();
+            atomic_store_explicit(page, p, memory_order_release);
+        }
+        pthread_mutex_unlock(&pages_lock);
+    }
+    return symbol_at(id);
+}
+
+static const char *arena_copy(struct shard *sh, const char *s, size_t len)
+{
+    char *p;
+
+    if (len + 1 > sh->arena_left) {
+        size_t size = len + 1 > ARENA_BLOCK ? len + 1 : ARENA_BLOCK;
+
+        sh->arena = malloc(size);
+        if (!sh->arena)
+            out_of_memory();
+        sh->arena_left = size;
+    }
+    p = sh->arena;
+    memcpy(p, s, len);
+    p[len] = '\0';
+    sh->arena += len + 1;
+    sh->arena_left -= len + 1;
+    return p;
+}
+
+static void grow(struct shard *sh)
+{
+    size_t size = sh->slots ? (sh->mask + 1) * 2 : 64;
+    struct slot *slots = calloc(size, sizeof *slots);
+    size_t i;
+
+    if (!slots)
+        out_of_memory();
+    for (i = 0; sh->slots && i <= sh->mask; i++) {
+        size_t j = sh->slots[i].hash & (size - 1);
+
+        if (sh->slots[i].id == SYMBOL_NONE)
+            continue;
+        while (slots[j].id != SYMBOL_NONE)
+            j = (j + 1) & (size - 1);
+        slots[j] = sh->slots[i];
+    }
+    free(sh->slots);
+    sh->slots = slots;
+    sh->mask = size - 1;
+}
+
+static uint32_t intern_hashed(const char *s, size_t len, uint32_t hash)
+{
+    struct shard *sh = &shards[hash >> (32 - SHARD_BITS)];
+    struct symbol *sym;
+    uint32_t id;
+    size_t i;
+
+    pthread_once(&shards_once, init_shards);
+    pthread_mutex_lock(&sh->lock);
+    if (!sh->slots)
+        grow(sh);
+    for (i = hash & sh->mask; sh->slots[i].id != SYMBOL_NONE;
+         i = (i + 1) & sh->mask) {
+        if (sh->slots[i].hash != hash)
+            continue;
+        sym = symbol_at(sh->slots[i].id);
+        if (sym->len == len && memcmp(sym->name, s, len) == 0) {
+            id = sh->slots[i].id;
+            pthread_mutex_unlock(&sh->lock);
+            return id;
+        }
+    }
+
+    id = atomic_fetch_add_explicit(&next_id, 1, memory_order_relaxed);
+    if (id == SYMBOL_NONE) {
+        fprintf(stderr, "minilang: too many distinct symbols\n");
+        exit(1);
+    }
+    sym = new_symbol(id);
+    sym->name = arena_copy(sh, s, len);
+    sym->len = (uint32_t) len;
+    sym->hash = hash;
+    sh->slots[i].hash = hash;
+    sh->slots[i].id = id;
+    if (++sh->used * 2 > sh->mask + 1)
+        grow(sh);
+    pthread_mutex_unlock(&sh->lock);
+    return id;
+}
+
+uint32_t intern(const char *s, size_t len)
+{
+    return intern_hashed(s, len, hash_bytes(s, len));
+}
+
+uint32_t intern_cached(struct intern_cache *cache, const char *s, size_t len)
+{
+    uint32_t hash = hash_bytes(s, len);
+    size_t i = hash & (INTERN_CACHE_SIZE - 1);
+
+    if (cache->id[i] != SYMBOL_NONE && cache->hash[i] == hash) {
+        const struct symbol *sym = symbol_at(cache->id[i]);
+
+        if (sym->len == len && memcmp(sym->name, s, len) == 0)
+            return cache->id[i];
+    }
+    cache->hash[i] = hash;
+    cache->id[i] = intern_hashed(s, len, hash);
+    return cache->id[i];
+}
+
+const char *symbol_name(uint32_t id, size_t *len)
+{
+    const struct symbol *sym = symbol_at(id);
+
+    if (len)
+        *len = sym->len;
+    return sym->name;
+}
+
+uint32_t symbol_count(void)
+{
+    return atomic_load_explicit(&next_id, memory_order_relaxed) - 1;
+}
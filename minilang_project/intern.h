@@ -0,0 +1,43 @@
+#ifndef MINILANG_INTERN_H
+#define MINILANG_INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Process-wide string interner.
+ *
+ * intern() maps a byte string to a 32-bit symbol id; equal strings always
+ * get the same id, so later phases compare names as integers.  Ids are
+ * dense and start at 1 (SYMBOL_NONE is never handed out).  With several
+ * lexer threads the order in which ids are assigned depends on
+ * scheduling, so an id is only meaningful within one process.
+ *
+ * The table is split into shards, each an open-addressing hash table with
+ * its own lock; the bytes of every distinct string are copied once into
+ * the shard's arena, NUL-terminated, and live until the process exits.
+ * All functions are safe to call from any thread. */
+
+#define SYMBOL_NONE 0
+
+uint32_t intern(const char *s, size_t len);
+
+/* Text of a symbol.  `id` must have come from intern() (in this thread,
+ * or handed over with the usual synchronisation). */
+const char *symbol_name(uint32_t id, size_t *len);
+
+/* Number of symbols interned so far. */
+uint32_t symbol_count(void);
+
+/* Small per-thread front cache, so that lexing `i` for the thousandth time
+ * costs a hash and a compare instead of a lock.  Zero-initialise before
+ * use; a cache must not be shared between threads. */
+#define INTERN_CACHE_SIZE 256
+
+struct intern_cache {
+    uint32_t hash[INTERN_CACHE_SIZE];
+    uint32_t id[INTERN_CACHE_SIZE];
+};
+
+uint32_t intern_cached(struct intern_cache *cache, const char *s, size_t len);
+
+#endif
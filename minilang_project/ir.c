@@ -0,0 +1,644 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "IR"
+#include "alloc.h"
+
+#include "intern.h"
+#include "ir.h"
+#include "number.h"
+
+const char *const ir_op_names[IR_OP_COUNT] = {
+#define IR_OP_NAME(name, text, arity) text,
+    IR_OPS(IR_OP_NAME)
+#undef IR_OP_NAME
+};
+
+const unsigned char ir_op_arity[IR_OP_COUNT] = {
+#define IR_OP_ARITY(name, text, arity) arity,
+    IR_OPS(IR_OP_ARITY)
+#undef IR_OP_ARITY
+};
+
+static void grow(struct ir_func *f)
+{
+    uint32_t n = f->capacity ? f->capacity * 2 : 256;
+
+    f->op = xrealloc(f->op, n);
+    f->type = xrealloc(f->type, n);
+    f->a = xrealloc(f->a, n * sizeof *f->a);
+    f->b = xrealloc(f->b, n * sizeof *f->b);
+    f->block = xrealloc(f->block, n * sizeof *f->block);
+    f->next = xrealloc(f->next, n * sizeof *f->next);
+    f->prev = xrealloc(f->prev, n * sizeof *f->prev);
+    f->offset = xrealloc(f->offset, n * sizeof *f->offset);
+    f->capacity = n;
+}
+
+uint32_t ir_new(struct ir_func *f, enum ir_op op, enum type type, uint32_t a,
+                uint32_t b, uint32_t offset)
+{
+    uint32_t n;
+
+    if (f->count + 1 >= f->capacity)
+        grow(f);
+    if (f->count == 0) {
+        /* number 0 is IR_NONE: no instruction, in no block */
+        f->op[0] = IR_CONST;
+        f->type[0] = TYPE_NONE;
+        f->a[0] = f->b[0] = f->block[0] = f->next[0] = f->prev[0] = 0;
+        f->offset[0] = 0;
+        f->count = 1;
+    }
+    n = f->count++;
+    f->op[n] = (uint8_t) op;
+    f->type[n] = (uint8_t) type;
+    f->a[n] = a;
+    f->b[n] = b;
+    f->block[n] = IR_NONE;
+    f->next[n] = IR_NONE;
+    f->prev[n] = IR_NONE;
+    f->offset[n] = offset;
+    return n;
+}
+
+uint32_t ir_reserve_args(struct ir_func *f, uint32_t count)
+{
+    uint32_t start = f->arg_count;
+
+    if (f->arg_count + count > f->arg_capacity) {
+        while (f->arg_count + count > f->arg_capacity)
+            f->arg_capacity = f->arg_capacity ? f->arg_capacity * 2 : 256;
+        f->args = xrealloc(f->args, f->arg_capacity * sizeof *f->args);
+    }
+    memset(f->args + start, 0, count * sizeof *f->args);
+    f->arg_count += count;
+    return start;
+}
+
+uint32_t ir_new_phi(struct ir_func *f, uint32_t block, enum type type)
+{
+    uint32_t count = f->blocks[block].pred_count;
+    uint32_t phi = ir_new(f, IR_PHI, type, ir_reserve_args(f, count), count,
+                          0);
+
+    ir_prepend(f, block, phi);
+    return phi;
+}
+
+void ir_append(struct ir_func *f, uint32_t block, uint32_t insn)
+{
+    struct ir_block *b = &f->blocks[block];
+
+    f->block[insn] = block;
+    f->prev[insn] = b->last;
+    f->next[insn] = IR_NONE;
+    if (b->last)
+        f->next[b->last] = insn;
+    else
+        b->first = insn;
+    b->last = insn;
+    f->live++;
+}
+
+void ir_prepend(struct ir_func *f, uint32_t block, uint32_t insn)
+{
+    struct ir_block *b = &f->blocks[block];
+
+    f->block[insn] = block;
+    f->prev[insn] = IR_NONE;
+    f->next[insn] = b->first;
+    if (b->first)
+        f->prev[b->first] = insn;
+    else
+        b->last = insn;
+    b->first = insn;
+    f->live++;
+}
+
+void ir_insert_after(struct ir_func *f, uint32_t after, uint32_t insn)
+{
+    uint32_t block = f->block[after];
+
+    f->block[insn] = block;
+    f->prev[insn] = after;
+    f->next[insn] = f->next[after];
+    if (f->next[after])
+        f->prev[f->next[after]] = insn;
+    else
+        f->blocks[block].last = insn;
+    f->next[after] = insn;
+    f->live++;
+}
+
+void ir_insert_before(struct ir_func *f, uint32_t before, uint32_t insn)
+{
+    uint32_t block = f->block[before];
+
+    f->block[insn] = block;
+    f->next[insn] = before;
+    f->prev[insn] = f->prev[before];
+    if (f->prev[before])
+        f->next[f->prev[before]] = insn;
+    else
+        f->blocks[block].first = insn;
+    f->prev[before] = insn;
+    f->live++;
+}
+
+void ir_unlink(struct ir_func *f, uint32_t insn)
+{
+    struct ir_block *b = &f->blocks[f->block[insn]];
+
+    if (f->prev[insn])
+        f->next[f->prev[insn]] = f->next[insn];
+    else
+        b->first = f->next[insn];
+    if (f->next[insn])
+        f->prev[f->next[insn]] = f->prev[insn];
+    else
+        b->last = f->prev[insn];
+    f->block[insn] = IR_NONE;
+    f->next[insn] = IR_NONE;
+    f->prev[insn] = IR_NONE;
+    f->live--;
+}
+
+void ir_delete(struct ir_func *f, uint32_t insn)
+{
+    ir_unlink(f, insn);
+}
+
+uint32_t ir_const(struct ir_func *f, enum type type, uint64_t bits)
+{
+    uint32_t insn = ir_new(f, IR_CONST, type, (uint32_t) bits,
+                           (uint32_t) (bits >> 32), 0);
+
+    ir_prepend(f, IR_ENTRY, insn);
+    return insn;
+}
+
+uint32_t ir_new_block(struct ir_func *f)
+{
+    struct ir_block *b;
+    uint32_t n, last;
+
+    if (f->block_count == f->block_capacity) {
+        f->block_capacity = f->block_capacity ? f->block_capacity * 2 : 64;
+        f->blocks = xrealloc(f->blocks,
+                             f->block_capacity * sizeof *f->blocks);
+    }
+    if (f->block_count == 0) {
+        memset(&f->blocks[0], 0, sizeof f->blocks[0]);
+        f->block_count = 1;
+    }
+    n = f->block_count++;
+    b = &f->blocks[n];
+    memset(b, 0, sizeof *b);
+    /* the end of the layout is the prev of block 0 */
+    last = f->blocks[0].prev;
+    b->prev = last;
+    f->blocks[last].next = n;
+    f->blocks[0].prev = n;
+    return n;
+}
+
+void ir_add_edge(struct ir_func *f, uint32_t from, uint32_t to)
+{
+    struct ir_block *b = &f->blocks[to];
+
+    f->blocks[from].succ[f->blocks[from].succ_count++] = to;
+    if (b->pred_count == b->pred_capacity) {
+        b->pred_capacity = b->pred_capacity ? b->pred_capacity * 2 : 2;
+        b->preds = xrealloc(b->preds, b->pred_capacity * sizeof *b->preds);
+    }
+    b->preds[b->pred_count++] = from;
+}
+
+/* Drops predecessor `index` of a block, and the operand of each phi that
+ * came in from it. */
+void ir_remove_pred(struct ir_func *f, uint32_t block, uint32_t index)
+{
+    struct ir_block *b = &f->blocks[block];
+    uint32_t insn;
+
+    for (insn = b->first; insn && f->op[insn] == IR_PHI;
+         insn = f->next[insn]) {
+        uint32_t *args = f->args + f->a[insn];
+
+        memmove(args + index, args + index + 1,
+                (f->b[insn] - index - 1) * sizeof *args);
+        f->b[insn]--;
+    }
+    memmove(b->preds + index, b->preds + index + 1,
+            (b->pred_count - index - 1) * sizeof *b->preds);
+    b->pred_count--;
+}
+
+uint32_t ir_pred_index(const struct ir_func *f, uint32_t block,
+                       uint32_t pred)
+{
+    const struct ir_block *b = &f->blocks[block];
+    uint32_t i;
+
+    for (i = 0; i < b->pred_count; i++)
+        if (b->preds[i] == pred)
+            break;
+    return i;
+}
+
+/* Deletes a block that nothing jumps to any more, and its edges out. */
+void ir_delete_block(struct ir_func *f, uint32_t block)
+{
+    struct ir_block *b = &f->blocks[block];
+    uint32_t k;
+
+    while (b->first)
+        ir_delete(f, b->first);
+    for (k = 0; k < b->succ_count; k++) {
+        uint32_t s = b->succ[k];
+
+        if (!f->blocks[s].dead)
+            ir_remove_pred(f, s, ir_pred_index(f, s, block));
+    }
+    b->succ_count = 0;
+    f->blocks[b->prev].next = b->next;
+    f->blocks[b->next].prev = b->prev;
+    b->dead = 1;
+}
+
+void ir_layout_before(struct ir_func *f, uint32_t block, uint32_t before)
+{
+    struct ir_block *b = &f->blocks[block];
+
+    f->blocks[b->prev].next = b->next;
+    f->blocks[b->next].prev = b->prev;
+    b->next = before;
+    b->prev = f->blocks[before].prev;
+    f->blocks[b->prev].next = block;
+    f->blocks[before].prev = block;
+}
+
+uint32_t ir_split_edge(struct ir_func *f, uint32_t from, uint32_t to)
+{
+    uint32_t block = ir_new_block(f);
+    struct ir_block *b = &f->blocks[block];
+    struct ir_block *src = &f->blocks[from];
+    uint32_t k;
+
+    for (k = 0; k < src->succ_count; k++)
+        if (src->succ[k] == to)
+            src->succ[k] = block;
+    f->blocks[to].preds[ir_pred_index(f, to, from)] = block;
+    b->preds = xrealloc(NULL, 2 * sizeof *b->preds);
+    b->preds[0] = from;
+    b->pred_count = 1;
+    b->pred_capacity = 2;
+    b->succ[0] = to;
+    b->succ_count = 1;
+    ir_append(f, block, ir_new(f, IR_JMP, TYPE_NONE, IR_NONE, IR_NONE, 0));
+    ir_layout_before(f, block, to);
+    return block;
+}
+
+static void func_free(struct ir_func *f)
+{
+    uint32_t i;
+
+    for (i = 1; i < f->block_count; i++)
+        free(f->blocks[i].preds);
+    free(f->blocks);
+    free(f->args);
+    free(f->op);
+    free(f->type);
+    free(f->a);
+    free(f->b);
+    free(f->block);
+    free(f->next);
+    free(f->prev);
+    free(f->offset);
+}
+
+void ir_program_free(struct ir_program *ir)
+{
+    uint32_t i;
+
+    for (i = 0; i < ir->count; i++)
+        func_free(&ir->funcs[i]);
+    free(ir->funcs);
+    ir->funcs = NULL;
+    ir->count = 0;
+}
+
+uint64_t ir_program_size(const struct ir_program *ir)
+{
+    uint64_t n = 0;
+    uint32_t i;
+
+    for (i = 0; i < ir->count; i++)
+        n += ir->funcs[i].live;
+    return n;
+}
+
+uint32_t ir_rpo(const struct ir_func *f, uint32_t *order)
+{
+    uint32_t *stack = xrealloc(NULL, f->block_count * sizeof *stack);
+    uint32_t *edge = xrealloc(NULL, f->block_count * sizeof *edge);
+    unsigned char *seen = xcalloc(f->block_count, 1);
+    uint32_t depth = 0, n = 0, i;
+
+    /* postorder, by an explicit stack of blocks and their next edge */
+    stack[depth] = IR_ENTRY;
+    edge[depth++] = 0;
+    seen[IR_ENTRY] = 1;
+    while (depth) {
+        const struct ir_block *b = &f->blocks[stack[depth - 1]];
+
+        if (edge[depth - 1] < b->succ_count) {
+            uint32_t s = b->succ[edge[depth - 1]++];
+
+            if (!seen[s]) {
+                seen[s] = 1;
+                stack[depth] = s;
+                edge[depth++] = 0;
+            }
+        } else {
+            order[n++] = stack[--depth];
+        }
+    }
+    for (i = 0; i < n / 2; i++) {
+        uint32_t t = order[i];
+
+        order[i] = order[n - 1 - i];
+        order[n - 1 - i] = t;
+    }
+    free(seen);
+    free(edge);
+    free(stack);
+    return n;
+}
+
+/* Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm": the
+ * immediate dominators, by iterating over the blocks in reverse postorder
+ * until nothing changes, which for code made from structured statements
+ * is two passes. */
+void ir_dominators(const struct ir_func *f, const uint32_t *rpo, uint32_t n,
+                   struct ir_dom *dom)
+{
+    size_t size = f->block_count * sizeof(uint32_t);
+    uint32_t *number = xrealloc(NULL, size);
+    uint32_t *stack = xrealloc(NULL, size);
+    uint32_t i, k, b, depth, counter;
+    int changed = 1;
+
+    dom->idom = xrealloc(NULL, size);
+    dom->pre = xrealloc(NULL, size);
+    dom->post = xrealloc(NULL, size);
+    dom->child = xrealloc(NULL, size);
+    dom->sibling = xrealloc(NULL, size);
+    for (i = 0; i < f->block_count; i++) {
+        number[i] = UINT32_MAX;
+        dom->idom[i] = IR_NONE;
+        dom->pre[i] = IR_NONE;
+        dom->post[i] = IR_NONE;
+        dom->child[i] = IR_NONE;
+        dom->sibling[i] = IR_NONE;
+    }
+    for (i = 0; i < n; i++)
+        number[rpo[i]] = i;
+    dom->idom[rpo[0]] = rpo[0];
+    while (changed) {
+        changed = 0;
+        for (i = 1; i < n; i++) {
+            const struct ir_block *blk = &f->blocks[rpo[i]];
+            uint32_t idom = IR_NONE;
+
+            for (k = 0; k < blk->pred_count; k++) {
+                uint32_t p = blk->preds[k];
+
+                if (number[p] == UINT32_MAX || !dom->idom[p])
+                    continue;
+                if (!idom) {
+                    idom = p;
+                    continue;
+                }
+                while (p != idom) {
+                    while (number[p] > number[idom])
+                        p = dom->idom[p];
+                    while (number[idom] > number[p])
+                        idom = dom->idom[idom];
+                }
+            }
+            if (dom->idom[rpo[i]] != idom) {
+                dom->idom[rpo[i]] = idom;
+                changed = 1;
+            }
+        }
+    }
+
+    /* the tree, children in reverse postorder, and its numbering */
+    for (i = n; i-- > 1;) {
+        b = rpo[i];
+        dom->sibling[b] = dom->child[dom->idom[b]];
+        dom->child[dom->idom[b]] = b;
+    }
+    depth = 0;
+    counter = 1;
+    stack[depth++] = rpo[0];
+    dom->pre[rpo[0]] = counter++;
+    number[rpo[0]] = dom->child[rpo[0]];
+    /* number[] now holds the next child of each block to go down to */
+    while (depth) {
+        uint32_t c;
+
+        b = stack[depth - 1];
+        c = number[b];
+        if (c) {
+            number[b] = dom->sibling[c];
+            number[c] = dom->child[c];
+            dom->pre[c] = counter++;
+            stack[depth++] = c;
+        } else {
+            dom->post[b] = counter++;
+            depth--;
+        }
+    }
+    free(stack);
+    free(number);
+}
+
+void ir_dom_free(struct ir_dom *dom)
+{
+    free(dom->idom);
+    free(dom->pre);
+    free(dom->post);
+    free(dom->child);
+    free(dom->sibling);
+}
+
+static void broken(const struct ir_func *f, uint32_t block, uint32_t insn,
+                   const char *what)
+{
+    fprintf(stderr, "minilang: IR check failed: %s at b%lu v%lu\n", what,
+            (unsigned long) block, (unsigned long) insn);
+    ir_print_func(stderr, f);
+    abort();
+}
+
+void ir_verify(const struct ir_func *f)
+{
+    uint32_t block, insn, k, n, v;
+
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        const struct ir_block *b = &f->blocks[block];
+
+        if (b->dead)
+            broken(f, block, 0, "deleted block in the layout");
+        if (!b->last || f->op[b->last] < IR_JMP)
+            broken(f, block, b->last, "block without a terminator");
+        if (b->succ_count != (f->op[b->last] == IR_BR ? 2u :
+                              f->op[b->last] == IR_JMP ? 1u : 0u))
+            broken(f, block, b->last, "successors unlike the terminator");
+        for (k = 0; k < b->succ_count; k++)
+            if (ir_pred_index(f, b->succ[k], block) ==
+                f->blocks[b->succ[k]].pred_count)
+                broken(f, block, 0, "successor without it as a pred");
+        for (k = 0; k < b->pred_count; k++) {
+            const struct ir_block *p = &f->blocks[b->preds[k]];
+
+            if (p->dead || (p->succ[0] != block &&
+                            (p->succ_count < 2 || p->succ[1] != block)))
+                broken(f, block, 0, "pred without it as a successor");
+        }
+        for (insn = b->first; insn; insn = f->next[insn]) {
+            if (f->block[insn] != block)
+                broken(f, block, insn, "instruction in the wrong block");
+            if (f->next[insn] ? f->prev[f->next[insn]] != insn :
+                b->last != insn)
+                broken(f, block, insn, "broken instruction list");
+            if (f->op[insn] == IR_PHI &&
+                (f->b[insn] != b->pred_count ||
+                 (f->prev[insn] && f->op[f->prev[insn]] != IR_PHI)))
+                broken(f, block, insn, "misplaced phi");
+            if (f->op[insn] >= IR_JMP && insn != b->last)
+                broken(f, block, insn, "terminator before the end");
+            if (f->op[insn] == IR_CONST && block != IR_ENTRY)
+                broken(f, block, insn, "constant outside the entry");
+            n = ir_operand_count(f, insn);
+            for (k = 0; k < n; k++) {
+                v = *ir_operand((struct ir_func *) f, insn, k);
+                if (!v || v >= f->count || !f->block[v] ||
+                    f->op[v] >= IR_PRINT)
+                    broken(f, block, insn, "operand that is no value");
+            }
+        }
+    }
+}
+
+static void print_value(FILE *out, uint32_t v)
+{
+    fprintf(out, "v%lu", (unsigned long) v);
+}
+
+static void print_const(FILE *out, const struct ir_func *f, uint32_t insn)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+    uint64_t bits = ir_const_bits(f, insn);
+    const char *text;
+    size_t len;
+    double d;
+
+    switch (f->type[insn]) {
+    case TYPE_INT:
+        fprintf(out, "%lld", (long long) (int64_t) bits);
+        break;
+    case TYPE_FLOAT:
+        memcpy(&d, &bits, sizeof d);
+        number_format(buf, d);
+        fputs(buf, out);
+        break;
+    default:
+        text = symbol_name(f->a[insn], &len);
+        fprintf(out, "\"%.*s\"", (int) len, text);
+        break;
+    }
+}
+
+static void print_insn(FILE *out, const struct ir_func *f, uint32_t insn)
+{
+    const struct ir_block *b = &f->blocks[f->block[insn]];
+    enum ir_op op = (enum ir_op) f->op[insn];
+    uint32_t k, n;
+
+    fputs("    ", out);
+    if (op < IR_PRINT) {
+        print_value(out, insn);
+        fprintf(out, " = %s %s ", ir_op_names[op], type_names[f->type[insn]]);
+    } else {
+        fprintf(out, "%s ", ir_op_names[op]);
+    }
+    switch (op) {
+    case IR_CONST:
+        print_const(out, f, insn);
+        break;
+    case IR_PHI:
+        for (k = 0; k < f->b[insn]; k++) {
+            fprintf(out, "%s[b%lu: ", k ? ", " : "",
+                    (unsigned long) b->preds[k]);
+            print_value(out, f->args[f->a[insn] + k]);
+            fputc(']', out);
+        }
+        break;
+    case IR_JMP:
+        fprintf(out, "b%lu", (unsigned long) b->succ[0]);
+        break;
+    case IR_BR:
+        print_value(out, f->a[insn]);
+        fprintf(out, ", b%lu, b%lu", (unsigned long) b->succ[0],
+                (unsigned long) b->succ[1]);
+        break;
+    default:
+        n = ir_op_arity[op];
+        for (k = 0; k < n; k++) {
+            if (k)
+                fputs(", ", out);
+            print_value(out, k ? f->b[insn] : f->a[insn]);
+        }
+        break;
+    }
+    fputc('\n', out);
+}
+
+void ir_print_func(FILE *out, const struct ir_func *f)
+{
+    uint32_t block, insn, k;
+    const char *name;
+    size_t len;
+
+    if (f->name) {
+        name = symbol_name(f->name, &len);
+        fprintf(out, "function %.*s: %lu instructions\n", (int) len, name,
+                (unsigned long) f->live);
+    } else {
+        fprintf(out, "top: %lu instructions\n", (unsigned long) f->live);
+    }
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        const struct ir_block *b = &f->blocks[block];
+
+        fprintf(out, "  b%lu:", (unsigned long) block);
+        for (k = 0; k < b->pred_count; k++)
+            fprintf(out, "%s b%lu", k ? "," : "  preds",
+                    (unsigned long) b->preds[k]);
+        fputc('\n', out);
+        for (insn = b->first; insn; insn = f->next[insn])
+            print_insn(out, f, insn);
+    }
+}
+
+void ir_print(FILE *out, const struct ir_program *ir)
+{
+    uint32_t i;
+
+    for (i = 0; i < ir->count; i++)
+        ir_print_func(out, &ir->funcs[i]);
+}
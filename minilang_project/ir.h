@@ -0,0 +1,258 @@
+#ifndef MINILANG_IR_H
+#define MINILANG_IR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ast.h"
+#include "check.h"
+
+/* SSA intermediate representation: what the optimizer (opt.h) works on
+ * and what the backends compile, built from a checked tree.
+ *
+ * A function is a graph of basic blocks, each a list of instructions that
+ * ends in a jump, a branch or a return.  Every instruction that has a
+ * result is that value: instructions and values share their numbers, and
+ * an operand is the number of the instruction that computed it.  Each
+ * value is assigned once, where it is computed; where control flow
+ * merges, a phi at the top of the block picks the value that came in
+ * through each predecessor, its operands in the order of the block's
+ * preds[].  Variables are gone: they only name values while the tree is
+ * translated (see ir_build()).
+ *
+ * Like the tree, instructions are parallel arrays indexed by number, and
+ * number 0 (IR_NONE) is no instruction.  The instructions of a block are
+ * a doubly linked list through next[] and prev[], phis first and the
+ * terminator last, so a pass inserts and deletes in place; a deleted
+ * instruction keeps its number, with block[] set to IR_NONE.  The
+ * operands of the other instructions are a[] and b[], those of a phi in
+ * args[], from a[] on, b[] of them.  Constants are all in the entry
+ * block, so they dominate every use and no pass has to move them; the
+ * value of one is in a[] (the low 32 bits) and b[] (the high), or for a
+ * string, the symbol of its text in a[].
+ *
+ * type[] is the type of the result: int for comparisons, the type of the
+ * operands (which is type[] of either) for the rest, string for `+` of
+ * two strings.  Converting between int and float takes an i2f or f2i.
+ * rem is `a - a / b * b`, the one way the language has to write a
+ * remainder, made into one instruction by ir_build() for ints.  An int div
+ * or rem of a divisor that may be 0 can fail at runtime (offset[] is
+ * where the divide is in the source); it is the one operation that is not
+ * pure.
+ *
+ *   const       a, b: the value
+ *   copy        a
+ *   phi         args[a .. a + b)
+ *   i2f f2i neg a
+ *   add sub mul div rem eq ne lt le gt ge   a, b
+ *   print       a
+ *   jmp         to succ[0]
+ *   br          a: to succ[0] if it is not 0, else succ[1]
+ *   ret         end of the function */
+#define IR_OPS(X) \
+    X(CONST,    "const",    0) \
+    X(COPY,     "copy",     1) \
+    X(PHI,      "phi",      0) \
+    X(I2F,      "i2f",      1) \
+    X(F2I,      "f2i",      1) \
+    X(NEG,      "neg",      1) \
+    X(ADD,      "add",      2) \
+    X(SUB,      "sub",      2) \
+    X(MUL,      "mul",      2) \
+    X(DIV,      "div",      2) \
+    X(REM,      "rem",      2) \
+    X(EQ,       "eq",       2) \
+    X(NE,       "ne",       2) \
+    X(LT,       "lt",       2) \
+    X(LE,       "le",       2) \
+    X(GT,       "gt",       2) \
+    X(GE,       "ge",       2) \
+    X(PRINT,    "print",    1) \
+    X(JMP,      "jmp",      0) \
+    X(BR,       "br",       1) \
+    X(RET,      "ret",      0)
+
+enum ir_op {
+#define IR_OP_ENUM(name, text, arity) IR_##name,
+    IR_OPS(IR_OP_ENUM)
+#undef IR_OP_ENUM
+    IR_OP_COUNT
+};
+
+#define IR_NONE 0
+
+struct ir_block {
+    uint32_t first;         /* instructions */
+    uint32_t last;
+    uint32_t *preds;
+    uint32_t pred_count;
+    uint32_t pred_capacity;
+    uint32_t succ[2];
+    uint32_t succ_count;
+    uint32_t next;          /* in layout order, from the entry */
+    uint32_t prev;
+    int dead;               /* deleted; its number is not reused */
+};
+
+/* One function, or the statements outside any function.  Blocks are
+ * numbered from 1 like the instructions, and block 1 is the entry.  The
+ * layout order is the order the backends lay the code out in: the order
+ * of the source, in which each loop is one run of blocks. */
+struct ir_func {
+    uint8_t *op;
+    uint8_t *type;          /* enum type */
+    uint32_t *a;
+    uint32_t *b;
+    uint32_t *block;
+    uint32_t *next;
+    uint32_t *prev;
+    uint32_t *offset;
+    uint32_t count;         /* numbers used, counting 0 */
+    uint32_t capacity;
+    uint32_t live;          /* instructions not deleted */
+    uint32_t *args;
+    uint32_t arg_count;
+    uint32_t arg_capacity;
+    struct ir_block *blocks;
+    uint32_t block_count;   /* counting 0 */
+    uint32_t block_capacity;
+    uint32_t node;          /* the AST_FUNCTION, or the AST_PROGRAM */
+    uint32_t name;          /* its symbol; for the AST_PROGRAM, none */
+    uint32_t end_offset;    /* of the return at the end */
+};
+
+#define IR_ENTRY 1
+
+/* Every frame of a program: funcs[0] is the statements outside functions,
+ * then the functions in source order.  main is the number of the one
+ * called main, or 0 (which is never a function) if there is none. */
+struct ir_program {
+    struct ir_func *funcs;
+    uint32_t count;
+    uint32_t main;
+};
+
+extern const char *const ir_op_names[IR_OP_COUNT];
+extern const unsigned char ir_op_arity[IR_OP_COUNT];
+
+/* Translate a checked tree without errors, every frame of it. */
+void ir_build(const struct ast *ast, const struct sema *sema,
+              struct ir_program *ir);
+void ir_program_free(struct ir_program *ir);
+
+/* Instructions and blocks of the program, as --emit=ir prints them. */
+void ir_print(FILE *out, const struct ir_program *ir);
+void ir_print_func(FILE *out, const struct ir_func *f);
+
+/* Checks that a frame is put together as described above, down to the
+ * links; prints it and aborts if not.  For debugging the passes, which
+ * call it after each when built with -DIR_VERIFY. */
+void ir_verify(const struct ir_func *f);
+
+/* Instructions not deleted, over every frame. */
+uint64_t ir_program_size(const struct ir_program *ir);
+
+/* Building and editing.  ir_new() makes an instruction that is in no
+ * block yet; the others place or move it.  Making a phi reserves its
+ * operands, one per predecessor of the block it is for. */
+uint32_t ir_new(struct ir_func *f, enum ir_op op, enum type type, uint32_t a,
+                uint32_t b, uint32_t offset);
+uint32_t ir_new_phi(struct ir_func *f, uint32_t block, enum type type);
+uint32_t ir_reserve_args(struct ir_func *f, uint32_t count);
+void ir_append(struct ir_func *f, uint32_t block, uint32_t insn);
+void ir_prepend(struct ir_func *f, uint32_t block, uint32_t insn);
+void ir_insert_after(struct ir_func *f, uint32_t after, uint32_t insn);
+void ir_insert_before(struct ir_func *f, uint32_t before, uint32_t insn);
+void ir_unlink(struct ir_func *f, uint32_t insn);
+void ir_delete(struct ir_func *f, uint32_t insn);
+
+/* A constant in the entry block. */
+uint32_t ir_const(struct ir_func *f, enum type type, uint64_t bits);
+
+uint32_t ir_new_block(struct ir_func *f);
+void ir_add_edge(struct ir_func *f, uint32_t from, uint32_t to);
+void ir_remove_pred(struct ir_func *f, uint32_t block, uint32_t index);
+void ir_delete_block(struct ir_func *f, uint32_t block);
+void ir_layout_before(struct ir_func *f, uint32_t block, uint32_t before);
+
+/* A new block on the edge from `from` to `to`, which only jumps on to
+ * `to`, laid out just before it.  Phis in `to` take the value that came
+ * through the edge from the new block instead. */
+uint32_t ir_split_edge(struct ir_func *f, uint32_t from, uint32_t to);
+
+/* Index of `pred` in the predecessors of `block`. */
+uint32_t ir_pred_index(const struct ir_func *f, uint32_t block,
+                       uint32_t pred);
+
+/* The last instruction of a block, its jump, branch or return. */
+static inline uint32_t ir_terminator(const struct ir_func *f, uint32_t block)
+{
+    return f->blocks[block].last;
+}
+
+static inline uint64_t ir_const_bits(const struct ir_func *f, uint32_t insn)
+{
+    return f->a[insn] | (uint64_t) f->b[insn] << 32;
+}
+
+static inline uint32_t ir_operand_count(const struct ir_func *f,
+                                        uint32_t insn)
+{
+    return f->op[insn] == IR_PHI ? f->b[insn] : ir_op_arity[f->op[insn]];
+}
+
+static inline uint32_t *ir_operand(struct ir_func *f, uint32_t insn,
+                                   uint32_t k)
+{
+    if (f->op[insn] == IR_PHI)
+        return &f->args[f->a[insn] + k];
+    return k ? &f->b[insn] : &f->a[insn];
+}
+
+/* Whether an int div or rem may divide by 0, which stops the program. */
+static inline int ir_may_fail(const struct ir_func *f, uint32_t insn)
+{
+    uint32_t d = f->b[insn];
+
+    return (f->op[insn] == IR_DIV || f->op[insn] == IR_REM) &&
+           f->type[insn] == TYPE_INT &&
+           (f->op[d] != IR_CONST || ir_const_bits(f, d) == 0);
+}
+
+/* Whether an instruction only computes its value: it may be deleted if
+ * that is not used, and computed anywhere its operands are. */
+static inline int ir_is_pure(const struct ir_func *f, uint32_t insn)
+{
+    enum ir_op op = (enum ir_op) f->op[insn];
+
+    return op != IR_PHI && op != IR_PRINT && op != IR_JMP && op != IR_BR &&
+           op != IR_RET && !ir_may_fail(f, insn);
+}
+
+/* Blocks reachable from the entry in reverse postorder, into order[];
+ * returns how many. */
+uint32_t ir_rpo(const struct ir_func *f, uint32_t *order);
+
+/* Dominator tree of the blocks in `rpo`: idom[] of each, the entry its
+ * own, and a preorder and postorder numbering of the tree, so that a
+ * dominates b when pre[a] <= pre[b] and post[b] <= post[a].  Arrays are
+ * by block number; unreachable blocks get IR_NONE. */
+struct ir_dom {
+    uint32_t *idom;
+    uint32_t *pre;
+    uint32_t *post;
+    uint32_t *child;        /* first child in the tree */
+    uint32_t *sibling;
+};
+
+void ir_dominators(const struct ir_func *f, const uint32_t *rpo, uint32_t n,
+                   struct ir_dom *dom);
+void ir_dom_free(struct ir_dom *dom);
+
+static inline int ir_dominates(const struct ir_dom *dom, uint32_t a,
+                               uint32_t b)
+{
+    return dom->pre[a] <= dom->pre[b] && dom->post[b] <= dom->post[a];
+}
+
+#endif
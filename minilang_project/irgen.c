@@ -0,0 +1,565 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "IR"
+#include "alloc.h"
+
+#include "intern.h"
+#include "ir.h"
+#include "runtime.h"
+
+/* Translation of the tree to SSA form as Braun et al. do it ("Simple and
+ * Efficient Construction of Static Single Assignment Form"): straight
+ * from the statements, with no dominance frontiers.  Each block records
+ * the value each variable slot has at its end; a read of a slot a block
+ * has not written looks in its predecessors, and where there are several
+ * makes a phi.  A block is sealed once all its predecessors are known,
+ * which for a loop's first block is only at the end of the loop: a read
+ * in it before then makes a phi whose operands are filled in when it is
+ * sealed.  Phis made this way may turn out to pick the same value
+ * through every edge; copy propagation (opt.h) deletes them, as it does
+ * the copies made for assignments of one variable to another. */
+
+struct pending {
+    uint32_t block;
+    uint32_t slot;
+    uint32_t phi;
+};
+
+struct builder {
+    const struct ast *ast;
+    const struct sema *sema;
+    const struct token *tokens;
+    const struct number *numbers;
+    struct ir_func *f;
+    uint32_t cur;               /* block being built; none after return */
+    uint64_t *keys;             /* (block, slot) + 1 -> value, hashed */
+    uint32_t *values;
+    uint32_t size;              /* a power of two */
+    uint32_t used;
+    unsigned char *sealed;      /* per block */
+    uint32_t sealed_capacity;
+    struct pending *pending;    /* phis in blocks not sealed yet */
+    uint32_t pending_count;
+    uint32_t pending_capacity;
+};
+
+static void statement(struct builder *b, uint32_t node);
+static uint32_t value(struct builder *b, uint32_t node);
+static uint32_t read_slot(struct builder *b, uint32_t slot, uint32_t block,
+                          enum type type);
+
+static uint32_t offset_of(const struct builder *b, uint32_t node)
+{
+    return b->tokens[b->ast->token[node]].offset;
+}
+
+static uint32_t hash_key(uint64_t key)
+{
+    key *= UINT64_C(0x9E3779B97F4A7C15);
+    return (uint32_t) (key >> 32);
+}
+
+static void grow_defs(struct builder *b)
+{
+    uint64_t *keys = b->keys;
+    uint32_t *values = b->values;
+    uint32_t size = b->size, i, h;
+
+    b->size = size ? size * 2 : 1024;
+    b->keys = xrealloc(NULL, b->size * sizeof *b->keys);
+    b->values = xrealloc(NULL, b->size * sizeof *b->values);
+    memset(b->keys, 0, b->size * sizeof *b->keys);
+    for (i = 0; i < size; i++) {
+        if (!keys[i])
+            continue;
+        for (h = hash_key(keys[i]);; h++)
+            if (!b->keys[h & (b->size - 1)])
+                break;
+        b->keys[h & (b->size - 1)] = keys[i];
+        b->values[h & (b->size - 1)] = values[i];
+    }
+    free(keys);
+    free(values);
+}
+
+static void define(struct builder *b, uint32_t block, uint32_t slot,
+                   uint32_t v)
+{
+    uint64_t key = ((uint64_t) block << 32 | slot) + 1;
+    uint32_t h;
+
+    if (b->used * 2 >= b->size)
+        grow_defs(b);
+    for (h = hash_key(key);; h++) {
+        uint64_t k = b->keys[h & (b->size - 1)];
+
+        if (!k || k == key)
+            break;
+    }
+    if (!b->keys[h & (b->size - 1)]) {
+        b->keys[h & (b->size - 1)] = key;
+        b->used++;
+    }
+    b->values[h & (b->size - 1)] = v;
+}
+
+static uint32_t defined(const struct builder *b, uint32_t block,
+                        uint32_t slot)
+{
+    uint64_t key = ((uint64_t) block << 32 | slot) + 1;
+    uint32_t h;
+
+    for (h = hash_key(key);; h++) {
+        uint64_t k = b->keys[h & (b->size - 1)];
+
+        if (!k)
+            return IR_NONE;
+        if (k == key)
+            return b->values[h & (b->size - 1)];
+    }
+}
+
+static uint32_t new_block(struct builder *b)
+{
+    uint32_t block = ir_new_block(b->f);
+
+    if (block >= b->sealed_capacity) {
+        b->sealed_capacity = b->sealed_capacity ? b->sealed_capacity * 2
+                                                : 64;
+        b->sealed = xrealloc(b->sealed, b->sealed_capacity);
+    }
+    b->sealed[block] = 0;
+    return block;
+}
+
+static void fill_phi(struct builder *b, uint32_t phi, uint32_t slot)
+{
+    struct ir_func *f = b->f;
+    uint32_t block = f->block[phi];
+    uint32_t count = f->blocks[block].pred_count;
+    uint32_t k;
+
+    f->a[phi] = ir_reserve_args(f, count);
+    f->b[phi] = count;
+    for (k = 0; k < count; k++) {
+        uint32_t v = read_slot(b, slot, f->blocks[block].preds[k],
+                               (enum type) f->type[phi]);
+
+        f->args[f->a[phi] + k] = v;
+    }
+}
+
+static uint32_t zero(struct builder *b, enum type type)
+{
+    union value v;
+    uint64_t bits;
+
+    if (type == TYPE_STRING)
+        return ir_const(b->f, type, intern("", 0));
+    v.i = 0;
+    if (type == TYPE_FLOAT)
+        v.f = 0.0;
+    memcpy(&bits, &v, sizeof bits);
+    return ir_const(b->f, type, bits);
+}
+
+static uint32_t read_slot(struct builder *b, uint32_t slot, uint32_t block,
+                          enum type type)
+{
+    struct ir_func *f = b->f;
+    uint32_t v = defined(b, block, slot);
+
+    if (v)
+        return v;
+    if (!b->sealed[block]) {
+        v = ir_new(f, IR_PHI, type, 0, 0, 0);
+        ir_prepend(f, block, v);
+        if (b->pending_count == b->pending_capacity) {
+            b->pending_capacity = b->pending_capacity
+                                  ? b->pending_capacity * 2 : 16;
+            b->pending = xrealloc(b->pending, b->pending_capacity *
+                                              sizeof *b->pending);
+        }
+        b->pending[b->pending_count].block = block;
+        b->pending[b->pending_count].slot = slot;
+        b->pending[b->pending_count++].phi = v;
+    } else if (f->blocks[block].pred_count == 1) {
+        v = read_slot(b, slot, f->blocks[block].preds[0], type);
+    } else if (f->blocks[block].pred_count == 0) {
+        /* the checker lets no variable be read before it is declared */
+        v = zero(b, type);
+    } else {
+        /* defined first, so that a loop back to here finds it */
+        v = ir_new(f, IR_PHI, type, 0, 0, 0);
+        ir_prepend(f, block, v);
+        define(b, block, slot, v);
+        fill_phi(b, v, slot);
+    }
+    define(b, block, slot, v);
+    return v;
+}
+
+static void seal(struct builder *b, uint32_t block)
+{
+    struct pending *mine;
+    uint32_t i, n, k = 0;
+
+    b->sealed[block] = 1;
+    if (!b->pending_count)
+        return;
+    /* taken out of the list first, since filling one in may leave more
+     * phis pending in other blocks */
+    mine = xrealloc(NULL, b->pending_count * sizeof *mine);
+    for (i = 0, n = 0; i < b->pending_count; i++) {
+        if (b->pending[i].block == block)
+            mine[k++] = b->pending[i];
+        else
+            b->pending[n++] = b->pending[i];
+    }
+    b->pending_count = n;
+    for (i = 0; i < k; i++)
+        fill_phi(b, mine[i].phi, mine[i].slot);
+    free(mine);
+}
+
+static uint32_t emit(struct builder *b, enum ir_op op, enum type type,
+                     uint32_t x, uint32_t y, uint32_t node)
+{
+    uint32_t insn = ir_new(b->f, op, type, x, y, offset_of(b, node));
+
+    ir_append(b->f, b->cur, insn);
+    return insn;
+}
+
+static void jump(struct builder *b, uint32_t to, uint32_t node)
+{
+    emit(b, IR_JMP, TYPE_NONE, 0, 0, node);
+    ir_add_edge(b->f, b->cur, to);
+    b->cur = IR_NONE;
+}
+
+static void branch(struct builder *b, uint32_t cond, uint32_t yes,
+                   uint32_t no)
+{
+    emit(b, IR_BR, TYPE_NONE, value(b, cond), 0, cond);
+    ir_add_edge(b->f, b->cur, yes);
+    ir_add_edge(b->f, b->cur, no);
+    b->cur = IR_NONE;
+}
+
+/* Go on in `block`, sealed, or nowhere if nothing goes there.  It is laid
+ * out after every block made so far, so that the blocks of a statement
+ * stay together whatever order they were made in. */
+static void enter(struct builder *b, uint32_t block)
+{
+    seal(b, block);
+    if (b->f->blocks[block].pred_count) {
+        ir_layout_before(b->f, block, IR_NONE);
+        b->cur = block;
+    } else {
+        ir_delete_block(b->f, block);
+        b->cur = IR_NONE;
+    }
+}
+
+static uint32_t literal(struct builder *b, uint32_t node)
+{
+    const struct token *tok = &b->tokens[b->ast->token[node]];
+    const struct number *number;
+    uint64_t bits;
+
+    if (b->ast->kind[node] == AST_STRING)
+        return ir_const(b->f, TYPE_STRING, tok->value);
+    number = &b->numbers[tok->value];
+    if (number->type == NUMBER_FLOAT) {
+        memcpy(&bits, &number->as.f, sizeof bits);
+        return ir_const(b->f, TYPE_FLOAT, bits);
+    }
+    return ir_const(b->f, TYPE_INT, (uint64_t) number->as.i);
+}
+
+/* `node` as type `to`: converted by an instruction, or for a literal
+ * here. */
+static uint32_t value_as(struct builder *b, uint32_t node, enum type to)
+{
+    const struct number *number;
+    union value v;
+    uint64_t bits;
+
+    if (b->sema->type[node] == to)
+        return value(b, node);
+    if (b->ast->kind[node] == AST_NUMBER) {
+        number = &b->numbers[b->tokens[b->ast->token[node]].value];
+        if (to == TYPE_FLOAT)
+            v.f = number->type == NUMBER_FLOAT ? number->as.f
+                                               : (double) number->as.i;
+        else
+            v.i = number->type == NUMBER_FLOAT ? float_to_int(number->as.f)
+                                               : number->as.i;
+        memcpy(&bits, &v, sizeof bits);
+        return ir_const(b->f, to, bits);
+    }
+    return emit(b, to == TYPE_FLOAT ? IR_I2F : IR_F2I, to, value(b, node), 0,
+                node);
+}
+
+static const unsigned char binary_ops[TOKEN_KIND_COUNT] = {
+    [TOKEN_PLUS] = IR_ADD, [TOKEN_MINUS] = IR_SUB, [TOKEN_MUL] = IR_MUL,
+    [TOKEN_DIV] = IR_DIV, [TOKEN_EQ] = IR_EQ, [TOKEN_NEQ] = IR_NE,
+    [TOKEN_LT] = IR_LT, [TOKEN_LTE] = IR_LE, [TOKEN_GT] = IR_GT,
+    [TOKEN_GTE] = IR_GE,
+};
+
+/* Whether x and y are the same value; each literal is a const of its
+ * own until gvn. */
+static int same(const struct ir_func *f, uint32_t x, uint32_t y)
+{
+    return x == y || (f->op[x] == IR_CONST && f->op[y] == IR_CONST &&
+                      f->type[x] == f->type[y] &&
+                      ir_const_bits(f, x) == ir_const_bits(f, y));
+}
+
+/* `a - a / c * c` of ints, the way a remainder is written, as one rem at
+ * the divide.  The multiply and the divide were made for this expression
+ * alone, not read from a variable, so nothing else uses them and they
+ * go; made separately, a pass could find the divide a value it has
+ * elsewhere and keep it.  Returns the rem, or IR_NONE. */
+static uint32_t rem_of(struct builder *b, uint32_t node, uint32_t left,
+                       uint32_t right)
+{
+    const struct ast *ast = b->ast;
+    struct ir_func *f = b->f;
+    uint32_t mul_node = ast->next[ast->child[node]];
+    uint32_t div_node = ast->child[mul_node];
+    uint32_t div = f->a[right], by = f->b[right];
+
+    if (ast->kind[mul_node] != AST_BINARY || f->op[right] != IR_MUL ||
+        f->type[right] != TYPE_INT)
+        return IR_NONE;
+    if (f->op[div] != IR_DIV || !same(f, f->b[div], by)) {
+        div = by;
+        by = f->a[right];
+        div_node = ast->next[div_node];
+    }
+    if (ast->kind[div_node] != AST_BINARY || f->op[div] != IR_DIV ||
+        f->a[div] != left || !same(f, f->b[div], by))
+        return IR_NONE;
+    by = f->b[div];
+    ir_delete(f, right);
+    ir_delete(f, div);
+    return emit(b, IR_REM, TYPE_INT, left, by, div_node);
+}
+
+static uint32_t value(struct builder *b, uint32_t node)
+{
+    const struct ast *ast = b->ast;
+    const struct sema *sema = b->sema;
+    uint32_t child = ast->child[node];
+    uint32_t left, right, rem;
+    enum type l, r, type;
+    enum ir_op op;
+
+    switch (ast->kind[node]) {
+    case AST_NAME:
+        return read_slot(b, sema->slot[node], b->cur,
+                         (enum type) sema->type[node]);
+    case AST_NUMBER:
+    case AST_STRING:
+        return literal(b, node);
+    case AST_NEG:
+        return emit(b, IR_NEG, (enum type) sema->type[node], value(b, child),
+                    0, node);
+    default:
+        l = (enum type) sema->type[child];
+        r = (enum type) sema->type[ast->next[child]];
+        type = l == TYPE_FLOAT || r == TYPE_FLOAT ? TYPE_FLOAT : l;
+        left = value_as(b, child, type);
+        right = value_as(b, ast->next[child], type);
+        op = (enum ir_op) binary_ops[b->tokens[ast->token[node]].kind];
+        if (op >= IR_EQ)
+            type = TYPE_INT;
+        else if (op == IR_SUB && type == TYPE_INT &&
+                 (rem = rem_of(b, node, left, right)))
+            return rem;
+        return emit(b, op, type, left, right, node);
+    }
+}
+
+/* `value` into the variable of `slot`; a variable of the same type is
+ * copied. */
+static void store(struct builder *b, uint32_t slot, enum type type,
+                  uint32_t node)
+{
+    uint32_t v = value_as(b, node, type);
+
+    if (b->ast->kind[node] == AST_NAME && b->sema->type[node] == type)
+        v = emit(b, IR_COPY, type, v, 0, node);
+    define(b, b->cur, slot, v);
+}
+
+static void loop(struct builder *b, uint32_t node, uint32_t cond,
+                 uint32_t step, uint32_t body)
+{
+    uint32_t top = new_block(b);
+    uint32_t exit = new_block(b);
+
+    /* the test at the bottom, as the bytecode had it, with a copy at the
+     * top to skip the loop: the loop is then one block that branches to
+     * itself when it is that simple */
+    if (cond)
+        branch(b, cond, top, exit);
+    else
+        jump(b, top, node);
+    b->cur = top;
+    statement(b, body);
+    if (b->cur && step)
+        statement(b, step);
+    if (b->cur) {
+        if (cond)
+            branch(b, cond, top, exit);
+        else
+            jump(b, top, node);
+    }
+    seal(b, top);
+    enter(b, exit);
+}
+
+static void statement(struct builder *b, uint32_t node)
+{
+    const struct ast *ast = b->ast;
+    const struct sema *sema = b->sema;
+    uint32_t child = ast->child[node];
+    uint32_t yes, no, join, cond, step;
+
+    if (!b->cur)
+        return;         /* after a return */
+    switch (ast->kind[node]) {
+    case AST_BLOCK:
+        for (; child && b->cur; child = ast->next[child])
+            statement(b, child);
+        break;
+    case AST_DECL:
+        if (ast->next[child])
+            store(b, sema->slot[node], (enum type) sema->type[child],
+                  ast->next[child]);
+        else
+            define(b, b->cur, sema->slot[node],
+                   zero(b, (enum type) sema->type[child]));
+        break;
+    case AST_ASSIGN:
+        store(b, sema->slot[child], (enum type) sema->type[child],
+              ast->next[child]);
+        break;
+    case AST_IF:
+        yes = new_block(b);
+        no = ast->next[ast->next[child]] ? new_block(b) : IR_NONE;
+        join = new_block(b);
+        branch(b, child, yes, no ? no : join);
+        enter(b, yes);
+        statement(b, ast->next[child]);
+        if (b->cur)
+            jump(b, join, node);
+        if (no) {
+            enter(b, no);
+            statement(b, ast->next[ast->next[child]]);
+            if (b->cur)
+                jump(b, join, node);
+        }
+        enter(b, join);
+        break;
+    case AST_WHILE:
+        loop(b, node, child, AST_NONE, ast->next[child]);
+        break;
+    case AST_FOR:
+        cond = ast->next[child];
+        step = ast->next[cond];
+        statement(b, child);
+        loop(b, node, ast->kind[cond] == AST_EMPTY ? AST_NONE : cond,
+             ast->kind[step] == AST_EMPTY ? AST_NONE : step, ast->next[step]);
+        break;
+    case AST_PRINT:
+        emit(b, IR_PRINT, TYPE_NONE, value(b, child), 0, node);
+        break;
+    case AST_RETURN:
+        /* the value is not used, but may fail */
+        if (child)
+            value(b, child);
+        emit(b, IR_RET, TYPE_NONE, 0, 0, node);
+        b->cur = IR_NONE;
+        break;
+    case AST_EXPR:
+        value(b, child);
+        break;
+    default:
+        break;
+    }
+}
+
+/* The statements from `first` on, skipping functions, into `f`. */
+static void frame(struct builder *b, struct ir_func *f, uint32_t first)
+{
+    uint32_t node, insn;
+
+    b->f = f;
+    b->used = 0;
+    if (b->size)
+        memset(b->keys, 0, b->size * sizeof *b->keys);
+    b->pending_count = 0;
+    b->cur = new_block(b);
+    seal(b, IR_ENTRY);
+    for (node = first; node && b->cur; node = b->ast->next[node])
+        if (b->ast->kind[node] != AST_FUNCTION)
+            statement(b, node);
+    if (b->cur) {
+        insn = ir_new(f, IR_RET, TYPE_NONE, 0, 0, f->end_offset);
+        ir_append(f, b->cur, insn);
+    }
+}
+
+void ir_build(const struct ast *ast, const struct sema *sema,
+              struct ir_program *ir)
+{
+    struct builder b;
+    uint32_t node, count = 1, n = 0;
+    uint32_t end = 0;
+
+    memset(&b, 0, sizeof b);
+    b.ast = ast;
+    b.sema = sema;
+    b.tokens = ast->tokens->data;
+    b.numbers = ast->tokens->numbers;
+    if (ast->tokens->count)
+        end = ast->tokens->data[ast->tokens->count - 1].offset;
+    ir->main = 0;
+    if (ast->root)
+        for (node = ast->child[ast->root]; node; node = ast->next[node])
+            count += ast->kind[node] == AST_FUNCTION;
+    ir->funcs = xrealloc(NULL, count * sizeof *ir->funcs);
+    memset(ir->funcs, 0, count * sizeof *ir->funcs);
+    ir->count = count;
+
+    ir->funcs[0].node = ast->root;
+    ir->funcs[0].end_offset = end;
+    frame(&b, &ir->funcs[n++], ast->root ? ast->child[ast->root] : 0);
+    if (ast->root) {
+        for (node = ast->child[ast->root]; node; node = ast->next[node]) {
+            struct ir_func *f;
+
+            if (ast->kind[node] != AST_FUNCTION)
+                continue;
+            f = &ir->funcs[n];
+            f->node = node;
+            f->name = b.tokens[ast->token[ast->child[node]]].value;
+            f->end_offset = offset_of(&b, node);
+            if (node == sema->main)
+                ir->main = n;
+            frame(&b, f, ast->next[ast->child[node]]);
+            n++;
+        }
+    }
+    free(b.keys);
+    free(b.values);
+    free(b.sealed);
+    free(b.pending);
+}
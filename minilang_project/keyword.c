@@ -0,0 +1,29 @@
+#include "keyword.h"
+
+/* kind, spelling, first and last character, length */
+#define KEYWORDS(X)                                 \
+    X(TOKEN_IF,     "if",     'i', 'f', 2)          \
+    X(TOKEN_ELSE,   "else",   'e', 'e', 4)          \
+    X(TOKEN_WHILE,  "while",  'w', 'e', 5)          \
+    X(TOKEN_FOR,    "for",    'f', 'r', 3)          \
+    X(TOKEN_INT,    "int",    'i', 't', 3)          \
+    X(TOKEN_FLOAT,  "float",  'f', 't', 5)          \
+    X(TOKEN_STRING, "string", 's', 'g', 6)          \
+    X(TOKEN_PRINT,  "print",  'p', 't', 5)          \
+    X(TOKEN_RETURN, "return", 'r', 'n', 6)
+
+#define SLOT(kind, name, first, last, len) \
+    [KEYWORD_HASH(first, last, len)] = { name, len, kind },
+
+const struct keyword keyword_table[KEYWORD_SLOTS] = {
+    KEYWORDS(SLOT)
+};
+
+/* The slots are disjoint exactly when adding their bits never carries. */
+#define BIT(kind, name, first, last, len) \
+    + (1ul << KEYWORD_HASH(first, last, len))
+#define ANY(kind, name, first, last, len) \
+    | (1ul << KEYWORD_HASH(first, last, len))
+
+_Static_assert((0 KEYWORDS(BIT)) == (0 KEYWORDS(ANY)),
+               "KEYWORD_HASH has a collision");
@@ -0,0 +1,46 @@
+#ifndef MINILANG_KEYWORD_H
+#define MINILANG_KEYWORD_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "token.h"
+
+/* Keywords are lexed by the identifier rule and then looked up in a
+ * perfect hash, instead of each getting its own states in the scanner.
+ *
+ * KEYWORD_HASH is collision-free over the nine keywords (keyword.c checks
+ * this at compile time), so a lexeme can only be the keyword in its one
+ * slot: a lookup is a hash and a single compare. */
+
+#define KEYWORD_SLOTS   16
+#define KEYWORD_MAX_LEN 6
+
+#define KEYWORD_HASH(first, last, len) \
+    (((unsigned) (first) * 3 + (unsigned) (last) + (unsigned) (len)) & \
+     (KEYWORD_SLOTS - 1))
+
+struct keyword {
+    char name[KEYWORD_MAX_LEN + 1];
+    unsigned char len;          /* 0 for an empty slot */
+    unsigned char kind;
+};
+
+extern const struct keyword keyword_table[KEYWORD_SLOTS];
+
+/* TOKEN_IF ... TOKEN_RETURN, or TOKEN_IDENTIFIER.  Inline so that each
+ * scanner gets a copy compiled for its own instruction set. */
+static inline enum token_kind keyword_kind(const char *s, size_t len)
+{
+    const struct keyword *kw;
+
+    if (len < 2 || len > KEYWORD_MAX_LEN)
+        return TOKEN_IDENTIFIER;
+    kw = &keyword_table[KEYWORD_HASH((unsigned char) s[0],
+                                     (unsigned char) s[len - 1], len)];
+    if (kw->len == len && memcmp(kw->name, s, len) == 0)
+        return (enum token_kind) kw->kind;
+    return TOKEN_IDENTIFIER;
+}
+
+#endif
@@ -352,8 +352,8 @@ static void yynoreturn yy_fatal_error ( const char* msg  );
 	(yy_hold_char) = *yy_cp; \
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 34
-#define YY_END_OF_BUFFER 35
+#define YY_NUM_RULES 30
+#define YY_END_OF_BUFFER 31
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -361,16 +361,40 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[79] =
+static const flex_int16_t yy_accept[296] =
     {   0,
-        0,    0,   35,   33,   32,   32,   33,   33,   21,   22,
-       18,   16,   26,   17,   19,   27,   25,   15,   20,   14,
-       28,   28,   28,   28,   28,   28,   28,   28,   23,   24,
-       32,   11,    0,   29,    0,   30,    0,   27,   13,   10,
-       12,   28,   28,   28,   28,    1,   28,   28,   28,   28,
-       28,    0,    0,   30,   27,   28,   28,    4,    5,   28,
-       28,   28,   28,   31,    2,   28,   28,   28,   28,   28,
-        6,    8,   28,   28,    3,    9,    7,    0
+        0,    0,    0,    0,   31,   28,   27,   29,   29,   12,
+       13,    9,    7,   17,    8,   10,   18,   16,    6,   11,
+        5,   19,   14,   15,   20,   24,   25,    2,    0,   21,
+       23,   22,    0,    4,    1,    3,   20,   24,   26,   18,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,   24,   24,   24,   24,   24,   24,
+       24,   24,   24,   24,    0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -384,97 +408,1378 @@ static const YY_CHAR yy_ec[256] =
        17,   18,    1,    1,   19,   19,   19,   19,   19,   19,
        19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
        19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
-        1,    1,    1,    1,   19,    1,   20,   19,   19,   19,
+        1,    1,    1,    1,   19,    1,   19,   19,   19,   19,
 
-       21,   22,   23,   24,   25,   19,   19,   26,   19,   27,
-       28,   29,   19,   30,   31,   32,   33,   19,   34,   19,
-       19,   19,   35,    1,   36,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   20,    1,   21,    1,    1,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22,   22,   22,   22,   22,   22,
+       22,   22,   22,   22,   22
     } ;
 
-static const YY_CHAR yy_meta[37] =
+static const YY_CHAR yy_meta[23] =
     {   0,
-        1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    3,    1,    1,    1,    1,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    1,    1
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1
     } ;
 
-static const flex_int16_t yy_base[83] =
+static const flex_int16_t yy_base[296] =
     {   0,
-        0,    0,   99,  100,   35,   37,   81,   92,  100,  100,
-      100,  100,  100,  100,   33,   30,  100,   79,   78,   77,
-        0,   67,   17,   25,   62,   70,   58,   65,  100,  100,
-       46,  100,   83,  100,   79,    0,   72,   39,  100,  100,
-      100,    0,   54,   56,   53,    0,   50,   56,   48,   49,
-       53,   69,   42,    0,   62,   54,   54,    0,    0,   46,
-       39,   46,   44,  100,    0,   37,   36,   37,   39,   44,
-        0,    0,   36,   34,    0,    0,    0,  100,   55,   51,
-       58,   61
+        0,    0,   22,   22,   45,   45,   45,   32,   64, 5729,
+     5729, 5729, 5729, 5729, 5729,   42,   39, 5729,   35,   37,
+       39,   73, 5729, 5729,   74,   96,   50, 5729,    0, 5729,
+     5729,  118,   45, 5729, 5729, 5729,   75,  140, 5729,    0,
+      162,  184,  206,  228,  250,  272,  294,  316,  338,  360,
+      382,  404,  426,  448,  470,  492,  514,  536,  558,  580,
+      602,  624,  646,  668,  690,  712,  734,  756,  778,  800,
+      822,  844,  866,  888,  910,  932,  954,  976,  998, 1020,
+     1042, 1064, 1086, 1108, 1130, 1152, 1174, 1196, 1218, 1240,
+     1262, 1284, 1306, 1328, 1350, 1372, 1394, 1416, 1438, 1460,
+
+     1482, 1504, 1526, 1548, 1570, 1592, 1614, 1636, 1658, 1680,
+     1702, 1724, 1746, 1768, 1790, 1812, 1834, 1856, 1878, 1900,
+     1922, 1944, 1966, 1988, 2010, 2032, 2054, 2076, 2098, 2120,
+     2142, 2164, 2186, 2208, 2230, 2252, 2274, 2296, 2318, 2340,
+     2362, 2384, 2406, 2428, 2450, 2472, 2494, 2516, 2538, 2560,
+     2582, 2604, 2626, 2648, 2670, 2692, 2714, 2736, 2758, 2780,
+     2802, 2824, 2846, 2868, 2890, 2912, 2934, 2956, 2978, 3000,
+     3022, 3044, 3066, 3088, 3110, 3132, 3154, 3176, 3198, 3220,
+     3242, 3264, 3286, 3308, 3330, 3352, 3374, 3396, 3418, 3440,
+     3462, 3484, 3506, 3528, 3550, 3572, 3594, 3616, 3638, 3660,
+
+     3682, 3704, 3726, 3748, 3770, 3792, 3814, 3836, 3858, 3880,
+     3902, 3924, 3946, 3968, 3990, 4012, 4034, 4056, 4078, 4100,
+     4122, 4144, 4166, 4188, 4210, 4232, 4254, 4276, 4298, 4320,
+     4342, 4364, 4386, 4408, 4430, 4452, 4474, 4496, 4518, 4540,
+     4562, 4584, 4606, 4628, 4650, 4672, 4694, 4716, 4738, 4760,
+     4782, 4804, 4826, 4848, 4870, 4892, 4914, 4936, 4958, 4980,
+     5002, 5024, 5046, 5068, 5090, 5112, 5134, 5156, 5178, 5200,
+     5222, 5244, 5266, 5288, 5310, 5332, 5354, 5376, 5398, 5420,
+     5442, 5464, 5486, 5508, 5530, 5552, 5574, 5596, 5618, 5640,
+     5662, 5684, 5706, 5729, 5729
     } ;
 
-static const flex_int16_t yy_def[83] =
+static const flex_int16_t yy_def[296] =
     {   0,
-       78,    1,   78,   78,   78,   78,   78,   79,   78,   78,
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       80,   80,   80,   80,   80,   80,   80,   80,   78,   78,
-       78,   78,   79,   78,   81,   82,   78,   78,   78,   78,
-       78,   80,   80,   80,   80,   80,   80,   80,   80,   80,
-       80,   81,   81,   82,   78,   80,   80,   80,   80,   80,
-       80,   80,   80,   78,   80,   80,   80,   80,   80,   80,
-       80,   80,   80,   80,   80,   80,   80,    0,   78,   78,
-       78,   78
+      295,    1,  295,    3,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,    6,  295,  295,  295,    9,  295,
+      295,   16,  295,  295,  295,  295,   22,  295,  295,   33,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,    0
     } ;
 
-static const flex_int16_t yy_nxt[137] =
+static const flex_int16_t yy_nxt[5752] =
     {   0,
-        4,    5,    6,    7,    8,    9,   10,   11,   12,   13,
-       14,    4,   15,   16,   17,   18,   19,   20,   21,   21,
-       22,   23,   21,   21,   24,   21,   21,   21,   25,   26,
-       27,   21,   21,   28,   29,   30,   31,   31,   31,   31,
-       35,   37,   44,   38,   45,   36,   46,   31,   31,   53,
-       37,   47,   38,   42,   64,   33,   77,   33,   52,   52,
-       52,   54,   76,   54,   75,   74,   73,   72,   71,   70,
-       69,   68,   67,   66,   65,   55,   53,   63,   62,   61,
-       60,   59,   58,   57,   56,   55,   53,   34,   51,   50,
-       49,   48,   43,   41,   40,   39,   34,   32,   78,    3,
-
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78
+        6,    7,    7,    8,    9,   10,   11,   12,   13,   14,
+       15,    6,   16,   17,   18,   19,   20,   21,   22,   23,
+       24,   25,   26,   26,   26,   26,   26,   26,   26,   27,
+       26,   26,   26,   26,   26,   26,   26,   26,   26,   26,
+       26,   26,   26,   26,  295,    6,    7,    7,   28,   31,
+       33,   34,   17,   35,   32,   36,    6,   27,   40,    0,
+        0,    0,   39,    0,   29,   29,    6,   29,   30,   29,
+       29,   29,   29,   29,   29,   29,   29,   29,   29,   29,
+       29,   29,   29,   29,   29,   29,   22,   37,   37,    0,
+        0,   22,   37,   37,   37,   25,   38,   38,   38,   38,
+
+       38,   38,   38,    0,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   32,   32,
+        0,   32,   32,   32,   32,   32,   32,   32,   32,   32,
+        0,   32,   32,   32,   32,   32,   32,   32,   32,   32,
+       41,   41,   41,   41,   41,   41,   41,    0,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   42,   42,   42,   42,   42,   42,   42,    0,
+       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
+       42,   42,   42,   42,   43,   43,   43,   43,   43,   43,
+       43,    0,   43,   43,   43,   43,   43,   43,   43,   43,
+
+       43,   43,   43,   43,   43,   43,   44,   44,   44,   44,
+       44,   44,   44,    0,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   45,   45,
+       45,   45,   45,   45,   45,    0,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       46,   46,   46,   46,   46,   46,   46,    0,   46,   46,
+       46,   46,   46,   46,   46,   46,   46,   46,   46,   46,
+       46,   46,   47,   47,   47,   47,   47,   47,   47,    0,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   48,   48,   48,   48,   48,   48,
+
+       48,    0,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   49,   49,   49,   49,
+       49,   49,   49,    0,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   50,   50,
+       50,   50,   50,   50,   50,    0,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       51,   51,   51,   51,   51,   51,   51,    0,   51,   51,
+       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
+       51,   51,   52,   52,   52,   52,   52,   52,   52,    0,
+       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
+
+       52,   52,   52,   52,   53,   53,   53,   53,   53,   53,
+       53,    0,   53,   53,   53,   53,   53,   53,   53,   53,
+       53,   53,   53,   53,   53,   53,   54,   54,   54,   54,
+       54,   54,   54,    0,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   55,   55,
+       55,   55,   55,   55,   55,    0,   55,   55,   55,   55,
+       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
+       56,   56,   56,   56,   56,   56,   56,    0,   56,   56,
+       56,   56,   56,   56,   56,   56,   56,   56,   56,   56,
+       56,   56,   57,   57,   57,   57,   57,   57,   57,    0,
+
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   58,   58,   58,   58,   58,   58,
+       58,    0,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   59,   59,   59,   59,
+       59,   59,   59,    0,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   60,   60,
+       60,   60,   60,   60,   60,    0,   60,   60,   60,   60,
+       60,   60,   60,   60,   60,   60,   60,   60,   60,   60,
+       61,   61,   61,   61,   61,   61,   61,    0,   61,   61,
+       61,   61,   61,   61,   61,   61,   61,   61,   61,   61,
+
+       61,   61,   62,   62,   62,   62,   62,   62,   62,    0,
+       62,   62,   62,   62,   62,   62,   62,   62,   62,   62,
+       62,   62,   62,   62,   63,   63,   63,   63,   63,   63,
+       63,    0,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   64,   64,   64,   64,
+       64,   64,   64,    0,   64,   64,   64,   64,   64,   64,
+       64,   64,   64,   64,   64,   64,   64,   64,   65,   65,
+       65,   65,   65,   65,   65,    0,   65,   65,   65,   65,
+       65,   65,   65,   65,   65,   65,   65,   65,   65,   65,
+       66,   66,   66,   66,   66,   66,   66,    0,   66,   66,
+
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   67,   67,   67,   67,   67,   67,   67,    0,
+       67,   67,   67,   67,   67,   67,   67,   67,   67,   67,
+       67,   67,   67,   67,   68,   68,   68,   68,   68,   68,
+       68,    0,   68,   68,   68,   68,   68,   68,   68,   68,
+       68,   68,   68,   68,   68,   68,   69,   69,   69,   69,
+       69,   69,   69,    0,   69,   69,   69,   69,   69,   69,
+       69,   69,   69,   69,   69,   69,   69,   69,   70,   70,
+       70,   70,   70,   70,   70,    0,   70,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+
+       71,   71,   71,   71,   71,   71,   71,    0,   71,   71,
+       71,   71,   71,   71,   71,   71,   71,   71,   71,   71,
+       71,   71,   72,   72,   72,   72,   72,   72,   72,    0,
+       72,   72,   72,   72,   72,   72,   72,   72,   72,   72,
+       72,   72,   72,   72,   73,   73,   73,   73,   73,   73,
+       73,    0,   73,   73,   73,   73,   73,   73,   73,   73,
+       73,   73,   73,   73,   73,   73,   74,   74,   74,   74,
+       74,   74,   74,    0,   74,   74,   74,   74,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   74,   75,   75,
+       75,   75,   75,   75,   75,    0,   75,   75,   75,   75,
+
+       75,   75,   75,   75,   75,   75,   75,   75,   75,   75,
+       76,   76,   76,   76,   76,   76,   76,    0,   76,   76,
+       76,   76,   76,   76,   76,   76,   76,   76,   76,   76,
+       76,   76,   77,   77,   77,   77,   77,   77,   77,    0,
+       77,   77,   77,   77,   77,   77,   77,   77,   77,   77,
+       77,   77,   77,   77,   78,   78,   78,   78,   78,   78,
+       78,    0,   78,   78,   78,   78,   78,   78,   78,   78,
+       78,   78,   78,   78,   78,   78,   79,   79,   79,   79,
+       79,   79,   79,    0,   79,   79,   79,   79,   79,   79,
+       79,   79,   79,   79,   79,   79,   79,   79,   80,   80,
+
+       80,   80,   80,   80,   80,    0,   80,   80,   80,   80,
+       80,   80,   80,   80,   80,   80,   80,   80,   80,   80,
+       81,   81,   81,   81,   81,   81,   81,    0,   81,   81,
+       81,   81,   81,   81,   81,   81,   81,   81,   81,   81,
+       81,   81,   82,   82,   82,   82,   82,   82,   82,    0,
+       82,   82,   82,   82,   82,   82,   82,   82,   82,   82,
+       82,   82,   82,   82,   83,   83,   83,   83,   83,   83,
+       83,    0,   83,   83,   83,   83,   83,   83,   83,   83,
+       83,   83,   83,   83,   83,   83,   84,   84,   84,   84,
+       84,   84,   84,    0,   84,   84,   84,   84,   84,   84,
+
+       84,   84,   84,   84,   84,   84,   84,   84,   85,   85,
+       85,   85,   85,   85,   85,    0,   85,   85,   85,   85,
+       85,   85,   85,   85,   85,   85,   85,   85,   85,   85,
+       86,   86,   86,   86,   86,   86,   86,    0,   86,   86,
+       86,   86,   86,   86,   86,   86,   86,   86,   86,   86,
+       86,   86,   87,   87,   87,   87,   87,   87,   87,    0,
+       87,   87,   87,   87,   87,   87,   87,   87,   87,   87,
+       87,   87,   87,   87,   88,   88,   88,   88,   88,   88,
+       88,    0,   88,   88,   88,   88,   88,   88,   88,   88,
+       88,   88,   88,   88,   88,   88,   89,   89,   89,   89,
+
+       89,   89,   89,    0,   89,   89,   89,   89,   89,   89,
+       89,   89,   89,   89,   89,   89,   89,   89,   90,   90,
+       90,   90,   90,   90,   90,    0,   90,   90,   90,   90,
+       90,   90,   90,   90,   90,   90,   90,   90,   90,   90,
+       91,   91,   91,   91,   91,   91,   91,    0,   91,   91,
+       91,   91,   91,   91,   91,   91,   91,   91,   91,   91,
+       91,   91,   92,   92,   92,   92,   92,   92,   92,    0,
+       92,   92,   92,   92,   92,   92,   92,   92,   92,   92,
+       92,   92,   92,   92,   93,   93,   93,   93,   93,   93,
+       93,    0,   93,   93,   93,   93,   93,   93,   93,   93,
+
+       93,   93,   93,   93,   93,   93,   94,   94,   94,   94,
+       94,   94,   94,    0,   94,   94,   94,   94,   94,   94,
+       94,   94,   94,   94,   94,   94,   94,   94,   95,   95,
+       95,   95,   95,   95,   95,    0,   95,   95,   95,   95,
+       95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+       96,   96,   96,   96,   96,   96,   96,    0,   96,   96,
+       96,   96,   96,   96,   96,   96,   96,   96,   96,   96,
+       96,   96,   97,   97,   97,   97,   97,   97,   97,    0,
+       97,   97,   97,   97,   97,   97,   97,   97,   97,   97,
+       97,   97,   97,   97,   98,   98,   98,   98,   98,   98,
+
+       98,    0,   98,   98,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   99,   99,   99,   99,
+       99,   99,   99,    0,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,  100,  100,
+      100,  100,  100,  100,  100,    0,  100,  100,  100,  100,
+      100,  100,  100,  100,  100,  100,  100,  100,  100,  100,
+      101,  101,  101,  101,  101,  101,  101,    0,  101,  101,
+      101,  101,  101,  101,  101,  101,  101,  101,  101,  101,
+      101,  101,  102,  102,  102,  102,  102,  102,  102,    0,
+      102,  102,  102,  102,  102,  102,  102,  102,  102,  102,
+
+      102,  102,  102,  102,  103,  103,  103,  103,  103,  103,
+      103,    0,  103,  103,  103,  103,  103,  103,  103,  103,
+      103,  103,  103,  103,  103,  103,  104,  104,  104,  104,
+      104,  104,  104,    0,  104,  104,  104,  104,  104,  104,
+      104,  104,  104,  104,  104,  104,  104,  104,  105,  105,
+      105,  105,  105,  105,  105,    0,  105,  105,  105,  105,
+      105,  105,  105,  105,  105,  105,  105,  105,  105,  105,
+      106,  106,  106,  106,  106,  106,  106,    0,  106,  106,
+      106,  106,  106,  106,  106,  106,  106,  106,  106,  106,
+      106,  106,  107,  107,  107,  107,  107,  107,  107,    0,
+
+      107,  107,  107,  107,  107,  107,  107,  107,  107,  107,
+      107,  107,  107,  107,  108,  108,  108,  108,  108,  108,
+      108,    0,  108,  108,  108,  108,  108,  108,  108,  108,
+      108,  108,  108,  108,  108,  108,  109,  109,  109,  109,
+      109,  109,  109,    0,  109,  109,  109,  109,  109,  109,
+      109,  109,  109,  109,  109,  109,  109,  109,  110,  110,
+      110,  110,  110,  110,  110,    0,  110,  110,  110,  110,
+      110,  110,  110,  110,  110,  110,  110,  110,  110,  110,
+      111,  111,  111,  111,  111,  111,  111,    0,  111,  111,
+      111,  111,  111,  111,  111,  111,  111,  111,  111,  111,
+
+      111,  111,  112,  112,  112,  112,  112,  112,  112,    0,
+      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
+      112,  112,  112,  112,  113,  113,  113,  113,  113,  113,
+      113,    0,  113,  113,  113,  113,  113,  113,  113,  113,
+      113,  113,  113,  113,  113,  113,  114,  114,  114,  114,
+      114,  114,  114,    0,  114,  114,  114,  114,  114,  114,
+      114,  114,  114,  114,  114,  114,  114,  114,  115,  115,
+      115,  115,  115,  115,  115,    0,  115,  115,  115,  115,
+      115,  115,  115,  115,  115,  115,  115,  115,  115,  115,
+      116,  116,  116,  116,  116,  116,  116,    0,  116,  116,
+
+      116,  116,  116,  116,  116,  116,  116,  116,  116,  116,
+      116,  116,  117,  117,  117,  117,  117,  117,  117,    0,
+      117,  117,  117,  117,  117,  117,  117,  117,  117,  117,
+      117,  117,  117,  117,  118,  118,  118,  118,  118,  118,
+      118,    0,  118,  118,  118,  118,  118,  118,  118,  118,
+      118,  118,  118,  118,  118,  118,  119,  119,  119,  119,
+      119,  119,  119,    0,  119,  119,  119,  119,  119,  119,
+      119,  119,  119,  119,  119,  119,  119,  119,  120,  120,
+      120,  120,  120,  120,  120,    0,  120,  120,  120,  120,
+      120,  120,  120,  120,  120,  120,  120,  120,  120,  120,
+
+      121,  121,  121,  121,  121,  121,  121,    0,  121,  121,
+      121,  121,  121,  121,  121,  121,  121,  121,  121,  121,
+      121,  121,  122,  122,  122,  122,  122,  122,  122,    0,
+      122,  122,  122,  122,  122,  122,  122,  122,  122,  122,
+      122,  122,  122,  122,  123,  123,  123,  123,  123,  123,
+      123,    0,  123,  123,  123,  123,  123,  123,  123,  123,
+      123,  123,  123,  123,  123,  123,  124,  124,  124,  124,
+      124,  124,  124,    0,  124,  124,  124,  124,  124,  124,
+      124,  124,  124,  124,  124,  124,  124,  124,  125,  125,
+      125,  125,  125,  125,  125,    0,  125,  125,  125,  125,
+
+      125,  125,  125,  125,  125,  125,  125,  125,  125,  125,
+      126,  126,  126,  126,  126,  126,  126,    0,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  127,  127,  127,  127,  127,  127,  127,    0,
+      127,  127,  127,  127,  127,  127,  127,  127,  127,  127,
+      127,  127,  127,  127,  128,  128,  128,  128,  128,  128,
+      128,    0,  128,  128,  128,  128,  128,  128,  128,  128,
+      128,  128,  128,  128,  128,  128,  129,  129,  129,  129,
+      129,  129,  129,    0,  129,  129,  129,  129,  129,  129,
+      129,  129,  129,  129,  129,  129,  129,  129,  130,  130,
+
+      130,  130,  130,  130,  130,    0,  130,  130,  130,  130,
+      130,  130,  130,  130,  130,  130,  130,  130,  130,  130,
+      131,  131,  131,  131,  131,  131,  131,    0,  131,  131,
+      131,  131,  131,  131,  131,  131,  131,  131,  131,  131,
+      131,  131,  132,  132,  132,  132,  132,  132,  132,    0,
+      132,  132,  132,  132,  132,  132,  132,  132,  132,  132,
+      132,  132,  132,  132,  133,  133,  133,  133,  133,  133,
+      133,    0,  133,  133,  133,  133,  133,  133,  133,  133,
+      133,  133,  133,  133,  133,  133,  134,  134,  134,  134,
+      134,  134,  134,    0,  134,  134,  134,  134,  134,  134,
+
+      134,  134,  134,  134,  134,  134,  134,  134,  135,  135,
+      135,  135,  135,  135,  135,    0,  135,  135,  135,  135,
+      135,  135,  135,  135,  135,  135,  135,  135,  135,  135,
+      136,  136,  136,  136,  136,  136,  136,    0,  136,  136,
+      136,  136,  136,  136,  136,  136,  136,  136,  136,  136,
+      136,  136,  137,  137,  137,  137,  137,  137,  137,    0,
+      137,  137,  137,  137,  137,  137,  137,  137,  137,  137,
+      137,  137,  137,  137,  138,  138,  138,  138,  138,  138,
+      138,    0,  138,  138,  138,  138,  138,  138,  138,  138,
+      138,  138,  138,  138,  138,  138,  139,  139,  139,  139,
+
+      139,  139,  139,    0,  139,  139,  139,  139,  139,  139,
+      139,  139,  139,  139,  139,  139,  139,  139,  140,  140,
+      140,  140,  140,  140,  140,    0,  140,  140,  140,  140,
+      140,  140,  140,  140,  140,  140,  140,  140,  140,  140,
+      141,  141,  141,  141,  141,  141,  141,    0,  141,  141,
+      141,  141,  141,  141,  141,  141,  141,  141,  141,  141,
+      141,  141,  142,  142,  142,  142,  142,  142,  142,    0,
+      142,  142,  142,  142,  142,  142,  142,  142,  142,  142,
+      142,  142,  142,  142,  143,  143,  143,  143,  143,  143,
+      143,    0,  143,  143,  143,  143,  143,  143,  143,  143,
+
+      143,  143,  143,  143,  143,  143,  144,  144,  144,  144,
+      144,  144,  144,    0,  144,  144,  144,  144,  144,  144,
+      144,  144,  144,  144,  144,  144,  144,  144,  145,  145,
+      145,  145,  145,  145,  145,    0,  145,  145,  145,  145,
+      145,  145,  145,  145,  145,  145,  145,  145,  145,  145,
+      146,  146,  146,  146,  146,  146,  146,    0,  146,  146,
+      146,  146,  146,  146,  146,  146,  146,  146,  146,  146,
+      146,  146,  147,  147,  147,  147,  147,  147,  147,    0,
+      147,  147,  147,  147,  147,  147,  147,  147,  147,  147,
+      147,  147,  147,  147,  148,  148,  148,  148,  148,  148,
+
+      148,    0,  148,  148,  148,  148,  148,  148,  148,  148,
+      148,  148,  148,  148,  148,  148,  149,  149,  149,  149,
+      149,  149,  149,    0,  149,  149,  149,  149,  149,  149,
+      149,  149,  149,  149,  149,  149,  149,  149,  150,  150,
+      150,  150,  150,  150,  150,    0,  150,  150,  150,  150,
+      150,  150,  150,  150,  150,  150,  150,  150,  150,  150,
+      151,  151,  151,  151,  151,  151,  151,    0,  151,  151,
+      151,  151,  151,  151,  151,  151,  151,  151,  151,  151,
+      151,  151,  152,  152,  152,  152,  152,  152,  152,    0,
+      152,  152,  152,  152,  152,  152,  152,  152,  152,  152,
+
+      152,  152,  152,  152,  153,  153,  153,  153,  153,  153,
+      153,    0,  153,  153,  153,  153,  153,  153,  153,  153,
+      153,  153,  153,  153,  153,  153,  154,  154,  154,  154,
+      154,  154,  154,    0,  154,  154,  154,  154,  154,  154,
+      154,  154,  154,  154,  154,  154,  154,  154,  155,  155,
+      155,  155,  155,  155,  155,    0,  155,  155,  155,  155,
+      155,  155,  155,  155,  155,  155,  155,  155,  155,  155,
+      156,  156,  156,  156,  156,  156,  156,    0,  156,  156,
+      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
+      156,  156,  157,  157,  157,  157,  157,  157,  157,    0,
+
+      157,  157,  157,  157,  157,  157,  157,  157,  157,  157,
+      157,  157,  157,  157,  158,  158,  158,  158,  158,  158,
+      158,    0,  158,  158,  158,  158,  158,  158,  158,  158,
+      158,  158,  158,  158,  158,  158,  159,  159,  159,  159,
+      159,  159,  159,    0,  159,  159,  159,  159,  159,  159,
+      159,  159,  159,  159,  159,  159,  159,  159,  160,  160,
+      160,  160,  160,  160,  160,    0,  160,  160,  160,  160,
+      160,  160,  160,  160,  160,  160,  160,  160,  160,  160,
+      161,  161,  161,  161,  161,  161,  161,    0,  161,  161,
+      161,  161,  161,  161,  161,  161,  161,  161,  161,  161,
+
+      161,  161,  162,  162,  162,  162,  162,  162,  162,    0,
+      162,  162,  162,  162,  162,  162,  162,  162,  162,  162,
+      162,  162,  162,  162,  163,  163,  163,  163,  163,  163,
+      163,    0,  163,  163,  163,  163,  163,  163,  163,  163,
+      163,  163,  163,  163,  163,  163,  164,  164,  164,  164,
+      164,  164,  164,    0,  164,  164,  164,  164,  164,  164,
+      164,  164,  164,  164,  164,  164,  164,  164,  165,  165,
+      165,  165,  165,  165,  165,    0,  165,  165,  165,  165,
+      165,  165,  165,  165,  165,  165,  165,  165,  165,  165,
+      166,  166,  166,  166,  166,  166,  166,    0,  166,  166,
+
+      166,  166,  166,  166,  166,  166,  166,  166,  166,  166,
+      166,  166,  167,  167,  167,  167,  167,  167,  167,    0,
+      167,  167,  167,  167,  167,  167,  167,  167,  167,  167,
+      167,  167,  167,  167,  168,  168,  168,  168,  168,  168,
+      168,    0,  168,  168,  168,  168,  168,  168,  168,  168,
+      168,  168,  168,  168,  168,  168,  169,  169,  169,  169,
+      169,  169,  169,    0,  169,  169,  169,  169,  169,  169,
+      169,  169,  169,  169,  169,  169,  169,  169,  170,  170,
+      170,  170,  170,  170,  170,    0,  170,  170,  170,  170,
+      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
+
+      171,  171,  171,  171,  171,  171,  171,    0,  171,  171,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  172,  172,  172,  172,  172,  172,  172,    0,
+      172,  172,  172,  172,  172,  172,  172,  172,  172,  172,
+      172,  172,  172,  172,  173,  173,  173,  173,  173,  173,
+      173,    0,  173,  173,  173,  173,  173,  173,  173,  173,
+      173,  173,  173,  173,  173,  173,  174,  174,  174,  174,
+      174,  174,  174,    0,  174,  174,  174,  174,  174,  174,
+      174,  174,  174,  174,  174,  174,  174,  174,  175,  175,
+      175,  175,  175,  175,  175,    0,  175,  175,  175,  175,
+
+      175,  175,  175,  175,  175,  175,  175,  175,  175,  175,
+      176,  176,  176,  176,  176,  176,  176,    0,  176,  176,
+      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
+      176,  176,  177,  177,  177,  177,  177,  177,  177,    0,
+      177,  177,  177,  177,  177,  177,  177,  177,  177,  177,
+      177,  177,  177,  177,  178,  178,  178,  178,  178,  178,
+      178,    0,  178,  178,  178,  178,  178,  178,  178,  178,
+      178,  178,  178,  178,  178,  178,  179,  179,  179,  179,
+      179,  179,  179,    0,  179,  179,  179,  179,  179,  179,
+      179,  179,  179,  179,  179,  179,  179,  179,  180,  180,
+
+      180,  180,  180,  180,  180,    0,  180,  180,  180,  180,
+      180,  180,  180,  180,  180,  180,  180,  180,  180,  180,
+      181,  181,  181,  181,  181,  181,  181,    0,  181,  181,
+      181,  181,  181,  181,  181,  181,  181,  181,  181,  181,
+      181,  181,  182,  182,  182,  182,  182,  182,  182,    0,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  183,  183,  183,  183,  183,  183,
+      183,    0,  183,  183,  183,  183,  183,  183,  183,  183,
+      183,  183,  183,  183,  183,  183,  184,  184,  184,  184,
+      184,  184,  184,    0,  184,  184,  184,  184,  184,  184,
+
+      184,  184,  184,  184,  184,  184,  184,  184,  185,  185,
+      185,  185,  185,  185,  185,    0,  185,  185,  185,  185,
+      185,  185,  185,  185,  185,  185,  185,  185,  185,  185,
+      186,  186,  186,  186,  186,  186,  186,    0,  186,  186,
+      186,  186,  186,  186,  186,  186,  186,  186,  186,  186,
+      186,  186,  187,  187,  187,  187,  187,  187,  187,    0,
+      187,  187,  187,  187,  187,  187,  187,  187,  187,  187,
+      187,  187,  187,  187,  188,  188,  188,  188,  188,  188,
+      188,    0,  188,  188,  188,  188,  188,  188,  188,  188,
+      188,  188,  188,  188,  188,  188,  189,  189,  189,  189,
+
+      189,  189,  189,    0,  189,  189,  189,  189,  189,  189,
+      189,  189,  189,  189,  189,  189,  189,  189,  190,  190,
+      190,  190,  190,  190,  190,    0,  190,  190,  190,  190,
+      190,  190,  190,  190,  190,  190,  190,  190,  190,  190,
+      191,  191,  191,  191,  191,  191,  191,    0,  191,  191,
+      191,  191,  191,  191,  191,  191,  191,  191,  191,  191,
+      191,  191,  192,  192,  192,  192,  192,  192,  192,    0,
+      192,  192,  192,  192,  192,  192,  192,  192,  192,  192,
+      192,  192,  192,  192,  193,  193,  193,  193,  193,  193,
+      193,    0,  193,  193,  193,  193,  193,  193,  193,  193,
+
+      193,  193,  193,  193,  193,  193,  194,  194,  194,  194,
+      194,  194,  194,    0,  194,  194,  194,  194,  194,  194,
+      194,  194,  194,  194,  194,  194,  194,  194,  195,  195,
+      195,  195,  195,  195,  195,    0,  195,  195,  195,  195,
+      195,  195,  195,  195,  195,  195,  195,  195,  195,  195,
+      196,  196,  196,  196,  196,  196,  196,    0,  196,  196,
+      196,  196,  196,  196,  196,  196,  196,  196,  196,  196,
+      196,  196,  197,  197,  197,  197,  197,  197,  197,    0,
+      197,  197,  197,  197,  197,  197,  197,  197,  197,  197,
+      197,  197,  197,  197,  198,  198,  198,  198,  198,  198,
+
+      198,    0,  198,  198,  198,  198,  198,  198,  198,  198,
+      198,  198,  198,  198,  198,  198,  199,  199,  199,  199,
+      199,  199,  199,    0,  199,  199,  199,  199,  199,  199,
+      199,  199,  199,  199,  199,  199,  199,  199,  200,  200,
+      200,  200,  200,  200,  200,    0,  200,  200,  200,  200,
+      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
+      201,  201,  201,  201,  201,  201,  201,    0,  201,  201,
+      201,  201,  201,  201,  201,  201,  201,  201,  201,  201,
+      201,  201,  202,  202,  202,  202,  202,  202,  202,    0,
+      202,  202,  202,  202,  202,  202,  202,  202,  202,  202,
+
+      202,  202,  202,  202,  203,  203,  203,  203,  203,  203,
+      203,    0,  203,  203,  203,  203,  203,  203,  203,  203,
+      203,  203,  203,  203,  203,  203,  204,  204,  204,  204,
+      204,  204,  204,    0,  204,  204,  204,  204,  204,  204,
+      204,  204,  204,  204,  204,  204,  204,  204,  205,  205,
+      205,  205,  205,  205,  205,    0,  205,  205,  205,  205,
+      205,  205,  205,  205,  205,  205,  205,  205,  205,  205,
+      206,  206,  206,  206,  206,  206,  206,    0,  206,  206,
+      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
+      206,  206,  207,  207,  207,  207,  207,  207,  207,    0,
+
+      207,  207,  207,  207,  207,  207,  207,  207,  207,  207,
+      207,  207,  207,  207,  208,  208,  208,  208,  208,  208,
+      208,    0,  208,  208,  208,  208,  208,  208,  208,  208,
+      208,  208,  208,  208,  208,  208,  209,  209,  209,  209,
+      209,  209,  209,    0,  209,  209,  209,  209,  209,  209,
+      209,  209,  209,  209,  209,  209,  209,  209,  210,  210,
+      210,  210,  210,  210,  210,    0,  210,  210,  210,  210,
+      210,  210,  210,  210,  210,  210,  210,  210,  210,  210,
+      211,  211,  211,  211,  211,  211,  211,    0,  211,  211,
+      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
+
+      211,  211,  212,  212,  212,  212,  212,  212,  212,    0,
+      212,  212,  212,  212,  212,  212,  212,  212,  212,  212,
+      212,  212,  212,  212,  213,  213,  213,  213,  213,  213,
+      213,    0,  213,  213,  213,  213,  213,  213,  213,  213,
+      213,  213,  213,  213,  213,  213,  214,  214,  214,  214,
+      214,  214,  214,    0,  214,  214,  214,  214,  214,  214,
+      214,  214,  214,  214,  214,  214,  214,  214,  215,  215,
+      215,  215,  215,  215,  215,    0,  215,  215,  215,  215,
+      215,  215,  215,  215,  215,  215,  215,  215,  215,  215,
+      216,  216,  216,  216,  216,  216,  216,    0,  216,  216,
+
+      216,  216,  216,  216,  216,  216,  216,  216,  216,  216,
+      216,  216,  217,  217,  217,  217,  217,  217,  217,    0,
+      217,  217,  217,  217,  217,  217,  217,  217,  217,  217,
+      217,  217,  217,  217,  218,  218,  218,  218,  218,  218,
+      218,    0,  218,  218,  218,  218,  218,  218,  218,  218,
+      218,  218,  218,  218,  218,  218,  219,  219,  219,  219,
+      219,  219,  219,    0,  219,  219,  219,  219,  219,  219,
+      219,  219,  219,  219,  219,  219,  219,  219,  220,  220,
+      220,  220,  220,  220,  220,    0,  220,  220,  220,  220,
+      220,  220,  220,  220,  220,  220,  220,  220,  220,  220,
+
+      221,  221,  221,  221,  221,  221,  221,    0,  221,  221,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  222,  222,  222,  222,  222,  222,  222,    0,
+      222,  222,  222,  222,  222,  222,  222,  222,  222,  222,
+      222,  222,  222,  222,  223,  223,  223,  223,  223,  223,
+      223,    0,  223,  223,  223,  223,  223,  223,  223,  223,
+      223,  223,  223,  223,  223,  223,  224,  224,  224,  224,
+      224,  224,  224,    0,  224,  224,  224,  224,  224,  224,
+      224,  224,  224,  224,  224,  224,  224,  224,  225,  225,
+      225,  225,  225,  225,  225,    0,  225,  225,  225,  225,
+
+      225,  225,  225,  225,  225,  225,  225,  225,  225,  225,
+      226,  226,  226,  226,  226,  226,  226,    0,  226,  226,
+      226,  226,  226,  226,  226,  226,  226,  226,  226,  226,
+      226,  226,  227,  227,  227,  227,  227,  227,  227,    0,
+      227,  227,  227,  227,  227,  227,  227,  227,  227,  227,
+      227,  227,  227,  227,  228,  228,  228,  228,  228,  228,
+      228,    0,  228,  228,  228,  228,  228,  228,  228,  228,
+      228,  228,  228,  228,  228,  228,  229,  229,  229,  229,
+      229,  229,  229,    0,  229,  229,  229,  229,  229,  229,
+      229,  229,  229,  229,  229,  229,  229,  229,  230,  230,
+
+      230,  230,  230,  230,  230,    0,  230,  230,  230,  230,
+      230,  230,  230,  230,  230,  230,  230,  230,  230,  230,
+      231,  231,  231,  231,  231,  231,  231,    0,  231,  231,
+      231,  231,  231,  231,  231,  231,  231,  231,  231,  231,
+      231,  231,  232,  232,  232,  232,  232,  232,  232,    0,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  233,  233,  233,  233,  233,  233,
+      233,    0,  233,  233,  233,  233,  233,  233,  233,  233,
+      233,  233,  233,  233,  233,  233,  234,  234,  234,  234,
+      234,  234,  234,    0,  234,  234,  234,  234,  234,  234,
+
+      234,  234,  234,  234,  234,  234,  234,  234,  235,  235,
+      235,  235,  235,  235,  235,    0,  235,  235,  235,  235,
+      235,  235,  235,  235,  235,  235,  235,  235,  235,  235,
+      236,  236,  236,  236,  236,  236,  236,    0,  236,  236,
+      236,  236,  236,  236,  236,  236,  236,  236,  236,  236,
+      236,  236,  237,  237,  237,  237,  237,  237,  237,    0,
+      237,  237,  237,  237,  237,  237,  237,  237,  237,  237,
+      237,  237,  237,  237,  238,  238,  238,  238,  238,  238,
+      238,    0,  238,  238,  238,  238,  238,  238,  238,  238,
+      238,  238,  238,  238,  238,  238,  239,  239,  239,  239,
+
+      239,  239,  239,    0,  239,  239,  239,  239,  239,  239,
+      239,  239,  239,  239,  239,  239,  239,  239,  240,  240,
+      240,  240,  240,  240,  240,    0,  240,  240,  240,  240,
+      240,  240,  240,  240,  240,  240,  240,  240,  240,  240,
+      241,  241,  241,  241,  241,  241,  241,    0,  241,  241,
+      241,  241,  241,  241,  241,  241,  241,  241,  241,  241,
+      241,  241,  242,  242,  242,  242,  242,  242,  242,    0,
+      242,  242,  242,  242,  242,  242,  242,  242,  242,  242,
+      242,  242,  242,  242,  243,  243,  243,  243,  243,  243,
+      243,    0,  243,  243,  243,  243,  243,  243,  243,  243,
+
+      243,  243,  243,  243,  243,  243,  244,  244,  244,  244,
+      244,  244,  244,    0,  244,  244,  244,  244,  244,  244,
+      244,  244,  244,  244,  244,  244,  244,  244,  245,  245,
+      245,  245,  245,  245,  245,    0,  245,  245,  245,  245,
+      245,  245,  245,  245,  245,  245,  245,  245,  245,  245,
+      246,  246,  246,  246,  246,  246,  246,    0,  246,  246,
+      246,  246,  246,  246,  246,  246,  246,  246,  246,  246,
+      246,  246,  247,  247,  247,  247,  247,  247,  247,    0,
+      247,  247,  247,  247,  247,  247,  247,  247,  247,  247,
+      247,  247,  247,  247,  248,  248,  248,  248,  248,  248,
+
+      248,    0,  248,  248,  248,  248,  248,  248,  248,  248,
+      248,  248,  248,  248,  248,  248,  249,  249,  249,  249,
+      249,  249,  249,    0,  249,  249,  249,  249,  249,  249,
+      249,  249,  249,  249,  249,  249,  249,  249,  250,  250,
+      250,  250,  250,  250,  250,    0,  250,  250,  250,  250,
+      250,  250,  250,  250,  250,  250,  250,  250,  250,  250,
+      251,  251,  251,  251,  251,  251,  251,    0,  251,  251,
+      251,  251,  251,  251,  251,  251,  251,  251,  251,  251,
+      251,  251,  252,  252,  252,  252,  252,  252,  252,    0,
+      252,  252,  252,  252,  252,  252,  252,  252,  252,  252,
+
+      252,  252,  252,  252,  253,  253,  253,  253,  253,  253,
+      253,    0,  253,  253,  253,  253,  253,  253,  253,  253,
+      253,  253,  253,  253,  253,  253,  254,  254,  254,  254,
+      254,  254,  254,    0,  254,  254,  254,  254,  254,  254,
+      254,  254,  254,  254,  254,  254,  254,  254,  255,  255,
+      255,  255,  255,  255,  255,    0,  255,  255,  255,  255,
+      255,  255,  255,  255,  255,  255,  255,  255,  255,  255,
+      256,  256,  256,  256,  256,  256,  256,    0,  256,  256,
+      256,  256,  256,  256,  256,  256,  256,  256,  256,  256,
+      256,  256,  257,  257,  257,  257,  257,  257,  257,    0,
+
+      257,  257,  257,  257,  257,  257,  257,  257,  257,  257,
+      257,  257,  257,  257,  258,  258,  258,  258,  258,  258,
+      258,    0,  258,  258,  258,  258,  258,  258,  258,  258,
+      258,  258,  258,  258,  258,  258,  259,  259,  259,  259,
+      259,  259,  259,    0,  259,  259,  259,  259,  259,  259,
+      259,  259,  259,  259,  259,  259,  259,  259,  260,  260,
+      260,  260,  260,  260,  260,    0,  260,  260,  260,  260,
+      260,  260,  260,  260,  260,  260,  260,  260,  260,  260,
+      261,  261,  261,  261,  261,  261,  261,    0,  261,  261,
+      261,  261,  261,  261,  261,  261,  261,  261,  261,  261,
+
+      261,  261,  262,  262,  262,  262,  262,  262,  262,    0,
+      262,  262,  262,  262,  262,  262,  262,  262,  262,  262,
+      262,  262,  262,  262,  263,  263,  263,  263,  263,  263,
+      263,    0,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  264,  264,  264,  264,
+      264,  264,  264,    0,  264,  264,  264,  264,  264,  264,
+      264,  264,  264,  264,  264,  264,  264,  264,  265,  265,
+      265,  265,  265,  265,  265,    0,  265,  265,  265,  265,
+      265,  265,  265,  265,  265,  265,  265,  265,  265,  265,
+      266,  266,  266,  266,  266,  266,  266,    0,  266,  266,
+
+      266,  266,  266,  266,  266,  266,  266,  266,  266,  266,
+      266,  266,  267,  267,  267,  267,  267,  267,  267,    0,
+      267,  267,  267,  267,  267,  267,  267,  267,  267,  267,
+      267,  267,  267,  267,  268,  268,  268,  268,  268,  268,
+      268,    0,  268,  268,  268,  268,  268,  268,  268,  268,
+      268,  268,  268,  268,  268,  268,  269,  269,  269,  269,
+      269,  269,  269,    0,  269,  269,  269,  269,  269,  269,
+      269,  269,  269,  269,  269,  269,  269,  269,  270,  270,
+      270,  270,  270,  270,  270,    0,  270,  270,  270,  270,
+      270,  270,  270,  270,  270,  270,  270,  270,  270,  270,
+
+      271,  271,  271,  271,  271,  271,  271,    0,  271,  271,
+      271,  271,  271,  271,  271,  271,  271,  271,  271,  271,
+      271,  271,  272,  272,  272,  272,  272,  272,  272,    0,
+      272,  272,  272,  272,  272,  272,  272,  272,  272,  272,
+      272,  272,  272,  272,  273,  273,  273,  273,  273,  273,
+      273,    0,  273,  273,  273,  273,  273,  273,  273,  273,
+      273,  273,  273,  273,  273,  273,  274,  274,  274,  274,
+      274,  274,  274,    0,  274,  274,  274,  274,  274,  274,
+      274,  274,  274,  274,  274,  274,  274,  274,  275,  275,
+      275,  275,  275,  275,  275,    0,  275,  275,  275,  275,
+
+      275,  275,  275,  275,  275,  275,  275,  275,  275,  275,
+      276,  276,  276,  276,  276,  276,  276,    0,  276,  276,
+      276,  276,  276,  276,  276,  276,  276,  276,  276,  276,
+      276,  276,  277,  277,  277,  277,  277,  277,  277,    0,
+      277,  277,  277,  277,  277,  277,  277,  277,  277,  277,
+      277,  277,  277,  277,  278,  278,  278,  278,  278,  278,
+      278,    0,  278,  278,  278,  278,  278,  278,  278,  278,
+      278,  278,  278,  278,  278,  278,  279,  279,  279,  279,
+      279,  279,  279,    0,  279,  279,  279,  279,  279,  279,
+      279,  279,  279,  279,  279,  279,  279,  279,  280,  280,
+
+      280,  280,  280,  280,  280,    0,  280,  280,  280,  280,
+      280,  280,  280,  280,  280,  280,  280,  280,  280,  280,
+      281,  281,  281,  281,  281,  281,  281,    0,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  282,  282,  282,  282,  282,  282,  282,    0,
+      282,  282,  282,  282,  282,  282,  282,  282,  282,  282,
+      282,  282,  282,  282,  283,  283,  283,  283,  283,  283,
+      283,    0,  283,  283,  283,  283,  283,  283,  283,  283,
+      283,  283,  283,  283,  283,  283,  284,  284,  284,  284,
+      284,  284,  284,    0,  284,  284,  284,  284,  284,  284,
+
+      284,  284,  284,  284,  284,  284,  284,  284,  285,  285,
+      285,  285,  285,  285,  285,    0,  285,  285,  285,  285,
+      285,  285,  285,  285,  285,  285,  285,  285,  285,  285,
+      286,  286,  286,  286,  286,  286,  286,    0,  286,  286,
+      286,  286,  286,  286,  286,  286,  286,  286,  286,  286,
+      286,  286,  287,  287,  287,  287,  287,  287,  287,    0,
+      287,  287,  287,  287,  287,  287,  287,  287,  287,  287,
+      287,  287,  287,  287,  288,  288,  288,  288,  288,  288,
+      288,    0,  288,  288,  288,  288,  288,  288,  288,  288,
+      288,  288,  288,  288,  288,  288,  289,  289,  289,  289,
+
+      289,  289,  289,    0,  289,  289,  289,  289,  289,  289,
+      289,  289,  289,  289,  289,  289,  289,  289,  290,  290,
+      290,  290,  290,  290,  290,    0,  290,  290,  290,  290,
+      290,  290,  290,  290,  290,  290,  290,  290,  290,  290,
+      291,  291,  291,  291,  291,  291,  291,    0,  291,  291,
+      291,  291,  291,  291,  291,  291,  291,  291,  291,  291,
+      291,  291,  292,  292,  292,  292,  292,  292,  292,    0,
+      292,  292,  292,  292,  292,  292,  292,  292,  292,  292,
+      292,  292,  292,  292,  293,  293,  293,  293,  293,  293,
+      293,    0,  293,  293,  293,  293,  293,  293,  293,  293,
+
+      293,  293,  293,  293,  293,  293,  294,  294,  294,  294,
+      294,  294,  294,    0,  294,  294,  294,  294,  294,  294,
+      294,  294,  294,  294,  294,  294,  294,  294,    5,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295
     } ;
 
-static const flex_int16_t yy_chk[137] =
+static const flex_int16_t yy_chk[5752] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    5,    5,    6,    6,
-       15,   16,   23,   16,   23,   15,   24,   31,   31,   53,
-       38,   24,   38,   80,   53,   79,   74,   79,   81,   81,
-       81,   82,   73,   82,   70,   69,   68,   67,   66,   63,
-       62,   61,   60,   57,   56,   55,   52,   51,   50,   49,
-       48,   47,   45,   44,   43,   37,   35,   33,   28,   27,
-       26,   25,   22,   20,   19,   18,    8,    7,    3,   78,
-
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   78,   78,   78,   78
+        1,    1,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    5,    6,    7,    7,    8,   16,
+       17,   19,   17,   20,   16,   21,    6,   27,   33,    0,
+        0,    0,   27,    0,    9,    9,    6,    9,    9,    9,
+        9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+        9,    9,    9,    9,    9,    9,   22,   25,   37,    0,
+        0,   22,   25,   37,   22,   25,   26,   26,   26,   26,
+
+       26,   26,   26,    0,   26,   26,   26,   26,   26,   26,
+       26,   26,   26,   26,   26,   26,   26,   26,   32,   32,
+        0,   32,   32,   32,   32,   32,   32,   32,   32,   32,
+        0,   32,   32,   32,   32,   32,   32,   32,   32,   32,
+       38,   38,   38,   38,   38,   38,   38,    0,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   41,   41,   41,   41,   41,   41,   41,    0,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   42,   42,   42,   42,   42,   42,
+       42,    0,   42,   42,   42,   42,   42,   42,   42,   42,
+
+       42,   42,   42,   42,   42,   42,   43,   43,   43,   43,
+       43,   43,   43,    0,   43,   43,   43,   43,   43,   43,
+       43,   43,   43,   43,   43,   43,   43,   43,   44,   44,
+       44,   44,   44,   44,   44,    0,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       45,   45,   45,   45,   45,   45,   45,    0,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   46,   46,   46,   46,   46,   46,   46,    0,
+       46,   46,   46,   46,   46,   46,   46,   46,   46,   46,
+       46,   46,   46,   46,   47,   47,   47,   47,   47,   47,
+
+       47,    0,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   48,   48,   48,   48,
+       48,   48,   48,    0,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   49,   49,
+       49,   49,   49,   49,   49,    0,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       50,   50,   50,   50,   50,   50,   50,    0,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   51,   51,   51,   51,   51,   51,   51,    0,
+       51,   51,   51,   51,   51,   51,   51,   51,   51,   51,
+
+       51,   51,   51,   51,   52,   52,   52,   52,   52,   52,
+       52,    0,   52,   52,   52,   52,   52,   52,   52,   52,
+       52,   52,   52,   52,   52,   52,   53,   53,   53,   53,
+       53,   53,   53,    0,   53,   53,   53,   53,   53,   53,
+       53,   53,   53,   53,   53,   53,   53,   53,   54,   54,
+       54,   54,   54,   54,   54,    0,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       55,   55,   55,   55,   55,   55,   55,    0,   55,   55,
+       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
+       55,   55,   56,   56,   56,   56,   56,   56,   56,    0,
+
+       56,   56,   56,   56,   56,   56,   56,   56,   56,   56,
+       56,   56,   56,   56,   57,   57,   57,   57,   57,   57,
+       57,    0,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   58,   58,   58,   58,
+       58,   58,   58,    0,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   59,   59,
+       59,   59,   59,   59,   59,    0,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,   59,
+       60,   60,   60,   60,   60,   60,   60,    0,   60,   60,
+       60,   60,   60,   60,   60,   60,   60,   60,   60,   60,
+
+       60,   60,   61,   61,   61,   61,   61,   61,   61,    0,
+       61,   61,   61,   61,   61,   61,   61,   61,   61,   61,
+       61,   61,   61,   61,   62,   62,   62,   62,   62,   62,
+       62,    0,   62,   62,   62,   62,   62,   62,   62,   62,
+       62,   62,   62,   62,   62,   62,   63,   63,   63,   63,
+       63,   63,   63,    0,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   64,   64,
+       64,   64,   64,   64,   64,    0,   64,   64,   64,   64,
+       64,   64,   64,   64,   64,   64,   64,   64,   64,   64,
+       65,   65,   65,   65,   65,   65,   65,    0,   65,   65,
+
+       65,   65,   65,   65,   65,   65,   65,   65,   65,   65,
+       65,   65,   66,   66,   66,   66,   66,   66,   66,    0,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   67,   67,   67,   67,   67,   67,
+       67,    0,   67,   67,   67,   67,   67,   67,   67,   67,
+       67,   67,   67,   67,   67,   67,   68,   68,   68,   68,
+       68,   68,   68,    0,   68,   68,   68,   68,   68,   68,
+       68,   68,   68,   68,   68,   68,   68,   68,   69,   69,
+       69,   69,   69,   69,   69,    0,   69,   69,   69,   69,
+       69,   69,   69,   69,   69,   69,   69,   69,   69,   69,
+
+       70,   70,   70,   70,   70,   70,   70,    0,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   71,   71,   71,   71,   71,   71,   71,    0,
+       71,   71,   71,   71,   71,   71,   71,   71,   71,   71,
+       71,   71,   71,   71,   72,   72,   72,   72,   72,   72,
+       72,    0,   72,   72,   72,   72,   72,   72,   72,   72,
+       72,   72,   72,   72,   72,   72,   73,   73,   73,   73,
+       73,   73,   73,    0,   73,   73,   73,   73,   73,   73,
+       73,   73,   73,   73,   73,   73,   73,   73,   74,   74,
+       74,   74,   74,   74,   74,    0,   74,   74,   74,   74,
+
+       74,   74,   74,   74,   74,   74,   74,   74,   74,   74,
+       75,   75,   75,   75,   75,   75,   75,    0,   75,   75,
+       75,   75,   75,   75,   75,   75,   75,   75,   75,   75,
+       75,   75,   76,   76,   76,   76,   76,   76,   76,    0,
+       76,   76,   76,   76,   76,   76,   76,   76,   76,   76,
+       76,   76,   76,   76,   77,   77,   77,   77,   77,   77,
+       77,    0,   77,   77,   77,   77,   77,   77,   77,   77,
+       77,   77,   77,   77,   77,   77,   78,   78,   78,   78,
+       78,   78,   78,    0,   78,   78,   78,   78,   78,   78,
+       78,   78,   78,   78,   78,   78,   78,   78,   79,   79,
+
+       79,   79,   79,   79,   79,    0,   79,   79,   79,   79,
+       79,   79,   79,   79,   79,   79,   79,   79,   79,   79,
+       80,   80,   80,   80,   80,   80,   80,    0,   80,   80,
+       80,   80,   80,   80,   80,   80,   80,   80,   80,   80,
+       80,   80,   81,   81,   81,   81,   81,   81,   81,    0,
+       81,   81,   81,   81,   81,   81,   81,   81,   81,   81,
+       81,   81,   81,   81,   82,   82,   82,   82,   82,   82,
+       82,    0,   82,   82,   82,   82,   82,   82,   82,   82,
+       82,   82,   82,   82,   82,   82,   83,   83,   83,   83,
+       83,   83,   83,    0,   83,   83,   83,   83,   83,   83,
+
+       83,   83,   83,   83,   83,   83,   83,   83,   84,   84,
+       84,   84,   84,   84,   84,    0,   84,   84,   84,   84,
+       84,   84,   84,   84,   84,   84,   84,   84,   84,   84,
+       85,   85,   85,   85,   85,   85,   85,    0,   85,   85,
+       85,   85,   85,   85,   85,   85,   85,   85,   85,   85,
+       85,   85,   86,   86,   86,   86,   86,   86,   86,    0,
+       86,   86,   86,   86,   86,   86,   86,   86,   86,   86,
+       86,   86,   86,   86,   87,   87,   87,   87,   87,   87,
+       87,    0,   87,   87,   87,   87,   87,   87,   87,   87,
+       87,   87,   87,   87,   87,   87,   88,   88,   88,   88,
+
+       88,   88,   88,    0,   88,   88,   88,   88,   88,   88,
+       88,   88,   88,   88,   88,   88,   88,   88,   89,   89,
+       89,   89,   89,   89,   89,    0,   89,   89,   89,   89,
+       89,   89,   89,   89,   89,   89,   89,   89,   89,   89,
+       90,   90,   90,   90,   90,   90,   90,    0,   90,   90,
+       90,   90,   90,   90,   90,   90,   90,   90,   90,   90,
+       90,   90,   91,   91,   91,   91,   91,   91,   91,    0,
+       91,   91,   91,   91,   91,   91,   91,   91,   91,   91,
+       91,   91,   91,   91,   92,   92,   92,   92,   92,   92,
+       92,    0,   92,   92,   92,   92,   92,   92,   92,   92,
+
+       92,   92,   92,   92,   92,   92,   93,   93,   93,   93,
+       93,   93,   93,    0,   93,   93,   93,   93,   93,   93,
+       93,   93,   93,   93,   93,   93,   93,   93,   94,   94,
+       94,   94,   94,   94,   94,    0,   94,   94,   94,   94,
+       94,   94,   94,   94,   94,   94,   94,   94,   94,   94,
+       95,   95,   95,   95,   95,   95,   95,    0,   95,   95,
+       95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+       95,   95,   96,   96,   96,   96,   96,   96,   96,    0,
+       96,   96,   96,   96,   96,   96,   96,   96,   96,   96,
+       96,   96,   96,   96,   97,   97,   97,   97,   97,   97,
+
+       97,    0,   97,   97,   97,   97,   97,   97,   97,   97,
+       97,   97,   97,   97,   97,   97,   98,   98,   98,   98,
+       98,   98,   98,    0,   98,   98,   98,   98,   98,   98,
+       98,   98,   98,   98,   98,   98,   98,   98,   99,   99,
+       99,   99,   99,   99,   99,    0,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+      100,  100,  100,  100,  100,  100,  100,    0,  100,  100,
+      100,  100,  100,  100,  100,  100,  100,  100,  100,  100,
+      100,  100,  101,  101,  101,  101,  101,  101,  101,    0,
+      101,  101,  101,  101,  101,  101,  101,  101,  101,  101,
+
+      101,  101,  101,  101,  102,  102,  102,  102,  102,  102,
+      102,    0,  102,  102,  102,  102,  102,  102,  102,  102,
+      102,  102,  102,  102,  102,  102,  103,  103,  103,  103,
+      103,  103,  103,    0,  103,  103,  103,  103,  103,  103,
+      103,  103,  103,  103,  103,  103,  103,  103,  104,  104,
+      104,  104,  104,  104,  104,    0,  104,  104,  104,  104,
+      104,  104,  104,  104,  104,  104,  104,  104,  104,  104,
+      105,  105,  105,  105,  105,  105,  105,    0,  105,  105,
+      105,  105,  105,  105,  105,  105,  105,  105,  105,  105,
+      105,  105,  106,  106,  106,  106,  106,  106,  106,    0,
+
+      106,  106,  106,  106,  106,  106,  106,  106,  106,  106,
+      106,  106,  106,  106,  107,  107,  107,  107,  107,  107,
+      107,    0,  107,  107,  107,  107,  107,  107,  107,  107,
+      107,  107,  107,  107,  107,  107,  108,  108,  108,  108,
+      108,  108,  108,    0,  108,  108,  108,  108,  108,  108,
+      108,  108,  108,  108,  108,  108,  108,  108,  109,  109,
+      109,  109,  109,  109,  109,    0,  109,  109,  109,  109,
+      109,  109,  109,  109,  109,  109,  109,  109,  109,  109,
+      110,  110,  110,  110,  110,  110,  110,    0,  110,  110,
+      110,  110,  110,  110,  110,  110,  110,  110,  110,  110,
+
+      110,  110,  111,  111,  111,  111,  111,  111,  111,    0,
+      111,  111,  111,  111,  111,  111,  111,  111,  111,  111,
+      111,  111,  111,  111,  112,  112,  112,  112,  112,  112,
+      112,    0,  112,  112,  112,  112,  112,  112,  112,  112,
+      112,  112,  112,  112,  112,  112,  113,  113,  113,  113,
+      113,  113,  113,    0,  113,  113,  113,  113,  113,  113,
+      113,  113,  113,  113,  113,  113,  113,  113,  114,  114,
+      114,  114,  114,  114,  114,    0,  114,  114,  114,  114,
+      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
+      115,  115,  115,  115,  115,  115,  115,    0,  115,  115,
+
+      115,  115,  115,  115,  115,  115,  115,  115,  115,  115,
+      115,  115,  116,  116,  116,  116,  116,  116,  116,    0,
+      116,  116,  116,  116,  116,  116,  116,  116,  116,  116,
+      116,  116,  116,  116,  117,  117,  117,  117,  117,  117,
+      117,    0,  117,  117,  117,  117,  117,  117,  117,  117,
+      117,  117,  117,  117,  117,  117,  118,  118,  118,  118,
+      118,  118,  118,    0,  118,  118,  118,  118,  118,  118,
+      118,  118,  118,  118,  118,  118,  118,  118,  119,  119,
+      119,  119,  119,  119,  119,    0,  119,  119,  119,  119,
+      119,  119,  119,  119,  119,  119,  119,  119,  119,  119,
+
+      120,  120,  120,  120,  120,  120,  120,    0,  120,  120,
+      120,  120,  120,  120,  120,  120,  120,  120,  120,  120,
+      120,  120,  121,  121,  121,  121,  121,  121,  121,    0,
+      121,  121,  121,  121,  121,  121,  121,  121,  121,  121,
+      121,  121,  121,  121,  122,  122,  122,  122,  122,  122,
+      122,    0,  122,  122,  122,  122,  122,  122,  122,  122,
+      122,  122,  122,  122,  122,  122,  123,  123,  123,  123,
+      123,  123,  123,    0,  123,  123,  123,  123,  123,  123,
+      123,  123,  123,  123,  123,  123,  123,  123,  124,  124,
+      124,  124,  124,  124,  124,    0,  124,  124,  124,  124,
+
+      124,  124,  124,  124,  124,  124,  124,  124,  124,  124,
+      125,  125,  125,  125,  125,  125,  125,    0,  125,  125,
+      125,  125,  125,  125,  125,  125,  125,  125,  125,  125,
+      125,  125,  126,  126,  126,  126,  126,  126,  126,    0,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  127,  127,  127,  127,  127,  127,
+      127,    0,  127,  127,  127,  127,  127,  127,  127,  127,
+      127,  127,  127,  127,  127,  127,  128,  128,  128,  128,
+      128,  128,  128,    0,  128,  128,  128,  128,  128,  128,
+      128,  128,  128,  128,  128,  128,  128,  128,  129,  129,
+
+      129,  129,  129,  129,  129,    0,  129,  129,  129,  129,
+      129,  129,  129,  129,  129,  129,  129,  129,  129,  129,
+      130,  130,  130,  130,  130,  130,  130,    0,  130,  130,
+      130,  130,  130,  130,  130,  130,  130,  130,  130,  130,
+      130,  130,  131,  131,  131,  131,  131,  131,  131,    0,
+      131,  131,  131,  131,  131,  131,  131,  131,  131,  131,
+      131,  131,  131,  131,  132,  132,  132,  132,  132,  132,
+      132,    0,  132,  132,  132,  132,  132,  132,  132,  132,
+      132,  132,  132,  132,  132,  132,  133,  133,  133,  133,
+      133,  133,  133,    0,  133,  133,  133,  133,  133,  133,
+
+      133,  133,  133,  133,  133,  133,  133,  133,  134,  134,
+      134,  134,  134,  134,  134,    0,  134,  134,  134,  134,
+      134,  134,  134,  134,  134,  134,  134,  134,  134,  134,
+      135,  135,  135,  135,  135,  135,  135,    0,  135,  135,
+      135,  135,  135,  135,  135,  135,  135,  135,  135,  135,
+      135,  135,  136,  136,  136,  136,  136,  136,  136,    0,
+      136,  136,  136,  136,  136,  136,  136,  136,  136,  136,
+      136,  136,  136,  136,  137,  137,  137,  137,  137,  137,
+      137,    0,  137,  137,  137,  137,  137,  137,  137,  137,
+      137,  137,  137,  137,  137,  137,  138,  138,  138,  138,
+
+      138,  138,  138,    0,  138,  138,  138,  138,  138,  138,
+      138,  138,  138,  138,  138,  138,  138,  138,  139,  139,
+      139,  139,  139,  139,  139,    0,  139,  139,  139,  139,
+      139,  139,  139,  139,  139,  139,  139,  139,  139,  139,
+      140,  140,  140,  140,  140,  140,  140,    0,  140,  140,
+      140,  140,  140,  140,  140,  140,  140,  140,  140,  140,
+      140,  140,  141,  141,  141,  141,  141,  141,  141,    0,
+      141,  141,  141,  141,  141,  141,  141,  141,  141,  141,
+      141,  141,  141,  141,  142,  142,  142,  142,  142,  142,
+      142,    0,  142,  142,  142,  142,  142,  142,  142,  142,
+
+      142,  142,  142,  142,  142,  142,  143,  143,  143,  143,
+      143,  143,  143,    0,  143,  143,  143,  143,  143,  143,
+      143,  143,  143,  143,  143,  143,  143,  143,  144,  144,
+      144,  144,  144,  144,  144,    0,  144,  144,  144,  144,
+      144,  144,  144,  144,  144,  144,  144,  144,  144,  144,
+      145,  145,  145,  145,  145,  145,  145,    0,  145,  145,
+      145,  145,  145,  145,  145,  145,  145,  145,  145,  145,
+      145,  145,  146,  146,  146,  146,  146,  146,  146,    0,
+      146,  146,  146,  146,  146,  146,  146,  146,  146,  146,
+      146,  146,  146,  146,  147,  147,  147,  147,  147,  147,
+
+      147,    0,  147,  147,  147,  147,  147,  147,  147,  147,
+      147,  147,  147,  147,  147,  147,  148,  148,  148,  148,
+      148,  148,  148,    0,  148,  148,  148,  148,  148,  148,
+      148,  148,  148,  148,  148,  148,  148,  148,  149,  149,
+      149,  149,  149,  149,  149,    0,  149,  149,  149,  149,
+      149,  149,  149,  149,  149,  149,  149,  149,  149,  149,
+      150,  150,  150,  150,  150,  150,  150,    0,  150,  150,
+      150,  150,  150,  150,  150,  150,  150,  150,  150,  150,
+      150,  150,  151,  151,  151,  151,  151,  151,  151,    0,
+      151,  151,  151,  151,  151,  151,  151,  151,  151,  151,
+
+      151,  151,  151,  151,  152,  152,  152,  152,  152,  152,
+      152,    0,  152,  152,  152,  152,  152,  152,  152,  152,
+      152,  152,  152,  152,  152,  152,  153,  153,  153,  153,
+      153,  153,  153,    0,  153,  153,  153,  153,  153,  153,
+      153,  153,  153,  153,  153,  153,  153,  153,  154,  154,
+      154,  154,  154,  154,  154,    0,  154,  154,  154,  154,
+      154,  154,  154,  154,  154,  154,  154,  154,  154,  154,
+      155,  155,  155,  155,  155,  155,  155,    0,  155,  155,
+      155,  155,  155,  155,  155,  155,  155,  155,  155,  155,
+      155,  155,  156,  156,  156,  156,  156,  156,  156,    0,
+
+      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
+      156,  156,  156,  156,  157,  157,  157,  157,  157,  157,
+      157,    0,  157,  157,  157,  157,  157,  157,  157,  157,
+      157,  157,  157,  157,  157,  157,  158,  158,  158,  158,
+      158,  158,  158,    0,  158,  158,  158,  158,  158,  158,
+      158,  158,  158,  158,  158,  158,  158,  158,  159,  159,
+      159,  159,  159,  159,  159,    0,  159,  159,  159,  159,
+      159,  159,  159,  159,  159,  159,  159,  159,  159,  159,
+      160,  160,  160,  160,  160,  160,  160,    0,  160,  160,
+      160,  160,  160,  160,  160,  160,  160,  160,  160,  160,
+
+      160,  160,  161,  161,  161,  161,  161,  161,  161,    0,
+      161,  161,  161,  161,  161,  161,  161,  161,  161,  161,
+      161,  161,  161,  161,  162,  162,  162,  162,  162,  162,
+      162,    0,  162,  162,  162,  162,  162,  162,  162,  162,
+      162,  162,  162,  162,  162,  162,  163,  163,  163,  163,
+      163,  163,  163,    0,  163,  163,  163,  163,  163,  163,
+      163,  163,  163,  163,  163,  163,  163,  163,  164,  164,
+      164,  164,  164,  164,  164,    0,  164,  164,  164,  164,
+      164,  164,  164,  164,  164,  164,  164,  164,  164,  164,
+      165,  165,  165,  165,  165,  165,  165,    0,  165,  165,
+
+      165,  165,  165,  165,  165,  165,  165,  165,  165,  165,
+      165,  165,  166,  166,  166,  166,  166,  166,  166,    0,
+      166,  166,  166,  166,  166,  166,  166,  166,  166,  166,
+      166,  166,  166,  166,  167,  167,  167,  167,  167,  167,
+      167,    0,  167,  167,  167,  167,  167,  167,  167,  167,
+      167,  167,  167,  167,  167,  167,  168,  168,  168,  168,
+      168,  168,  168,    0,  168,  168,  168,  168,  168,  168,
+      168,  168,  168,  168,  168,  168,  168,  168,  169,  169,
+      169,  169,  169,  169,  169,    0,  169,  169,  169,  169,
+      169,  169,  169,  169,  169,  169,  169,  169,  169,  169,
+
+      170,  170,  170,  170,  170,  170,  170,    0,  170,  170,
+      170,  170,  170,  170,  170,  170,  170,  170,  170,  170,
+      170,  170,  171,  171,  171,  171,  171,  171,  171,    0,
+      171,  171,  171,  171,  171,  171,  171,  171,  171,  171,
+      171,  171,  171,  171,  172,  172,  172,  172,  172,  172,
+      172,    0,  172,  172,  172,  172,  172,  172,  172,  172,
+      172,  172,  172,  172,  172,  172,  173,  173,  173,  173,
+      173,  173,  173,    0,  173,  173,  173,  173,  173,  173,
+      173,  173,  173,  173,  173,  173,  173,  173,  174,  174,
+      174,  174,  174,  174,  174,    0,  174,  174,  174,  174,
+
+      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
+      175,  175,  175,  175,  175,  175,  175,    0,  175,  175,
+      175,  175,  175,  175,  175,  175,  175,  175,  175,  175,
+      175,  175,  176,  176,  176,  176,  176,  176,  176,    0,
+      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
+      176,  176,  176,  176,  177,  177,  177,  177,  177,  177,
+      177,    0,  177,  177,  177,  177,  177,  177,  177,  177,
+      177,  177,  177,  177,  177,  177,  178,  178,  178,  178,
+      178,  178,  178,    0,  178,  178,  178,  178,  178,  178,
+      178,  178,  178,  178,  178,  178,  178,  178,  179,  179,
+
+      179,  179,  179,  179,  179,    0,  179,  179,  179,  179,
+      179,  179,  179,  179,  179,  179,  179,  179,  179,  179,
+      180,  180,  180,  180,  180,  180,  180,    0,  180,  180,
+      180,  180,  180,  180,  180,  180,  180,  180,  180,  180,
+      180,  180,  181,  181,  181,  181,  181,  181,  181,    0,
+      181,  181,  181,  181,  181,  181,  181,  181,  181,  181,
+      181,  181,  181,  181,  182,  182,  182,  182,  182,  182,
+      182,    0,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  183,  183,  183,  183,
+      183,  183,  183,    0,  183,  183,  183,  183,  183,  183,
+
+      183,  183,  183,  183,  183,  183,  183,  183,  184,  184,
+      184,  184,  184,  184,  184,    0,  184,  184,  184,  184,
+      184,  184,  184,  184,  184,  184,  184,  184,  184,  184,
+      185,  185,  185,  185,  185,  185,  185,    0,  185,  185,
+      185,  185,  185,  185,  185,  185,  185,  185,  185,  185,
+      185,  185,  186,  186,  186,  186,  186,  186,  186,    0,
+      186,  186,  186,  186,  186,  186,  186,  186,  186,  186,
+      186,  186,  186,  186,  187,  187,  187,  187,  187,  187,
+      187,    0,  187,  187,  187,  187,  187,  187,  187,  187,
+      187,  187,  187,  187,  187,  187,  188,  188,  188,  188,
+
+      188,  188,  188,    0,  188,  188,  188,  188,  188,  188,
+      188,  188,  188,  188,  188,  188,  188,  188,  189,  189,
+      189,  189,  189,  189,  189,    0,  189,  189,  189,  189,
+      189,  189,  189,  189,  189,  189,  189,  189,  189,  189,
+      190,  190,  190,  190,  190,  190,  190,    0,  190,  190,
+      190,  190,  190,  190,  190,  190,  190,  190,  190,  190,
+      190,  190,  191,  191,  191,  191,  191,  191,  191,    0,
+      191,  191,  191,  191,  191,  191,  191,  191,  191,  191,
+      191,  191,  191,  191,  192,  192,  192,  192,  192,  192,
+      192,    0,  192,  192,  192,  192,  192,  192,  192,  192,
+
+      192,  192,  192,  192,  192,  192,  193,  193,  193,  193,
+      193,  193,  193,    0,  193,  193,  193,  193,  193,  193,
+      193,  193,  193,  193,  193,  193,  193,  193,  194,  194,
+      194,  194,  194,  194,  194,    0,  194,  194,  194,  194,
+      194,  194,  194,  194,  194,  194,  194,  194,  194,  194,
+      195,  195,  195,  195,  195,  195,  195,    0,  195,  195,
+      195,  195,  195,  195,  195,  195,  195,  195,  195,  195,
+      195,  195,  196,  196,  196,  196,  196,  196,  196,    0,
+      196,  196,  196,  196,  196,  196,  196,  196,  196,  196,
+      196,  196,  196,  196,  197,  197,  197,  197,  197,  197,
+
+      197,    0,  197,  197,  197,  197,  197,  197,  197,  197,
+      197,  197,  197,  197,  197,  197,  198,  198,  198,  198,
+      198,  198,  198,    0,  198,  198,  198,  198,  198,  198,
+      198,  198,  198,  198,  198,  198,  198,  198,  199,  199,
+      199,  199,  199,  199,  199,    0,  199,  199,  199,  199,
+      199,  199,  199,  199,  199,  199,  199,  199,  199,  199,
+      200,  200,  200,  200,  200,  200,  200,    0,  200,  200,
+      200,  200,  200,  200,  200,  200,  200,  200,  200,  200,
+      200,  200,  201,  201,  201,  201,  201,  201,  201,    0,
+      201,  201,  201,  201,  201,  201,  201,  201,  201,  201,
+
+      201,  201,  201,  201,  202,  202,  202,  202,  202,  202,
+      202,    0,  202,  202,  202,  202,  202,  202,  202,  202,
+      202,  202,  202,  202,  202,  202,  203,  203,  203,  203,
+      203,  203,  203,    0,  203,  203,  203,  203,  203,  203,
+      203,  203,  203,  203,  203,  203,  203,  203,  204,  204,
+      204,  204,  204,  204,  204,    0,  204,  204,  204,  204,
+      204,  204,  204,  204,  204,  204,  204,  204,  204,  204,
+      205,  205,  205,  205,  205,  205,  205,    0,  205,  205,
+      205,  205,  205,  205,  205,  205,  205,  205,  205,  205,
+      205,  205,  206,  206,  206,  206,  206,  206,  206,    0,
+
+      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
+      206,  206,  206,  206,  207,  207,  207,  207,  207,  207,
+      207,    0,  207,  207,  207,  207,  207,  207,  207,  207,
+      207,  207,  207,  207,  207,  207,  208,  208,  208,  208,
+      208,  208,  208,    0,  208,  208,  208,  208,  208,  208,
+      208,  208,  208,  208,  208,  208,  208,  208,  209,  209,
+      209,  209,  209,  209,  209,    0,  209,  209,  209,  209,
+      209,  209,  209,  209,  209,  209,  209,  209,  209,  209,
+      210,  210,  210,  210,  210,  210,  210,    0,  210,  210,
+      210,  210,  210,  210,  210,  210,  210,  210,  210,  210,
+
+      210,  210,  211,  211,  211,  211,  211,  211,  211,    0,
+      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
+      211,  211,  211,  211,  212,  212,  212,  212,  212,  212,
+      212,    0,  212,  212,  212,  212,  212,  212,  212,  212,
+      212,  212,  212,  212,  212,  212,  213,  213,  213,  213,
+      213,  213,  213,    0,  213,  213,  213,  213,  213,  213,
+      213,  213,  213,  213,  213,  213,  213,  213,  214,  214,
+      214,  214,  214,  214,  214,    0,  214,  214,  214,  214,
+      214,  214,  214,  214,  214,  214,  214,  214,  214,  214,
+      215,  215,  215,  215,  215,  215,  215,    0,  215,  215,
+
+      215,  215,  215,  215,  215,  215,  215,  215,  215,  215,
+      215,  215,  216,  216,  216,  216,  216,  216,  216,    0,
+      216,  216,  216,  216,  216,  216,  216,  216,  216,  216,
+      216,  216,  216,  216,  217,  217,  217,  217,  217,  217,
+      217,    0,  217,  217,  217,  217,  217,  217,  217,  217,
+      217,  217,  217,  217,  217,  217,  218,  218,  218,  218,
+      218,  218,  218,    0,  218,  218,  218,  218,  218,  218,
+      218,  218,  218,  218,  218,  218,  218,  218,  219,  219,
+      219,  219,  219,  219,  219,    0,  219,  219,  219,  219,
+      219,  219,  219,  219,  219,  219,  219,  219,  219,  219,
+
+      220,  220,  220,  220,  220,  220,  220,    0,  220,  220,
+      220,  220,  220,  220,  220,  220,  220,  220,  220,  220,
+      220,  220,  221,  221,  221,  221,  221,  221,  221,    0,
+      221,  221,  221,  221,  221,  221,  221,  221,  221,  221,
+      221,  221,  221,  221,  222,  222,  222,  222,  222,  222,
+      222,    0,  222,  222,  222,  222,  222,  222,  222,  222,
+      222,  222,  222,  222,  222,  222,  223,  223,  223,  223,
+      223,  223,  223,    0,  223,  223,  223,  223,  223,  223,
+      223,  223,  223,  223,  223,  223,  223,  223,  224,  224,
+      224,  224,  224,  224,  224,    0,  224,  224,  224,  224,
+
+      224,  224,  224,  224,  224,  224,  224,  224,  224,  224,
+      225,  225,  225,  225,  225,  225,  225,    0,  225,  225,
+      225,  225,  225,  225,  225,  225,  225,  225,  225,  225,
+      225,  225,  226,  226,  226,  226,  226,  226,  226,    0,
+      226,  226,  226,  226,  226,  226,  226,  226,  226,  226,
+      226,  226,  226,  226,  227,  227,  227,  227,  227,  227,
+      227,    0,  227,  227,  227,  227,  227,  227,  227,  227,
+      227,  227,  227,  227,  227,  227,  228,  228,  228,  228,
+      228,  228,  228,    0,  228,  228,  228,  228,  228,  228,
+      228,  228,  228,  228,  228,  228,  228,  228,  229,  229,
+
+      229,  229,  229,  229,  229,    0,  229,  229,  229,  229,
+      229,  229,  229,  229,  229,  229,  229,  229,  229,  229,
+      230,  230,  230,  230,  230,  230,  230,    0,  230,  230,
+      230,  230,  230,  230,  230,  230,  230,  230,  230,  230,
+      230,  230,  231,  231,  231,  231,  231,  231,  231,    0,
+      231,  231,  231,  231,  231,  231,  231,  231,  231,  231,
+      231,  231,  231,  231,  232,  232,  232,  232,  232,  232,
+      232,    0,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  233,  233,  233,  233,
+      233,  233,  233,    0,  233,  233,  233,  233,  233,  233,
+
+      233,  233,  233,  233,  233,  233,  233,  233,  234,  234,
+      234,  234,  234,  234,  234,    0,  234,  234,  234,  234,
+      234,  234,  234,  234,  234,  234,  234,  234,  234,  234,
+      235,  235,  235,  235,  235,  235,  235,    0,  235,  235,
+      235,  235,  235,  235,  235,  235,  235,  235,  235,  235,
+      235,  235,  236,  236,  236,  236,  236,  236,  236,    0,
+      236,  236,  236,  236,  236,  236,  236,  236,  236,  236,
+      236,  236,  236,  236,  237,  237,  237,  237,  237,  237,
+      237,    0,  237,  237,  237,  237,  237,  237,  237,  237,
+      237,  237,  237,  237,  237,  237,  238,  238,  238,  238,
+
+      238,  238,  238,    0,  238,  238,  238,  238,  238,  238,
+      238,  238,  238,  238,  238,  238,  238,  238,  239,  239,
+      239,  239,  239,  239,  239,    0,  239,  239,  239,  239,
+      239,  239,  239,  239,  239,  239,  239,  239,  239,  239,
+      240,  240,  240,  240,  240,  240,  240,    0,  240,  240,
+      240,  240,  240,  240,  240,  240,  240,  240,  240,  240,
+      240,  240,  241,  241,  241,  241,  241,  241,  241,    0,
+      241,  241,  241,  241,  241,  241,  241,  241,  241,  241,
+      241,  241,  241,  241,  242,  242,  242,  242,  242,  242,
+      242,    0,  242,  242,  242,  242,  242,  242,  242,  242,
+
+      242,  242,  242,  242,  242,  242,  243,  243,  243,  243,
+      243,  243,  243,    0,  243,  243,  243,  243,  243,  243,
+      243,  243,  243,  243,  243,  243,  243,  243,  244,  244,
+      244,  244,  244,  244,  244,    0,  244,  244,  244,  244,
+      244,  244,  244,  244,  244,  244,  244,  244,  244,  244,
+      245,  245,  245,  245,  245,  245,  245,    0,  245,  245,
+      245,  245,  245,  245,  245,  245,  245,  245,  245,  245,
+      245,  245,  246,  246,  246,  246,  246,  246,  246,    0,
+      246,  246,  246,  246,  246,  246,  246,  246,  246,  246,
+      246,  246,  246,  246,  247,  247,  247,  247,  247,  247,
+
+      247,    0,  247,  247,  247,  247,  247,  247,  247,  247,
+      247,  247,  247,  247,  247,  247,  248,  248,  248,  248,
+      248,  248,  248,    0,  248,  248,  248,  248,  248,  248,
+      248,  248,  248,  248,  248,  248,  248,  248,  249,  249,
+      249,  249,  249,  249,  249,    0,  249,  249,  249,  249,
+      249,  249,  249,  249,  249,  249,  249,  249,  249,  249,
+      250,  250,  250,  250,  250,  250,  250,    0,  250,  250,
+      250,  250,  250,  250,  250,  250,  250,  250,  250,  250,
+      250,  250,  251,  251,  251,  251,  251,  251,  251,    0,
+      251,  251,  251,  251,  251,  251,  251,  251,  251,  251,
+
+      251,  251,  251,  251,  252,  252,  252,  252,  252,  252,
+      252,    0,  252,  252,  252,  252,  252,  252,  252,  252,
+      252,  252,  252,  252,  252,  252,  253,  253,  253,  253,
+      253,  253,  253,    0,  253,  253,  253,  253,  253,  253,
+      253,  253,  253,  253,  253,  253,  253,  253,  254,  254,
+      254,  254,  254,  254,  254,    0,  254,  254,  254,  254,
+      254,  254,  254,  254,  254,  254,  254,  254,  254,  254,
+      255,  255,  255,  255,  255,  255,  255,    0,  255,  255,
+      255,  255,  255,  255,  255,  255,  255,  255,  255,  255,
+      255,  255,  256,  256,  256,  256,  256,  256,  256,    0,
+
+      256,  256,  256,  256,  256,  256,  256,  256,  256,  256,
+      256,  256,  256,  256,  257,  257,  257,  257,  257,  257,
+      257,    0,  257,  257,  257,  257,  257,  257,  257,  257,
+      257,  257,  257,  257,  257,  257,  258,  258,  258,  258,
+      258,  258,  258,    0,  258,  258,  258,  258,  258,  258,
+      258,  258,  258,  258,  258,  258,  258,  258,  259,  259,
+      259,  259,  259,  259,  259,    0,  259,  259,  259,  259,
+      259,  259,  259,  259,  259,  259,  259,  259,  259,  259,
+      260,  260,  260,  260,  260,  260,  260,    0,  260,  260,
+      260,  260,  260,  260,  260,  260,  260,  260,  260,  260,
+
+      260,  260,  261,  261,  261,  261,  261,  261,  261,    0,
+      261,  261,  261,  261,  261,  261,  261,  261,  261,  261,
+      261,  261,  261,  261,  262,  262,  262,  262,  262,  262,
+      262,    0,  262,  262,  262,  262,  262,  262,  262,  262,
+      262,  262,  262,  262,  262,  262,  263,  263,  263,  263,
+      263,  263,  263,    0,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  264,  264,
+      264,  264,  264,  264,  264,    0,  264,  264,  264,  264,
+      264,  264,  264,  264,  264,  264,  264,  264,  264,  264,
+      265,  265,  265,  265,  265,  265,  265,    0,  265,  265,
+
+      265,  265,  265,  265,  265,  265,  265,  265,  265,  265,
+      265,  265,  266,  266,  266,  266,  266,  266,  266,    0,
+      266,  266,  266,  266,  266,  266,  266,  266,  266,  266,
+      266,  266,  266,  266,  267,  267,  267,  267,  267,  267,
+      267,    0,  267,  267,  267,  267,  267,  267,  267,  267,
+      267,  267,  267,  267,  267,  267,  268,  268,  268,  268,
+      268,  268,  268,    0,  268,  268,  268,  268,  268,  268,
+      268,  268,  268,  268,  268,  268,  268,  268,  269,  269,
+      269,  269,  269,  269,  269,    0,  269,  269,  269,  269,
+      269,  269,  269,  269,  269,  269,  269,  269,  269,  269,
+
+      270,  270,  270,  270,  270,  270,  270,    0,  270,  270,
+      270,  270,  270,  270,  270,  270,  270,  270,  270,  270,
+      270,  270,  271,  271,  271,  271,  271,  271,  271,    0,
+      271,  271,  271,  271,  271,  271,  271,  271,  271,  271,
+      271,  271,  271,  271,  272,  272,  272,  272,  272,  272,
+      272,    0,  272,  272,  272,  272,  272,  272,  272,  272,
+      272,  272,  272,  272,  272,  272,  273,  273,  273,  273,
+      273,  273,  273,    0,  273,  273,  273,  273,  273,  273,
+      273,  273,  273,  273,  273,  273,  273,  273,  274,  274,
+      274,  274,  274,  274,  274,    0,  274,  274,  274,  274,
+
+      274,  274,  274,  274,  274,  274,  274,  274,  274,  274,
+      275,  275,  275,  275,  275,  275,  275,    0,  275,  275,
+      275,  275,  275,  275,  275,  275,  275,  275,  275,  275,
+      275,  275,  276,  276,  276,  276,  276,  276,  276,    0,
+      276,  276,  276,  276,  276,  276,  276,  276,  276,  276,
+      276,  276,  276,  276,  277,  277,  277,  277,  277,  277,
+      277,    0,  277,  277,  277,  277,  277,  277,  277,  277,
+      277,  277,  277,  277,  277,  277,  278,  278,  278,  278,
+      278,  278,  278,    0,  278,  278,  278,  278,  278,  278,
+      278,  278,  278,  278,  278,  278,  278,  278,  279,  279,
+
+      279,  279,  279,  279,  279,    0,  279,  279,  279,  279,
+      279,  279,  279,  279,  279,  279,  279,  279,  279,  279,
+      280,  280,  280,  280,  280,  280,  280,    0,  280,  280,
+      280,  280,  280,  280,  280,  280,  280,  280,  280,  280,
+      280,  280,  281,  281,  281,  281,  281,  281,  281,    0,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  282,  282,  282,  282,  282,  282,
+      282,    0,  282,  282,  282,  282,  282,  282,  282,  282,
+      282,  282,  282,  282,  282,  282,  283,  283,  283,  283,
+      283,  283,  283,    0,  283,  283,  283,  283,  283,  283,
+
+      283,  283,  283,  283,  283,  283,  283,  283,  284,  284,
+      284,  284,  284,  284,  284,    0,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      285,  285,  285,  285,  285,  285,  285,    0,  285,  285,
+      285,  285,  285,  285,  285,  285,  285,  285,  285,  285,
+      285,  285,  286,  286,  286,  286,  286,  286,  286,    0,
+      286,  286,  286,  286,  286,  286,  286,  286,  286,  286,
+      286,  286,  286,  286,  287,  287,  287,  287,  287,  287,
+      287,    0,  287,  287,  287,  287,  287,  287,  287,  287,
+      287,  287,  287,  287,  287,  287,  288,  288,  288,  288,
+
+      288,  288,  288,    0,  288,  288,  288,  288,  288,  288,
+      288,  288,  288,  288,  288,  288,  288,  288,  289,  289,
+      289,  289,  289,  289,  289,    0,  289,  289,  289,  289,
+      289,  289,  289,  289,  289,  289,  289,  289,  289,  289,
+      290,  290,  290,  290,  290,  290,  290,    0,  290,  290,
+      290,  290,  290,  290,  290,  290,  290,  290,  290,  290,
+      290,  290,  291,  291,  291,  291,  291,  291,  291,    0,
+      291,  291,  291,  291,  291,  291,  291,  291,  291,  291,
+      291,  291,  291,  291,  292,  292,  292,  292,  292,  292,
+      292,    0,  292,  292,  292,  292,  292,  292,  292,  292,
+
+      292,  292,  292,  292,  292,  292,  293,  293,  293,  293,
+      293,  293,  293,    0,  293,  293,  293,  293,  293,  293,
+      293,  293,  293,  293,  293,  293,  293,  293,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295,  295,  295,  295,  295,  295,  295,  295,  295,  295,
+      295
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -494,10 +1799,39 @@ char *yytext;
 #line 1 "minilang.l"
 #line 2 "minilang.l"
 #include <stdio.h>
-#line 497 "lex.yy.c"
-#line 498 "lex.yy.c"
+#include <string.h>
+#include "diag.h"
+#include "flexlex.h"
+#include "intern.h"
+#include "keyword.h"
+#include "lines.h"
+#include "utf8.h"
+
+/* Byte offset of the current token and of the next unread byte. */
+static uint32_t tok_offset;
+static uint32_t src_offset;
+static uint32_t comment_start;
+
+static struct token_buffer *collect;
+static int give_up;             /* too many errors while printing */
+
+#define YY_USER_ACTION  if (give_up) yyterminate(); \
+                        tok_offset = src_offset; src_offset += yyleng;
+
+static struct utf8_stream utf8_input;
+
+#define YY_INPUT(buf, result, max_size) \
+    ((result) = read_input((buf), (max_size)))
+
+static size_t read_input(char *buf, size_t max);
+static void emit(enum token_kind kind);
+static void emit_split(void);
+static void unterminated_comment(void);
+#line 1830 "lex.yy.c"
+#line 1831 "lex.yy.c"
 
 #define INITIAL 0
+#define COMMENT 1
 
 #ifndef YY_NO_UNISTD_H
 /* Special case for "unistd.h", since it is non-ANSI. We include it way
@@ -712,10 +2046,10 @@ YY_DECL
 		}
 
 	{
-#line 11 "minilang.l"
+#line 44 "minilang.l"
 
 
-#line 718 "lex.yy.c"
+#line 2052 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -742,13 +2076,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 79 )
+				if ( yy_current_state >= 296 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 100 );
+		while ( yy_base[yy_current_state] != 5729 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -774,177 +2108,162 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 13 "minilang.l"
-{ printf("TOKEN_IF\n"); }
+#line 46 "minilang.l"
+{ emit(TOKEN_EQ); }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 14 "minilang.l"
-{ printf("TOKEN_ELSE\n"); }
+#line 47 "minilang.l"
+{ emit(TOKEN_NEQ); }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 15 "minilang.l"
-{ printf("TOKEN_WHILE\n"); }
+#line 48 "minilang.l"
+{ emit(TOKEN_GTE); }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 16 "minilang.l"
-{ printf("TOKEN_FOR\n"); }
+#line 49 "minilang.l"
+{ emit(TOKEN_LTE); }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 17 "minilang.l"
-{ printf("TOKEN_INT\n"); }
+#line 50 "minilang.l"
+{ emit(TOKEN_GT); }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 18 "minilang.l"
-{ printf("TOKEN_FLOAT\n"); }
+#line 51 "minilang.l"
+{ emit(TOKEN_LT); }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 19 "minilang.l"
-{ printf("TOKEN_STRING\n"); }
+#line 53 "minilang.l"
+{ emit(TOKEN_PLUS); }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 20 "minilang.l"
-{ printf("TOKEN_PRINT\n"); }
+#line 54 "minilang.l"
+{ emit(TOKEN_MINUS); }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 21 "minilang.l"
-{ printf("TOKEN_RETURN\n"); }
+#line 55 "minilang.l"
+{ emit(TOKEN_MUL); }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 23 "minilang.l"
-{ printf("TOKEN_EQ\n"); }
+#line 56 "minilang.l"
+{ emit(TOKEN_DIV); }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 24 "minilang.l"
-{ printf("TOKEN_NEQ\n"); }
+#line 57 "minilang.l"
+{ emit(TOKEN_ASSIGN); }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 25 "minilang.l"
-{ printf("TOKEN_GTE\n"); }
+#line 59 "minilang.l"
+{ emit(TOKEN_LPAREN); }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 26 "minilang.l"
-{ printf("TOKEN_LTE\n"); }
+#line 60 "minilang.l"
+{ emit(TOKEN_RPAREN); }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 27 "minilang.l"
-{ printf("TOKEN_GT\n"); }
+#line 61 "minilang.l"
+{ emit(TOKEN_LBRACE); }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 28 "minilang.l"
-{ printf("TOKEN_LT\n"); }
+#line 62 "minilang.l"
+{ emit(TOKEN_RBRACE); }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 30 "minilang.l"
-{ printf("TOKEN_PLUS\n"); }
+#line 63 "minilang.l"
+{ emit(TOKEN_SEMICOLON); }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 31 "minilang.l"
-{ printf("TOKEN_MINUS\n"); }
+#line 64 "minilang.l"
+{ emit(TOKEN_COMMA); }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 32 "minilang.l"
-{ printf("TOKEN_MUL\n"); }
+#line 66 "minilang.l"
+{ emit(TOKEN_NUMBER); }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 33 "minilang.l"
-{ printf("TOKEN_DIV\n"); }
+#line 67 "minilang.l"
+{ emit(keyword_kind(yytext, (size_t) yyleng)); }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 34 "minilang.l"
-{ printf("TOKEN_ASSIGN\n"); }
+#line 68 "minilang.l"
+{ emit_split(); }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 36 "minilang.l"
-{ printf("TOKEN_LPAREN\n"); }
+#line 69 "minilang.l"
+{ emit(TOKEN_STRING_LITERAL); }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 37 "minilang.l"
-{ printf("TOKEN_RPAREN\n"); }
+#line 71 "minilang.l"
+{ /* single line comment, ignore */ }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 38 "minilang.l"
-{ printf("TOKEN_LBRACE\n"); }
+#line 72 "minilang.l"
+{ comment_start = tok_offset; BEGIN(COMMENT); }
 	YY_BREAK
 case 24:
+/* rule 24 can match eol */
 YY_RULE_SETUP
-#line 39 "minilang.l"
-{ printf("TOKEN_RBRACE\n"); }
+#line 74 "minilang.l"
+{ /* in pieces, so the buffer never holds it all */ }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 40 "minilang.l"
-{ printf("TOKEN_SEMICOLON\n"); }
+#line 75 "minilang.l"
+{ }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 41 "minilang.l"
-{ printf("TOKEN_COMMA\n"); }
+#line 76 "minilang.l"
+{ BEGIN(INITIAL); }
 	YY_BREAK
 case 27:
+/* rule 27 can match eol */
 YY_RULE_SETUP
-#line 43 "minilang.l"
-{ printf("TOKEN_NUMBER(%s)\n", yytext); }
+#line 79 "minilang.l"
+{ /* whitespace, ignore */ }
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 44 "minilang.l"
-{ printf("TOKEN_IDENTIFIER(%s)\n", yytext); }
+#line 80 "minilang.l"
+{ emit_split(); }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 45 "minilang.l"
-{ printf("TOKEN_STRING_LITERAL(%s)\n", yytext); }
+#line 81 "minilang.l"
+{ emit(TOKEN_UNKNOWN); }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 47 "minilang.l"
-{ /* single line comment, ignore */ }
-	YY_BREAK
-case 31:
-/* rule 31 can match eol */
-YY_RULE_SETUP
-#line 48 "minilang.l"
-{ /* multi-line comment, ignore */ }
-	YY_BREAK
-case 32:
-/* rule 32 can match eol */
-YY_RULE_SETUP
-#line 50 "minilang.l"
-{ /* whitespace, ignore */ }
-	YY_BREAK
-case 33:
-YY_RULE_SETUP
-#line 51 "minilang.l"
-{ printf("UNKNOWN(%s)\n", yytext); }
-	YY_BREAK
-case 34:
-YY_RULE_SETUP
-#line 53 "minilang.l"
+#line 83 "minilang.l"
 ECHO;
 	YY_BREAK
-#line 947 "lex.yy.c"
+#line 2261 "lex.yy.c"
+case YY_STATE_EOF(COMMENT):
+#line 77 "minilang.l"
+{ unterminated_comment(); BEGIN(INITIAL); yyterminate(); }
+	YY_BREAK
+#line 2266 "lex.yy.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1241,7 +2560,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 79 )
+			if ( yy_current_state >= 296 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1269,11 +2588,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 79 )
+		if ( yy_current_state >= 296 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 78);
+	yy_is_jam = (yy_current_state == 295);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
@@ -1949,17 +3268,229 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 53 "minilang.l"
+#line 83 "minilang.l"
 
 
 int yywrap() {
     return 1;
 }
 
+/* Tokens are printed as they are matched unless a buffer is collecting
+ * them, in which case the caller reports errors. */
+static void emit_text(enum token_kind kind, uint32_t offset, const char *text,
+                      uint32_t length) {
+    static struct intern_cache cache;
+    uint32_t value = SYMBOL_NONE;
+
+    /* "." only matches a lone '!' or a '"' that starts no string */
+    if (kind == TOKEN_UNKNOWN)
+        value = text[0] == '"' ? TOKEN_ERROR_STRING : TOKEN_ERROR_BYTES;
+
+    if (collect) {
+        if (kind == TOKEN_IDENTIFIER)
+            value = intern_cached(&cache, text, length);
+        else if (kind == TOKEN_STRING_LITERAL)
+            value = intern_cached(&cache, text + 1, length - 2);
+        else if (kind == TOKEN_NUMBER)
+            value = token_buffer_add_number(collect, text, offset, length);
+        token_buffer_push(collect, kind, offset, length, value);
+        return;
+    }
+
+    if (kind == TOKEN_NUMBER) {
+        struct number num;
+
+        number_parse(text, length, &num);
+        if (num.type == NUMBER_OVERFLOW)
+            diag_error(offset, "integer literal out of range");
+    } else if (value == TOKEN_ERROR_STRING) {
+        diag_error(offset, "unterminated string literal");
+    } else if (kind == TOKEN_UNKNOWN) {
+        diag_invalid(offset, length, text);
+    }
+    if (diag_stopped()) {
+        give_up = 1;
+        return;
+    }
+    if (token_has_text(kind)) {
+        printf("%s(%.*s)\n", token_names[kind], (int) length, text);
+    } else {
+        printf("%s\n", token_names[kind]);
+    }
+}
+
+static void emit(enum token_kind kind) {
+    emit_text(kind, tok_offset, yytext, (uint32_t) yyleng);
+}
+
+static int ident_byte(unsigned c) {
+    return c == '_' || (c | 0x20) - 'a' < 26 || c - '0' < 10;
+}
+
+static int invalid_byte(unsigned c) {
+    return c < 0x80 && !ident_byte(c) &&
+           (c == 0 || !strchr("=!<>+-*/(){};,\"\t\n ", (int) c));
+}
+
+/* End of the identifier or run of bytes that start no token at s[pos],
+ * which are told apart by the Unicode tables, or pos if s[pos] starts
+ * something else. */
+static size_t split_piece(const unsigned char *s, size_t pos, size_t len,
+                          enum token_kind *kind) {
+    uint32_t cp;
+    size_t n = utf8_decode(s, pos, len, &cp);
+
+    if (n && (cp < 0x80 ? ident_byte(cp) && cp - '0' >= 10 : xid_start(cp))) {
+        *kind = TOKEN_IDENTIFIER;
+        for (pos += n; pos < len; pos += n) {
+            n = utf8_decode(s, pos, len, &cp);
+            if (!n || !(cp < 0x80 ? ident_byte(cp) : xid_continue(cp)))
+                break;
+        }
+        return pos;
+    }
+    *kind = TOKEN_UNKNOWN;
+    while (pos < len) {
+        if (s[pos] < 0x80) {
+            if (!invalid_byte(s[pos]))
+                break;
+            pos++;
+        } else {
+            n = utf8_decode(s, pos, len, &cp);
+            if (n && xid_start(cp))
+                break;
+            pos += n ? n : 1;
+        }
+    }
+    return pos;
+}
 
-int main(void) {
+/* {uid} and {invalid}+ run identifier characters, non-ASCII bytes and
+ * {invalid} bytes together, since the rules cannot tell which non-ASCII
+ * characters may be in a name: cut the match up as dfalex.c lexes it.
+ * Every piece but the last is whole.  The last may go on past the match,
+ * so unless it is the first it is given back to be matched again; each
+ * byte is thus looked at no more than twice. */
+static void emit_split(void) {
+    const unsigned char *s = (const unsigned char *) yytext;
+    size_t len = (size_t) yyleng;
+    uint32_t base = tok_offset;
+    size_t pos = 0;
+
+    while (pos < len) {
+        enum token_kind kind;
+        size_t end = split_piece(s, pos, len, &kind);
+
+        if (end == pos || (end == len && pos > 0)) {
+            yyless((int) pos);
+            src_offset = base + (uint32_t) pos;
+            return;
+        }
+        if (kind == TOKEN_IDENTIFIER)
+            kind = keyword_kind(yytext + pos, end - pos);
+        emit_text(kind, base + (uint32_t) pos, yytext + pos,
+                  (uint32_t) (end - pos));
+        if (give_up)
+            return;
+        pos = end;
+    }
+}
+
+/* Offset of the first byte flex_lex() read that is not well-formed UTF-8,
+ * or UINT64_MAX: kept for the caller when collecting, which reports it
+ * with the errors marked in the tokens. */
+static uint64_t utf8_bad;
+
+/* Flex's own YY_INPUT, plus a UTF-8 check of each piece read.  Only
+ * flex_lex() reads through it; flex_lex_buffer() checks the whole buffer
+ * up front. */
+static size_t read_input(char *buf, size_t max) {
+    size_t n = 0;
+    uint64_t bad;
+
+    if (YY_CURRENT_BUFFER_LVALUE->yy_is_interactive) {
+        int c = '*';
+
+        while (n < max && (c = getc(yyin)) != EOF && c != '\n')
+            buf[n++] = (char) c;
+        if (c == '\n')
+            buf[n++] = (char) c;
+        if (c == EOF && ferror(yyin))
+            YY_FATAL_ERROR("input in flex scanner failed");
+    } else {
+        errno = 0;
+        while ((n = fread(buf, 1, max, yyin)) == 0 && ferror(yyin)) {
+            if (errno != EINTR)
+                YY_FATAL_ERROR("input in flex scanner failed");
+            errno = 0;
+            clearerr(yyin);
+        }
+    }
+    if (!utf8_stream_check(&utf8_input, buf, n, &bad)) {
+        if (collect)
+            utf8_bad = bad;
+        else
+            diag_error((uint32_t) bad, "source is not valid UTF-8");
+    }
+    return n;
+}
+
+/* A comment still open at the end of the input: the opener becomes an
+ * unknown token, as dfalex.c makes it. */
+static void unterminated_comment(void) {
+    if (collect) {
+        token_buffer_push(collect, TOKEN_UNKNOWN, comment_start, 2,
+                          TOKEN_ERROR_COMMENT);
+        return;
+    }
+    diag_error(comment_start, "unterminated comment");
+    if (diag_stopped())
+        return;
+    printf("%s(/*)\n", token_names[TOKEN_UNKNOWN]);
+}
+
+uint32_t flex_lex(FILE *in, const char *name, struct token_buffer *out,
+                  uint64_t *bad_utf8) {
+    yyin = in;
+    memset(&utf8_input, 0, sizeof utf8_input);
+    utf8_bad = UINT64_MAX;
+    collect = out;
+    src_offset = 0;
+    give_up = 0;
+    BEGIN(INITIAL);
+    if (!collect)
+        diag_begin(name, NULL);
     yylex();
-    return 0;
+    if (!collect)
+        diag_end();
+    if (bad_utf8)
+        *bad_utf8 = utf8_bad;
+    return src_offset;
+}
+
+uint32_t flex_lex_buffer(char *buf, size_t len, const char *name,
+                         struct token_buffer *out) {
+    YY_BUFFER_STATE state = yy_scan_buffer(buf, len + 2);
+    struct line_index lines;
+
+    line_index_init(&lines, buf, len);
+    collect = out;
+    src_offset = 0;
+    give_up = 0;
+    BEGIN(INITIAL);
+    if (!collect) {
+        size_t bad = utf8_validate(buf, len);
+
+        diag_begin(name, &lines);
+        if (bad < len)
+            diag_error((uint32_t) bad, "source is not valid UTF-8");
+    }
+    yylex();
+    if (!collect)
+        diag_end();
+    yy_delete_buffer(state);
+    line_index_free(&lines);
+    return src_offset;
 }
 
 
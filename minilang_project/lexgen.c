@@ -0,0 +1,845 @@
+/* Scanner table generator: builds the DFA tablelex.c runs from the rules
+ * in minilang.l, without flex.
+ *
+ *   lexgen minilang.l > lextab.h
+ *
+ * Reads the definitions and the INITIAL rules (those with a start
+ * condition belong to the comment skipper, which tablelex.c does by hand),
+ * turns the patterns into one NFA, makes it deterministic over classes of
+ * bytes that no pattern tells apart, and merges equivalent states.  Ties go
+ * to the earliest rule and the longest match wins, as in flex.
+ *
+ * Only the part of flex's pattern syntax minilang.l uses is understood:
+ * strings, bracket classes, ".", escapes, grouping, "|", "*", "+", "?",
+ * {n,m} and {name}.  Actions are recognised by what they call, see
+ * classify(); anything else is an error, so a new kind of rule has to be
+ * taught to tablelex.c before it can be generated. */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_PROGRAM "lexgen"
+#define ALLOC_WHAT "scanner tables"
+#include "alloc.h"
+
+#define MAX_LINE    1024
+#define MAX_DEFS    64
+#define MAX_RULES   64
+
+enum node_op {
+    N_SET,          /* one byte out of `set` */
+    N_EMPTY,
+    N_CAT,
+    N_ALT,
+    N_STAR,
+    N_PLUS,
+    N_OPT,
+    N_REPEAT        /* a, min to max times; max -1 for no limit */
+};
+
+struct node {
+    enum node_op op;
+    int a, b;
+    int min, max;
+    unsigned char set[32];
+};
+
+struct def {
+    char name[64];
+    int node;
+};
+
+/* A rule of the INITIAL start condition. */
+struct rule {
+    int node;
+    int line;
+    const char *action;     /* LEX_ name for lextab.h */
+    char kind[64];          /* token kind for LEX_TOKEN, else "0" */
+};
+
+/* Thompson NFA: a state either moves on a byte of nodes[set].set to `out`
+ * or has up to two empty moves; rule is set on the final state of each
+ * rule's pattern. */
+struct nstate {
+    int set;
+    int out;
+    int eps[2];
+    int rule;
+};
+
+static struct node *nodes;
+static int node_count, node_cap;
+static struct def defs[MAX_DEFS];
+static int def_count;
+static struct rule rules[MAX_RULES];
+static int rule_count;
+static struct nstate *nfa;
+static int nfa_count, nfa_cap;
+
+static const char *input_name;
+static int input_line;
+
+static void fail(const char *fmt, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "lexgen: %s:%d: ", input_name, input_line);
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+static int new_node(enum node_op op, int a, int b)
+{
+    if (node_count == node_cap) {
+        node_cap = node_cap ? node_cap * 2 : 256;
+        nodes = xrealloc(nodes, (size_t) node_cap * sizeof *nodes);
+    }
+    memset(&nodes[node_count], 0, sizeof *nodes);
+    nodes[node_count].op = op;
+    nodes[node_count].a = a;
+    nodes[node_count].b = b;
+    return node_count++;
+}
+
+static void set_add(unsigned char *set, unsigned c)
+{
+    set[c >> 3] |= (unsigned char) (1u << (c & 7));
+}
+
+static int set_has(const unsigned char *set, unsigned c)
+{
+    return set[c >> 3] >> (c & 7) & 1;
+}
+
+/* Pattern parser: recursive descent over flex's syntax, building nodes. */
+
+static const char *pat;
+
+static int parse_alt(void);
+
+static int hex_digit(int c)
+{
+    return isdigit(c) ? c - '0' : tolower(c) - 'a' + 10;
+}
+
+/* The character of the escape after a backslash, advancing past it. */
+static unsigned parse_escape(void)
+{
+    int c = (unsigned char) *pat++;
+    unsigned v;
+
+    switch (c) {
+    case 'n': return '\n';
+    case 't': return '\t';
+    case 'r': return '\r';
+    case 'f': return '\f';
+    case 'v': return '\v';
+    case 'a': return '\a';
+    case 'b': return '\b';
+    case 'x':
+        if (!isxdigit((unsigned char) *pat))
+            fail("\\x without digits");
+        v = 0;
+        while (isxdigit((unsigned char) *pat) && v < 0x10)
+            v = v * 16 + (unsigned) hex_digit(*pat++);
+        return v;
+    case '\0':
+        fail("pattern ends in a backslash");
+        return 0;
+    default:
+        if (c >= '0' && c <= '7') {
+            v = (unsigned) (c - '0');
+            while (*pat >= '0' && *pat <= '7' && v < 0x20)
+                v = v * 8 + (unsigned) (*pat++ - '0');
+            return v;
+        }
+        return (unsigned) c;
+    }
+}
+
+static int char_node(unsigned c)
+{
+    int n = new_node(N_SET, -1, -1);
+
+    set_add(nodes[n].set, c);
+    return n;
+}
+
+static int parse_class(void)
+{
+    int n = new_node(N_SET, -1, -1);
+    unsigned char set[32];
+    int negate = 0;
+    int first = 1;
+    unsigned i;
+
+    memset(set, 0, sizeof set);
+    if (*pat == '^') {
+        negate = 1;
+        pat++;
+    }
+    while (*pat != ']' || first) {
+        unsigned lo, hi;
+
+        if (*pat == '\0')
+            fail("unterminated character class");
+        first = 0;
+        if (*pat == '\\') {
+            pat++;
+            lo = parse_escape();
+        } else {
+            lo = (unsigned char) *pat++;
+        }
+        hi = lo;
+        if (pat[0] == '-' && pat[1] != ']' && pat[1] != '\0') {
+            pat++;
+            if (*pat == '\\') {
+                pat++;
+                hi = parse_escape();
+            } else {
+                hi = (unsigned char) *pat++;
+            }
+            if (hi < lo)
+                fail("reversed range in character class");
+        }
+        for (i = lo; i <= hi; i++)
+            set_add(set, i);
+    }
+    pat++;
+    for (i = 0; i < 256; i++)
+        if (set_has(set, i) != negate)
+            set_add(nodes[n].set, i);
+    return n;
+}
+
+static int parse_atom(void)
+{
+    int n, i;
+
+    switch (*pat) {
+    case '(':
+        pat++;
+        n = parse_alt();
+        if (*pat != ')')
+            fail("missing ')'");
+        pat++;
+        return n;
+    case '"':
+        pat++;
+        n = new_node(N_EMPTY, -1, -1);
+        while (*pat != '"') {
+            unsigned c;
+
+            if (*pat == '\0')
+                fail("unterminated string in pattern");
+            if (*pat == '\\') {
+                pat++;
+                c = parse_escape();
+            } else {
+                c = (unsigned char) *pat++;
+            }
+            n = new_node(N_CAT, n, char_node(c));
+        }
+        pat++;
+        return n;
+    case '[':
+        pat++;
+        return parse_class();
+    case '.':
+        pat++;
+        n = new_node(N_SET, -1, -1);
+        for (i = 0; i < 256; i++)
+            if (i != '\n')
+                set_add(nodes[n].set, (unsigned) i);
+        return n;
+    case '{': {
+        const char *end = strchr(pat, '}');
+        size_t len;
+
+        if (!end)
+            fail("missing '}'");
+        len = (size_t) (end - pat - 1);
+        for (i = 0; i < def_count; i++) {
+            if (strlen(defs[i].name) == len &&
+                memcmp(defs[i].name, pat + 1, len) == 0) {
+                pat = end + 1;
+                return defs[i].node;
+            }
+        }
+        fail("undefined definition {%.*s}", (int) len, pat + 1);
+        return -1;
+    }
+    case '\\':
+        pat++;
+        return char_node(parse_escape());
+    case '\0': case '|': case ')': case '*': case '+': case '?':
+        fail("expected a pattern at \"%s\"", pat);
+        return -1;
+    default:
+        return char_node((unsigned char) *pat++);
+    }
+}
+
+static int parse_postfix(void)
+{
+    int n = parse_atom();
+
+    for (;;) {
+        if (*pat == '*') {
+            n = new_node(N_STAR, n, -1);
+        } else if (*pat == '+') {
+            n = new_node(N_PLUS, n, -1);
+        } else if (*pat == '?') {
+            n = new_node(N_OPT, n, -1);
+        } else if (*pat == '{' && isdigit((unsigned char) pat[1])) {
+            char *end;
+            long min = strtol(pat + 1, &end, 10);
+            long max = min;
+
+            if (*end == ',') {
+                max = isdigit((unsigned char) end[1]) ?
+                      strtol(end + 1, &end, 10) : (end++, -1);
+            }
+            if (*end != '}' || (max != -1 && max < min))
+                fail("bad repeat count");
+            n = new_node(N_REPEAT, n, -1);
+            nodes[n].min = (int) min;
+            nodes[n].max = (int) max;
+            pat = end;
+        } else {
+            return n;
+        }
+        pat++;
+    }
+}
+
+static int parse_cat(void)
+{
+    int n = parse_postfix();
+
+    while (*pat != '\0' && *pat != '|' && *pat != ')')
+        n = new_node(N_CAT, n, parse_postfix());
+    return n;
+}
+
+static int parse_alt(void)
+{
+    int n = parse_cat();
+
+    while (*pat == '|') {
+        pat++;
+        n = new_node(N_ALT, n, parse_cat());
+    }
+    return n;
+}
+
+static int parse_pattern(const char *text)
+{
+    int n;
+
+    pat = text;
+    n = parse_alt();
+    if (*pat != '\0')
+        fail("unexpected '%c' in pattern", *pat);
+    return n;
+}
+
+/* NFA construction. */
+
+static int new_state(void)
+{
+    if (nfa_count == nfa_cap) {
+        nfa_cap = nfa_cap ? nfa_cap * 2 : 1024;
+        nfa = xrealloc(nfa, (size_t) nfa_cap * sizeof *nfa);
+    }
+    nfa[nfa_count].set = -1;
+    nfa[nfa_count].out = -1;
+    nfa[nfa_count].eps[0] = -1;
+    nfa[nfa_count].eps[1] = -1;
+    nfa[nfa_count].rule = 0;
+    return nfa_count++;
+}
+
+static void add_eps(int from, int to)
+{
+    if (nfa[from].eps[0] < 0)
+        nfa[from].eps[0] = to;
+    else
+        nfa[from].eps[1] = to;
+}
+
+/* Build node n; its fragment runs from *start to *end, which has no moves
+ * yet. */
+static void build(int n, int *start, int *end)
+{
+    int s1, e1, s2, e2, i;
+
+    switch (nodes[n].op) {
+    case N_SET:
+        *start = new_state();
+        *end = new_state();
+        nfa[*start].set = n;
+        nfa[*start].out = *end;
+        return;
+    case N_EMPTY:
+        *start = new_state();
+        *end = new_state();
+        add_eps(*start, *end);
+        return;
+    case N_CAT:
+        build(nodes[n].a, start, &e1);
+        build(nodes[n].b, &s2, end);
+        add_eps(e1, s2);
+        return;
+    case N_ALT:
+        build(nodes[n].a, &s1, &e1);
+        build(nodes[n].b, &s2, &e2);
+        *start = new_state();
+        *end = new_state();
+        add_eps(*start, s1);
+        add_eps(*start, s2);
+        add_eps(e1, *end);
+        add_eps(e2, *end);
+        return;
+    case N_STAR:
+    case N_OPT:
+        build(nodes[n].a, &s1, &e1);
+        *start = new_state();
+        *end = new_state();
+        add_eps(*start, s1);
+        add_eps(*start, *end);
+        add_eps(e1, *end);
+        if (nodes[n].op == N_STAR)
+            add_eps(e1, s1);
+        return;
+    case N_PLUS:
+        build(nodes[n].a, start, &e1);
+        *end = new_state();
+        add_eps(e1, *start);
+        add_eps(e1, *end);
+        return;
+    case N_REPEAT:
+        *start = new_state();
+        *end = *start;
+        for (i = 0; i < nodes[n].min; i++) {
+            build(nodes[n].a, &s1, &e1);
+            add_eps(*end, s1);
+            *end = e1;
+        }
+        if (nodes[n].max < 0) {
+            build(nodes[n].a, &s1, &e1);
+            s2 = new_state();
+            add_eps(*end, s2);
+            add_eps(s2, s1);
+            add_eps(e1, s2);
+            *end = s2;
+            e2 = new_state();
+            add_eps(*end, e2);
+            *end = e2;
+            return;
+        }
+        for (; i < nodes[n].max; i++) {
+            build(nodes[n].a, &s1, &e1);
+            e2 = new_state();
+            add_eps(*end, s1);
+            add_eps(*end, e2);
+            add_eps(e1, e2);
+            *end = e2;
+        }
+        return;
+    }
+}
+
+/* Byte classes: bytes that every N_SET in use either contains or not
+ * behave the same in every state. */
+
+static unsigned char byte_class[256];
+static int class_count;
+
+static void make_classes(void)
+{
+    int map[256 * 2];
+    int i, c;
+
+    memset(byte_class, 0, sizeof byte_class);
+    class_count = 1;
+    for (i = 0; i < nfa_count; i++) {
+        const unsigned char *set;
+        int n = 0;
+
+        if (nfa[i].set < 0)
+            continue;
+        set = nodes[nfa[i].set].set;
+        for (c = 0; c < class_count * 2; c++)
+            map[c] = -1;
+        for (c = 0; c < 256; c++) {
+            int key = byte_class[c] * 2 + set_has(set, (unsigned) c);
+
+            if (map[key] < 0)
+                map[key] = n++;
+            byte_class[c] = (unsigned char) map[key];
+        }
+        class_count = n;
+    }
+}
+
+/* Subset construction.  DFA state 0 is the empty set, from which nothing
+ * matches; each state is kept as a bitset of NFA states. */
+
+static int words;           /* uint64_t words per bitset */
+static uint64_t *dsets;
+static int *dnext;          /* [state * class_count + class] */
+static int *daccept;
+static int dfa_count, dfa_cap;
+
+static void closure(uint64_t *set)
+{
+    int *stack = xrealloc(NULL, (size_t) nfa_count * sizeof *stack);
+    int top = 0;
+    int i, k;
+
+    for (i = 0; i < nfa_count; i++)
+        if (set[i / 64] >> (i % 64) & 1)
+            stack[top++] = i;
+    while (top > 0) {
+        i = stack[--top];
+        for (k = 0; k < 2; k++) {
+            int t = nfa[i].eps[k];
+
+            if (t >= 0 && !(set[t / 64] >> (t % 64) & 1)) {
+                set[t / 64] |= (uint64_t) 1 << (t % 64);
+                stack[top++] = t;
+            }
+        }
+    }
+    free(stack);
+}
+
+static int dfa_state(const uint64_t *set)
+{
+    int i, r;
+
+    for (i = 0; i < dfa_count; i++)
+        if (memcmp(&dsets[(size_t) i * words], set, words * sizeof *set) == 0)
+            return i;
+    if (dfa_count == dfa_cap) {
+        dfa_cap = dfa_cap ? dfa_cap * 2 : 256;
+        dsets = xrealloc(dsets, (size_t) dfa_cap * words * sizeof *dsets);
+        dnext = xrealloc(dnext, (size_t) dfa_cap * class_count * sizeof *dnext);
+        daccept = xrealloc(daccept, (size_t) dfa_cap * sizeof *daccept);
+    }
+    memcpy(&dsets[(size_t) dfa_count * words], set, words * sizeof *set);
+    daccept[dfa_count] = 0;
+    for (i = 0; i < nfa_count; i++) {
+        r = nfa[i].rule;
+        if (r && (set[i / 64] >> (i % 64) & 1) &&
+            (!daccept[dfa_count] || r < daccept[dfa_count]))
+            daccept[dfa_count] = r;
+    }
+    return dfa_count++;
+}
+
+static void make_dfa(const int *starts)
+{
+    uint64_t *set;
+    int d, c, i;
+
+    words = (nfa_count + 63) / 64;
+    set = xrealloc(NULL, words * sizeof *set);
+
+    memset(set, 0, words * sizeof *set);
+    dfa_state(set);
+    for (i = 0; i < rule_count; i++)
+        set[starts[i] / 64] |= (uint64_t) 1 << (starts[i] % 64);
+    closure(set);
+    dfa_state(set);
+
+    for (d = 0; d < dfa_count; d++) {
+        for (c = 0; c < class_count; c++) {
+            unsigned b = 0;
+
+            while (byte_class[b] != c)
+                b++;
+            memset(set, 0, words * sizeof *set);
+            for (i = 0; i < nfa_count; i++) {
+                int n = nfa[i].set;
+
+                if (n >= 0 && (dsets[(size_t) d * words + i / 64] >> (i % 64) & 1)
+                    && set_has(nodes[n].set, b))
+                    set[nfa[i].out / 64] |= (uint64_t) 1 << (nfa[i].out % 64);
+            }
+            closure(set);
+            /* dfa_state() may move dnext */
+            i = dfa_state(set);
+            dnext[(size_t) d * class_count + c] = i;
+        }
+    }
+    free(set);
+}
+
+/* Moore's partition refinement: start from states grouped by the rule
+ * they accept, split groups whose members move to different groups, until
+ * nothing splits.  Returns the number of groups; group[] maps each state,
+ * with the empty state in group 0 and the start state in group 1. */
+static int minimize(int *group)
+{
+    int *sig = xrealloc(NULL, (size_t) dfa_count * (class_count + 1) *
+                               sizeof *sig);
+    int *next = xrealloc(NULL, (size_t) dfa_count * sizeof *next);
+    int count = 0, prev = -1;
+    int d, e, c;
+
+    for (d = 0; d < dfa_count; d++)
+        group[d] = daccept[d];
+    while (count != prev) {
+        prev = count;
+        count = 0;
+        for (d = 0; d < dfa_count; d++) {
+            int *s = &sig[(size_t) d * (class_count + 1)];
+
+            s[0] = group[d];
+            for (c = 0; c < class_count; c++)
+                s[c + 1] = group[dnext[(size_t) d * class_count + c]];
+            for (e = 0; e < d; e++)
+                if (memcmp(&sig[(size_t) e * (class_count + 1)], s,
+                           (class_count + 1) * sizeof *s) == 0)
+                    break;
+            next[d] = e < d ? next[e] : count++;
+        }
+        memcpy(group, next, (size_t) dfa_count * sizeof *group);
+    }
+    free(sig);
+    free(next);
+    /* states 0 and 1 come first, so their groups already are 0 and 1,
+     * unless the start state can never match anything */
+    if (group[1] == 0)
+        fail("no rule matches anything");
+    return count;
+}
+
+/* Reading minilang.l. */
+
+static char *trim(char *s)
+{
+    size_t n = strlen(s);
+
+    while (n > 0 && isspace((unsigned char) s[n - 1]))
+        s[--n] = '\0';
+    while (isspace((unsigned char) *s))
+        s++;
+    return s;
+}
+
+/* Length of the pattern at the start of a rule line: up to the first
+ * blank outside quotes and brackets. */
+static size_t pattern_length(const char *s)
+{
+    const char *p = s;
+    int quoted = 0, bracket = 0;
+
+    for (; *p; p++) {
+        if (*p == '\\' && p[1]) {
+            p++;
+        } else if (bracket) {
+            if (*p == ']' && p > s && p[-1] != '[' &&
+                !(p[-1] == '^' && p[-2] == '['))
+                bracket = 0;
+        } else if (*p == '"') {
+            quoted = !quoted;
+        } else if (!quoted && *p == '[') {
+            bracket = 1;
+        } else if (!quoted && isspace((unsigned char) *p)) {
+            break;
+        }
+    }
+    return (size_t) (p - s);
+}
+
+/* What the action does, as far as tablelex.c is concerned. */
+static void classify(struct rule *r, const char *action)
+{
+    const char *p;
+
+    strcpy(r->kind, "0");
+    if (strstr(action, "emit(keyword_kind(")) {
+        r->action = "LEX_WORD";
+    } else if ((p = strstr(action, "emit(TOKEN_")) != NULL) {
+        size_t n = strcspn(p + 5, ")");
+
+        if (n >= sizeof r->kind)
+            fail("token kind too long");
+        memcpy(r->kind, p + 5, n);
+        r->kind[n] = '\0';
+        r->action = "LEX_TOKEN";
+    } else if (strstr(action, "emit_split()")) {
+        r->action = "LEX_SPLIT";
+    } else if (strstr(action, "BEGIN(COMMENT)")) {
+        r->action = "LEX_COMMENT";
+    } else {
+        /* an empty action, or nothing but a comment */
+        p = action;
+        if (*p == '{')
+            p++;
+        while (isspace((unsigned char) *p))
+            p++;
+        if (p[0] == '/' && p[1] == '*') {
+            p = strstr(p, "*/");
+            p = p ? p + 2 : "";
+            while (isspace((unsigned char) *p))
+                p++;
+        }
+        if (strcmp(p, "}") != 0 && *p != '\0')
+            fail("action not understood: %s", action);
+        r->action = "LEX_SKIP";
+    }
+}
+
+static void read_rules(FILE *in)
+{
+    char line[MAX_LINE];
+    int section = 1, verbatim = 0;
+
+    while (fgets(line, sizeof line, in)) {
+        char *s;
+
+        input_line++;
+        if (strchr(line, '\n') == NULL && !feof(in))
+            fail("line too long");
+        if (strncmp(line, "%%", 2) == 0) {
+            if (++section == 3)
+                return;
+            continue;
+        }
+        if (strncmp(line, "%{", 2) == 0 || strncmp(line, "%}", 2) == 0) {
+            verbatim = line[1] == '{';
+            continue;
+        }
+        if (verbatim || line[0] == '%' || isspace((unsigned char) line[0]) ||
+            line[0] == '<' || strncmp(line, "/*", 2) == 0)
+            continue;       /* code, options, start conditions, comments */
+        s = trim(line);
+        if (section == 1) {
+            size_t n = strcspn(s, " \t");
+            struct def *d = &defs[def_count];
+
+            if (def_count == MAX_DEFS || n >= sizeof d->name)
+                fail("too many or too long definitions");
+            memcpy(d->name, s, n);
+            d->name[n] = '\0';
+            /* {name} then stands for the whole pattern, as in flex */
+            d->node = parse_pattern(trim(s + n));
+            def_count++;
+        } else {
+            size_t n = pattern_length(s);
+            struct rule *r = &rules[rule_count];
+
+            if (rule_count == MAX_RULES)
+                fail("too many rules");
+            r->line = input_line;
+            classify(r, trim(s + n));
+            s[n] = '\0';
+            r->node = parse_pattern(s);
+            rule_count++;
+        }
+    }
+    if (section < 2)
+        fail("no rules section");
+}
+
+static void write_tables(int states, const int *group)
+{
+    int *rep = xrealloc(NULL, (size_t) states * sizeof *rep);
+    const char *type = states <= 256 ? "unsigned char" : "unsigned short";
+    int d, c, g;
+
+    for (d = dfa_count - 1; d >= 0; d--)
+        rep[group[d]] = d;
+
+    printf("/* Generated by lexgen from %s; do not edit. */\n\n", input_name);
+    printf("#define LEX_STATES  %d\n", states);
+    printf("#define LEX_CLASSES %d\n", class_count);
+    printf("#define LEX_START   1\n\n");
+
+    printf("static const unsigned char lex_class[256] = {\n");
+    for (c = 0; c < 256; c += 16) {
+        printf("   ");
+        for (d = c; d < c + 16; d++)
+            printf(" %2d,", byte_class[d]);
+        printf("\n");
+    }
+    printf("};\n\n");
+
+    printf("/* Next state by state and byte class; 0 ends the match. */\n");
+    printf("static const %s lex_next[LEX_STATES][LEX_CLASSES] = {\n", type);
+    for (g = 0; g < states; g++) {
+        printf("    {");
+        for (c = 0; c < class_count; c++)
+            printf("%s%3d", c ? "," : "",
+                   group[dnext[(size_t) rep[g] * class_count + c]]);
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("/* Rule a state accepts, 0 for none. */\n");
+    printf("static const unsigned char lex_accept[LEX_STATES] = {\n");
+    for (g = 0; g < states; g += 16) {
+        printf("   ");
+        for (d = g; d < g + 16 && d < states; d++)
+            printf(" %2d,", daccept[rep[d]]);
+        printf("\n");
+    }
+    printf("};\n\n");
+
+    printf("static const struct lex_rule lex_rules[%d] = {\n", rule_count + 1);
+    printf("    { LEX_NONE, 0 },\n");
+    for (d = 0; d < rule_count; d++)
+        printf("    { %s, %s },%*s/* %s:%d */\n", rules[d].action,
+               rules[d].kind,
+               (int) (30 - strlen(rules[d].action) - strlen(rules[d].kind)),
+               "", input_name, rules[d].line);
+    printf("};\n");
+    free(rep);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in;
+    int starts[MAX_RULES];
+    int *group;
+    int i, end, states;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: lexgen minilang.l > lextab.h\n");
+        return 2;
+    }
+    input_name = argv[1];
+    in = fopen(input_name, "r");
+    if (!in) {
+        fprintf(stderr, "lexgen: ");
+        perror(input_name);
+        return 1;
+    }
+    read_rules(in);
+    fclose(in);
+    if (rule_count == 0)
+        fail("no rules");
+
+    for (i = 0; i < rule_count; i++) {
+        build(rules[i].node, &starts[i], &end);
+        nfa[end].rule = i + 1;
+    }
+    make_classes();
+    make_dfa(starts);
+    group = xrealloc(NULL, (size_t) dfa_count * sizeof *group);
+    states = minimize(group);
+    write_tables(states, group);
+    free(group);
+    return ferror(stdout) ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+/* Generated by lexgen from minilang.l; do not edit. */
+
+#define LEX_STATES  33
+#define LEX_CLASSES 22
+#define LEX_START   1
+
+static const unsigned char lex_class[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     1,  3,  4,  0,  0,  0,  0,  0,  5,  6,  7,  8,  9, 10, 11, 12,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13,  0, 14, 15, 16, 17,  0,
+     0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,  0,  0,  0,  0, 18,
+     0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 19,  0, 20,  0,  0,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+};
+
+/* Next state by state and byte class; 0 ends the match. */
+static const unsigned char lex_next[LEX_STATES][LEX_CLASSES] = {
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  2,  3,  3,  4,  5,  6,  7,  8,  9, 10, 11,  2, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21 },
+    {  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2 },
+    {  0,  3,  3,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 22,  0,  0,  0,  0,  0 },
+    { 23, 23,  0, 23, 24, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0, 25,  0,  0,  0,  0, 26,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 27,  0, 13,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 28,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 29,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 30,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 18,  0,  0,  0,  0, 18,  0,  0, 31 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  0, 31,  0,  0,  0,  0, 31,  0,  0, 21 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    { 23, 23,  0, 23, 24, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    { 26, 26,  0, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 31,  0,  0,  0,  0, 31,  0,  0, 31 },
+    {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32,  0,  0,  0,  0,  0,  0,  0,  0 },
+};
+
+/* Rule a state accepts, 0 for none. */
+static const unsigned char lex_accept[LEX_STATES] = {
+     0,  0, 25, 24, 26, 26, 12, 13,  9,  7, 17,  8, 10, 18, 16,  6,
+    11,  5, 19, 14, 15, 20,  2,  0, 21, 23, 22,  0,  4,  1,  3, 20,
+    18,
+};
+
+static const struct lex_rule lex_rules[27] = {
+    { LEX_NONE, 0 },
+    { LEX_TOKEN, TOKEN_EQ },             /* minilang.l:46 */
+    { LEX_TOKEN, TOKEN_NEQ },            /* minilang.l:47 */
+    { LEX_TOKEN, TOKEN_GTE },            /* minilang.l:48 */
+    { LEX_TOKEN, TOKEN_LTE },            /* minilang.l:49 */
+    { LEX_TOKEN, TOKEN_GT },             /* minilang.l:50 */
+    { LEX_TOKEN, TOKEN_LT },             /* minilang.l:51 */
+    { LEX_TOKEN, TOKEN_PLUS },           /* minilang.l:53 */
+    { LEX_TOKEN, TOKEN_MINUS },          /* minilang.l:54 */
+    { LEX_TOKEN, TOKEN_MUL },            /* minilang.l:55 */
+    { LEX_TOKEN, TOKEN_DIV },            /* minilang.l:56 */
+    { LEX_TOKEN, TOKEN_ASSIGN },         /* minilang.l:57 */
+    { LEX_TOKEN, TOKEN_LPAREN },         /* minilang.l:59 */
+    { LEX_TOKEN, TOKEN_RPAREN },         /* minilang.l:60 */
+    { LEX_TOKEN, TOKEN_LBRACE },         /* minilang.l:61 */
+    { LEX_TOKEN, TOKEN_RBRACE },         /* minilang.l:62 */
+    { LEX_TOKEN, TOKEN_SEMICOLON },      /* minilang.l:63 */
+    { LEX_TOKEN, TOKEN_COMMA },          /* minilang.l:64 */
+    { LEX_TOKEN, TOKEN_NUMBER },         /* minilang.l:66 */
+    { LEX_WORD, 0 },                     /* minilang.l:67 */
+    { LEX_SPLIT, 0 },                    /* minilang.l:68 */
+    { LEX_TOKEN, TOKEN_STRING_LITERAL }, /* minilang.l:69 */
+    { LEX_SKIP, 0 },                     /* minilang.l:71 */
+    { LEX_COMMENT, 0 },                  /* minilang.l:72 */
+    { LEX_SKIP, 0 },                     /* minilang.l:79 */
+    { LEX_SPLIT, 0 },                    /* minilang.l:80 */
+    { LEX_TOKEN, TOKEN_UNKNOWN },        /* minilang.l:81 */
+};
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lines.h"
+#include "simd.h"
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+/* The scalar kernels lean on memchr, which the C library vectorises. */
+static size_t count_newlines_scalar(const char *s, size_t len)
+{
+    const char *end = s + len;
+    size_t n = 0;
+
+    while ((s = memchr(s, '\n', (size_t) (end - s))) != NULL) {
+        n++;
+        s++;
+    }
+    return n;
+}
+
+/* Record the start of every line after the first into starts[]. */
+static void fill_starts_scalar(const char *s, size_t len, uint32_t *starts)
+{
+    const char *p = s, *end = s + len;
+
+    while ((p = memchr(p, '\n', (size_t) (end - p))) != NULL)
+        *starts++ = (uint32_t) (++p - s);
+}
+
+#if SIMD_X86
+
+static TARGET_AVX2 uint32_t newline_mask_avx2(const char *p)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *) p);
+
+    return (uint32_t) _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+}
+
+static TARGET_AVX2 size_t count_newlines_avx2(const char *s, size_t len)
+{
+    size_t n = 0, pos = 0;
+
+    for (; pos + 32 <= len; pos += 32)
+        n += (size_t) __builtin_popcount(newline_mask_avx2(s + pos));
+    return n + count_newlines_scalar(s + pos, len - pos);
+}
+
+static TARGET_AVX2 void fill_starts_avx2(const char *s, size_t len,
+                                         uint32_t *starts)
+{
+    size_t pos = 0;
+
+    for (; pos + 32 <= len; pos += 32) {
+        uint32_t mask = newline_mask_avx2(s + pos);
+
+        while (mask) {
+            *starts++ = (uint32_t) (pos + (size_t) __builtin_ctz(mask) + 1);
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < len; pos++) {
+        if (s[pos] == '\n')
+            *starts++ = (uint32_t) (pos + 1);
+    }
+}
+
+#endif /* SIMD_X86 */
+
+static void build(struct line_index *idx)
+{
+    size_t (*count)(const char *, size_t) = count_newlines_scalar;
+    void (*fill)(const char *, size_t, uint32_t *) = fill_starts_scalar;
+    size_t n;
+
+#if SIMD_X86
+    if (simd_level() == SIMD_AVX2) {
+        count = count_newlines_avx2;
+        fill = fill_starts_avx2;
+    }
+#endif
+    n = count(idx->src, idx->len);
+    idx->starts = malloc((n + 1) * sizeof *idx->starts);
+    if (!idx->starts) {
+        fprintf(stderr, "minilang: out of memory for line index\n");
+        exit(1);
+    }
+    idx->starts[0] = 0;
+    fill(idx->src, idx->len, idx->starts + 1);
+    idx->count = n + 1;
+}
+
+void line_index_init(struct line_index *idx, const char *src, size_t len)
+{
+    idx->src = src;
+    idx->len = len;
+    idx->starts = NULL;
+    idx->count = 0;
+}
+
+void line_index_lookup(struct line_index *idx, uint32_t offset,
+                       uint32_t *line, uint32_t *column)
+{
+    size_t lo = 0, hi;
+
+    if (!idx->starts)
+        build(idx);
+    /* last line start at or before offset */
+    hi = idx->count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (idx->starts[mid] <= offset)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    *line = (uint32_t) lo + 1;
+    *column = offset - idx->starts[lo] + 1;
+}
+
+void line_index_free(struct line_index *idx)
+{
+    free(idx->starts);
+    idx->starts = NULL;
+    idx->count = 0;
+}
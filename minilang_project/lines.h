@@ -0,0 +1,30 @@
+#ifndef MINILANG_LINES_H
+#define MINILANG_LINES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Byte offset -> line and column, for diagnostics.
+ *
+ * Tokens only record their byte offset, so lexing never looks at line
+ * breaks.  The table of line starts is built the first time a location
+ * is asked for, by counting the newlines in the whole source with vector
+ * compares and then recording where they are; a source with no errors
+ * never pays for it. */
+struct line_index {
+    const char *src;
+    size_t len;
+    uint32_t *starts;       /* offset of each line, NULL until needed */
+    size_t count;
+};
+
+/* Cheap: only remembers the source. */
+void line_index_init(struct line_index *idx, const char *src, size_t len);
+
+/* 1-based line and byte column of `offset`, which may be `len`. */
+void line_index_lookup(struct line_index *idx, uint32_t offset,
+                       uint32_t *line, uint32_t *column);
+
+void line_index_free(struct line_index *idx);
+
+#endif
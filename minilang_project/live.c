@@ -0,0 +1,472 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "live ranges"
+#include "alloc.h"
+
+#include "live.h"
+
+static int is_value(const struct ir_func *f, uint32_t insn)
+{
+    return f->op[insn] < IR_PRINT && f->op[insn] != IR_CONST;
+}
+
+/* Ranges are added last first, so each goes before those there are, or
+ * joins the first if they touch. */
+static void add_range(struct live *l, uint32_t v, uint32_t from, uint32_t to)
+{
+    uint32_t r = l->first[v];
+
+    if (r && l->ranges[r].from <= to) {
+        if (from < l->ranges[r].from)
+            l->ranges[r].from = from;
+        if (to > l->ranges[r].to)
+            l->ranges[r].to = to;
+        return;
+    }
+    if (l->range_count == l->range_capacity) {
+        l->range_capacity *= 2;
+        l->ranges = xrealloc(l->ranges,
+                             l->range_capacity * sizeof *l->ranges);
+    }
+    l->ranges[l->range_count].from = from;
+    l->ranges[l->range_count].to = to;
+    l->ranges[l->range_count].next = r;
+    l->first[v] = l->range_count++;
+}
+
+/* Where `v` is defined, at `at` in `block`: the range that reaches it
+ * starts there, or it has one of its own. */
+static void define(struct live *l, uint32_t v, uint32_t block, uint32_t at)
+{
+    uint32_t r = l->first[v];
+
+    if (r && l->ranges[r].from < l->to[block])
+        l->ranges[r].from = at;
+    else
+        add_range(l, v, at, at + 1);
+}
+
+#define BIT_SET(set, i)     ((set)[(i) / 64] |= UINT64_C(1) << (i) % 64)
+#define BIT_CLEAR(set, i)   ((set)[(i) / 64] &= ~(UINT64_C(1) << (i) % 64))
+
+struct flow {
+    const struct ir_func *f;
+    uint32_t *index;        /* of each global value in the sets */
+    uint32_t *globals;      /* by index */
+    uint32_t words;
+    uint64_t *in;           /* live in of each block, words each */
+};
+
+/* What is live out of `block` into `out`: what is live into a successor,
+ * and the operands of its phis from this block; the latter, if `edge` is
+ * not NULL, into it instead. */
+static void live_out(const struct flow *fl, uint32_t block, uint64_t *out,
+                     uint64_t *edge)
+{
+    const struct ir_func *f = fl->f;
+    const struct ir_block *b = &f->blocks[block];
+    uint32_t k, w, insn, j, u;
+
+    memset(out, 0, fl->words * sizeof *out);
+    if (edge)
+        memset(edge, 0, fl->words * sizeof *edge);
+    for (k = 0; k < b->succ_count; k++) {
+        const uint64_t *in = fl->in + (size_t) b->succ[k] * fl->words;
+
+        for (w = 0; w < fl->words; w++)
+            out[w] |= in[w];
+        j = ir_pred_index(f, b->succ[k], block);
+        for (insn = f->blocks[b->succ[k]].first;
+             insn && f->op[insn] == IR_PHI; insn = f->next[insn]) {
+            u = f->args[f->a[insn] + j];
+            if (f->op[u] != IR_CONST)
+                BIT_SET(edge ? edge : out, fl->index[u]);
+        }
+    }
+}
+
+void live_build(const struct ir_func *f, struct live *l)
+{
+    struct flow fl;
+    uint32_t *layout = xmalloc(f->block_count * sizeof *layout);
+    uint32_t n = 0, i, k, w, p, block, insn, count, u;
+    uint64_t *out, *edge;
+    int changed = 1;
+
+    l->pos = xcalloc(f->count, sizeof *l->pos);
+    l->uses = xcalloc(f->count, sizeof *l->uses);
+    l->first = xcalloc(f->count, sizeof *l->first);
+    l->global = xcalloc(f->count, 1);
+    l->from = xcalloc(f->block_count, sizeof *l->from);
+    l->to = xcalloc(f->block_count, sizeof *l->to);
+    l->range_capacity = 256;
+    l->range_count = 1;
+    l->ranges = xmalloc(l->range_capacity * sizeof *l->ranges);
+
+    /* positions, uses, and which values are live across blocks */
+    p = 2;
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        layout[n++] = block;
+        l->from[block] = p;
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            if (f->op[insn] == IR_CONST)
+                continue;
+            if (f->op[insn] == IR_PHI) {
+                l->pos[insn] = l->from[block];
+                l->global[insn] = 1;
+            } else {
+                p += 2;
+                l->pos[insn] = p;
+            }
+            count = ir_operand_count(f, insn);
+            for (k = 0; k < count; k++) {
+                u = *ir_operand((struct ir_func *) f, insn, k);
+                l->uses[u]++;
+                if (f->op[insn] == IR_PHI || f->block[u] != block)
+                    l->global[u] = 1;
+            }
+        }
+        p += 2;
+        l->to[block] = p;
+    }
+    l->end = p;
+
+    fl.f = f;
+    fl.index = xcalloc(f->count, sizeof *fl.index);
+    fl.globals = xmalloc(f->count * sizeof *fl.globals);
+    count = 0;
+    for (i = 0; i < f->count; i++) {
+        if (l->global[i] && f->op[i] != IR_CONST) {
+            fl.index[i] = count;
+            fl.globals[count++] = i;
+        }
+    }
+    fl.words = (count + 63) / 64;
+    fl.in = xcalloc((size_t) f->block_count * fl.words, sizeof *fl.in);
+    out = xmalloc((fl.words + 1) * sizeof *out);
+    edge = xmalloc((fl.words + 1) * sizeof *edge);
+
+    /* live in of each global, backwards until nothing changes */
+    while (changed && fl.words) {
+        changed = 0;
+        for (i = n; i-- > 0;) {
+            uint64_t *in;
+
+            block = layout[i];
+            in = fl.in + (size_t) block * fl.words;
+            live_out(&fl, block, out, NULL);
+            for (insn = f->blocks[block].last; insn; insn = f->prev[insn]) {
+                if (f->op[insn] == IR_CONST)
+                    continue;
+                if (is_value(f, insn) && l->global[insn])
+                    BIT_CLEAR(out, fl.index[insn]);
+                if (f->op[insn] == IR_PHI)
+                    continue;
+                count = ir_operand_count(f, insn);
+                for (k = 0; k < count; k++) {
+                    u = *ir_operand((struct ir_func *) f, insn, k);
+                    if (l->global[u] && f->op[u] != IR_CONST)
+                        BIT_SET(out, fl.index[u]);
+                }
+            }
+            if (memcmp(in, out, fl.words * sizeof *out)) {
+                memcpy(in, out, fl.words * sizeof *out);
+                changed = 1;
+            }
+        }
+    }
+
+    /* then the ranges, the last block first and each backwards */
+    for (i = n; i-- > 0;) {
+        block = layout[i];
+        if (fl.words)
+            live_out(&fl, block, out, edge);
+        for (w = 0; w < fl.words; w++) {
+            uint64_t bits;
+
+            for (bits = out[w]; bits; bits &= bits - 1)
+                add_range(l, fl.globals[w * 64 + __builtin_ctzll(bits)],
+                          l->from[block], l->to[block]);
+            for (bits = edge[w]; bits; bits &= bits - 1)
+                add_range(l, fl.globals[w * 64 + __builtin_ctzll(bits)],
+                          l->from[block], live_edge(l, block));
+        }
+        for (insn = f->blocks[block].last; insn; insn = f->prev[insn]) {
+            if (f->op[insn] == IR_CONST)
+                continue;
+            if (is_value(f, insn))
+                define(l, insn, block, l->pos[insn]);
+            if (f->op[insn] == IR_PHI)
+                continue;
+            count = ir_operand_count(f, insn);
+            for (k = 0; k < count; k++) {
+                u = *ir_operand((struct ir_func *) f, insn, k);
+                if (f->op[u] != IR_CONST)
+                    add_range(l, u, l->from[block], l->pos[insn]);
+            }
+        }
+    }
+
+    free(edge);
+    free(out);
+    free(fl.in);
+    free(fl.globals);
+    free(fl.index);
+    free(layout);
+}
+
+void live_free(struct live *l)
+{
+    free(l->pos);
+    free(l->uses);
+    free(l->first);
+    free(l->global);
+    free(l->from);
+    free(l->to);
+    free(l->ranges);
+}
+
+/* ---- coalescing ---- */
+
+struct span {
+    uint32_t from;
+    uint32_t to;
+};
+
+/* A copy into the group's register on an edge, from a value outside it. */
+struct point {
+    uint32_t pos;
+    uint32_t src;
+};
+
+struct group {
+    struct span *spans;     /* in order, apart */
+    uint32_t span_count;
+    struct point *points;   /* in order of pos */
+    uint32_t point_count;
+};
+
+static uint32_t find(uint32_t *leader, uint32_t v)
+{
+    uint32_t root = v, next;
+
+    while (leader[root] != root)
+        root = leader[root];
+    while (leader[v] != root) {
+        next = leader[v];
+        leader[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+static int spans_overlap(const struct group *x, const struct group *y)
+{
+    uint32_t i = 0, j = 0;
+
+    while (i < x->span_count && j < y->span_count) {
+        if (x->spans[i].to <= y->spans[j].from)
+            i++;
+        else if (y->spans[j].to <= x->spans[i].from)
+            j++;
+        else
+            return 1;
+    }
+    return 0;
+}
+
+static int covers(const struct group *x, uint32_t pos)
+{
+    uint32_t lo = 0, hi = x->span_count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if (x->spans[mid].to <= pos)
+            lo = mid + 1;
+        else if (x->spans[mid].from > pos)
+            hi = mid;
+        else
+            return 1;
+    }
+    return 0;
+}
+
+/* Whether a copy of x's would go where y is live, or would meet one of
+ * y's from another value: the points that stay once x and y are one. */
+static int points_clash(uint32_t *leader, uint32_t gx, const struct group *x,
+                        uint32_t gy, const struct group *y)
+{
+    uint32_t i, j = 0, s;
+
+    for (i = 0; i < x->point_count; i++) {
+        s = find(leader, x->points[i].src);
+        if (s == gx || s == gy)
+            continue;
+        if (covers(y, x->points[i].pos))
+            return 1;
+        while (j < y->point_count && y->points[j].pos < x->points[i].pos)
+            j++;
+        for (s = j; s < y->point_count &&
+                    y->points[s].pos == x->points[i].pos; s++)
+            if (y->points[s].src != x->points[i].src)
+                return 1;
+    }
+    return 0;
+}
+
+static void merge(uint32_t *leader, struct group *groups, uint32_t gx,
+                  uint32_t gy)
+{
+    struct group *x = &groups[gx], *y = &groups[gy];
+    struct span *spans = xmalloc((x->span_count + y->span_count) *
+                                 sizeof *spans);
+    struct point *points = xmalloc((x->point_count + y->point_count) *
+                                   sizeof *points);
+    uint32_t i = 0, j = 0, n = 0, s;
+
+    while (i < x->span_count || j < y->span_count) {
+        struct span next;
+
+        if (j == y->span_count ||
+            (i < x->span_count && x->spans[i].from < y->spans[j].from))
+            next = x->spans[i++];
+        else
+            next = y->spans[j++];
+        if (n && spans[n - 1].to == next.from)
+            spans[n - 1].to = next.to;
+        else
+            spans[n++] = next;
+    }
+    free(x->spans);
+    x->spans = spans;
+    x->span_count = n;
+
+    leader[gy] = gx;
+    i = j = n = 0;
+    while (i < x->point_count || j < y->point_count) {
+        struct point next;
+
+        if (j == y->point_count ||
+            (i < x->point_count && x->points[i].pos <= y->points[j].pos))
+            next = x->points[i++];
+        else
+            next = y->points[j++];
+        s = find(leader, next.src);
+        if (s == gx || (n && points[n - 1].pos == next.pos &&
+                        points[n - 1].src == next.src))
+            continue;
+        points[n++] = next;
+    }
+    free(x->points);
+    x->points = points;
+    x->point_count = n;
+    free(y->spans);
+    free(y->points);
+    memset(y, 0, sizeof *y);
+}
+
+void live_coalesce(const struct ir_func *f, const struct live *l,
+                   struct live_groups *g)
+{
+    struct group *groups = xcalloc(f->count, sizeof *groups);
+    uint32_t v, r, n, k, block, insn, gx, gy, s;
+
+    g->leader = xmalloc(f->count * sizeof *g->leader);
+    g->lo = xcalloc(f->count, sizeof *g->lo);
+    g->hi = xcalloc(f->count, sizeof *g->hi);
+    for (v = 0; v < f->count; v++) {
+        g->leader[v] = v;
+        if (!f->block[v] || !is_value(f, v))
+            continue;
+        for (n = 0, r = l->first[v]; r; r = l->ranges[r].next)
+            n++;
+        groups[v].spans = xmalloc(n * sizeof *groups[v].spans);
+        for (n = 0, r = l->first[v]; r; r = l->ranges[r].next) {
+            groups[v].spans[n].from = l->ranges[r].from;
+            groups[v].spans[n++].to = l->ranges[r].to;
+        }
+        groups[v].span_count = n;
+    }
+
+    /* the copies into each phi, one per edge in */
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        const struct ir_block *b = &f->blocks[block];
+
+        for (insn = b->first; insn && f->op[insn] == IR_PHI;
+             insn = f->next[insn]) {
+            struct group *x = &groups[insn];
+
+            x->points = xmalloc(b->pred_count * sizeof *x->points);
+            for (k = 0; k < b->pred_count; k++) {
+                struct point p;
+
+                p.pos = live_edge(l, b->preds[k]);
+                p.src = f->args[f->a[insn] + k];
+                if (p.src == insn)
+                    continue;
+                /* in order, the few there are */
+                for (n = x->point_count;
+                     n > 0 && x->points[n - 1].pos > p.pos; n--)
+                    x->points[n] = x->points[n - 1];
+                x->points[n] = p;
+                x->point_count++;
+            }
+        }
+    }
+
+    /* each phi with each operand it can go with, in order */
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn && f->op[insn] == IR_PHI;
+             insn = f->next[insn]) {
+            for (k = 0; k < f->b[insn]; k++) {
+                s = f->args[f->a[insn] + k];
+                if (f->op[s] == IR_CONST)
+                    continue;
+                gx = find(g->leader, insn);
+                gy = find(g->leader, s);
+                if (gx == gy || spans_overlap(&groups[gx], &groups[gy]) ||
+                    points_clash(g->leader, gx, &groups[gx], gy,
+                                 &groups[gy]) ||
+                    points_clash(g->leader, gy, &groups[gy], gx,
+                                 &groups[gx]))
+                    continue;
+                merge(g->leader, groups, gx, gy);
+            }
+        }
+    }
+
+    for (v = 0; v < f->count; v++) {
+        struct group *x = &groups[v];
+
+        if (!f->block[v] || !is_value(f, v) || find(g->leader, v) != v)
+            continue;
+        g->lo[v] = x->span_count ? x->spans[0].from : UINT32_MAX;
+        g->hi[v] = x->span_count ? x->spans[x->span_count - 1].to : 0;
+        if (x->point_count && x->points[0].pos < g->lo[v])
+            g->lo[v] = x->points[0].pos;
+        if (x->point_count && x->points[x->point_count - 1].pos >= g->hi[v])
+            g->hi[v] = x->points[x->point_count - 1].pos + 1;
+        free(x->spans);
+        free(x->points);
+    }
+    free(groups);
+}
+
+void live_groups_free(struct live_groups *g)
+{
+    free(g->leader);
+    free(g->lo);
+    free(g->hi);
+}
+
+int live_by_lo(const void *a, const void *b)
+{
+    const struct live_interval *x = a, *y = b;
+
+    if (x->lo != y->lo)
+        return (x->lo > y->lo) - (x->lo < y->lo);
+    return (x->value > y->value) - (x->value < y->value);
+}
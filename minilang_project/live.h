@@ -0,0 +1,88 @@
+#ifndef MINILANG_LIVE_H
+#define MINILANG_LIVE_H
+
+#include <stdint.h>
+
+#include "ir.h"
+
+/* Where each value of an IR frame (ir.h) is live, for the backends to
+ * give it a register.
+ *
+ * The blocks are numbered in layout order into positions, each block
+ * from its own even from[] to the to[] of the next: its phis are at from,
+ * the instructions after them at from + 2, from + 4 and so on, the
+ * terminator last, and to[] is 2 past that.  Constants have no position;
+ * a backend keeps them apart.  The copies that phis take on an edge are
+ * made at to - 1 in the block the edge leaves, after its terminator has
+ * read what it reads: in effect, on the edge.
+ *
+ * A value is live over a list of half-open ranges of positions, from
+ * where it is defined to where it is last used.  A use at u ends a range
+ * at u, so a value defined by that same instruction may take the same
+ * register; one never used is live over [d, d + 1).  A phi operand is
+ * used at the edge, to - 1 of the predecessor.
+ *
+ * Values only used in the block that defines them, the most, are walked
+ * once backwards; those live across blocks (global[]), phis and their
+ * operands are found by iterating over the blocks until nothing changes. */
+struct live_range {
+    uint32_t from;
+    uint32_t to;
+    uint32_t next;          /* later range of the same value, or 0 */
+};
+
+struct live {
+    uint32_t *pos;          /* of each instruction, 0 for a constant */
+    uint32_t *from;         /* of each block */
+    uint32_t *to;
+    uint32_t *first;        /* first range of each value, 0 for none */
+    uint32_t *uses;         /* operands it is, phi operands too */
+    unsigned char *global;
+    struct live_range *ranges;      /* [0] unused */
+    uint32_t range_count;
+    uint32_t range_capacity;
+    uint32_t end;           /* past every position */
+};
+
+void live_build(const struct ir_func *f, struct live *l);
+void live_free(struct live *l);
+
+/* Where the copies onto the edges out of `block` are made. */
+static inline uint32_t live_edge(const struct live *l, uint32_t block)
+{
+    return l->to[block] - 1;
+}
+
+/* Coalescing: phis put in one group with their operands where nothing
+ * tells them apart, so that one register serves them all and the copy
+ * between them is not made.  A phi and an operand go together unless
+ * they would be live at once, or either's register would be written on
+ * an edge, by a copy from outside the group, while the other is live
+ * there, or two copies from different values would meet on the same
+ * edge.  leader[] is each value's group, named by one of its values;
+ * lo[] and hi[] are, for each leader, the first and one past the last
+ * position at which the group's register is used, edges included. */
+struct live_groups {
+    uint32_t *leader;
+    uint32_t *lo;
+    uint32_t *hi;
+};
+
+void live_coalesce(const struct ir_func *f, const struct live *l,
+                   struct live_groups *g);
+void live_groups_free(struct live_groups *g);
+
+/* Where a group's register is in use, lo to hi of its leader `value`,
+ * for the backends' linear scans.  Each backend's interval starts with
+ * one, so that live_by_lo() sorts them all. */
+struct live_interval {
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t value;
+};
+
+/* qsort() comparison of structs that start with a live_interval: by lo,
+ * then by value, so that ties fall the same way on every libc. */
+int live_by_lo(const void *a, const void *b);
+
+#endif
@@ -0,0 +1,957 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bytecode.h"
+#include "check.h"
+#include "dfalex.h"
+#include "diag.h"
+#include "elf.h"
+#include "flexlex.h"
+#include "fuse.h"
+#include "ir.h"
+#include "opt.h"
+#include "parlex.h"
+#include "parse.h"
+#include "source.h"
+#include "tablelex.h"
+#include "token.h"
+#include "tokring.h"
+#include "tokstream.h"
+#include "utf8.h"
+#include "vm.h"
+#include "walk.h"
+#include "x86.h"
+
+enum engine { ENGINE_DFA, ENGINE_FLEX, ENGINE_TABLE };
+
+/* What to do with a source: each step past the tokens takes the ones
+ * before it. */
+enum emit {
+    EMIT_TOKENS,
+    EMIT_TOKENS_BIN,
+    EMIT_AST,
+    EMIT_TYPES,
+    EMIT_IR,            /* after the passes */
+    EMIT_OBJECT,        /* x86-64 code, an ELF object */
+    EMIT_BYTECODE,
+    EMIT_PROFILE,       /* sequences of instructions in the bytecode */
+    EMIT_RUN,           /* not emitted: run, with the VM */
+    EMIT_RUN_GENERIC,   /* run, with the VM on tagged registers */
+    EMIT_RUN_TREE       /* run, walking the tree */
+};
+
+/* What --stats reports: bytes and tokens lexed, the clock and cycle
+ * counter readings around the lexing, and the clock once the tokens are
+ * written as well; with --emit=ast, the nodes built, the memory they take
+ * and the time spent parsing, with --emit=types the time spent checking
+ * too, with --emit=ir the time spent building the IR and optimizing it
+ * and what each pass did, with --emit=obj the time spent on machine code
+ * and the functions and bytes of it, and with --run the time spent
+ * compiling (all of that and the bytecode) and running, and with
+ * --count-dispatches what the VM did. */
+struct stats {
+    uint64_t bytes;
+    uint64_t tokens;
+    struct timespec start;
+    struct timespec end;
+    struct timespec done;
+    uint64_t start_cycles;
+    uint64_t end_cycles;
+    int parsed;
+    struct timespec parsed_at;      /* when the tree was complete */
+    uint64_t nodes;
+    uint64_t ast_bytes;
+    double parse_seconds;
+    int checked;
+    double check_seconds;
+    int optimized;
+    double ir_seconds;
+    double opt_seconds;
+    struct opt_stats opt;
+    int native;
+    double native_seconds;
+    struct x86_stats x86;
+    int ran;
+    double compile_seconds;
+    double run_seconds;
+    int counted;
+    uint64_t dispatches;
+    uint64_t back_jumps;
+};
+
+/* One file of a batch.  A worker fills in everything below path and then
+ * sets done; the main thread prints the results in argument order. */
+struct job {
+    const char *path;
+    struct source src;
+    struct token_buffer tokens;
+    int error;
+    int done;
+};
+
+struct batch {
+    struct job *jobs;
+    size_t count;
+    size_t next;
+    enum engine engine;
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+};
+
+/* The lexer side of a pipelined run: lexes `src` in blocks of
+ * PIPE_BLOCK_BYTES into the ring and records when it is done in `lexed`. */
+struct pipe_lexer {
+    const struct source *src;
+    struct token_ring ring;
+    struct stats lexed;
+};
+
+/* The parser side: what take_block() hands the lexer's blocks on to. */
+struct pipe_feed {
+    const struct source *src;
+    struct pipe_lexer *pl;
+    struct token_buffer *tokens;    /* every block so far */
+    struct stats *st;
+};
+
+#define PIPE_BLOCK_BYTES    (64 * 1024)
+#define PIPE_SLOTS          16
+
+/* The flex scanner lives in globals, so only one thread may run it. */
+static pthread_mutex_t flex_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* --no-fuse and --count-dispatches, for the VM. */
+static int fuse_bytecode = 1;
+static int count_dispatches;
+
+/* --passes=, the optimizer's pipeline. */
+static struct pipeline passes;
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: minilang"
+            " [--emit=tokens|tokens-bin|ast|types|ir|obj|bytecode|profile]"
+            " [--run[=vm|generic|tree]] [--passes=pass,...] [--no-fuse]"
+            " [--count-dispatches]"
+            " [--engine=dfa|flex|table] [-j N] [--max-errors=N] [--stats]"
+            " [file...]\n");
+}
+
+/* Time stamp counter where there is one; cycles_per_byte reads 0 without. */
+static uint64_t read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void stats_start(struct stats *st)
+{
+    st->bytes = 0;
+    st->tokens = 0;
+    st->parsed = 0;
+    st->nodes = 0;
+    st->ast_bytes = 0;
+    st->parse_seconds = 0;
+    st->checked = 0;
+    st->check_seconds = 0;
+    st->optimized = 0;
+    st->ir_seconds = 0;
+    st->opt_seconds = 0;
+    memset(&st->opt, 0, sizeof st->opt);
+    st->native = 0;
+    st->native_seconds = 0;
+    memset(&st->x86, 0, sizeof st->x86);
+    st->ran = 0;
+    st->compile_seconds = 0;
+    st->run_seconds = 0;
+    st->counted = 0;
+    st->dispatches = 0;
+    st->back_jumps = 0;
+    clock_gettime(CLOCK_MONOTONIC, &st->start);
+    st->start_cycles = read_cycles();
+}
+
+static void stats_stop(struct stats *st)
+{
+    st->end_cycles = read_cycles();
+    clock_gettime(CLOCK_MONOTONIC, &st->end);
+}
+
+static void stats_done(struct stats *st)
+{
+    clock_gettime(CLOCK_MONOTONIC, &st->done);
+}
+
+static double elapsed(const struct timespec *from, const struct timespec *to)
+{
+    return (double) (to->tv_sec - from->tv_sec) +
+           (double) (to->tv_nsec - from->tv_nsec) * 1e-9;
+}
+
+/* One line of key=value pairs on stderr, for scripts such as bench_lex.sh
+ * to pick up.  total_seconds runs until the tokens are written, so it is
+ * the latency of the whole front end; front_seconds runs until the tree
+ * is parsed, lexing included; peak RSS covers the whole process so far. */
+static void stats_print(const struct stats *st)
+{
+    struct rusage usage;
+    double seconds = elapsed(&st->start, &st->end);
+    long peak_kb = 0;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        peak_kb = usage.ru_maxrss / 1024;
+#else
+        peak_kb = usage.ru_maxrss;
+#endif
+    }
+    if (seconds <= 0)
+        seconds = 1e-9;
+    fprintf(stderr,
+            "minilang: stats: bytes=%llu tokens=%llu seconds=%.6f"
+            " mb_per_s=%.2f tokens_per_s=%.0f cycles_per_byte=%.3f"
+            " peak_rss_kb=%ld total_seconds=%.6f",
+            (unsigned long long) st->bytes, (unsigned long long) st->tokens,
+            seconds, (double) st->bytes / seconds / 1e6,
+            (double) st->tokens / seconds,
+            st->bytes ? (double) (st->end_cycles - st->start_cycles) /
+                        (double) st->bytes : 0.0,
+            peak_kb, elapsed(&st->start, &st->done));
+    if (st->parsed)
+        fprintf(stderr, " nodes=%llu ast_bytes=%llu bytes_per_node=%.1f"
+                " parse_seconds=%.6f parse_mb_per_s=%.2f front_seconds=%.6f",
+                (unsigned long long) st->nodes,
+                (unsigned long long) st->ast_bytes,
+                st->nodes ? (double) st->ast_bytes / (double) st->nodes : 0.0,
+                st->parse_seconds, st->parse_seconds > 0 ?
+                (double) st->bytes / st->parse_seconds / 1e6 : 0.0,
+                elapsed(&st->start, &st->parsed_at));
+    if (st->checked)
+        fprintf(stderr, " check_seconds=%.6f", st->check_seconds);
+    if (st->optimized)
+        fprintf(stderr, " ir_seconds=%.6f opt_seconds=%.6f", st->ir_seconds,
+                st->opt_seconds);
+    if (st->native) {
+        /* throughput from the source: every step it took, lexing aside */
+        double compile = st->parse_seconds + st->check_seconds +
+                         st->ir_seconds + st->opt_seconds +
+                         st->native_seconds;
+
+        fprintf(stderr, " native_seconds=%.6f functions=%llu"
+                " functions_per_s=%.0f code_bytes=%llu spilled=%llu",
+                st->native_seconds, (unsigned long long) st->x86.functions,
+                compile > 0 ? (double) st->x86.functions / compile : 0.0,
+                (unsigned long long) st->x86.code_bytes,
+                (unsigned long long) st->x86.spilled);
+    }
+    if (st->ran)
+        fprintf(stderr, " compile_seconds=%.6f run_seconds=%.6f",
+                st->compile_seconds, st->run_seconds);
+    if (st->counted)
+        fprintf(stderr, " dispatches=%llu back_jumps=%llu",
+                (unsigned long long) st->dispatches,
+                (unsigned long long) st->back_jumps);
+    fputc('\n', stderr);
+    if (st->optimized)
+        opt_stats_print(stderr, &st->opt);
+}
+
+/* Standard input that cannot be mapped; the flex engine streams it through
+ * YY_INPUT instead of reading it all up front. */
+static int piped_stdin(const char *path)
+{
+    struct stat st;
+
+    if (path && strcmp(path, "-") != 0)
+        return 0;
+    return fstat(STDIN_FILENO, &st) != 0 || !S_ISREG(st.st_mode);
+}
+
+static void print_tokens(const char *src, const struct token_buffer *tokens)
+{
+    size_t i;
+
+    for (i = 0; i < tokens->count; i++) {
+        const struct token *tok = &tokens->data[i];
+
+        if (token_has_text((enum token_kind) tok->kind))
+            printf("%s(%.*s)\n", token_names[tok->kind], (int) tok->length,
+                   src + tok->offset);
+        else
+            printf("%s\n", token_names[tok->kind]);
+    }
+}
+
+/* Only the first bad sequence is reported: after it the source is not
+ * text anyway.  Bytes outside strings and comments are also reported as
+ * invalid with the tokens. */
+static void check_utf8(const struct source *src)
+{
+    size_t bad = utf8_validate(src->data, src->len);
+
+    if (bad < src->len)
+        diag_error((uint32_t) bad, "source is not valid UTF-8");
+}
+
+/* Report the errors marked in tokens, between diag_begin() and diag_end();
+ * returns how many of them to keep, fewer than all once past the error
+ * limit, when the tokens from the one in error on are dropped as the flex
+ * scanner stops printing there. */
+static size_t check_tokens(const struct source *src,
+                           const struct token_buffer *tokens)
+{
+    size_t i;
+
+    for (i = 0; i < tokens->count; i++) {
+        const struct token *tok = &tokens->data[i];
+
+        if (tok->kind == TOKEN_NUMBER) {
+            if (tokens->numbers[tok->value].type == NUMBER_OVERFLOW)
+                diag_error(tok->offset, "integer literal out of range");
+        } else if (tok->kind == TOKEN_UNKNOWN) {
+            if (tok->value == TOKEN_ERROR_STRING)
+                diag_error(tok->offset, "unterminated string literal");
+            else if (tok->value == TOKEN_ERROR_COMMENT)
+                diag_error(tok->offset, "unterminated comment");
+            else
+                diag_invalid(tok->offset, tok->length,
+                             src->data ? src->data + tok->offset : NULL);
+        }
+        if (diag_stopped())
+            break;
+    }
+    return i;
+}
+
+/* The lexer converts number tokens and marks bad input as it goes but
+ * cannot report, since a parallel lex may throw some of its work away;
+ * report what was kept.  A source the flex scanner read from a pipe is
+ * not held to check, so `piped_bad` is where it stopped being UTF-8, or
+ * UINT64_MAX.  Returns whether there was anything to report. */
+static int report_errors(const char *path, const struct source *src,
+                         uint64_t piped_bad, struct token_buffer *tokens)
+{
+    struct line_index lines;
+    unsigned long errors = diag_error_count();
+    size_t kept, i;
+
+    line_index_init(&lines, src->data, src->len);
+    diag_begin(path, src->data ? &lines : NULL);
+    if (src->data)
+        check_utf8(src);
+    else if (piped_bad != UINT64_MAX)
+        diag_error((uint32_t) piped_bad, "source is not valid UTF-8");
+    kept = check_tokens(src, tokens);
+    if (kept < tokens->count) {
+        tokens->number_count = 0;
+        for (i = kept; i-- > 0;) {
+            if (tokens->data[i].kind == TOKEN_NUMBER) {
+                tokens->number_count = tokens->data[i].value + 1;
+                break;
+            }
+        }
+        tokens->count = kept;
+    }
+    diag_end();
+    line_index_free(&lines);
+    return diag_error_count() != errors;
+}
+
+/* Seconds from *mark until now, which becomes the new mark. */
+static double lap(struct timespec *mark)
+{
+    struct timespec now;
+    double seconds;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    seconds = elapsed(mark, &now);
+    *mark = now;
+    return seconds;
+}
+
+/* Hand the parser the next block from the lexer thread, reporting its
+ * errors and rebasing its number tokens onto the numbers so far. */
+static int take_block(void *arg)
+{
+    struct pipe_feed *feed = arg;
+    struct token_buffer *out = feed->tokens;
+    struct token_buffer *block = token_ring_acquire(&feed->pl->ring);
+    size_t kept, need, i;
+    uint32_t base;
+
+    if (!block)
+        return 0;
+    kept = check_tokens(feed->src, block);
+    feed->st->tokens += block->count;
+    while (out->capacity < out->count + kept)
+        token_buffer_grow(out);
+    need = out->number_count + block->number_count;
+    if (need > out->number_capacity)
+        token_buffer_reserve_numbers(out, need > out->number_capacity * 2 ?
+                                          need : out->number_capacity * 2);
+    base = (uint32_t) out->number_count;
+    for (i = 0; i < kept; i++) {
+        struct token tok = block->data[i];
+
+        if (tok.kind == TOKEN_NUMBER)
+            tok.value += base;
+        out->data[out->count++] = tok;
+    }
+    if (block->number_count)
+        memcpy(out->numbers + out->number_count, block->numbers,
+               block->number_count * sizeof *out->numbers);
+    out->number_count = need;
+    token_ring_release(&feed->pl->ring);
+    return !diag_stopped();
+}
+
+/* Parse the tokens and go on as far as `emit` says: print the tree, check
+ * it and print it annotated, translate it to IR and optimize it and print
+ * that, compile that to machine code and write the object, compile it
+ * and print the bytecode, or run it.  A source with errors, the lexer's
+ * (`lex_failed`) or any found on the way, is neither compiled nor run.
+ * Each step alone is timed, into st; their errors are reported after the
+ * lexer's.  With a `feed` the tokens are still being lexed: the parser
+ * takes them as they come, their errors are reported with its own, and
+ * parse_seconds includes waiting for the lexer.  Returns 1 if the program
+ * failed at runtime, or the object could not be written. */
+static int write_ast(const char *path, const struct source *src,
+                     size_t len, const struct token_buffer *tokens,
+                     struct pipe_feed *feed, enum emit emit, int lex_failed,
+                     struct stats *st)
+{
+    struct line_index lines;
+    struct timespec mark;
+    struct ast ast;
+    struct sema sema;
+    struct ir_program ir;
+    struct program prog;
+    struct elf_object obj;
+    unsigned long errors = diag_error_count();
+    int translated = 0;
+    int assembled = 0;
+    int compiled = 0;
+    int status = 0;
+
+    line_index_init(&lines, src->data, src->len);
+    diag_begin(path, src->data ? &lines : NULL);
+    clock_gettime(CLOCK_MONOTONIC, &mark);
+    if (feed) {
+        check_utf8(src);
+        parse_stream(feed->tokens, (uint32_t) len, &ast, take_block, feed);
+        /* the parser may have stopped early, at the error limit */
+        token_ring_cancel(&feed->pl->ring);
+    } else {
+        parse(tokens, (uint32_t) len, &ast);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &st->parsed_at);
+    st->parsed = 1;
+    st->nodes += ast.count - 1;
+    st->ast_bytes += (uint64_t) ast.count * AST_NODE_BYTES;
+    st->parse_seconds += lap(&mark);
+    if (emit >= EMIT_TYPES) {
+        check(&ast, &sema);
+        st->checked = 1;
+        st->check_seconds += lap(&mark);
+    }
+    if (emit >= EMIT_IR && !lex_failed && diag_error_count() == errors) {
+        double seconds;
+
+        if (emit != EMIT_RUN_TREE) {
+            ir_build(&ast, &sema, &ir);
+            translated = 1;
+            st->optimized = 1;
+            st->ir_seconds += seconds = lap(&mark);
+            st->compile_seconds += seconds;
+            optimize(&ir, &passes, &st->opt);
+            st->opt_seconds += seconds = lap(&mark);
+            st->compile_seconds += seconds;
+        }
+        if (emit == EMIT_OBJECT) {
+            elf_init(&obj);
+            x86_compile(&ir, path, src->data ? &lines : NULL, &obj,
+                        &st->x86);
+            assembled = 1;
+            st->native = 1;
+            st->native_seconds += lap(&mark);
+        }
+        if (emit >= EMIT_BYTECODE && emit != EMIT_RUN_TREE) {
+            status = compile(&ir, emit == EMIT_RUN_GENERIC, &prog);
+            if (status == 0 && fuse_bytecode)
+                fuse(&prog);
+            compiled = 1;
+        }
+        if (emit >= EMIT_RUN) {
+            struct vm_counts counts;
+            int counting = count_dispatches && emit != EMIT_RUN_TREE;
+
+            st->ran = 1;
+            st->compile_seconds += lap(&mark);
+            if (status == 0)
+                status = emit == EMIT_RUN_TREE
+                         ? walk_run(&ast, &sema)
+                         : vm_run(&prog, counting ? &counts : NULL);
+            st->run_seconds += lap(&mark);
+            if (status == 0 && counting) {
+                st->counted = 1;
+                st->dispatches += counts.dispatches;
+                st->back_jumps += counts.back_jumps;
+            }
+        }
+    }
+    diag_end();
+    line_index_free(&lines);
+
+    if (emit == EMIT_AST)
+        ast_print(stdout, &ast);
+    else if (emit == EMIT_TYPES)
+        sema_print(stdout, &ast, &sema);
+    else if (emit == EMIT_IR && translated)
+        ir_print(stdout, &ir);
+    else if (assembled && elf_write(stdout, &obj) != 0)
+        status = 1;
+    else if (emit == EMIT_BYTECODE && compiled && status == 0)
+        program_print(stdout, &prog);
+    else if (emit == EMIT_PROFILE && compiled && status == 0)
+        profile_print(stdout, &prog);
+    if (assembled)
+        elf_free(&obj);
+    if (compiled)
+        program_free(&prog);
+    if (translated)
+        ir_program_free(&ir);
+    if (emit >= EMIT_TYPES)
+        sema_free(&sema);
+    ast_free(&ast);
+    return status;
+}
+
+static int write_tokens(const char *path, const struct source *src,
+                        size_t len, const struct token_buffer *tokens,
+                        enum emit emit, int lex_failed, struct stats *st)
+{
+    if (emit >= EMIT_AST) {
+        return write_ast(path, src, len, tokens, NULL, emit, lex_failed, st);
+    } else if (emit == EMIT_TOKENS_BIN) {
+        if (tokstream_write(stdout, tokens, (uint32_t) len) != 0 ||
+            fflush(stdout) != 0) {
+            perror("minilang: writing token stream");
+            return 1;
+        }
+    } else {
+        print_tokens(src->data, tokens);
+    }
+    return 0;
+}
+
+static void *pipe_worker(void *arg)
+{
+    struct pipe_lexer *pl = arg;
+    const char *data = pl->src->data;
+    size_t len = pl->src->len;
+    size_t pos = 0;
+
+    while (pos < len) {
+        struct token_buffer *block = token_ring_reserve(&pl->ring);
+        size_t stop = len - pos > PIPE_BLOCK_BYTES ? pos + PIPE_BLOCK_BYTES
+                                                   : len;
+
+        if (!block)
+            break;
+        pos = dfa_lex_range(data, len, pos, stop, block);
+        token_ring_publish(&pl->ring);
+    }
+    stats_stop(&pl->lexed);
+    token_ring_close(&pl->ring);
+    return NULL;
+}
+
+static void pipe_start(struct pipe_lexer *pl, pthread_t *thread,
+                       const struct source *src, const struct stats *st)
+{
+    pl->src = src;
+    if (token_ring_init(&pl->ring, PIPE_SLOTS) != 0) {
+        fprintf(stderr, "minilang: out of memory for token ring\n");
+        exit(1);
+    }
+    pl->lexed = *st;
+    errno = pthread_create(thread, NULL, pipe_worker, pl);
+    if (errno != 0) {
+        perror("minilang: starting lexer thread");
+        exit(1);
+    }
+}
+
+static void pipe_finish(struct pipe_lexer *pl, pthread_t thread,
+                        struct stats *st)
+{
+    pthread_join(thread, NULL);
+    token_ring_free(&pl->ring);
+    st->end = pl->lexed.end;
+    st->end_cycles = pl->lexed.end_cycles;
+    st->bytes = pl->src->len;
+}
+
+/* Lex one in-memory source on a second thread while this one reports and
+ * prints the tokens, block by block, so the run takes about as long as the
+ * slower of the two rather than both.  Output is the same as lexing first
+ * and printing after, except that errors come at the end. */
+static void lex_pipelined(const char *path, const struct source *src,
+                          struct stats *st)
+{
+    struct pipe_lexer pl;
+    struct token_buffer *block;
+    struct line_index lines;
+    pthread_t thread;
+
+    pipe_start(&pl, &thread, src, st);
+    line_index_init(&lines, src->data, src->len);
+    diag_begin(path, &lines);
+    check_utf8(src);
+    while ((block = token_ring_acquire(&pl.ring)) != NULL) {
+        size_t kept = check_tokens(src, block);
+
+        st->tokens += block->count;
+        block->count = kept;
+        print_tokens(src->data, block);
+        token_ring_release(&pl.ring);
+        if (diag_stopped()) {
+            token_ring_cancel(&pl.ring);
+            break;
+        }
+    }
+    diag_end();
+    line_index_free(&lines);
+    pipe_finish(&pl, thread, st);
+}
+
+/* As lex_pipelined(), for a parse: the parser takes the blocks as the
+ * lexer makes them, so lexing and parsing overlap.  Output is the same as
+ * lexing first and parsing after, except that the lexer's errors are
+ * sorted in among the parser's rather than coming first, so the error
+ * limit may cut off different ones. */
+static int parse_pipelined(const char *path, const struct source *src,
+                           enum emit emit, struct stats *st)
+{
+    struct pipe_lexer pl;
+    struct pipe_feed feed;
+    struct token_buffer tokens;
+    pthread_t thread;
+    int status;
+
+    token_buffer_init(&tokens);
+    feed.src = src;
+    feed.pl = &pl;
+    feed.tokens = &tokens;
+    feed.st = st;
+    pipe_start(&pl, &thread, src, st);
+    status = write_ast(path, src, src->len, &tokens, &feed, emit, 0, st);
+    pipe_finish(&pl, thread, st);
+    token_buffer_free(&tokens);
+    return status;
+}
+
+static void lex_job(struct job *job, enum engine engine)
+{
+    if (source_open(&job->src, job->path) != 0) {
+        job->error = errno;
+        return;
+    }
+    if (engine == ENGINE_DFA) {
+        dfa_lex(job->src.data, job->src.len, &job->tokens);
+    } else if (engine == ENGINE_TABLE) {
+        table_lex(job->src.data, job->src.len, &job->tokens);
+    } else {
+        pthread_mutex_lock(&flex_lock);
+        flex_lex_buffer(job->src.data, job->src.len, job->path, &job->tokens);
+        pthread_mutex_unlock(&flex_lock);
+    }
+}
+
+static void *batch_worker(void *arg)
+{
+    struct batch *batch = arg;
+
+    for (;;) {
+        struct job *job;
+
+        pthread_mutex_lock(&batch->lock);
+        if (batch->next == batch->count) {
+            pthread_mutex_unlock(&batch->lock);
+            return NULL;
+        }
+        job = &batch->jobs[batch->next++];
+        pthread_mutex_unlock(&batch->lock);
+
+        lex_job(job, batch->engine);
+
+        pthread_mutex_lock(&batch->lock);
+        job->done = 1;
+        pthread_cond_broadcast(&batch->finished);
+        pthread_mutex_unlock(&batch->lock);
+    }
+}
+
+/* Lex several files on up to nthreads threads.  Output is the same as
+ * running minilang on each file in turn; each file's tokens are written as
+ * soon as it and every file before it are done, so memory stays bounded
+ * by the files in flight rather than the whole batch. */
+static int lex_batch(char **paths, size_t count, long nthreads,
+                     enum engine engine, enum emit emit, struct stats *st)
+{
+    struct batch batch;
+    pthread_t *threads;
+    size_t started = 0;
+    size_t i;
+    int status = 0;
+
+    if (nthreads > (long) count)
+        nthreads = (long) count;
+    batch.jobs = calloc(count, sizeof *batch.jobs);
+    threads = malloc((size_t) nthreads * sizeof *threads);
+    if (!batch.jobs || !threads) {
+        fprintf(stderr, "minilang: out of memory for batch\n");
+        exit(1);
+    }
+    for (i = 0; i < count; i++) {
+        batch.jobs[i].path = paths[i];
+        token_buffer_init(&batch.jobs[i].tokens);
+    }
+    batch.count = count;
+    batch.next = 0;
+    batch.engine = engine;
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.finished, NULL);
+
+    for (; started < (size_t) nthreads; started++) {
+        errno = pthread_create(&threads[started], NULL, batch_worker, &batch);
+        if (errno != 0) {
+            if (started == 0) {
+                perror("minilang: starting lexer thread");
+                exit(1);
+            }
+            break;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        struct job *job = &batch.jobs[i];
+
+        pthread_mutex_lock(&batch.lock);
+        while (!job->done)
+            pthread_cond_wait(&batch.finished, &batch.lock);
+        pthread_mutex_unlock(&batch.lock);
+
+        if (job->error) {
+            fprintf(stderr, "minilang: %s: %s\n", job->path,
+                    strerror(job->error));
+            status = 1;
+        } else {
+            int failed;
+
+            st->bytes += job->src.len;
+            st->tokens += job->tokens.count;
+            failed = report_errors(job->path, &job->src, UINT64_MAX,
+                                   &job->tokens);
+            if (write_tokens(job->path, &job->src, job->src.len,
+                             &job->tokens, emit, failed, st) != 0)
+                status = 1;
+        }
+        token_buffer_free(&job->tokens);
+        source_close(&job->src);
+    }
+
+    for (i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    pthread_cond_destroy(&batch.finished);
+    pthread_mutex_destroy(&batch.lock);
+    free(threads);
+    free(batch.jobs);
+    return status || diag_error_count() ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    struct token_buffer tokens;
+    struct source src = { NULL, 0, 0 };
+    struct stats st;
+    enum engine engine = ENGINE_DFA;
+    const char *path = NULL;
+    const char *name;
+    char **paths;
+    size_t npaths = 0;
+    long nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+    enum emit emit = EMIT_TOKENS;
+    int want_stats = 0;
+    int passes_given = 0;
+    int failed;
+    size_t len = 0;
+    uint64_t piped_bad = UINT64_MAX;
+    int status;
+    int i;
+
+    paths = malloc((size_t) argc * sizeof *paths);
+    if (!paths) {
+        fprintf(stderr, "minilang: out of memory\n");
+        return 1;
+    }
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--emit=tokens") == 0) {
+            emit = EMIT_TOKENS;
+        } else if (strcmp(argv[i], "--emit=tokens-bin") == 0) {
+            emit = EMIT_TOKENS_BIN;
+        } else if (strcmp(argv[i], "--emit=ast") == 0) {
+            emit = EMIT_AST;
+        } else if (strcmp(argv[i], "--emit=types") == 0) {
+            emit = EMIT_TYPES;
+        } else if (strcmp(argv[i], "--emit=ir") == 0) {
+            emit = EMIT_IR;
+        } else if (strcmp(argv[i], "--emit=obj") == 0) {
+            emit = EMIT_OBJECT;
+        } else if (strcmp(argv[i], "--emit=bytecode") == 0) {
+            emit = EMIT_BYTECODE;
+        } else if (strcmp(argv[i], "--emit=profile") == 0) {
+            emit = EMIT_PROFILE;
+        } else if (strcmp(argv[i], "--run") == 0 ||
+                   strcmp(argv[i], "--run=vm") == 0) {
+            emit = EMIT_RUN;
+        } else if (strcmp(argv[i], "--run=generic") == 0) {
+            emit = EMIT_RUN_GENERIC;
+        } else if (strcmp(argv[i], "--run=tree") == 0) {
+            emit = EMIT_RUN_TREE;
+        } else if (strcmp(argv[i], "--engine=dfa") == 0) {
+            engine = ENGINE_DFA;
+        } else if (strcmp(argv[i], "--engine=flex") == 0) {
+            engine = ENGINE_FLEX;
+        } else if (strcmp(argv[i], "--engine=table") == 0) {
+            engine = ENGINE_TABLE;
+        } else if (strncmp(argv[i], "--max-errors=", 13) == 0) {
+            diag_set_limit(strtoul(argv[i] + 13, NULL, 10));
+        } else if (strncmp(argv[i], "--passes=", 9) == 0) {
+            if (pipeline_parse(argv[i] + 9, &passes) != 0) {
+                fprintf(stderr, "minilang: unknown pass in %s\n", argv[i]);
+                usage();
+                return 2;
+            }
+            passes_given = 1;
+        } else if (strcmp(argv[i], "--no-fuse") == 0) {
+            fuse_bytecode = 0;
+        } else if (strcmp(argv[i], "--count-dispatches") == 0) {
+            count_dispatches = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            want_stats = 1;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            nthreads = strtol(argv[++i], NULL, 10);
+            if (nthreads < 1) {
+                usage();
+                return 2;
+            }
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            paths[npaths++] = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (!passes_given)
+        pipeline_default(&passes);
+    if (nthreads < 1)
+        nthreads = 1;
+    stats_start(&st);
+    if (npaths > 1) {
+        /* Files are written as they finish, so the batch is timed whole. */
+        status = lex_batch(paths, npaths, nthreads, engine, emit, &st);
+        stats_stop(&st);
+        stats_done(&st);
+        if (want_stats)
+            stats_print(&st);
+        free(paths);
+        return status;
+    }
+    if (npaths == 1)
+        path = paths[0];
+    free(paths);
+
+    name = path && strcmp(path, "-") != 0 ? path : "stdin";
+    token_buffer_init(&tokens);
+    if (engine == ENGINE_FLEX && piped_stdin(path)) {
+        if (emit == EMIT_TOKENS) {
+            /* Printed as matched, with no buffer to count: tokens=0. */
+            st.bytes = flex_lex(stdin, name, NULL, NULL);
+            stats_stop(&st);
+            stats_done(&st);
+            if (want_stats)
+                stats_print(&st);
+            return diag_error_count() ? 1 : 0;
+        }
+        len = flex_lex(stdin, name, &tokens, &piped_bad);
+    } else {
+        if (source_open(&src, path) != 0) {
+            fprintf(stderr, "minilang: %s: ", name);
+            perror(NULL);
+            return 1;
+        }
+        len = src.len;
+        if (engine == ENGINE_DFA && emit == EMIT_TOKENS && nthreads > 1) {
+            lex_pipelined(name, &src, &st);
+            status = fflush(stdout) != 0;
+            stats_done(&st);
+            if (want_stats)
+                stats_print(&st);
+            source_close(&src);
+            return status || diag_error_count() ? 1 : 0;
+        } else if (engine == ENGINE_DFA && emit >= EMIT_AST &&
+                   nthreads > 1) {
+            status = parse_pipelined(name, &src, emit, &st) ||
+                     fflush(stdout) != 0;
+            stats_done(&st);
+            if (want_stats)
+                stats_print(&st);
+            source_close(&src);
+            return status || diag_error_count() ? 1 : 0;
+        } else if (engine == ENGINE_DFA) {
+            /* Only the binary stream lexes a single source in chunks:
+             * it is written from the whole array once lexing is done,
+             * where the pipelines above overlap lexing with printing or
+             * parsing instead. */
+            dfa_lex_parallel(src.data, src.len, nthreads, &tokens);
+        } else if (engine == ENGINE_TABLE) {
+            table_lex(src.data, src.len, &tokens);
+        } else if (emit == EMIT_TOKENS && !want_stats) {
+            flex_lex_buffer(src.data, src.len, name, NULL);
+            source_close(&src);
+            return diag_error_count() ? 1 : 0;
+        } else {
+            flex_lex_buffer(src.data, src.len, name, &tokens);
+        }
+    }
+
+    stats_stop(&st);
+    st.bytes = len;
+    st.tokens = tokens.count;
+
+    failed = report_errors(name, &src, piped_bad, &tokens);
+    status = write_tokens(name, &src, len, &tokens, emit, failed, &st) ||
+             fflush(stdout) != 0;
+    stats_done(&st);
+    if (want_stats)
+        stats_print(&st);
+    token_buffer_free(&tokens);
+    source_close(&src);
+    return status || diag_error_count() ? 1 : 0;
+}
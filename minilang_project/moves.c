@@ -0,0 +1,77 @@
+#include <stdlib.h>
+
+#define ALLOC_WHAT "phi copies"
+#include "alloc.h"
+
+#include "moves.h"
+
+static void add(struct moves *m, uint32_t dst, uint32_t src, uint32_t to,
+                uint32_t from)
+{
+    if (dst == src)
+        return;
+    if (m->count == m->capacity) {
+        m->capacity = m->capacity ? m->capacity * 2 : 16;
+        m->list = xrealloc(m->list, m->capacity * sizeof *m->list);
+    }
+    m->list[m->count].dst = dst;
+    m->list[m->count].src = src;
+    m->list[m->count].to = to;
+    m->list[m->count++].from = from;
+}
+
+uint32_t moves_edge(struct moves *m, const struct ir_func *f, uint32_t from,
+                    uint32_t to, moves_place_fn *place, void *arg)
+{
+    uint32_t j = ir_pred_index(f, to, from), insn, operand;
+
+    m->count = 0;
+    for (insn = f->blocks[to].first; insn && f->op[insn] == IR_PHI;
+         insn = f->next[insn]) {
+        operand = f->args[f->a[insn] + j];
+        add(m, place(arg, insn), place(arg, operand), insn, operand);
+    }
+    return m->count;
+}
+
+void moves_emit(struct moves *m, uint32_t scratch, moves_emit_fn *emit,
+                void *arg)
+{
+    struct move *list = m->list;
+    uint32_t n = m->count, i, k;
+
+    while (n) {
+        for (i = 0; i < n; i++) {
+            for (k = 0; k < n; k++)
+                if (list[k].src == list[i].dst)
+                    break;
+            if (k == n)
+                break;
+        }
+        if (i == n) {
+            /* every one is in a cycle */
+            struct move save;
+
+            i = 0;
+            save.dst = scratch;
+            save.src = list[i].dst;
+            save.to = list[i].to;
+            save.from = list[i].to;
+            emit(arg, &save);
+            for (k = 0; k < n; k++)
+                if (list[k].src == list[i].dst)
+                    list[k].src = scratch;
+        }
+        emit(arg, &list[i]);
+        list[i] = list[--n];
+    }
+    m->count = 0;
+}
+
+void moves_free(struct moves *m)
+{
+    free(m->list);
+    m->list = NULL;
+    m->count = 0;
+    m->capacity = 0;
+}
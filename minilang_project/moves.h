@@ -0,0 +1,51 @@
+#ifndef MINILANG_MOVES_H
+#define MINILANG_MOVES_H
+
+#include <stdint.h>
+
+#include "ir.h"
+
+/* The copies the phis of a block take on an edge into it, for both
+ * backends: a parallel copy, each phi getting its operand as if all at
+ * once, made as a sequence of single copies.
+ *
+ * The backend numbers the places values are kept in (registers, slots
+ * of the frame, constants) its own way, two values getting the same
+ * number only when they are in the same place, and makes each copy
+ * itself.  A copy goes once nothing still to be copied reads the place
+ * it overwrites; when every one left is in a cycle, one place is saved
+ * in a scratch one, and the copies that read it read that instead. */
+struct move {
+    uint32_t dst;           /* places */
+    uint32_t src;
+    uint32_t to;            /* the value in dst after the copy, the phi */
+    uint32_t from;          /* the value in src before it, its operand */
+};
+
+struct moves {
+    struct move *list;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+/* The backend's number for the place of `value`. */
+typedef uint32_t moves_place_fn(void *arg, uint32_t value);
+
+/* Make one copy.  The one that saves a place in the scratch one has
+ * dst == scratch and to == from, the phi whose place it saves. */
+typedef void moves_emit_fn(void *arg, const struct move *move);
+
+/* The copies onto the edge from `from` to `to`, in place of any in m,
+ * leaving out those from a place to itself; returns how many there
+ * are. */
+uint32_t moves_edge(struct moves *m, const struct ir_func *f, uint32_t from,
+                    uint32_t to, moves_place_fn *place, void *arg);
+
+/* Make the copies in m, in an order that gives each phi its operand, and
+ * empty it.  `scratch` is a place no copy reads or writes. */
+void moves_emit(struct moves *m, uint32_t scratch, moves_emit_fn *emit,
+                void *arg);
+
+void moves_free(struct moves *m);
+
+#endif
@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "native.h"
+
+static struct arena strings;
+
+const struct str *minilang_concat(const struct str *a, const struct str *b)
+{
+    return str_concat(&strings, a, b);
+}
+
+void minilang_div_zero(const char *where)
+{
+    fflush(stdout);
+    fprintf(stderr, "minilang: %s: division by zero\n", where);
+    exit(1);
+}
+
+int main(void)
+{
+    struct timespec start, end;
+
+    arena_init(&strings);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    minilang_top();
+    minilang_main();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (fflush(stdout) != 0) {
+        perror("minilang: writing output");
+        return 1;
+    }
+    if (getenv("MINILANG_STATS"))
+        fprintf(stderr, "minilang: stats: run_seconds=%.6f\n",
+                (double) (end.tv_sec - start.tv_sec) +
+                (double) (end.tv_nsec - start.tv_nsec) * 1e-9);
+    arena_free(&strings);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef MINILANG_NATIVE_H
+#define MINILANG_NATIVE_H
+
+#include "runtime.h"
+
+/* What a program compiled by the native backend (x86.h) links with,
+ * besides runtime.c: the main() that runs it, and what its code calls
+ * that the VM does in place.
+ *
+ * main() calls minilang_top() and then minilang_main(), as vm_run() runs
+ * the top level and then main.  With MINILANG_STATS set in the
+ * environment it also prints how long they took on standard error, in
+ * the key=value form of --stats (run_seconds=), for bench_native.sh. */
+void minilang_top(void);
+void minilang_main(void);
+
+/* str_concat() into an arena of the process's own. */
+const struct str *minilang_concat(const struct str *a, const struct str *b);
+
+/* The report of a division by zero, which ends the program with status
+ * 1; `where` is the source and the line and column of the divide. */
+void minilang_div_zero(const char *where);
+
+#endif
@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number.h"
+#include "pow5_table.h"
+
+/* Exponent of pow5_table[0]. */
+#define POW5_MIN_Q      (-342)
+
+/* Largest power of ten, and largest integer, that a double holds
+ * exactly: Clinger's fast path is exact within both. */
+#define CLINGER_MAX_Q   22
+#define CLINGER_MAX_W   (UINT64_C(1) << 53)
+
+/* Significant digits that always fit in a uint64_t. */
+#define MAX_DIGITS      19
+
+static const double pow10_exact[CLINGER_MAX_Q + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* Value of eight ASCII digits, combined pairwise in one register. */
+static uint32_t eight_digits(const char *p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint32_t v = 0;
+    int i;
+
+    for (i = 0; i < 8; i++)
+        v = v * 10 + (uint32_t) (p[i] - '0');
+    return v;
+#else
+    const uint64_t mask = UINT64_C(0x000000FF000000FF);
+    const uint64_t mul1 = 100 + (UINT64_C(1000000) << 32);
+    const uint64_t mul2 = 1 + (UINT64_C(10000) << 32);
+    uint64_t v;
+
+    memcpy(&v, p, 8);
+    v -= UINT64_C(0x3030303030303030);
+    v = v * 10 + (v >> 8);      /* adjacent digits -> two-digit values */
+    v = ((v & mask) * mul1 + ((v >> 16) & mask) * mul2) >> 32;
+    return (uint32_t) v;
+#endif
+}
+
+/* acc followed by the len digits at p.  Callers keep the total at or
+ * below MAX_DIGITS, so this cannot wrap. */
+static uint64_t accumulate(uint64_t acc, const char *p, size_t len)
+{
+    for (; len >= 8; p += 8, len -= 8)
+        acc = acc * 100000000u + eight_digits(p);
+    for (; len > 0; p++, len--)
+        acc = acc * 10 + (uint64_t) (*p - '0');
+    return acc;
+}
+
+/* High and low halves of a * b. */
+static void mul128(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128) a * b;
+
+    *hi = (uint64_t) (p >> 64);
+    *lo = (uint64_t) p;
+#else
+    uint64_t a_lo = (uint32_t) a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t) b, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    *lo = (mid << 32) | (uint32_t) ll;
+#endif
+}
+
+/* Correctly rounded w * 10^q for w != 0 and POW5_MIN_Q <= q <= 0, after
+ * Lemire, "Number Parsing at a Gigabyte per Second" (2021): the top bits
+ * of w times a truncated 128-bit 5^q are always enough to round. */
+static double eisel_lemire(uint64_t w, int q)
+{
+    const uint64_t *pow5 = pow5_table[q - POW5_MIN_Q];
+    int lz = __builtin_clzll(w);
+    uint64_t hi, lo, mantissa, bits;
+    int upper, power2;
+    double d;
+
+    w <<= lz;
+    mul128(w, pow5[0], &hi, &lo);
+    if ((hi & 0x1FF) == 0x1FF) {
+        uint64_t hi2, lo2;
+
+        mul128(w, pow5[1], &hi2, &lo2);
+        lo += hi2;
+        if (hi2 > lo)
+            hi++;
+    }
+
+    upper = (int) (hi >> 63);
+    mantissa = hi >> (upper + 9);
+    power2 = (int) (((217706 * (int64_t) q) >> 16) + 63) + upper - lz + 1023;
+
+    if (power2 <= 0) {
+        /* subnormal, or zero */
+        if (-power2 + 1 >= 64)
+            return 0.0;
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < (UINT64_C(1) << 52) ? 0 : 1;
+    } else {
+        /* exactly halfway: round to even instead of up */
+        if (lo <= 1 && q >= -4 && (mantissa & 3) == 1 &&
+            mantissa << (upper + 9) == hi)
+            mantissa &= ~UINT64_C(1);
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        if (mantissa >= UINT64_C(2) << 52) {
+            mantissa = UINT64_C(1) << 52;
+            power2++;
+        }
+        mantissa &= ~(UINT64_C(1) << 52);
+    }
+    bits = mantissa | (uint64_t) power2 << 52;
+    memcpy(&d, &bits, sizeof d);
+    return d;
+}
+
+/* More significant digits than a uint64_t holds: let the C library do
+ * it.  The lexeme is not NUL-terminated, and whatever follows it in the
+ * source (an 'e', say) must not be read as part of it. */
+static double slow_path(const char *s, size_t len)
+{
+    char small[64];
+    char *copy = len < sizeof small ? small : malloc(len + 1);
+    double d;
+
+    if (!copy)
+        return strtod("nan", NULL);
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    d = strtod(copy, NULL);
+    if (copy != small)
+        free(copy);
+    return d;
+}
+
+static double parse_float(const char *s, size_t len, size_t int_len)
+{
+    const char *ip = s, *fp = s + int_len + 1;
+    size_t in = int_len, fn = len - int_len - 1;
+    size_t places;
+    uint64_t w;
+    int q;
+
+    /* Leading zeros of the integer part and trailing zeros of the fraction
+     * carry no information; the value is w * 10^-places. */
+    while (in > 0 && *ip == '0') {
+        ip++;
+        in--;
+    }
+    while (fn > 0 && fp[fn - 1] == '0')
+        fn--;
+    places = fn;
+    if (in == 0) {
+        while (fn > 0 && *fp == '0') {
+            fp++;
+            fn--;
+        }
+    }
+    if (in + fn == 0)
+        return 0.0;
+    if (in + fn > MAX_DIGITS)
+        return slow_path(s, len);
+    if (places > (size_t) -POW5_MIN_Q)
+        return 0.0;     /* below 10^-323, half the smallest subnormal */
+
+    w = accumulate(accumulate(0, ip, in), fp, fn);
+    q = -(int) places;
+    if (q >= -CLINGER_MAX_Q && w <= CLINGER_MAX_W)
+        return (double) w / pow10_exact[-q];
+    return eisel_lemire(w, q);
+}
+
+void number_parse(const char *s, size_t len, struct number *out)
+{
+    const char *dot = memchr(s, '.', len);
+
+    if (dot) {
+        out->type = NUMBER_FLOAT;
+        out->as.f = parse_float(s, len, (size_t) (dot - s));
+        return;
+    }
+
+    while (len > 1 && *s == '0') {
+        s++;
+        len--;
+    }
+    if (len <= MAX_DIGITS) {
+        uint64_t v = accumulate(0, s, len);
+
+        if (v <= INT64_MAX) {
+            out->type = NUMBER_INT;
+            out->as.i = (int64_t) v;
+            return;
+        }
+    }
+    out->type = NUMBER_OVERFLOW;
+    out->as.i = INT64_MAX;
+}
+
+void number_format(char buf[NUMBER_FORMAT_SIZE], double d)
+{
+    int digits;
+
+    for (digits = 15; digits < 17; digits++) {
+        snprintf(buf, NUMBER_FORMAT_SIZE, "%.*g", digits, d);
+        if (strtod(buf, NULL) == d)
+            return;
+    }
+    snprintf(buf, NUMBER_FORMAT_SIZE, "%.17g", d);
+}
@@ -0,0 +1,34 @@
+#ifndef MINILANG_NUMBER_H
+#define MINILANG_NUMBER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Value of a {number} lexeme: digits, optionally '.' and more digits. */
+enum number_type {
+    NUMBER_INT,         /* fits in int64_t */
+    NUMBER_FLOAT,       /* had a fraction; correctly rounded double */
+    NUMBER_OVERFLOW     /* integer above INT64_MAX; i is INT64_MAX */
+};
+
+struct number {
+    uint32_t type;
+    uint32_t offset;    /* of the token, for diagnostics */
+    union {
+        int64_t i;
+        double f;
+    } as;
+};
+
+/* Convert the text of a {number} token.  Integers are parsed eight digits
+ * at a time; floats take Clinger's exact fast path when the digits fit a
+ * double's mantissa and the Eisel-Lemire algorithm otherwise, falling
+ * back to strtod() only past 19 significant digits. */
+void number_parse(const char *s, size_t len, struct number *out);
+
+/* Shortest of %.15g, %.16g and %.17g that reads back as `d`, into buf. */
+#define NUMBER_FORMAT_SIZE 32
+
+void number_format(char buf[NUMBER_FORMAT_SIZE], double d);
+
+#endif
@@ -0,0 +1,1109 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ALLOC_WHAT "optimizer"
+#include "alloc.h"
+
+#include "intern.h"
+#include "opt.h"
+#include "runtime.h"
+
+const char *const pass_names[PASS_COUNT] = {
+#define OPT_PASS_NAME(name, text, counts) text,
+    OPT_PASSES(OPT_PASS_NAME)
+#undef OPT_PASS_NAME
+};
+
+static const char *const pass_counts[PASS_COUNT] = {
+#define OPT_PASS_COUNTS(name, text, counts) counts,
+    OPT_PASSES(OPT_PASS_COUNTS)
+#undef OPT_PASS_COUNTS
+};
+
+/* Replacements: repl[v] is the value to use for v, or IR_NONE to keep
+ * it.  A replacement may itself have been replaced since. */
+static uint32_t find(uint32_t *repl, uint32_t v)
+{
+    uint32_t root = v, next;
+
+    while (repl[root])
+        root = repl[root];
+    while (repl[v] && repl[v] != root) {
+        next = repl[v];
+        repl[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+/* Make every operand of every instruction its replacement. */
+static void apply(struct ir_func *f, uint32_t *repl)
+{
+    uint32_t block, insn, k, n;
+
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            n = ir_operand_count(f, insn);
+            for (k = 0; k < n; k++) {
+                uint32_t *op = ir_operand(f, insn, k);
+
+                *op = find(repl, *op);
+            }
+        }
+    }
+}
+
+/* Who uses each value: users[start[v] .. start[v + 1]), an instruction
+ * once per operand it is used as. */
+struct uses {
+    uint32_t *start;
+    uint32_t *users;
+};
+
+static void uses_build(struct ir_func *f, struct uses *u)
+{
+    uint32_t block, insn, k, n, total = 0;
+
+    u->start = xcalloc(f->count + 1, sizeof *u->start);
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            n = ir_operand_count(f, insn);
+            for (k = 0; k < n; k++)
+                u->start[*ir_operand(f, insn, k) + 1]++;
+        }
+    }
+    for (k = 1; k <= f->count; k++)
+        u->start[k] += u->start[k - 1];
+    total = u->start[f->count];
+    u->users = xmalloc(total * sizeof *u->users);
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            n = ir_operand_count(f, insn);
+            for (k = 0; k < n; k++)
+                u->users[u->start[*ir_operand(f, insn, k)]++] = insn;
+        }
+    }
+    /* start[] moved up by one value filling in; move it back */
+    for (k = f->count; k > 0; k--)
+        u->start[k] = u->start[k - 1];
+    u->start[0] = 0;
+}
+
+static void uses_free(struct uses *u)
+{
+    free(u->start);
+    free(u->users);
+}
+
+/* ---- sparse conditional constant propagation ---- */
+
+enum { TOP, CONSTANT, BOTTOM };
+
+struct sccp {
+    struct ir_func *f;
+    struct uses uses;
+    unsigned char *state;
+    uint64_t *bits;
+    unsigned char *reached;     /* per block */
+    unsigned char *edges;       /* per block, bit k for succ[k] */
+    uint32_t *flow;             /* edges to go down: block * 2 + k */
+    uint32_t flow_count;
+    uint32_t *work;             /* values whose state went down */
+    uint32_t work_count;
+};
+
+static int compare_str(uint32_t x, uint32_t y)
+{
+    size_t xlen, ylen;
+    const char *xs = symbol_name(x, &xlen);
+    const char *ys = symbol_name(y, &ylen);
+    int c = memcmp(xs, ys, xlen < ylen ? xlen : ylen);
+
+    if (c)
+        return c;
+    return (xlen > ylen) - (xlen < ylen);
+}
+
+/* The value of `insn` on constant operands x and y, as the VM would
+ * compute it.  Returns 0 if it has none: an int divided by 0. */
+static int evaluate(const struct ir_func *f, uint32_t insn, uint64_t x,
+                    uint64_t y, uint64_t *out)
+{
+    enum type t = (enum type) f->type[f->a[insn]];
+    union value l, r, v;
+    int cmp = 0;
+
+    memcpy(&l, &x, sizeof l);
+    memcpy(&r, &y, sizeof r);
+    v.i = 0;
+    if (f->op[insn] >= IR_EQ) {
+        if (t == TYPE_INT) {
+            cmp = (l.i > r.i) - (l.i < r.i);
+        } else if (t == TYPE_FLOAT) {
+            cmp = (l.f > r.f) - (l.f < r.f);
+            if (l.f != r.f && !cmp)
+                cmp = 2;        /* NaN is neither */
+        } else {
+            cmp = compare_str((uint32_t) x, (uint32_t) y);
+            cmp = (cmp > 0) - (cmp < 0);
+        }
+    }
+    switch (f->op[insn]) {
+    case IR_COPY:
+        v = l;
+        break;
+    case IR_I2F:
+        v.f = (double) l.i;
+        break;
+    case IR_F2I:
+        v.i = float_to_int(l.f);
+        break;
+    case IR_NEG:
+        if (t == TYPE_INT)
+            v.i = int_neg(l.i);
+        else
+            v.f = -l.f;
+        break;
+    case IR_ADD:
+        if (t == TYPE_INT) {
+            v.i = int_add(l.i, r.i);
+        } else if (t == TYPE_FLOAT) {
+            v.f = l.f + r.f;
+        } else {
+            size_t xlen, ylen;
+            const char *xs = symbol_name((uint32_t) x, &xlen);
+            const char *ys = symbol_name((uint32_t) y, &ylen);
+            char *text = xmalloc(xlen + ylen);
+
+            memcpy(text, xs, xlen);
+            memcpy(text + xlen, ys, ylen);
+            v.i = intern(text, xlen + ylen);
+            free(text);
+        }
+        break;
+    case IR_SUB:
+        if (t == TYPE_INT)
+            v.i = int_sub(l.i, r.i);
+        else
+            v.f = l.f - r.f;
+        break;
+    case IR_MUL:
+        if (t == TYPE_INT)
+            v.i = int_mul(l.i, r.i);
+        else
+            v.f = l.f * r.f;
+        break;
+    case IR_DIV:
+        if (t == TYPE_INT) {
+            if (r.i == 0)
+                return 0;
+            v.i = int_div(l.i, r.i);
+        } else {
+            v.f = l.f / r.f;
+        }
+        break;
+    case IR_REM:
+        if (r.i == 0)
+            return 0;
+        v.i = int_rem(l.i, r.i);
+        break;
+    case IR_EQ:
+        v.i = cmp == 0;
+        break;
+    case IR_NE:
+        v.i = cmp != 0;
+        break;
+    case IR_LT:
+        v.i = cmp == -1;
+        break;
+    case IR_LE:
+        v.i = cmp == -1 || cmp == 0;
+        break;
+    case IR_GT:
+        v.i = cmp == 1;
+        break;
+    case IR_GE:
+        v.i = cmp == 1 || cmp == 0;
+        break;
+    default:
+        return 0;
+    }
+    memcpy(out, &v, sizeof *out);
+    return 1;
+}
+
+static void lower(struct sccp *s, uint32_t v, int state, uint64_t bits)
+{
+    if (state <= s->state[v])
+        return;
+    s->state[v] = (unsigned char) state;
+    s->bits[v] = bits;
+    s->work[s->work_count++] = v;
+}
+
+static void reach_edge(struct sccp *s, uint32_t block, uint32_t k)
+{
+    if (s->edges[block] & 1u << k)
+        return;
+    s->edges[block] |= (unsigned char) (1u << k);
+    s->flow[s->flow_count++] = block * 2 + k;
+}
+
+/* Whether the edge into `block` from its predecessor `index` is known to
+ * be taken. */
+static int edge_reached(const struct sccp *s, uint32_t block, uint32_t index)
+{
+    const struct ir_func *f = s->f;
+    uint32_t pred = f->blocks[block].preds[index];
+    uint32_t k = f->blocks[pred].succ[0] == block ? 0 : 1;
+
+    return s->edges[pred] >> k & 1;
+}
+
+static int truth(const struct sccp *s, uint32_t v)
+{
+    union value x;
+
+    memcpy(&x, &s->bits[v], sizeof x);
+    return s->f->type[v] == TYPE_FLOAT ? x.f != 0 : x.i != 0;
+}
+
+static void visit(struct sccp *s, uint32_t insn)
+{
+    struct ir_func *f = s->f;
+    uint32_t block = f->block[insn];
+    uint32_t k, n, v;
+    uint64_t bits = 0;
+    int state = TOP;
+
+    switch (f->op[insn]) {
+    case IR_CONST:
+        lower(s, insn, CONSTANT, ir_const_bits(f, insn));
+        return;
+    case IR_PHI:
+        for (k = 0; k < f->b[insn]; k++) {
+            if (!edge_reached(s, block, k))
+                continue;
+            v = f->args[f->a[insn] + k];
+            if (s->state[v] == BOTTOM ||
+                (s->state[v] == CONSTANT && state == CONSTANT &&
+                 s->bits[v] != bits)) {
+                state = BOTTOM;
+                break;
+            }
+            if (s->state[v] == CONSTANT) {
+                state = CONSTANT;
+                bits = s->bits[v];
+            }
+        }
+        lower(s, insn, state, bits);
+        return;
+    case IR_JMP:
+        reach_edge(s, block, 0);
+        return;
+    case IR_BR:
+        v = f->a[insn];
+        if (s->state[v] == BOTTOM) {
+            reach_edge(s, block, 0);
+            reach_edge(s, block, 1);
+        } else if (s->state[v] == CONSTANT) {
+            reach_edge(s, block, truth(s, v) ? 0 : 1);
+        }
+        return;
+    case IR_PRINT:
+    case IR_RET:
+        return;
+    default:
+        n = ir_op_arity[f->op[insn]];
+        state = CONSTANT;
+        for (k = 0; k < n; k++) {
+            v = k ? f->b[insn] : f->a[insn];
+            if (s->state[v] == BOTTOM)
+                state = BOTTOM;
+            else if (s->state[v] == TOP && state != BOTTOM)
+                state = TOP;
+        }
+        if (state == CONSTANT &&
+            !evaluate(f, insn, s->bits[f->a[insn]],
+                      n > 1 ? s->bits[f->b[insn]] : 0, &bits))
+            state = BOTTOM;
+        lower(s, insn, state, bits);
+        return;
+    }
+}
+
+static void visit_block(struct sccp *s, uint32_t block)
+{
+    struct ir_func *f = s->f;
+    uint32_t insn = f->blocks[block].first;
+
+    if (s->reached[block]) {
+        /* only its phis have anything new: an edge in */
+        for (; insn && f->op[insn] == IR_PHI; insn = f->next[insn])
+            visit(s, insn);
+        return;
+    }
+    s->reached[block] = 1;
+    for (; insn; insn = f->next[insn])
+        visit(s, insn);
+}
+
+static uint64_t sccp(struct ir_func *f)
+{
+    struct sccp s;
+    /* room for a constant for each value folded */
+    uint32_t *repl = xcalloc(2 * f->count, sizeof *repl);
+    uint32_t block, next, insn, k, taken;
+    uint64_t folded = 0;
+
+    s.f = f;
+    uses_build(f, &s.uses);
+    s.state = xcalloc(f->count, 1);
+    s.bits = xcalloc(f->count, sizeof *s.bits);
+    s.reached = xcalloc(f->block_count, 1);
+    s.edges = xcalloc(f->block_count, 1);
+    s.flow = xmalloc(2 * f->block_count * sizeof *s.flow);
+    s.flow_count = 0;
+    /* a value goes down twice at most */
+    s.work = xmalloc(2 * f->count * sizeof *s.work);
+    s.work_count = 0;
+
+    visit_block(&s, IR_ENTRY);
+    while (s.flow_count || s.work_count) {
+        if (s.flow_count) {
+            uint32_t edge = s.flow[--s.flow_count];
+
+            visit_block(&s, f->blocks[edge / 2].succ[edge % 2]);
+            continue;
+        }
+        insn = s.work[--s.work_count];
+        for (k = s.uses.start[insn]; k < s.uses.start[insn + 1]; k++) {
+            uint32_t user = s.uses.users[k];
+
+            if (s.reached[f->block[user]])
+                visit(&s, user);
+        }
+    }
+
+    /* constants for what is constant, jumps for branches that go one way */
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        struct ir_block *b = &f->blocks[block];
+
+        if (!s.reached[block])
+            continue;
+        for (insn = b->first; insn; insn = next) {
+            next = f->next[insn];
+            if (s.state[insn] == CONSTANT && f->op[insn] != IR_CONST &&
+                f->op[insn] < IR_PRINT) {
+                repl[insn] = ir_const(f, (enum type) f->type[insn],
+                                      s.bits[insn]);
+                ir_delete(f, insn);
+                folded++;
+            }
+        }
+        insn = b->last;
+        if (f->op[insn] == IR_BR && s.state[f->a[insn]] == CONSTANT) {
+            taken = truth(&s, f->a[insn]) ? 0 : 1;
+            ir_remove_pred(f, b->succ[!taken],
+                           ir_pred_index(f, b->succ[!taken], block));
+            b->succ[0] = b->succ[taken];
+            b->succ_count = 1;
+            f->op[insn] = IR_JMP;
+            f->a[insn] = IR_NONE;
+            folded++;
+        }
+    }
+    for (block = f->blocks[IR_ENTRY].next; block; block = next) {
+        next = f->blocks[block].next;
+        if (!s.reached[block])
+            ir_delete_block(f, block);
+    }
+    apply(f, repl);
+
+    uses_free(&s.uses);
+    free(s.work);
+    free(s.flow);
+    free(s.edges);
+    free(s.reached);
+    free(s.bits);
+    free(s.state);
+    free(repl);
+    return folded;
+}
+
+/* ---- copy propagation ---- */
+
+static uint64_t copyprop(struct ir_func *f)
+{
+    uint32_t *repl = xcalloc(f->count, sizeof *repl);
+    uint32_t block, insn, next, k, v, same;
+    uint64_t propagated = 0;
+    int changed = 1;
+
+    /* a phi may only turn out to be a copy once another has */
+    while (changed) {
+        changed = 0;
+        for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+            for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+                if (repl[insn])
+                    continue;
+                if (f->op[insn] == IR_COPY) {
+                    repl[insn] = f->a[insn];
+                    changed = 1;
+                    continue;
+                }
+                if (f->op[insn] != IR_PHI)
+                    continue;
+                same = IR_NONE;
+                for (k = 0; k < f->b[insn]; k++) {
+                    v = find(repl, f->args[f->a[insn] + k]);
+                    if (v == insn || v == same)
+                        continue;
+                    if (same) {
+                        same = IR_NONE;
+                        break;
+                    }
+                    same = v;
+                }
+                if (k == f->b[insn] && same) {
+                    repl[insn] = same;
+                    changed = 1;
+                }
+            }
+        }
+    }
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = next) {
+            next = f->next[insn];
+            if (repl[insn]) {
+                ir_delete(f, insn);
+                propagated++;
+            }
+        }
+    }
+    apply(f, repl);
+    free(repl);
+    return propagated;
+}
+
+/* ---- global value numbering ---- */
+
+static int commutative(const struct ir_func *f, uint32_t insn)
+{
+    switch (f->op[insn]) {
+    case IR_ADD:
+        return f->type[insn] != TYPE_STRING;
+    case IR_MUL:
+    case IR_EQ:
+    case IR_NE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* The order the operands of a commutative operation are put in, so that
+ * x + y and y + x are found the same: constants second, as the VM's
+ * superinstructions look for them, the rest by number. */
+static int operand_after(const struct ir_func *f, uint32_t x, uint32_t y)
+{
+    int cx = f->op[x] == IR_CONST, cy = f->op[y] == IR_CONST;
+
+    return cx != cy ? cx : x > y;
+}
+
+static uint32_t gvn_hash(const struct ir_func *f, uint32_t insn)
+{
+    uint32_t h = f->op[insn] * 31u + f->type[insn];
+
+    h = (h ^ f->a[insn]) * 0x9e3779b1u;
+    h = (h ^ f->b[insn]) * 0x9e3779b1u;
+    return h ^ h >> 16;
+}
+
+static int gvn_same(const struct ir_func *f, uint32_t x, uint32_t y)
+{
+    return f->op[x] == f->op[y] && f->type[x] == f->type[y] &&
+           f->a[x] == f->a[y] && f->b[x] == f->b[y];
+}
+
+static uint64_t gvn(struct ir_func *f)
+{
+    uint32_t *rpo = xmalloc(f->block_count * sizeof *rpo);
+    uint32_t *repl = xcalloc(f->count, sizeof *repl);
+    uint32_t *link = xmalloc(f->count * sizeof *link);
+    uint32_t *hash = xmalloc(f->count * sizeof *hash);
+    uint32_t *scope = xmalloc(f->count * sizeof *scope);
+    uint32_t *stack = xmalloc(f->block_count * sizeof *stack);
+    uint32_t *mark = xmalloc(f->block_count * sizeof *mark);
+    uint32_t *cursor = xmalloc(f->block_count * sizeof *cursor);
+    uint32_t size = 64, mask, *table;
+    uint32_t n, depth = 0, scope_count = 0, block, insn, next, k, x;
+    uint64_t merged = 0;
+    struct ir_dom dom;
+
+    while (size < f->count * 2)
+        size *= 2;
+    mask = size - 1;
+    table = xcalloc(size, sizeof *table);
+    n = ir_rpo(f, rpo);
+    ir_dominators(f, rpo, n, &dom);
+
+    /* down the dominator tree: what a block finds in the table was
+     * computed in a block that dominates it, and is taken out again on
+     * the way back up */
+    stack[depth] = IR_ENTRY;
+    cursor[depth] = 0;
+    mark[depth++] = scope_count;
+    for (block = IR_ENTRY; block;) {
+        for (insn = f->blocks[block].first; insn; insn = next) {
+            next = f->next[insn];
+            if (f->op[insn] == IR_PHI || f->op[insn] >= IR_PRINT ||
+                f->op[insn] == IR_COPY) {
+                if (f->op[insn] != IR_PHI) {
+                    for (k = 0; k < ir_op_arity[f->op[insn]]; k++) {
+                        uint32_t *op = ir_operand(f, insn, k);
+
+                        *op = find(repl, *op);
+                    }
+                }
+                continue;
+            }
+            if (f->op[insn] != IR_CONST) {
+                f->a[insn] = find(repl, f->a[insn]);
+                if (ir_op_arity[f->op[insn]] > 1)
+                    f->b[insn] = find(repl, f->b[insn]);
+                if (commutative(f, insn) && operand_after(f, f->a[insn],
+                                                          f->b[insn])) {
+                    x = f->a[insn];
+                    f->a[insn] = f->b[insn];
+                    f->b[insn] = x;
+                }
+            }
+            hash[insn] = gvn_hash(f, insn) & mask;
+            for (x = table[hash[insn]]; x; x = link[x])
+                if (gvn_same(f, x, insn))
+                    break;
+            if (x) {
+                repl[insn] = x;
+                ir_delete(f, insn);
+                merged++;
+                continue;
+            }
+            link[insn] = table[hash[insn]];
+            table[hash[insn]] = insn;
+            scope[scope_count++] = insn;
+        }
+        cursor[depth - 1] = dom.child[block];
+
+        /* the next block: the next child of the deepest block that has
+         * one left, leaving the scopes of those that have none */
+        block = IR_NONE;
+        while (depth) {
+            uint32_t child = cursor[depth - 1];
+
+            if (child) {
+                cursor[depth - 1] = dom.sibling[child];
+                stack[depth] = child;
+                cursor[depth] = 0;
+                mark[depth++] = scope_count;
+                block = child;
+                break;
+            }
+            depth--;
+            while (scope_count > mark[depth]) {
+                x = scope[--scope_count];
+                table[hash[x]] = link[x];
+            }
+        }
+    }
+    apply(f, repl);
+
+    ir_dom_free(&dom);
+    free(table);
+    free(cursor);
+    free(mark);
+    free(stack);
+    free(scope);
+    free(hash);
+    free(link);
+    free(repl);
+    free(rpo);
+    return merged;
+}
+
+/* ---- loops ---- */
+
+/* The natural loops of a frame, each a header and the blocks from which
+ * it can be reached again without leaving through it.  of[] is the
+ * innermost loop of each block, 0 for none; loops are numbered from 1,
+ * outer loops before those they contain.  The blocks are in rpo[], in
+ * reverse postorder, with the preheader of each loop just before its
+ * header. */
+struct loops {
+    uint32_t count;
+    uint32_t *header;
+    uint32_t *parent;
+    uint32_t *pre;          /* IR_NONE where none could be made */
+    uint32_t *of;
+    uint32_t *rpo;
+    uint32_t rpo_count;
+};
+
+static int in_loop(const struct loops *l, uint32_t loop, uint32_t block)
+{
+    uint32_t x;
+
+    for (x = l->of[block]; x; x = l->parent[x])
+        if (x == loop)
+            return 1;
+    return 0;
+}
+
+/* The block before a loop, which jumps to its header and to nothing
+ * else; made if there is none but one edge comes in from outside.  A
+ * header that more than one does is left without, as nothing the tree
+ * makes comes to. */
+static uint32_t preheader(struct ir_func *f, struct loops *l, uint32_t loop)
+{
+    uint32_t h = l->header[loop];
+    struct ir_block *hb = &f->blocks[h];
+    uint32_t k, outside = IR_NONE, count = 0, p, i;
+
+    for (k = 0; k < hb->pred_count; k++) {
+        if (!in_loop(l, loop, hb->preds[k])) {
+            outside = hb->preds[k];
+            count++;
+        }
+    }
+    if (count != 1)
+        return IR_NONE;
+    if (f->blocks[outside].succ_count == 1)
+        return outside;
+    p = ir_split_edge(f, outside, h);
+    l->of[p] = l->parent[loop];
+    for (i = 0; l->rpo[i] != h; i++)
+        ;
+    memmove(l->rpo + i + 1, l->rpo + i,
+            (l->rpo_count - i) * sizeof *l->rpo);
+    l->rpo[i] = p;
+    l->rpo_count++;
+    return p;
+}
+
+static uint32_t *push(uint32_t *array, size_t *capacity, size_t at,
+                       uint32_t value)
+{
+    if (at == *capacity) {
+        *capacity *= 2;
+        array = xrealloc(array, *capacity * sizeof *array);
+    }
+    array[at] = value;
+    return array;
+}
+
+static void loops_find(struct ir_func *f, struct loops *l)
+{
+    uint32_t blocks = f->block_count;
+    uint32_t *loop_of = xcalloc(blocks, sizeof *loop_of);
+    uint32_t *size, *start, *body, *order, *work;
+    uint32_t i, k, n, count = 0, body_count = 0, work_count, h, b;
+    size_t body_capacity;
+    struct ir_dom dom;
+
+    /* room for a preheader for every header */
+    l->rpo = xmalloc(2 * blocks * sizeof *l->rpo);
+    n = ir_rpo(f, l->rpo);
+    l->rpo_count = n;
+    ir_dominators(f, l->rpo, n, &dom);
+
+    /* a header is a block some edge goes back to, from a block it
+     * dominates; loop_of[] numbers them */
+    for (i = 0; i < n; i++) {
+        const struct ir_block *blk = &f->blocks[l->rpo[i]];
+
+        for (k = 0; k < blk->succ_count; k++) {
+            h = blk->succ[k];
+            if (ir_dominates(&dom, h, l->rpo[i]) && !loop_of[h])
+                loop_of[h] = ++count;
+        }
+    }
+    l->count = count;
+    l->header = xcalloc(count + 1, sizeof *l->header);
+    l->parent = xcalloc(count + 1, sizeof *l->parent);
+    l->pre = xcalloc(count + 1, sizeof *l->pre);
+    l->of = xcalloc(2 * blocks, sizeof *l->of);
+    size = xcalloc(count + 1, sizeof *size);
+    start = xcalloc(count + 2, sizeof *start);
+    body_capacity = n;
+    body = xmalloc(body_capacity * sizeof *body);
+    order = xmalloc((count + 1) * sizeof *order);
+    work = xmalloc(n * sizeof *work);
+    memset(loop_of, 0, blocks * sizeof *loop_of);
+
+    /* each body, walking back from the edges to the header */
+    for (i = 0; i < n && count; i++) {
+        h = l->rpo[i];
+        for (k = 0; k < f->blocks[h].pred_count; k++)
+            if (ir_dominates(&dom, h, f->blocks[h].preds[k]))
+                break;
+        if (k == f->blocks[h].pred_count)
+            continue;
+        l->header[++body_count] = h;
+        start[body_count] = body_count > 1 ?
+            start[body_count - 1] + size[body_count - 1] : 0;
+        body = push(body, &body_capacity,
+                    start[body_count] + size[body_count]++, h);
+        loop_of[h] = body_count;
+        work_count = 0;
+        for (k = 0; k < f->blocks[h].pred_count; k++) {
+            b = f->blocks[h].preds[k];
+            if (ir_dominates(&dom, h, b) && loop_of[b] != body_count) {
+                loop_of[b] = body_count;
+                work[work_count++] = b;
+            }
+        }
+        while (work_count) {
+            b = work[--work_count];
+            body = push(body, &body_capacity,
+                        start[body_count] + size[body_count]++, b);
+            for (k = 0; k < f->blocks[b].pred_count; k++) {
+                uint32_t p = f->blocks[b].preds[k];
+
+                if (dom.pre[p] && loop_of[p] != body_count) {
+                    loop_of[p] = body_count;
+                    work[work_count++] = p;
+                }
+            }
+        }
+    }
+
+    /* outer loops first: a loop's header is in the loops around it, which
+     * are bigger, so of[] ends up the innermost */
+    for (i = 1; i <= count; i++)
+        order[i] = i;
+    for (i = 2; i <= count; i++) {
+        uint32_t x = order[i];
+
+        for (k = i; k > 1 && size[order[k - 1]] < size[x]; k--)
+            order[k] = order[k - 1];
+        order[k] = x;
+    }
+    for (i = 1; i <= count; i++) {
+        uint32_t x = order[i];
+
+        l->parent[i] = l->of[l->header[x]];
+        for (k = 0; k < size[x]; k++)
+            l->of[body[start[x] + k]] = i;
+    }
+    /* renumber the headers in that order */
+    for (i = 1; i <= count; i++)
+        work[i - 1] = l->header[order[i]];
+    for (i = 1; i <= count; i++)
+        l->header[i] = work[i - 1];
+    for (i = 1; i <= count; i++)
+        l->pre[i] = preheader(f, l, i);
+
+    ir_dom_free(&dom);
+    free(work);
+    free(order);
+    free(body);
+    free(start);
+    free(size);
+    free(loop_of);
+}
+
+static void loops_free(struct loops *l)
+{
+    free(l->header);
+    free(l->parent);
+    free(l->pre);
+    free(l->of);
+    free(l->rpo);
+}
+
+/* ---- loop-invariant code motion ---- */
+
+static uint64_t licm(struct ir_func *f)
+{
+    struct loops l;
+    uint32_t loop, i, insn, next, k, n, to;
+    uint64_t hoisted = 0;
+
+    loops_find(f, &l);
+    /* inner loops first, so what leaves one can leave the next one out */
+    for (loop = l.count; loop >= 1; loop--) {
+        if (!l.pre[loop])
+            continue;
+        to = ir_terminator(f, l.pre[loop]);
+        for (i = 0; i < l.rpo_count; i++) {
+            if (!in_loop(&l, loop, l.rpo[i]))
+                continue;
+            for (insn = f->blocks[l.rpo[i]].first; insn; insn = next) {
+                next = f->next[insn];
+                if (f->op[insn] == IR_CONST || !ir_is_pure(f, insn))
+                    continue;
+                n = ir_operand_count(f, insn);
+                for (k = 0; k < n; k++)
+                    if (in_loop(&l, loop, f->block[*ir_operand(f, insn, k)]))
+                        break;
+                if (k < n)
+                    continue;
+                ir_unlink(f, insn);
+                ir_insert_before(f, to, insn);
+                hoisted++;
+            }
+        }
+    }
+    loops_free(&l);
+    return hoisted;
+}
+
+/* ---- strength reduction ---- */
+
+/* What `v` is now: a multiply sr has replaced, its replacement.  Only
+ * the values there were when it started, those below n, are replaced. */
+static uint32_t resolve(const uint32_t *repl, uint32_t n, uint32_t v)
+{
+    while (v < n && repl[v])
+        v = repl[v];
+    return v;
+}
+
+/* The operand of a two-operand instruction that is not `v`, or IR_NONE if
+ * neither is. */
+static uint32_t other(const struct ir_func *f, const uint32_t *repl,
+                      uint32_t n, uint32_t insn, uint32_t v)
+{
+    uint32_t a = resolve(repl, n, f->a[insn]);
+    uint32_t b = resolve(repl, n, f->b[insn]);
+
+    if (a == v)
+        return b;
+    if (b == v)
+        return a;
+    return IR_NONE;
+}
+
+/* x * y, for the block before a loop: by 0 and by 1 take nothing, and
+ * two constants are folded. */
+static uint32_t product(struct ir_func *f, uint32_t pre, uint32_t x,
+                        uint32_t y)
+{
+    uint32_t insn;
+
+    if (f->op[x] == IR_CONST && ir_const_bits(f, x) <= 1)
+        return ir_const_bits(f, x) ? y : x;
+    if (f->op[y] == IR_CONST && ir_const_bits(f, y) <= 1)
+        return ir_const_bits(f, y) ? x : y;
+    if (f->op[x] == IR_CONST && f->op[y] == IR_CONST)
+        return ir_const(f, TYPE_INT, (uint64_t) int_mul(
+            (int64_t) ir_const_bits(f, x), (int64_t) ir_const_bits(f, y)));
+    insn = ir_new(f, IR_MUL, TYPE_INT, x, y, 0);
+    ir_insert_before(f, ir_terminator(f, pre), insn);
+    return insn;
+}
+
+static uint64_t sr(struct ir_func *f)
+{
+    struct loops l;
+    uint32_t n = f->count, *repl = xcalloc(n, sizeof *repl), *all;
+    uint32_t loop, h, pre, in, back, iv, init, step, next, i, insn, after;
+    uint32_t c, m0, d, psi, psi_next, args;
+    uint64_t reduced = 0;
+
+    loops_find(f, &l);
+    /* outer loops first: what an inner one is given from outside may be
+     * a multiply the outer one replaced, which resolve() follows */
+    for (loop = 1; loop <= l.count; loop++) {
+        h = l.header[loop];
+        pre = l.pre[loop];
+        if (!pre || f->blocks[h].pred_count != 2)
+            continue;
+        in = ir_pred_index(f, h, pre);
+        back = !in;
+        /* each basic induction variable: a phi that goes from init to
+         * itself plus a step that is the same all through the loop */
+        for (iv = f->blocks[h].first; iv && f->op[iv] == IR_PHI;
+             iv = f->next[iv]) {
+            if (f->type[iv] != TYPE_INT)
+                continue;
+            init = resolve(repl, n, f->args[f->a[iv] + in]);
+            next = resolve(repl, n, f->args[f->a[iv] + back]);
+            if (f->op[next] != IR_ADD)
+                continue;
+            step = other(f, repl, n, next, iv);
+            if (!step || in_loop(&l, loop, f->block[step]))
+                continue;
+            /* and each iv * c in the loop, with c the same all through */
+            for (i = 0; i < l.rpo_count; i++) {
+                if (!in_loop(&l, loop, l.rpo[i]))
+                    continue;
+                for (insn = f->blocks[l.rpo[i]].first; insn; insn = after) {
+                    after = f->next[insn];
+                    if (f->op[insn] != IR_MUL || f->type[insn] != TYPE_INT)
+                        continue;
+                    c = other(f, repl, n, insn, iv);
+                    if (!c || in_loop(&l, loop, f->block[c]))
+                        continue;
+                    m0 = product(f, pre, init, c);
+                    d = product(f, pre, step, c);
+                    psi = ir_new_phi(f, h, TYPE_INT);
+                    args = f->a[psi];
+                    /* before the step, which the VM may fuse with the
+                     * test after it */
+                    psi_next = ir_new(f, IR_ADD, TYPE_INT, psi, d, 0);
+                    ir_insert_before(f, next, psi_next);
+                    f->args[args + in] = m0;
+                    f->args[args + back] = psi_next;
+                    repl[insn] = psi;
+                    ir_delete(f, insn);
+                    reduced++;
+                }
+            }
+        }
+    }
+    all = xcalloc(f->count, sizeof *all);
+    memcpy(all, repl, n * sizeof *all);
+    apply(f, all);
+    loops_free(&l);
+    free(all);
+    free(repl);
+    return reduced;
+}
+
+/* ---- dead code elimination ---- */
+
+static uint64_t dce(struct ir_func *f)
+{
+    unsigned char *live = xcalloc(f->count, 1);
+    uint32_t *work = xmalloc(f->count * sizeof *work);
+    uint32_t work_count = 0, block, insn, next, k, n, v;
+    uint64_t removed = 0;
+
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            if (f->op[insn] >= IR_PRINT || ir_may_fail(f, insn)) {
+                live[insn] = 1;
+                work[work_count++] = insn;
+            }
+        }
+    }
+    while (work_count) {
+        insn = work[--work_count];
+        n = ir_operand_count(f, insn);
+        for (k = 0; k < n; k++) {
+            v = *ir_operand(f, insn, k);
+            if (!live[v]) {
+                live[v] = 1;
+                work[work_count++] = v;
+            }
+        }
+    }
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = next) {
+            next = f->next[insn];
+            if (!live[insn]) {
+                ir_delete(f, insn);
+                removed++;
+            }
+        }
+    }
+    free(work);
+    free(live);
+    return removed;
+}
+
+/* ---- the pipeline ---- */
+
+static uint64_t (*const passes[PASS_COUNT])(struct ir_func *) = {
+    sccp, copyprop, gvn, licm, sr, dce
+};
+
+void pipeline_default(struct pipeline *p)
+{
+    unsigned i;
+
+    for (i = 0; i < PASS_COUNT; i++)
+        p->passes[i] = (unsigned char) i;
+    p->count = PASS_COUNT;
+}
+
+int pipeline_parse(const char *list, struct pipeline *p)
+{
+    const char *end;
+    size_t len;
+    unsigned i;
+
+    p->count = 0;
+    if (!*list)
+        return 0;
+    for (;;) {
+        end = strchr(list, ',');
+        len = end ? (size_t) (end - list) : strlen(list);
+        for (i = 0; i < PASS_COUNT; i++)
+            if (strlen(pass_names[i]) == len &&
+                !memcmp(pass_names[i], list, len))
+                break;
+        if (i == PASS_COUNT || p->count == PIPELINE_MAX)
+            return -1;
+        p->passes[p->count++] = (unsigned char) i;
+        if (!end)
+            return 0;
+        list = end + 1;
+    }
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void optimize(struct ir_program *ir, const struct pipeline *p,
+              struct opt_stats *stats)
+{
+    unsigned i;
+    uint32_t k;
+    double start;
+
+    for (i = 0; i < p->count; i++) {
+        enum pass pass = (enum pass) p->passes[i];
+        uint64_t changes = 0;
+
+        start = now();
+        if (stats)
+            stats->before[pass] += ir_program_size(ir);
+        for (k = 0; k < ir->count; k++) {
+            changes += passes[pass](&ir->funcs[k]);
+#ifdef IR_VERIFY
+            ir_verify(&ir->funcs[k]);
+#endif
+        }
+        if (stats) {
+            stats->after[pass] += ir_program_size(ir);
+            stats->changes[pass] += changes;
+            stats->seconds[pass] += now() - start;
+            stats->runs[pass]++;
+        }
+    }
+}
+
+void opt_stats_print(FILE *out, const struct opt_stats *stats)
+{
+    unsigned i;
+
+    for (i = 0; i < PASS_COUNT; i++) {
+        if (!stats->runs[i])
+            continue;
+        fprintf(out, "minilang: pass: name=%s runs=%u seconds=%.6f "
+                "insns_before=%llu insns_after=%llu %s=%llu\n",
+                pass_names[i], stats->runs[i], stats->seconds[i],
+                (unsigned long long) stats->before[i],
+                (unsigned long long) stats->after[i], pass_counts[i],
+                (unsigned long long) stats->changes[i]);
+    }
+}
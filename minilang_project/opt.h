@@ -0,0 +1,91 @@
+#ifndef MINILANG_OPT_H
+#define MINILANG_OPT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ir.h"
+
+/* The optimizer: passes over the IR (ir.h), each a function of one frame
+ * to itself, run in the order a pipeline lists them.  The default is
+ * every pass once, in this order:
+ *
+ *   sccp       sparse conditional constant propagation (Wegman and
+ *              Zadeck): values that are constant, even along paths where
+ *              a branch can only go one way, become constants; branches
+ *              on constants become jumps, and blocks nothing reaches any
+ *              more are deleted
+ *   copyprop   uses of a copy, or of a phi that picks the same value
+ *              through every edge, use that value instead
+ *   gvn        global value numbering, over the dominator tree: a pure
+ *              computation that one before it which dominates it already
+ *              made is replaced by that one
+ *   licm       loop-invariant code motion: a pure computation in a loop
+ *              whose operands are all from outside it moves to the block
+ *              before the loop, which is made if there is none
+ *   sr         strength reduction: i * c, for an induction variable i
+ *              that goes up by a step s that does not change in the loop
+ *              and a c that does not either, becomes a variable of its own
+ *              that goes up by s * c, an add in place of a multiply
+ *   dce        dead code elimination: what no print, branch or possible
+ *              runtime error needs is deleted, phis in loops included
+ *
+ * Each pass does one thing and leaves the rest to the others: sr leaves
+ * the multiply it replaced for dce, and licm leaves constant operands
+ * where they are, since they are already outside every loop.  The IR
+ * each leaves has the same behaviour, runtime errors included: nothing
+ * that can fail is deleted, moved or made to fail earlier. */
+#define OPT_PASSES(X) \
+    X(SCCP,     "sccp",     "folded") \
+    X(COPYPROP, "copyprop", "propagated") \
+    X(GVN,      "gvn",      "merged") \
+    X(LICM,     "licm",     "hoisted") \
+    X(SR,       "sr",       "reduced") \
+    X(DCE,      "dce",      "removed")
+
+enum pass {
+#define OPT_PASS_ENUM(name, text, counts) PASS_##name,
+    OPT_PASSES(OPT_PASS_ENUM)
+#undef OPT_PASS_ENUM
+    PASS_COUNT
+};
+
+#define PIPELINE_MAX    32
+
+struct pipeline {
+    unsigned char passes[PIPELINE_MAX];     /* enum pass */
+    unsigned count;
+};
+
+/* What each pass did, over all the frames and all the times it ran:
+ * the instructions before and after it, the time it took and the count
+ * it reports, in the unit the table above names. */
+struct opt_stats {
+    unsigned runs[PASS_COUNT];
+    uint64_t before[PASS_COUNT];
+    uint64_t after[PASS_COUNT];
+    uint64_t changes[PASS_COUNT];
+    double seconds[PASS_COUNT];
+};
+
+extern const char *const pass_names[PASS_COUNT];
+
+void pipeline_default(struct pipeline *p);
+
+/* A pipeline from a list of pass names separated by commas, as for
+ * --passes=; an empty list is no passes.  Returns 0, or -1 for a name
+ * that is no pass or a list that is too long. */
+int pipeline_parse(const char *list, struct pipeline *p);
+
+/* Run the passes over every frame of the program, adding to `stats`
+ * unless it is NULL. */
+void optimize(struct ir_program *ir, const struct pipeline *p,
+              struct opt_stats *stats);
+
+/* One line per pass that ran, of key=value pairs like --stats:
+ *
+ *   minilang: pass: name=sccp runs=1 seconds=... insns_before=...
+ *   insns_after=... folded=... */
+void opt_stats_print(FILE *out, const struct opt_stats *stats);
+
+#endif
@@ -0,0 +1,251 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfalex.h"
+#include "parlex.h"
+
+/* Smaller chunks are not worth a thread. */
+#define MIN_CHUNK       (1u << 20)
+
+/* Upper bound on chunks, which also bounds the per-call thread arrays. */
+#define MAX_CHUNKS      256
+
+/* Bytes re-lexed per step while looking for the speculative stream. */
+#define STITCH_WINDOW   4096
+
+struct chunk {
+    size_t start;                   /* speculative entry point */
+    size_t stop;                    /* tokens starting before this are ours */
+    size_t end;                     /* where the speculative lex stopped */
+    struct token_buffer tokens;     /* speculative tokens */
+    struct token_buffer fixup;      /* re-lexed prefix that replaces ... */
+    size_t first;                   /* ... tokens[0, first) */
+    size_t fixup_numbers;           /* numbers of the kept fixup tokens */
+    size_t first_number;            /* first number of tokens[first, ) */
+    size_t out_index;               /* where fixup goes in the output */
+    size_t out_number;              /* and where its numbers go */
+};
+
+struct parlex {
+    const char *src;
+    size_t len;
+    struct chunk *chunks;
+    struct token_buffer *out;
+};
+
+struct worker {
+    struct parlex *par;
+    size_t index;
+};
+
+static void *lex_chunk(void *arg)
+{
+    struct worker *w = arg;
+    struct chunk *c = &w->par->chunks[w->index];
+
+    c->end = dfa_lex_range(w->par->src, w->par->len, c->start, c->stop,
+                           &c->tokens);
+    return NULL;
+}
+
+/* Move a chunk's surviving tokens and number values into place, rebasing
+ * number tokens onto the output's number array. */
+static void *copy_chunk(void *arg)
+{
+    struct worker *w = arg;
+    struct chunk *c = &w->par->chunks[w->index];
+    struct token_buffer *out = w->par->out;
+    struct token *dst = out->data + c->out_index;
+    size_t spec_count = c->tokens.count - c->first;
+    size_t spec_numbers = c->tokens.number_count - c->first_number;
+    size_t i;
+
+    if (c->fixup.count)
+        memcpy(dst, c->fixup.data, c->fixup.count * sizeof *dst);
+    if (spec_count)
+        memcpy(dst + c->fixup.count, c->tokens.data + c->first,
+               spec_count * sizeof *dst);
+    if (c->fixup_numbers == 0 && spec_numbers == 0)
+        return NULL;
+
+    if (c->fixup_numbers)
+        memcpy(out->numbers + c->out_number, c->fixup.numbers,
+               c->fixup_numbers * sizeof *out->numbers);
+    if (spec_numbers)
+        memcpy(out->numbers + c->out_number + c->fixup_numbers,
+               c->tokens.numbers + c->first_number,
+               spec_numbers * sizeof *out->numbers);
+    for (i = 0; i < c->fixup.count; i++) {
+        if (dst[i].kind == TOKEN_NUMBER)
+            dst[i].value += (uint32_t) c->out_number;
+    }
+    for (dst += c->fixup.count, i = 0; i < spec_count; i++) {
+        if (dst[i].kind == TOKEN_NUMBER)
+            dst[i].value = (uint32_t) (dst[i].value - c->first_number +
+                                       c->out_number + c->fixup_numbers);
+    }
+    return NULL;
+}
+
+/* Run fn over every chunk, one thread each.  If a thread cannot be
+ * started its chunk is done on the calling thread instead. */
+static void run_all(struct parlex *par, size_t nchunks,
+                    void *(*fn)(void *))
+{
+    struct worker workers[MAX_CHUNKS];
+    pthread_t threads[MAX_CHUNKS];
+    int started[MAX_CHUNKS];
+    size_t i;
+
+    for (i = 0; i < nchunks; i++) {
+        workers[i].par = par;
+        workers[i].index = i;
+        started[i] = i > 0 &&
+                     pthread_create(&threads[i], NULL, fn, &workers[i]) == 0;
+    }
+    for (i = 0; i < nchunks; i++) {
+        if (!started[i])
+            fn(&workers[i]);
+    }
+    for (i = 0; i < nchunks; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    }
+}
+
+/* Index of the speculative token at offset, or tokens->count. */
+static size_t find_token(const struct token_buffer *tokens, uint32_t offset)
+{
+    size_t lo = 0, hi = tokens->count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (tokens->data[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < tokens->count && tokens->data[lo].offset == offset ?
+           lo : tokens->count;
+}
+
+/* The serial lexer reaches chunk c at entry.  Re-lex from there until a
+ * token matches one of the speculative ones: both lexers then sit at the
+ * same token boundary and agree from there on.  Returns the offset at
+ * which the serial lexer leaves the chunk. */
+static size_t stitch(struct parlex *par, struct chunk *c, size_t entry)
+{
+    size_t window = STITCH_WINDOW;
+    size_t pos = entry;
+
+    if (entry == c->start)
+        return c->end;
+
+    while (pos < c->stop) {
+        size_t limit = c->stop - pos > window ? pos + window : c->stop;
+        size_t i = c->fixup.count;
+
+        pos = dfa_lex_range(par->src, par->len, pos, limit, &c->fixup);
+        for (; i < c->fixup.count; i++) {
+            const struct token *tok = &c->fixup.data[i];
+            size_t j = find_token(&c->tokens, tok->offset);
+
+            if (j < c->tokens.count && c->tokens.data[j].kind == tok->kind &&
+                c->tokens.data[j].length == tok->length) {
+                c->fixup.count = i + 1;
+                c->first = j + 1;
+                return c->end;
+            }
+        }
+        window *= 2;
+    }
+    /* never resynchronised: the re-lexed tokens are the whole chunk */
+    c->first = c->tokens.count;
+    return pos;
+}
+
+void dfa_lex_parallel(const char *src, size_t len, long nthreads,
+                      struct token_buffer *out)
+{
+    struct parlex par;
+    size_t nchunks = len / MIN_CHUNK;
+    size_t entry = 0;
+    size_t total = 0;
+    size_t total_numbers = 0;
+    size_t i;
+
+    if (nthreads < (long) nchunks)
+        nchunks = (size_t) nthreads;
+    if (nchunks > MAX_CHUNKS)
+        nchunks = MAX_CHUNKS;
+    if (nchunks < 2) {
+        dfa_lex(src, len, out);
+        return;
+    }
+
+    par.src = src;
+    par.len = len;
+    par.out = out;
+    par.chunks = calloc(nchunks, sizeof *par.chunks);
+    if (!par.chunks) {
+        fprintf(stderr, "minilang: out of memory for chunks\n");
+        exit(1);
+    }
+
+    /* Cut just after a newline when the chunk has one. */
+    for (i = 0; i < nchunks; i++) {
+        struct chunk *c = &par.chunks[i];
+        size_t cut = len / nchunks * i;
+        size_t next = len / nchunks * (i + 1);
+
+        if (i > 0) {
+            const char *nl = memchr(src + cut, '\n', next - cut);
+
+            if (nl)
+                cut = (size_t) (nl - src) + 1;
+        }
+        c->start = cut;
+        if (i > 0)
+            par.chunks[i - 1].stop = cut;
+        token_buffer_init(&c->tokens);
+        token_buffer_init(&c->fixup);
+    }
+    par.chunks[nchunks - 1].stop = len;
+
+    run_all(&par, nchunks, lex_chunk);
+
+    for (i = 0; i < nchunks; i++) {
+        struct chunk *c = &par.chunks[i];
+
+        entry = stitch(&par, c, entry);
+        if (c->fixup.count)
+            c->fixup_numbers = token_buffer_numbers_before(
+                &c->fixup, c->fixup.data[c->fixup.count - 1].offset + 1);
+        c->first_number = c->first < c->tokens.count ?
+            token_buffer_numbers_before(&c->tokens,
+                                        c->tokens.data[c->first].offset) :
+            c->tokens.number_count;
+        c->out_index = out->count + total;
+        c->out_number = out->number_count + total_numbers;
+        total += c->fixup.count + c->tokens.count - c->first;
+        total_numbers += c->fixup_numbers + c->tokens.number_count -
+                         c->first_number;
+    }
+
+    if (total) {
+        token_buffer_reserve(out, out->count + total);
+        token_buffer_reserve_numbers(out, out->number_count + total_numbers);
+        run_all(&par, nchunks, copy_chunk);
+    }
+    out->count += total;
+    out->number_count += total_numbers;
+
+    for (i = 0; i < nchunks; i++) {
+        token_buffer_free(&par.chunks[i].tokens);
+        token_buffer_free(&par.chunks[i].fixup);
+    }
+    free(par.chunks);
+}
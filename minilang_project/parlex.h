@@ -0,0 +1,20 @@
+#ifndef MINILANG_PARLEX_H
+#define MINILANG_PARLEX_H
+
+#include <stddef.h>
+
+#include "token.h"
+
+/* Lex one large in-memory source on up to nthreads threads.
+ *
+ * The source is cut into chunks that start just after a newline, and each
+ * chunk is lexed speculatively as if a token started there.  Strings never
+ * span a newline, so the only way a guess can be wrong is a block comment
+ * (or a token run) crossing the cut; a sequential stitching pass re-lexes
+ * from the true entry point until it reproduces one of the chunk's tokens,
+ * after which the two agree.  The result is exactly what dfa_lex()
+ * produces.  Small sources are lexed on the calling thread. */
+void dfa_lex_parallel(const char *src, size_t len, long nthreads,
+                      struct token_buffer *out);
+
+#endif
@@ -0,0 +1,549 @@
+#include "diag.h"
+#include "parse.h"
+
+/* How deep statements and parentheses may nest before the parser gives
+ * up on the statement rather than on its stack. */
+#define PARSE_MAX_DEPTH 1000
+
+/* peek() at the end of the tokens; no token kind is 0 */
+#define TOKEN_EOF       0
+
+struct parser {
+    const struct token *tokens;     /* buf's, as of the last call to more */
+    size_t count;
+    struct token_buffer *buf;
+    parse_more_fn *more;            /* NULL once the tokens are all in */
+    void *more_arg;
+    size_t pos;
+    uint32_t len;
+    struct ast *ast;
+    int depth;
+    int height;         /* of the expression last parsed, in nodes */
+    int panic;          /* reported an error and not yet back in step */
+    int too_deep;       /* reported nesting too deep in this top-level item */
+};
+
+/* Binding power of each binary operator, 0 for tokens that are not. */
+static const unsigned char binding_power[TOKEN_KIND_COUNT] = {
+    [TOKEN_EQ] = 1, [TOKEN_NEQ] = 1,
+    [TOKEN_LT] = 2, [TOKEN_LTE] = 2, [TOKEN_GT] = 2, [TOKEN_GTE] = 2,
+    [TOKEN_PLUS] = 3, [TOKEN_MINUS] = 3,
+    [TOKEN_MUL] = 4, [TOKEN_DIV] = 4,
+};
+
+#define PREFIX_POWER    5
+
+static uint32_t statement(struct parser *p);
+static uint32_t expression(struct parser *p, unsigned min_power);
+
+/* Whether there is a token `ahead` past the current one, waiting for
+ * more while they are still arriving.  Only called at the end of the
+ * tokens so far, so the common case costs one comparison. */
+static int fill(struct parser *p, size_t ahead)
+{
+    while (p->pos + ahead >= p->count) {
+        if (!p->more || !p->more(p->more_arg)) {
+            p->more = NULL;
+            return 0;
+        }
+        p->tokens = p->buf->data;
+        p->count = p->buf->count;
+    }
+    return 1;
+}
+
+static enum token_kind peek(struct parser *p)
+{
+    return p->pos < p->count || fill(p, 0)
+           ? (enum token_kind) p->tokens[p->pos].kind : TOKEN_EOF;
+}
+
+/* Index of the current token, moving past it and any unknown ones after
+ * it. */
+static uint32_t advance(struct parser *p)
+{
+    size_t pos = p->pos++;
+
+    while ((p->pos < p->count || fill(p, 0)) &&
+           p->tokens[p->pos].kind == TOKEN_UNKNOWN)
+        p->pos++;
+    return (uint32_t) pos;
+}
+
+static uint32_t new_node(struct parser *p, enum ast_kind kind,
+                         uint32_t token)
+{
+    return ast_add(p->ast, kind, token);
+}
+
+/* Links are set through these rather than by assigning to the arrays
+ * directly, so that the arrays are not read before a call that may grow
+ * them. */
+static void set_child(struct parser *p, uint32_t node, uint32_t child)
+{
+    p->ast->child[node] = child;
+}
+
+static void set_next(struct parser *p, uint32_t node, uint32_t next)
+{
+    p->ast->next[node] = next;
+}
+
+/* A node with the given children, in order. */
+static uint32_t node2(struct parser *p, enum ast_kind kind, uint32_t token,
+                      uint32_t a, uint32_t b)
+{
+    uint32_t node = new_node(p, kind, token);
+
+    set_child(p, node, a);
+    set_next(p, a, b);
+    return node;
+}
+
+static uint32_t empty(struct parser *p)
+{
+    return new_node(p, AST_EMPTY, (uint32_t) p->pos);
+}
+
+/* Offset of the current token, for errors. */
+static uint32_t here(struct parser *p)
+{
+    return p->pos < p->count || fill(p, 0) ? p->tokens[p->pos].offset
+                                           : p->len;
+}
+
+/* Errors are reported unless one is already being recovered from. */
+static void error_at(struct parser *p, uint32_t offset, const char *message)
+{
+    if (!p->panic) {
+        diag_error(offset, "%s", message);
+        p->panic = 1;
+    }
+}
+
+static void expected(struct parser *p, const char *what)
+{
+    if (!p->panic) {
+        diag_error(here(p), "expected %s", what);
+        p->panic = 1;
+    }
+}
+
+/* Past PARSE_MAX_DEPTH: give up on what starts here, skipping it to the
+ * ';', ')' or '}' that ends it, brackets and all, so that the levels
+ * above find their own closing tokens.  Reported once per top-level
+ * item, however many levels run into the limit on the way out. */
+static uint32_t nested_too_deeply(struct parser *p)
+{
+    uint32_t node;
+    size_t level = 0;
+
+    p->depth--;
+    if (!p->too_deep) {
+        error_at(p, here(p), "nested too deeply");
+        p->too_deep = 1;
+    }
+    node = empty(p);
+    for (;;) {
+        switch ((int) peek(p)) {
+        case TOKEN_EOF:
+            return node;
+        case TOKEN_LPAREN:
+        case TOKEN_LBRACE:
+            level++;
+            break;
+        case TOKEN_RPAREN:
+        case TOKEN_RBRACE:
+            if (level == 0)
+                return node;
+            level--;
+            break;
+        case TOKEN_SEMICOLON:
+            if (level == 0)
+                return node;
+            break;
+        default:
+            break;
+        }
+        advance(p);
+    }
+}
+
+/* Move past the current token if it is `kind`; a ';' or '}' found where
+ * it belongs also ends the recovery from an error. */
+static int expect(struct parser *p, enum token_kind kind, const char *what)
+{
+    if (peek(p) != kind) {
+        /* a missing ';' is missing at the end of the line, not wherever
+         * the next token is */
+        if (kind == TOKEN_SEMICOLON && !p->panic) {
+            size_t prev = p->pos;
+
+            /* after the last token parsed, not the unknown ones skipped */
+            while (prev > 0 && p->tokens[prev - 1].kind == TOKEN_UNKNOWN)
+                prev--;
+            if (prev > 0) {
+                const struct token *tok = &p->tokens[prev - 1];
+
+                diag_error(tok->offset + tok->length, "expected %s", what);
+                p->panic = 1;
+            }
+        }
+        expected(p, what);
+        return 0;
+    }
+    advance(p);
+    if (kind == TOKEN_SEMICOLON || kind == TOKEN_RBRACE)
+        p->panic = 0;
+    return 1;
+}
+
+/* After an error: skip to just past the next ';', or to the next '}' or
+ * statement keyword, where parsing can pick up again. */
+static void synchronize(struct parser *p)
+{
+    for (;;) {
+        switch ((int) peek(p)) {
+        case TOKEN_SEMICOLON:
+            advance(p);
+            /* fall through */
+        case TOKEN_EOF:
+        case TOKEN_RBRACE:
+        case TOKEN_IF:
+        case TOKEN_WHILE:
+        case TOKEN_FOR:
+        case TOKEN_PRINT:
+        case TOKEN_RETURN:
+        case TOKEN_INT:
+        case TOKEN_FLOAT:
+        case TOKEN_STRING:
+            p->panic = 0;
+            return;
+        default:
+            advance(p);
+        }
+    }
+}
+
+static uint32_t name(struct parser *p)
+{
+    if (peek(p) != TOKEN_IDENTIFIER) {
+        expected(p, "a name");
+        return empty(p);
+    }
+    return new_node(p, AST_NAME, advance(p));
+}
+
+static uint32_t prefix(struct parser *p)
+{
+    uint32_t node;
+
+    p->height = 1;
+    switch (peek(p)) {
+    case TOKEN_IDENTIFIER:
+        return new_node(p, AST_NAME, advance(p));
+    case TOKEN_NUMBER:
+        return new_node(p, AST_NUMBER, advance(p));
+    case TOKEN_STRING_LITERAL:
+        return new_node(p, AST_STRING, advance(p));
+    case TOKEN_LPAREN:
+        advance(p);
+        node = expression(p, 0);
+        expect(p, TOKEN_RPAREN, "')'");
+        return node;
+    case TOKEN_MINUS:
+        node = new_node(p, AST_NEG, advance(p));
+        set_child(p, node, expression(p, PREFIX_POWER));
+        p->height++;
+        return node;
+    default:
+        expected(p, "an expression");
+        return empty(p);
+    }
+}
+
+/* Pratt loop: parse a prefix, then keep folding in operators that bind
+ * tighter than min_power.  Passing an operator's own power for its right
+ * operand makes operators of equal power group to the left.
+ *
+ * The loop takes no stack, but each operator folded in puts the tree
+ * built so far a level further down, and the passes after the parser walk
+ * it recursively: so it is the height of the tree, not the recursion
+ * here, that is held to the depth limit, and a + b + c ... is as deep as
+ * the same chain in parentheses. */
+static uint32_t expression(struct parser *p, unsigned min_power)
+{
+    int depth = p->depth;
+    int height;
+    uint32_t left;
+
+    if (++p->depth > PARSE_MAX_DEPTH) {
+        p->height = 1;
+        return nested_too_deeply(p);
+    }
+    left = prefix(p);
+    height = p->height;
+    for (;;) {
+        unsigned power = binding_power[peek(p)];
+        uint32_t op, right;
+
+        if (power <= min_power)
+            break;
+        op = advance(p);
+        right = expression(p, power);
+        height = 1 + (p->height > height ? p->height : height);
+        if (depth + height > PARSE_MAX_DEPTH) {
+            left = nested_too_deeply(p);
+            height = 1;
+            break;
+        }
+        left = node2(p, AST_BINARY, op, left, right);
+    }
+    p->depth = depth;
+    p->height = height;
+    return left;
+}
+
+/* "name = value", or an expression evaluated for nothing; also what
+ * for's first and third parts hold. */
+static uint32_t simple(struct parser *p)
+{
+    uint32_t left = expression(p, 0);
+    uint32_t tok;
+
+    if (peek(p) != TOKEN_ASSIGN)
+        return node2(p, AST_EXPR, p->ast->token[left], left, AST_NONE);
+    tok = advance(p);
+    if (p->ast->kind[left] != AST_NAME)
+        error_at(p, p->tokens[tok].offset, "only a name can be assigned to");
+    return node2(p, AST_ASSIGN, tok, left, expression(p, 0));
+}
+
+/* "int x" with an optional "= value"; the ';' is the caller's. */
+static uint32_t declaration(struct parser *p)
+{
+    uint32_t node = new_node(p, AST_DECL, advance(p));
+    uint32_t var = name(p);
+
+    set_child(p, node, var);
+    if (peek(p) == TOKEN_ASSIGN) {
+        advance(p);
+        set_next(p, var, expression(p, 0));
+    }
+    return node;
+}
+
+static uint32_t block(struct parser *p)
+{
+    uint32_t node = new_node(p, AST_BLOCK, advance(p));
+    uint32_t last = AST_NONE;
+
+    while (peek(p) != TOKEN_RBRACE && peek(p) != TOKEN_EOF &&
+           !diag_stopped()) {
+        size_t before = p->pos;
+        uint32_t stmt = statement(p);
+
+        if (last)
+            set_next(p, last, stmt);
+        else
+            set_child(p, node, stmt);
+        last = stmt;
+        if (p->panic)
+            synchronize(p);
+        if (p->pos == before)
+            advance(p);
+    }
+    expect(p, TOKEN_RBRACE, "'}'");
+    return node;
+}
+
+/* "(" condition ")", for if and while. */
+static uint32_t condition(struct parser *p)
+{
+    uint32_t node;
+
+    expect(p, TOKEN_LPAREN, "'('");
+    node = expression(p, 0);
+    expect(p, TOKEN_RPAREN, "')'");
+    return node;
+}
+
+static uint32_t for_statement(struct parser *p)
+{
+    uint32_t node = new_node(p, AST_FOR, advance(p));
+    uint32_t init, cond, step;
+
+    expect(p, TOKEN_LPAREN, "'('");
+    switch (peek(p)) {
+    case TOKEN_SEMICOLON:
+        init = empty(p);
+        break;
+    case TOKEN_INT:
+    case TOKEN_FLOAT:
+    case TOKEN_STRING:
+        init = declaration(p);
+        break;
+    default:
+        init = simple(p);
+        break;
+    }
+    expect(p, TOKEN_SEMICOLON, "';'");
+    cond = peek(p) == TOKEN_SEMICOLON ? empty(p) : expression(p, 0);
+    expect(p, TOKEN_SEMICOLON, "';'");
+    step = peek(p) == TOKEN_RPAREN ? empty(p) : simple(p);
+    expect(p, TOKEN_RPAREN, "')'");
+    set_child(p, node, init);
+    set_next(p, init, cond);
+    set_next(p, cond, step);
+    set_next(p, step, statement(p));
+    return node;
+}
+
+static uint32_t statement(struct parser *p)
+{
+    uint32_t node, cond, body;
+
+    if (++p->depth > PARSE_MAX_DEPTH)
+        return nested_too_deeply(p);
+    switch (peek(p)) {
+    case TOKEN_LBRACE:
+        node = block(p);
+        break;
+    case TOKEN_IF:
+        node = new_node(p, AST_IF, advance(p));
+        cond = condition(p);
+        body = statement(p);
+        set_child(p, node, cond);
+        set_next(p, cond, body);
+        if (peek(p) == TOKEN_ELSE) {
+            advance(p);
+            set_next(p, body, statement(p));
+        }
+        break;
+    case TOKEN_WHILE:
+        node = new_node(p, AST_WHILE, advance(p));
+        cond = condition(p);
+        body = statement(p);
+        set_child(p, node, cond);
+        set_next(p, cond, body);
+        break;
+    case TOKEN_FOR:
+        node = for_statement(p);
+        break;
+    case TOKEN_PRINT:
+        node = new_node(p, AST_PRINT, advance(p));
+        set_child(p, node, condition(p));
+        expect(p, TOKEN_SEMICOLON, "';'");
+        break;
+    case TOKEN_RETURN:
+        node = new_node(p, AST_RETURN, advance(p));
+        if (peek(p) != TOKEN_SEMICOLON)
+            set_child(p, node, expression(p, 0));
+        expect(p, TOKEN_SEMICOLON, "';'");
+        break;
+    case TOKEN_INT:
+    case TOKEN_FLOAT:
+    case TOKEN_STRING:
+        node = declaration(p);
+        expect(p, TOKEN_SEMICOLON, "';'");
+        break;
+    case TOKEN_SEMICOLON:
+        node = empty(p);
+        advance(p);
+        break;
+    default:
+        node = simple(p);
+        expect(p, TOKEN_SEMICOLON, "';'");
+        break;
+    }
+    p->depth--;
+    return node;
+}
+
+/* "int main { ... }": a type, a name and a block. */
+static int at_function(struct parser *p)
+{
+    enum token_kind kind = peek(p);
+
+    return (kind == TOKEN_INT || kind == TOKEN_FLOAT || kind == TOKEN_STRING) &&
+           fill(p, 2) &&
+           p->tokens[p->pos + 1].kind == TOKEN_IDENTIFIER &&
+           p->tokens[p->pos + 2].kind == TOKEN_LBRACE;
+}
+
+static void parse_tokens(struct parser *p, struct ast *ast)
+{
+    uint32_t last = AST_NONE;
+
+    while ((p->pos < p->count || fill(p, 0)) &&
+           p->tokens[p->pos].kind == TOKEN_UNKNOWN)
+        p->pos++;
+
+    ast->root = new_node(p, AST_PROGRAM, 0);
+    while (peek(p) != TOKEN_EOF && !diag_stopped()) {
+        size_t before = p->pos;
+        uint32_t item;
+
+        if (at_function(p)) {
+            uint32_t tok = advance(p);
+            uint32_t fn_name = name(p);
+
+            item = node2(p, AST_FUNCTION, tok, fn_name, block(p));
+        } else if (peek(p) == TOKEN_RBRACE) {
+            error_at(p, here(p), "'}' without a '{'");
+            item = empty(p);
+            advance(p);
+        } else {
+            item = statement(p);
+        }
+        if (last)
+            set_next(p, last, item);
+        else
+            set_child(p, ast->root, item);
+        last = item;
+        if (p->panic)
+            synchronize(p);
+        if (p->pos == before)
+            advance(p);
+        p->too_deep = 0;
+    }
+    ast_shrink(ast);
+}
+
+static void parser_init(struct parser *p, const struct token_buffer *tokens,
+                        uint32_t len, struct ast *ast)
+{
+    ast_init(ast, tokens);
+    p->tokens = tokens->data;
+    p->count = tokens->count;
+    p->buf = NULL;
+    p->more = NULL;
+    p->more_arg = NULL;
+    p->pos = 0;
+    p->len = len;
+    p->ast = ast;
+    p->depth = 0;
+    p->height = 0;
+    p->panic = 0;
+    p->too_deep = 0;
+}
+
+void parse(const struct token_buffer *tokens, uint32_t len, struct ast *ast)
+{
+    struct parser p;
+
+    parser_init(&p, tokens, len, ast);
+    parse_tokens(&p, ast);
+}
+
+void parse_stream(struct token_buffer *tokens, uint32_t len, struct ast *ast,
+                  parse_more_fn *more, void *arg)
+{
+    struct parser p;
+
+    parser_init(&p, tokens, len, ast);
+    p.buf = tokens;
+    p.more = more;
+    p.more_arg = arg;
+    parse_tokens(&p, ast);
+}
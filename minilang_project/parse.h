@@ -0,0 +1,38 @@
+#ifndef MINILANG_PARSE_H
+#define MINILANG_PARSE_H
+
+#include <stdint.h>
+
+#include "ast.h"
+#include "token.h"
+
+/* Parse a lexed source into `ast`, which keeps a pointer to `tokens`.
+ *
+ * A hand-written recursive descent parser for statements with Pratt
+ * (precedence climbing) parsing for expressions: one function and one
+ * loop handle every binary operator, by binding power
+ *
+ *   == !=  <  <= > >=  + -  * /      (lowest to highest, all left to right)
+ *
+ * with unary minus above them.  Nodes are appended to the tree's arrays
+ * as they are made.
+ *
+ * Errors are reported through diag_error(), so call it between
+ * diag_begin() and diag_end(); `len` is the length of the source, where
+ * "end of input" errors point.  After an error the parser skips to the
+ * end of the statement and goes on, so the tree is always complete, with
+ * AST_EMPTY where something was missing.  TOKEN_UNKNOWN tokens are
+ * skipped: the lexer has reported them already. */
+void parse(const struct token_buffer *tokens, uint32_t len, struct ast *ast);
+
+/* Appends the next tokens to the buffer given to parse_stream(), numbers
+ * and all; returns 0 when there are no more. */
+typedef int parse_more_fn(void *arg);
+
+/* As parse(), for tokens that are still being lexed: `tokens` starts with
+ * what there is so far, and more(arg) is called whenever the parser needs
+ * a token past its end, so that parsing overlaps with lexing. */
+void parse_stream(struct token_buffer *tokens, uint32_t len, struct ast *ast,
+                  parse_more_fn *more, void *arg);
+
+#endif
@@ -0,0 +1,156 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "dfalex.h"
+#include "relex.h"
+
+/* Bytes lexed per step while looking for the old stream again. */
+#define RELEX_WINDOW    256
+
+/* Index of the first token starting at or after offset. */
+static size_t first_at(const struct token_buffer *tokens, size_t offset)
+{
+    size_t lo = 0, hi = tokens->count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (tokens->data[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Whether lexing tok looked at any byte from `at` on.  Tokens look at
+ * most four bytes past their end (whether the next character, up to four
+ * bytes of UTF-8, goes on an identifier), except a lone '"', which looked
+ * for its closing quote to the end of the line, and an unterminated
+ * comment, which looked to the end of the source. */
+static int reads_past(const char *src, const struct token *tok, size_t at)
+{
+    size_t end = (size_t) tok->offset + tok->length;
+
+    if (tok->kind == TOKEN_UNKNOWN && tok->value == TOKEN_ERROR_COMMENT)
+        return 1;
+    if (end + 4 > at)
+        return 1;
+    return tok->kind == TOKEN_UNKNOWN && tok->value == TOKEN_ERROR_STRING &&
+           !memchr(src + end, '\n', at - end);
+}
+
+/* Index of the first token that the edit at `at` may have changed. */
+static size_t restart_index(const struct token_buffer *tokens,
+                            const char *src, size_t at)
+{
+    size_t first = first_at(tokens, at);
+    size_t line = at;
+    size_t i;
+
+    /* A lone '"' anywhere earlier on the line may have its closing quote
+     * inserted; tokens before it on the line are checked below. */
+    while (line > 0 && src[line - 1] != '\n')
+        line--;
+    for (i = first_at(tokens, line); i < first; i++) {
+        if (tokens->data[i].kind == TOKEN_UNKNOWN &&
+            tokens->data[i].value == TOKEN_ERROR_STRING) {
+            first = i;
+            break;
+        }
+    }
+    while (first > 0 && reads_past(src, &tokens->data[first - 1], at))
+        first--;
+    return first;
+}
+
+void relex(struct token_buffer *tokens, const char *src, size_t len,
+           const struct edit *edit, struct relex_range *changed)
+{
+    struct token_buffer fresh;
+    size_t at = edit->offset;
+    size_t resume = at + edit->inserted;   /* first new byte after the edit */
+    size_t first = restart_index(tokens, src, at);
+    size_t last = tokens->count;           /* first old token kept */
+    size_t window = RELEX_WINDOW;
+    size_t pos, tail, first_number, last_number, tail_numbers, i;
+    uint32_t shift = (uint32_t) (edit->inserted - edit->removed);
+
+    token_buffer_init(&fresh);
+    pos = first ? (size_t) tokens->data[first - 1].offset +
+                  tokens->data[first - 1].length : 0;
+    while (pos < len && last == tokens->count) {
+        size_t limit = len - pos > window ? pos + window : len;
+
+        i = fresh.count;
+        pos = dfa_lex_range(src, len, pos, limit, &fresh);
+        for (; i < fresh.count; i++) {
+            const struct token *tok = &fresh.data[i];
+            size_t old, j;
+
+            if (tok->offset < resume)
+                continue;
+            old = tok->offset - edit->inserted + edit->removed;
+            j = first_at(tokens, old);
+            if (j < tokens->count && tokens->data[j].offset == old &&
+                tokens->data[j].kind == tok->kind &&
+                tokens->data[j].length == tok->length) {
+                last = j;
+                fresh.count = i;
+                fresh.number_count =
+                    token_buffer_numbers_before(&fresh, tok->offset);
+                break;
+            }
+        }
+        window *= 2;
+    }
+
+    /* Splice fresh over tokens[first, last), and likewise the numbers. */
+    first_number = first < tokens->count ?
+        token_buffer_numbers_before(tokens, tokens->data[first].offset) :
+        tokens->number_count;
+    last_number = last < tokens->count ?
+        token_buffer_numbers_before(tokens, tokens->data[last].offset) :
+        tokens->number_count;
+    tail = tokens->count - last;
+    tail_numbers = tokens->number_count - last_number;
+
+    token_buffer_reserve(tokens, first + fresh.count + tail);
+    if (tail)
+        memmove(tokens->data + first + fresh.count, tokens->data + last,
+                tail * sizeof *tokens->data);
+    if (fresh.count)
+        memcpy(tokens->data + first, fresh.data,
+               fresh.count * sizeof *tokens->data);
+    for (i = first; i < first + fresh.count; i++) {
+        if (tokens->data[i].kind == TOKEN_NUMBER)
+            tokens->data[i].value += (uint32_t) first_number;
+    }
+    for (; i < first + fresh.count + tail; i++) {
+        tokens->data[i].offset += shift;
+        if (tokens->data[i].kind == TOKEN_NUMBER)
+            tokens->data[i].value = (uint32_t) (tokens->data[i].value -
+                                                last_number + first_number +
+                                                fresh.number_count);
+    }
+
+    token_buffer_reserve_numbers(tokens, first_number + fresh.number_count +
+                                         tail_numbers);
+    if (tail_numbers)
+        memmove(tokens->numbers + first_number + fresh.number_count,
+                tokens->numbers + last_number,
+                tail_numbers * sizeof *tokens->numbers);
+    if (fresh.number_count)
+        memcpy(tokens->numbers + first_number, fresh.numbers,
+               fresh.number_count * sizeof *tokens->numbers);
+    for (i = first_number + fresh.number_count;
+         i < first_number + fresh.number_count + tail_numbers; i++)
+        tokens->numbers[i].offset += shift;
+
+    changed->first = first;
+    changed->removed = last - first;
+    changed->inserted = fresh.count;
+    tokens->count = first + fresh.count + tail;
+    tokens->number_count = first_number + fresh.number_count + tail_numbers;
+    token_buffer_free(&fresh);
+}
@@ -0,0 +1,39 @@
+#ifndef MINILANG_RELEX_H
+#define MINILANG_RELEX_H
+
+#include <stddef.h>
+
+#include "token.h"
+
+/* One edit to a source: `removed` bytes at `offset` were replaced by
+ * `inserted` new ones. */
+struct edit {
+    size_t offset;
+    size_t removed;
+    size_t inserted;
+};
+
+/* Which tokens relex() replaced: tokens[first, first + removed) of the old
+ * array are now tokens[first, first + inserted).  Tokens after them are
+ * the old ones, moved. */
+struct relex_range {
+    size_t first;
+    size_t removed;
+    size_t inserted;
+};
+
+/* Bring `tokens`, lexed with dfa_lex() from a source, up to date with
+ * that source after `edit`; `src` and `len` are the edited source.
+ *
+ * Lexing restarts at the end of the last token that the edit cannot have
+ * changed (a token end is never inside a comment or string) and stops at
+ * the first new token that lines up with an old one past the edit: both
+ * lexers are then at the same token boundary over the same bytes, and the
+ * rest of the old stream stands.  So the lexing done is proportional to
+ * the edit, not the file; what remains linear is moving the tail of the
+ * array and shifting its offsets.  The result is exactly what dfa_lex()
+ * gives for the edited source. */
+void relex(struct token_buffer *tokens, const char *src, size_t len,
+           const struct edit *edit, struct relex_range *changed);
+
+#endif
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number.h"
+#include "runtime.h"
+
+const struct str *str_make(struct arena *arena, const char *text,
+                           size_t len)
+{
+    struct str *s = arena_alloc(arena, sizeof *s + len + 1);
+
+    s->len = (uint32_t) len;
+    memcpy(s->text, text, len);
+    s->text[len] = '\0';
+    return s;
+}
+
+const struct str *str_concat(struct arena *arena, const struct str *a,
+                             const struct str *b)
+{
+    size_t len = (size_t) a->len + b->len;
+    struct str *s;
+
+    if (len > UINT32_MAX) {
+        fprintf(stderr, "minilang: string too long\n");
+        exit(1);
+    }
+    s = arena_alloc(arena, sizeof *s + len + 1);
+    s->len = (uint32_t) len;
+    memcpy(s->text, a->text, a->len);
+    memcpy(s->text + a->len, b->text, b->len);
+    s->text[len] = '\0';
+    return s;
+}
+
+int str_compare(const struct str *a, const struct str *b)
+{
+    int c = memcmp(a->text, b->text, a->len < b->len ? a->len : b->len);
+
+    if (c != 0)
+        return c;
+    return a->len < b->len ? -1 : a->len > b->len;
+}
+
+int64_t float_to_int(double f)
+{
+    if (f != f)
+        return 0;
+    if (f >= 9223372036854775808.0)
+        return INT64_MAX;
+    if (f <= -9223372036854775808.0)
+        return INT64_MIN;
+    return (int64_t) f;
+}
+
+void print_int(int64_t i)
+{
+    printf("%lld\n", (long long) i);
+}
+
+void print_float(double f)
+{
+    char buf[NUMBER_FORMAT_SIZE];
+
+    number_format(buf, f);
+    puts(buf);
+}
+
+void print_str(const struct str *s)
+{
+    fwrite(s->text, 1, s->len, stdout);
+    putchar('\n');
+}
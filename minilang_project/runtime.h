@@ -0,0 +1,84 @@
+#ifndef MINILANG_RUNTIME_H
+#define MINILANG_RUNTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+/* What running a MiniLang program takes, whichever way it is run: values,
+ * strings, the integer arithmetic that C leaves undefined, and print.
+ *
+ * Strings are immutable.  Those made while the program runs, by
+ * concatenation, are allocated from an arena and only freed when it ends,
+ * so a program that builds strings in a loop grows for as long as it runs. */
+struct str {
+    uint32_t len;
+    char text[];
+};
+
+/* A value of any type; which one is known statically, or kept beside it
+ * as an enum type (see check.h). */
+union value {
+    int64_t i;
+    double f;
+    const struct str *s;
+};
+
+const struct str *str_make(struct arena *arena, const char *text,
+                           size_t len);
+const struct str *str_concat(struct arena *arena, const struct str *a,
+                             const struct str *b);
+
+/* Bytewise, a prefix before what it prefixes: <0, 0 or >0. */
+int str_compare(const struct str *a, const struct str *b);
+
+/* Integers wrap around on overflow, as the hardware does; the caller of
+ * int_div() has checked for a zero divisor. */
+static inline int64_t int_add(int64_t a, int64_t b)
+{
+    return (int64_t) ((uint64_t) a + (uint64_t) b);
+}
+
+static inline int64_t int_sub(int64_t a, int64_t b)
+{
+    return (int64_t) ((uint64_t) a - (uint64_t) b);
+}
+
+static inline int64_t int_mul(int64_t a, int64_t b)
+{
+    return (int64_t) ((uint64_t) a * (uint64_t) b);
+}
+
+static inline int64_t int_neg(int64_t a)
+{
+    return (int64_t) (0 - (uint64_t) a);
+}
+
+/* A 32-bit divide takes a fraction of the time of a 64-bit one on most
+ * x86 parts, and loop counters and the like fit in one. */
+static inline int64_t int_div(int64_t a, int64_t b)
+{
+    if (((uint64_t) a | (uint64_t) b) >> 31 == 0)
+        return (int64_t) ((uint32_t) a / (uint32_t) b);
+    return b == -1 ? int_neg(a) : a / b;
+}
+
+/* What x - x / y * y comes to, wrapping as int_div() does. */
+static inline int64_t int_rem(int64_t a, int64_t b)
+{
+    if (((uint64_t) a | (uint64_t) b) >> 31 == 0)
+        return (int64_t) ((uint32_t) a % (uint32_t) b);
+    return b == -1 ? 0 : a % b;
+}
+
+/* Truncated towards zero and clamped to the int64_t range; NaN is 0. */
+int64_t float_to_int(double f);
+
+/* print(): the value and a newline on standard output.  Floats are
+ * written as number_format() writes them. */
+void print_int(int64_t i);
+void print_float(double f);
+void print_str(const struct str *s);
+
+#endif
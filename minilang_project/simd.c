@@ -0,0 +1,38 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+static enum simd_level detect(void)
+{
+    enum simd_level level = SIMD_SCALAR;
+    const char *cap = getenv("MINILANG_SIMD");
+
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        level = SIMD_AVX2;
+    else if (__builtin_cpu_supports("sse4.2"))
+        level = SIMD_SSE42;
+#endif
+    if (cap && strcmp(cap, "scalar") == 0)
+        level = SIMD_SCALAR;
+    else if (cap && strcmp(cap, "sse4.2") == 0 && level > SIMD_SSE42)
+        level = SIMD_SSE42;
+    return level;
+}
+
+/* Several lexer threads may race to detect; they all store the same
+ * value. */
+enum simd_level simd_level(void)
+{
+    static atomic_int cached = -1;
+    int level = atomic_load_explicit(&cached, memory_order_relaxed);
+
+    if (level < 0) {
+        level = (int) detect();
+        atomic_store_explicit(&cached, level, memory_order_relaxed);
+    }
+    return (enum simd_level) level;
+}
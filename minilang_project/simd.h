@@ -0,0 +1,25 @@
+#ifndef MINILANG_SIMD_H
+#define MINILANG_SIMD_H
+
+/* x86 vector kernels are built with per-function target attributes, so the
+ * rest of the program needs no -m flags and still runs on any x86-64. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_X86 1
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define SIMD_X86 0
+#endif
+
+enum simd_level {
+    SIMD_SCALAR,
+    SIMD_SSE42,
+    SIMD_AVX2
+};
+
+/* Best instruction set the running CPU supports, detected once via CPUID.
+ * Setting MINILANG_SIMD to "scalar" or "sse4.2" caps it, which is how the
+ * kernels are checked against each other. */
+enum simd_level simd_level(void);
+
+#endif
@@ -0,0 +1,124 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "source.h"
+
+/* Map `len` bytes of `fd` followed by at least two zero bytes.  The
+ * sentinel comes for free when the file does not end on a page boundary
+ * (the rest of the last page reads as zero); otherwise an anonymous page
+ * reserved behind the file mapping provides it. */
+static int map_file(struct source *src, int fd, size_t len)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t map_len = (len + 2 + page - 1) / page * page;
+    char *base;
+
+    base = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        return -1;
+    if (len && mmap(base, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                    fd, 0) == MAP_FAILED) {
+        int saved = errno;
+
+        munmap(base, map_len);
+        errno = saved;
+        return -1;
+    }
+    madvise(base, len, MADV_SEQUENTIAL);
+    src->data = base;
+    src->len = len;
+    src->map_len = map_len;
+    return 0;
+}
+
+static int read_fd(struct source *src, int fd)
+{
+    size_t size = 0, capacity = 1 << 16;
+    char *buf = malloc(capacity);
+
+    for (;;) {
+        ssize_t n;
+
+        if (!buf)
+            return -1;
+        if (capacity - size <= 2) {
+            char *grown = realloc(buf, capacity * 2);
+
+            if (!grown) {
+                free(buf);
+                return -1;
+            }
+            buf = grown;
+            capacity *= 2;
+        }
+        n = read(fd, buf + size, capacity - size - 2);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            int saved = errno;
+
+            free(buf);
+            errno = saved;
+            return -1;
+        }
+        if (n == 0)
+            break;
+        size += (size_t) n;
+        if (size > SOURCE_MAX) {
+            free(buf);
+            errno = EFBIG;
+            return -1;
+        }
+    }
+    buf[size] = buf[size + 1] = '\0';
+    src->data = buf;
+    src->len = size;
+    src->map_len = 0;
+    return 0;
+}
+
+int source_open(struct source *src, const char *path)
+{
+    int from_stdin = !path || strcmp(path, "-") == 0;
+    int fd = from_stdin ? STDIN_FILENO : open(path, O_RDONLY);
+    struct stat st;
+    int ret;
+
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+        lseek(fd, 0, SEEK_CUR) == 0) {
+        if ((uint64_t) st.st_size > SOURCE_MAX) {
+            errno = EFBIG;
+            ret = -1;
+        } else {
+            ret = map_file(src, fd, (size_t) st.st_size);
+        }
+    } else {
+        ret = read_fd(src, fd);
+    }
+    if (!from_stdin) {
+        int saved = errno;
+
+        close(fd);
+        errno = saved;
+    }
+    return ret;
+}
+
+void source_close(struct source *src)
+{
+    if (src->map_len)
+        munmap(src->data, src->map_len);
+    else
+        free(src->data);
+    src->data = NULL;
+    src->len = 0;
+    src->map_len = 0;
+}
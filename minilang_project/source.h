@@ -0,0 +1,31 @@
+#ifndef MINILANG_SOURCE_H
+#define MINILANG_SOURCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* A whole source file in memory.
+ *
+ * Regular files are mapped privately instead of read, so lexing works on
+ * the page cache directly and token offsets point straight into the
+ * mapping.  Pipes and terminals are read into a heap buffer.  Either way
+ * data[len] and data[len + 1] are NUL, which is the end-of-buffer sentinel
+ * yy_scan_buffer() wants, so the flex scanner needs no copy either. */
+struct source {
+    char *data;
+    size_t len;
+    size_t map_len;     /* size of the mapping, 0 if data is malloc'd */
+};
+
+/* Token offsets and lengths are 32-bit (see token.h), so a source is at
+ * most this long. */
+#define SOURCE_MAX UINT32_MAX
+
+/* Load `path`, or standard input when `path` is NULL or "-".  Returns 0 on
+ * success, -1 with errno set on failure: EFBIG for a source longer than
+ * SOURCE_MAX. */
+int source_open(struct source *src, const char *path);
+
+void source_close(struct source *src);
+
+#endif
@@ -0,0 +1,171 @@
+#include <string.h>
+
+#include "intern.h"
+#include "keyword.h"
+#include "tablelex.h"
+#include "utf8.h"
+
+/* What a rule's action does; lexgen.c works it out from minilang.l. */
+enum lex_action {
+    LEX_NONE,       /* no rule matched */
+    LEX_TOKEN,      /* emit(kind) */
+    LEX_WORD,       /* a keyword or an identifier */
+    LEX_SPLIT,      /* a run to cut up as emit_split() does */
+    LEX_COMMENT,    /* the opener of a block comment */
+    LEX_SKIP        /* whitespace or a line comment */
+};
+
+struct lex_rule {
+    unsigned char action;
+    unsigned char kind;
+};
+
+#include "lextab.h"
+
+static int ident_byte(unsigned c)
+{
+    return c == '_' || (c | 0x20) - 'a' < 26 || c - '0' < 10;
+}
+
+static int invalid_byte(unsigned c)
+{
+    return c < 0x80 && !ident_byte(c) &&
+           (c == 0 || !strchr("=!<>+-*/(){};,\"\t\n ", (int) c));
+}
+
+/* The first piece of a {uid} or {invalid}+ match, as emit_split() in
+ * minilang.l cuts it: an identifier, or a run of bytes that start no
+ * token. */
+static size_t split_piece(const unsigned char *s, size_t pos, size_t len,
+                          enum token_kind *kind)
+{
+    uint32_t cp;
+    size_t n = utf8_decode(s, pos, len, &cp);
+
+    if (n && (cp < 0x80 ? ident_byte(cp) && cp - '0' >= 10 : xid_start(cp))) {
+        *kind = TOKEN_IDENTIFIER;
+        for (pos += n; pos < len; pos += n) {
+            n = utf8_decode(s, pos, len, &cp);
+            if (!n || !(cp < 0x80 ? ident_byte(cp) : xid_continue(cp)))
+                break;
+        }
+        return pos;
+    }
+    *kind = TOKEN_UNKNOWN;
+    while (pos < len) {
+        if (s[pos] < 0x80) {
+            if (!invalid_byte(s[pos]))
+                break;
+            pos++;
+        } else {
+            n = utf8_decode(s, pos, len, &cp);
+            if (n && xid_start(cp))
+                break;
+            pos += n ? n : 1;
+        }
+    }
+    return pos;
+}
+
+/* Offset of the "*" of the first comment terminator from pos, or len. */
+static size_t comment_end(const unsigned char *s, size_t pos, size_t len)
+{
+    while (pos + 1 < len) {
+        const unsigned char *star = memchr(s + pos, '*', len - pos - 1);
+
+        if (!star)
+            break;
+        pos = (size_t) (star - s);
+        if (s[pos + 1] == '/')
+            return pos;
+        pos++;
+    }
+    return len;
+}
+
+void table_lex(const char *src, size_t len, struct token_buffer *out)
+{
+    const unsigned char *s = (const unsigned char *) src;
+    struct intern_cache cache;
+    size_t pos = 0;
+
+    memset(&cache, 0, sizeof cache);
+    while (pos < len) {
+        size_t start = pos;
+        size_t end = pos + 1;
+        size_t p;
+        unsigned state = LEX_START;
+        unsigned rule = 0;
+        enum token_kind kind;
+        uint32_t value = SYMBOL_NONE;
+
+        /* longest match: run until the DFA stops, remembering the last
+         * accepting state passed */
+        for (p = pos; p < len; p++) {
+            state = lex_next[state][lex_class[s[p]]];
+            if (state == 0)
+                break;
+            if (lex_accept[state]) {
+                rule = lex_accept[state];
+                end = p + 1;
+            }
+        }
+        pos = end;
+
+        switch (lex_rules[rule].action) {
+        case LEX_SKIP:
+            continue;
+
+        case LEX_COMMENT:
+            p = comment_end(s, start + 2, len);
+            if (p < len) {
+                pos = p + 2;
+                continue;
+            }
+            token_buffer_push(out, TOKEN_UNKNOWN, (uint32_t) start, 2,
+                              TOKEN_ERROR_COMMENT);
+            return;
+
+        case LEX_WORD:
+            kind = keyword_kind(src + start, pos - start);
+            if (kind == TOKEN_IDENTIFIER)
+                value = intern_cached(&cache, src + start, pos - start);
+            break;
+
+        case LEX_SPLIT:
+            pos = split_piece(s, start, len, &kind);
+            if (kind == TOKEN_IDENTIFIER) {
+                kind = keyword_kind(src + start, pos - start);
+                if (kind == TOKEN_IDENTIFIER)
+                    value = intern_cached(&cache, src + start, pos - start);
+            } else {
+                value = TOKEN_ERROR_BYTES;
+            }
+            break;
+
+        case LEX_TOKEN:
+            kind = (enum token_kind) lex_rules[rule].kind;
+            if (kind == TOKEN_NUMBER)
+                value = token_buffer_add_number(out, src + start,
+                                                (uint32_t) start,
+                                                (uint32_t) (pos - start));
+            else if (kind == TOKEN_STRING_LITERAL)
+                value = intern_cached(&cache, src + start + 1,
+                                      pos - start - 2);
+            else if (kind == TOKEN_UNKNOWN)
+                /* "." only matches a lone '!' or a '"' that starts no
+                 * string */
+                value = s[start] == '"' ? TOKEN_ERROR_STRING
+                                        : TOKEN_ERROR_BYTES;
+            break;
+
+        default:
+            /* the "." rule leaves only '\n', which is whitespace */
+            kind = TOKEN_UNKNOWN;
+            value = TOKEN_ERROR_BYTES;
+            break;
+        }
+        token_buffer_push(out, kind, (uint32_t) start, (uint32_t) (pos - start),
+                          value);
+    }
+}
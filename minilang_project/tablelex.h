@@ -0,0 +1,17 @@
+#ifndef MINILANG_TABLELEX_H
+#define MINILANG_TABLELEX_H
+
+#include <stddef.h>
+
+#include "token.h"
+
+/* Table-driven scanner for the rules in minilang.l.
+ *
+ * Runs the DFA that lexgen.c builds from minilang.l itself, so unlike
+ * dfa_lex() it follows the rules without being written to match them, and
+ * unlike the flex scanner it needs no flex: the tables in lextab.h are
+ * constant data, ready at load time, and the scanner keeps no global
+ * state.  The tokens are exactly those of the other two engines. */
+void table_lex(const char *src, size_t len, struct token_buffer *out);
+
+#endif
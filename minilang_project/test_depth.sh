@@ -0,0 +1,110 @@
+#!/bin/sh
+# The parser's depth limit (see parse.c): programs nested or chained far
+# past it must fail with one "nested too deeply" at every step, on one
+# thread and pipelined, rather than overflow the stack of a pass that
+# walks the tree; the same shapes under it must compile and print what
+# they compute.
+#
+#   ./test_depth.sh
+#
+# Shapes, each the initial value of x in `int main { int x = ...; }`:
+#
+#   chain N      1 + 1 + ... + 1, N terms, which the parser folds into a
+#                tree as deep as N parentheses
+#   parens N     (((1))) in N parentheses
+#   nested N M   N parentheses, each around a chain of M terms that starts
+#                with the parentheses inside it
+#   blocks N     not an expression: print(x) inside N nested blocks
+
+MINILANG=${MINILANG:-./minilang}
+STEPS=${STEPS:-"--emit=ast --emit=types --emit=ir --emit=obj --emit=bytecode
+                --run=vm --run=generic --run=tree"}
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Writes the program of shape $1 (with its sizes after it) to stdout.
+program() {
+    awk -v shape="$1" -v n="$2" -v m="${3:-0}" 'BEGIN {
+        x = "1"
+        if (shape == "chain") {
+            for (i = 1; i < n; i++)
+                x = x " + 1"
+        } else if (shape == "parens") {
+            for (i = 0; i < n; i++)
+                x = "(" x ")"
+        } else if (shape == "nested") {
+            for (i = 0; i < n; i++) {
+                x = "(" x
+                for (j = 1; j < m; j++)
+                    x = x " + 1"
+                x = x ")"
+            }
+        }
+        printf "int main {\n    int x = %s;\n", x
+        if (shape == "blocks") {
+            for (i = 0; i < n; i++)
+                printf "{"
+            printf "print(x);"
+            for (i = 0; i < n; i++)
+                printf "}"
+            printf "\n"
+        } else {
+            printf "    print(x);\n"
+        }
+        printf "}\n"
+    }'
+}
+
+failed=0
+checked=0
+
+# Runs every step on $dir/input.minilang, and fails unless each exits with
+# status $1 and, when that is 0, a run prints $2, or, when it is 1, the
+# only error is "nested too deeply".
+check() {
+    want=$1
+    printed=$2
+    for step in $STEPS; do
+        for j in 1 2; do
+            "$MINILANG" "$step" -j "$j" "$dir/input.minilang" \
+                > "$dir/out" 2> "$dir/err"
+            status=$?
+            checked=$((checked + 1))
+            ok=1
+            if [ "$status" -ne "$want" ]; then
+                ok=0
+            elif [ "$want" -eq 0 ]; then
+                case $step in
+                --run*) [ "$(cat "$dir/out")" = "$printed" ] || ok=0 ;;
+                esac
+            elif [ "$(grep -c 'nested too deeply' "$dir/err")" -ne 1 ] ||
+                 [ "$(wc -l < "$dir/err")" -ne 1 ]; then
+                ok=0
+            fi
+            if [ "$ok" -eq 0 ]; then
+                echo "FAIL: $shape: minilang $step -j $j exited $status" >&2
+                head -3 "$dir/err" >&2
+                failed=$((failed + 1))
+            fi
+        done
+    done
+}
+
+# Under the limit, then far past it.
+while read -r want printed shape; do
+    program $shape > "$dir/input.minilang"
+    check "$want" "$printed"
+done <<EOF
+0 900 chain 900
+0 1 parens 900
+0 781 nested 20 40
+0 1 blocks 900
+1 - chain 100000
+1 - parens 100000
+1 - nested 300 300
+1 - blocks 100000
+EOF
+
+echo "$checked runs, $failed failed"
+[ "$failed" -eq 0 ]
@@ -0,0 +1,106 @@
+#!/bin/sh
+# Differential test of the lexers: lexes corpora of every mix (see
+# gen_corpus.c) and random bytes with each engine, and fails if any of
+# them writes different tokens, text or binary, different diagnostics or
+# exits differently from the flex scanner.
+#
+#   ./test_lex.sh [-s seeds] [-r inputs] [size...]
+#
+# Sizes default to 1k 64k 4m: the last is large enough that the dfa
+# engine on several threads splits it into chunks for the binary stream
+# (see parlex.h).  Each mix is generated with seeds 1 to `seeds` (default
+# 2) at each size, and then `inputs` (default 200) more of the bytes mix,
+# each with its own seed and a size under 4 KB, since short inputs are
+# where tokens are cut off.  A failure prints the gen_corpus command that
+# reproduces the input.
+#
+# Engines: flex, table and dfa-j1 on one thread, dfa-j8 on eight,
+# however many CPUs there are, so that the chunks are always stitched.
+# Each is compared with flex.
+
+MINILANG=${MINILANG:-./minilang}
+GEN_CORPUS=${GEN_CORPUS:-./gen_corpus}
+MIXES=${MIXES:-"balanced comments identifiers numbers strings unicode bytes"}
+ENGINES=${ENGINES:-"table dfa-j1 dfa-j8"}
+
+seeds=2
+inputs=200
+while getopts s:r: opt; do
+    case $opt in
+    s) seeds=$OPTARG ;;
+    r) inputs=$OPTARG ;;
+    *) echo "usage: $0 [-s seeds] [-r inputs] [size...]" >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+sizes=${*:-"1k 64k 4m"}
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Lexes file $2 with engine $1 and --emit=$3 into $dir/$1.$3, with the
+# diagnostics in .err and the exit status in .status after it.
+run() {
+    engine=$1
+    file=$2
+    emit=$3
+    case $engine in
+    flex)   set -- --engine=flex -j 1 ;;
+    table)  set -- --engine=table -j 1 ;;
+    dfa-j1) set -- --engine=dfa -j 1 ;;
+    dfa-j8) set -- --engine=dfa -j 8 ;;
+    *)      echo "$0: unknown engine $engine" >&2; exit 2 ;;
+    esac
+    "$MINILANG" --emit="$emit" --max-errors=0 "$@" "$file" \
+        > "$dir/$engine.$emit" 2> "$dir/$engine.$emit.err"
+    echo $? > "$dir/$engine.$emit.status"
+}
+
+failed=0
+checked=0
+
+# Checks one generated input: gen_corpus arguments $@.
+check() {
+    "$GEN_CORPUS" "$@" > "$dir/input.minilang" || {
+        echo "$0: gen_corpus $* failed" >&2
+        exit 1
+    }
+    for emit in tokens tokens-bin; do
+        run flex "$dir/input.minilang" "$emit"
+        for engine in $ENGINES; do
+            run "$engine" "$dir/input.minilang" "$emit"
+            for what in "" .err .status; do
+                if ! cmp -s "$dir/flex.$emit$what" \
+                            "$dir/$engine.$emit$what"; then
+                    echo "FAIL: gen_corpus $*: $engine differs from flex" \
+                         "(--emit=$emit${what:+, $what})" >&2
+                    failed=1
+                    break
+                fi
+            done
+        done
+    done
+    checked=$((checked + 1))
+}
+
+for size in $sizes; do
+    for mix in $MIXES; do
+        seed=1
+        while [ $seed -le "$seeds" ]; do
+            check --mix="$mix" --seed="$seed" "$size"
+            seed=$((seed + 1))
+        done
+    done
+done
+seed=1
+while [ $seed -le "$inputs" ]; do
+    check --mix=bytes --seed="$seed" $((seed * 7919 % 4096 + 1))
+    seed=$((seed + 1))
+done
+
+if [ $failed -ne 0 ]; then
+    echo "$0: engines disagree" >&2
+    exit 1
+fi
+echo "$0: $checked inputs, all engines agree"
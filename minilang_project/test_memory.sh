@@ -0,0 +1,88 @@
+#!/bin/sh
+# Peak memory against input size: pipes sources of each size through the
+# engines with `minilang --stats` and fails if peak_rss_kb grows with the
+# size by more than SLACK_KB (default 1024).
+#
+#   ./test_memory.sh [size...]
+#
+# Sizes default to 1m 16m 128m, each compared with the first.  Two
+# inputs are piped:
+#
+#   comment   one block comment of the whole size, a line of text repeated
+#   strings   a string-heavy corpus (gen_corpus --mix=strings)
+#
+# The flex scanner reads the pipe as it goes, eating comments in bounded
+# pieces and printing each token as it is matched, so its own peak RSS
+# must stay flat on both.  The hand-coded and table scanners lex a source
+# held whole in memory (see source.h), so for them it is what they take
+# beyond the source that must stay flat, on the comment; over the strings
+# corpus they keep a token and an interned name per literal, which grow
+# with it by design.
+
+MINILANG=${MINILANG:-./minilang}
+GEN_CORPUS=${GEN_CORPUS:-./gen_corpus}
+SLACK_KB=${SLACK_KB:-1024}
+
+sizes=${*:-"1m 16m 128m"}
+
+# Writes a block comment of about $1 bytes.
+comment() {
+    printf '/*\n'
+    yes 'a licence line, with the odd * and / in it' | head -c "$1"
+    printf '*/\n'
+}
+
+# Prints the bytes of a gen_corpus size.
+bytes() {
+    case $1 in
+    *k) echo $((${1%k} * 1024)) ;;
+    *m) echo $((${1%m} * 1024 * 1024)) ;;
+    *g) echo $((${1%g} * 1024 * 1024 * 1024)) ;;
+    *)  echo "$1" ;;
+    esac
+}
+
+# Prints the peak RSS in KB of engine $1 over input $2 of size $3, less
+# the source when $4 is "beyond-source".
+measure() {
+    case $2 in
+    comment) comment "$(bytes "$3")" ;;
+    strings) "$GEN_CORPUS" --mix=strings "$3" ;;
+    esac | "$MINILANG" --stats --engine="$1" -j 1 2>&1 > /dev/null |
+        awk -v what="$4" '/^minilang: stats:/ {
+            for (i = 3; i <= NF; i++) {
+                split($i, kv, "=")
+                v[kv[1]] = kv[2]
+            }
+            kb = v["peak_rss_kb"]
+            if (what == "beyond-source")
+                kb -= int(v["bytes"] / 1024)
+            print kb
+            found = 1
+        } END { if (!found) exit 1 }'
+}
+
+failed=0
+printf '%s\t%s\t%s\t%s\t%s\n' input engine size peak_rss_kb counted
+for run in "comment flex total" "strings flex total" \
+           "comment table beyond-source" "comment dfa beyond-source"; do
+    set -- $run
+    first=
+    first_size=
+    for size in $sizes; do
+        kb=$(measure "$2" "$1" "$size" "$3") || {
+            echo "$0: $2 failed on the $1 input of $size" >&2
+            exit 1
+        }
+        printf '%s\t%s\t%s\t%s\t%s\n' "$1" "$2" "$size" "$kb" "$3"
+        if [ -z "$first" ]; then
+            first=$kb
+            first_size=$size
+        elif [ "$kb" -gt $((first + SLACK_KB)) ]; then
+            echo "FAIL: $2 on the $1 input: $kb KB at $size, $first KB" \
+                 "at $first_size" >&2
+            failed=1
+        fi
+    done
+done
+exit $failed
@@ -0,0 +1,308 @@
+/* Round-trip test of the binary token stream (tokstream.h).
+ *
+ *   test_tokstream FILE...
+ *
+ * Each file is lexed with dfa_lex() and written with tokstream_write(),
+ * and the stream read back with tokstream_read() must give the same
+ * tokens and numbers, with each name's symbol id replaced by one stream
+ * id, and the source's size.  Read again after those tokens, the stream
+ * must come out appended: its numbers after the first copy's and its
+ * stream ids after the first copy's highest.
+ *
+ * The stream cut short at every length (every step of them, for a long
+ * one) and corrupted in each of the ways tokstream_read() rejects (bad
+ * magic, version or record size, a kind out of range, a token or number
+ * outside the source, a number token without its number, a symbol id of
+ * 0) must then fail and leave the buffer and the size as they were.
+ *
+ * Prints nothing when every check passes; the first that does not is
+ * reported and the exit status is 1. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_PROGRAM "test_tokstream"
+#define ALLOC_WHAT "token streams"
+#include "alloc.h"
+
+#include "dfalex.h"
+#include "intern.h"
+#include "source.h"
+#include "tokstream.h"
+
+/* Cut lengths tried on one stream, at most. */
+#define MAX_CUTS 1024
+
+/* What the buffer held before a read, which a failed one must keep. */
+#define SIZE_BEFORE 0xdeadbeefu
+
+static void put_u32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char) v;
+    p[1] = (unsigned char) (v >> 8);
+    p[2] = (unsigned char) (v >> 16);
+    p[3] = (unsigned char) (v >> 24);
+}
+
+static FILE *temporary(void)
+{
+    FILE *f = tmpfile();
+
+    if (!f) {
+        perror("test_tokstream: tmpfile");
+        exit(1);
+    }
+    return f;
+}
+
+/* The stream tokstream_write() gives for tokens, in memory. */
+static unsigned char *write_stream(const struct token_buffer *tokens,
+                                   uint32_t source_size, size_t *size)
+{
+    FILE *f = temporary();
+    unsigned char *data;
+    long end;
+
+    if (tokstream_write(f, tokens, source_size) != 0 || fflush(f) != 0 ||
+        (end = ftell(f)) < 0) {
+        perror("test_tokstream: writing the stream");
+        exit(1);
+    }
+    *size = (size_t) end;
+    data = xmalloc(*size);
+    rewind(f);
+    if (fread(data, 1, *size, f) != *size) {
+        perror("test_tokstream: reading the stream back");
+        exit(1);
+    }
+    fclose(f);
+    return data;
+}
+
+/* tokstream_read() of the first `size` bytes of data. */
+static int read_stream(const unsigned char *data, size_t size,
+                       struct token_buffer *buf, uint32_t *source_size)
+{
+    FILE *f = temporary();
+    int status;
+
+    if (size && fwrite(data, 1, size, f) != size) {
+        perror("test_tokstream: writing the stream");
+        exit(1);
+    }
+    rewind(f);
+    status = tokstream_read(f, buf, source_size);
+    fclose(f);
+    return status;
+}
+
+static int same_number(const struct number *a, const struct number *b)
+{
+    return a->type == b->type && a->offset == b->offset &&
+           memcmp(&a->as, &b->as, sizeof a->as) == 0;
+}
+
+static int has_symbol(const struct token *tok)
+{
+    return tok->kind == TOKEN_IDENTIFIER || tok->kind == TOKEN_STRING_LITERAL;
+}
+
+/* Whether read holds the tokens lexed, with stream ids numbered from 1
+ * as names first occur; returns the highest stream id, or -1.  id_of,
+ * zeroed, has room for every symbol id lexed holds. */
+static long check_read(const struct token_buffer *lexed,
+                       const struct token_buffer *read, uint32_t *id_of)
+{
+    uint32_t next = 1;
+    size_t i;
+
+    if (read->count != lexed->count ||
+        read->number_count != lexed->number_count)
+        return -1;
+    for (i = 0; i < lexed->count; i++) {
+        const struct token *a = &lexed->data[i], *b = &read->data[i];
+
+        if (a->kind != b->kind || a->offset != b->offset ||
+            a->length != b->length)
+            return -1;
+        if (has_symbol(a)) {
+            if (a->value > lexed->count)
+                return -1;
+            if (!id_of[a->value])
+                id_of[a->value] = next++;
+            if (b->value != id_of[a->value])
+                return -1;
+        } else if (a->value != b->value) {
+            return -1;
+        }
+    }
+    for (i = 0; i < lexed->number_count; i++) {
+        if (!same_number(&lexed->numbers[i], &read->numbers[i]))
+            return -1;
+    }
+    return (long) next - 1;
+}
+
+/* Whether the second copy in buf is the first appended: numbers and
+ * stream ids going on after the first copy's. */
+static int check_appended(const struct token_buffer *buf, size_t count,
+                          size_t numbers, uint32_t last_id)
+{
+    size_t i;
+
+    if (buf->count != 2 * count || buf->number_count != 2 * numbers)
+        return 0;
+    for (i = 0; i < count; i++) {
+        const struct token *a = &buf->data[i], *b = &buf->data[count + i];
+        uint32_t shift = a->kind == TOKEN_NUMBER ? (uint32_t) numbers :
+                         has_symbol(a) ? last_id : 0;
+
+        if (a->kind != b->kind || a->offset != b->offset ||
+            a->length != b->length || b->value != a->value + shift)
+            return 0;
+    }
+    for (i = 0; i < numbers; i++) {
+        if (!same_number(&buf->numbers[i], &buf->numbers[numbers + i]))
+            return 0;
+    }
+    return 1;
+}
+
+/* Whether reading data[0, size) fails and leaves buf and the size alone. */
+static int rejected(const unsigned char *data, size_t size,
+                    struct token_buffer *buf)
+{
+    size_t count = buf->count, numbers = buf->number_count;
+    uint32_t source_size = SIZE_BEFORE;
+
+    return read_stream(data, size, buf, &source_size) != 0 &&
+           buf->count == count && buf->number_count == numbers &&
+           source_size == SIZE_BEFORE;
+}
+
+/* Whether the stream with the u32 at `at` set to v is rejected. */
+static int rejects_patch(unsigned char *data, size_t size, size_t at,
+                         uint32_t v, struct token_buffer *buf)
+{
+    unsigned char saved[4];
+    int ok;
+
+    memcpy(saved, data + at, 4);
+    put_u32(data + at, v);
+    ok = rejected(data, size, buf);
+    memcpy(data + at, saved, 4);
+    return ok;
+}
+
+/* The first check the stream of `lexed`, from a source of `len` bytes,
+ * fails, or NULL. */
+static const char *check_stream(const struct token_buffer *lexed,
+                                size_t len, unsigned char *data, size_t size,
+                                struct token_buffer *read)
+{
+    uint32_t source_size = SIZE_BEFORE;
+    uint32_t *id_of;
+    size_t step, cut, i, numbers_at;
+    long last_id;
+
+    if (read_stream(data, size, read, &source_size) != 0 ||
+        source_size != len)
+        return "the stream written does not read back";
+    id_of = xcalloc(lexed->count + 1, sizeof *id_of);
+    last_id = check_read(lexed, read, id_of);
+    free(id_of);
+    if (last_id < 0)
+        return "the tokens read back are not the ones written";
+    if (read_stream(data, size, read, NULL) != 0 ||
+        !check_appended(read, lexed->count, lexed->number_count,
+                        (uint32_t) last_id))
+        return "the stream read after itself is not appended";
+
+    /* Every failure below must leave both copies in read. */
+    step = size / MAX_CUTS + 1;
+    for (cut = 0; cut < size; cut += step) {
+        if (!rejected(data, cut, read))
+            return "a stream cut short reads";
+    }
+    if (!rejected(data, size - 1, read))
+        return "a stream cut short reads";
+
+    if (!rejects_patch(data, size, 0, 0, read) ||
+        !rejects_patch(data, size, 4, TOKSTREAM_VERSION + 1, read) ||
+        !rejects_patch(data, size, 4, TOKSTREAM_VERSION |
+                                      (TOKSTREAM_RECORD_SIZE + 4) << 16,
+                       read))
+        return "a stream with a bad header reads";
+    if (lexed->count &&
+        (!rejects_patch(data, size, TOKSTREAM_HEADER_SIZE, 0, read) ||
+         !rejects_patch(data, size, TOKSTREAM_HEADER_SIZE, TOKEN_KIND_COUNT,
+                        read) ||
+         !rejects_patch(data, size, TOKSTREAM_HEADER_SIZE + 4,
+                        (uint32_t) len + 1, read)))
+        return "a stream with a bad token reads";
+
+    for (i = 0; i < lexed->count && !has_symbol(&lexed->data[i]); i++)
+        ;
+    if (i < lexed->count &&
+        !rejects_patch(data, size, TOKSTREAM_HEADER_SIZE +
+                                   i * TOKSTREAM_RECORD_SIZE + 12,
+                       SYMBOL_NONE, read))
+        return "a stream with a symbol id of 0 reads";
+
+    /* The number records follow the tokens and their count. */
+    numbers_at = TOKSTREAM_HEADER_SIZE + lexed->count * TOKSTREAM_RECORD_SIZE
+                 + 4;
+    for (i = 0; i < lexed->count && lexed->data[i].kind != TOKEN_NUMBER; i++)
+        ;
+    if (i < lexed->count &&
+        (!rejects_patch(data, size, TOKSTREAM_HEADER_SIZE +
+                                    i * TOKSTREAM_RECORD_SIZE + 12,
+                        (uint32_t) lexed->number_count, read) ||
+         !rejects_patch(data, size, numbers_at, NUMBER_OVERFLOW + 1, read) ||
+         !rejects_patch(data, size, numbers_at + 4, (uint32_t) len, read)))
+        return "a stream with a bad number reads";
+    return NULL;
+}
+
+static int test_file(const char *path)
+{
+    struct source src;
+    struct token_buffer lexed, read;
+    unsigned char *data;
+    const char *failed;
+    size_t size;
+
+    if (source_open(&src, path) != 0) {
+        fprintf(stderr, "test_tokstream: ");
+        perror(path);
+        return 1;
+    }
+    token_buffer_init(&lexed);
+    token_buffer_init(&read);
+    dfa_lex(src.data, src.len, &lexed);
+    data = write_stream(&lexed, (uint32_t) src.len, &size);
+    failed = check_stream(&lexed, src.len, data, size, &read);
+    if (failed)
+        fprintf(stderr, "test_tokstream: %s: %s\n", path, failed);
+    token_buffer_free(&lexed);
+    token_buffer_free(&read);
+    free(data);
+    source_close(&src);
+    return failed != NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int status = 0;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: test_tokstream FILE...\n");
+        return 2;
+    }
+    for (i = 1; i < argc; i++)
+        status |= test_file(argv[i]);
+    return status;
+}
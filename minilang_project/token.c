@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "token.h"
+
+const char *const token_names[TOKEN_KIND_COUNT] = {
+    [TOKEN_IF]             = "TOKEN_IF",
+    [TOKEN_ELSE]           = "TOKEN_ELSE",
+    [TOKEN_WHILE]          = "TOKEN_WHILE",
+    [TOKEN_FOR]            = "TOKEN_FOR",
+    [TOKEN_INT]            = "TOKEN_INT",
+    [TOKEN_FLOAT]          = "TOKEN_FLOAT",
+    [TOKEN_STRING]         = "TOKEN_STRING",
+    [TOKEN_PRINT]          = "TOKEN_PRINT",
+    [TOKEN_RETURN]         = "TOKEN_RETURN",
+    [TOKEN_EQ]             = "TOKEN_EQ",
+    [TOKEN_NEQ]            = "TOKEN_NEQ",
+    [TOKEN_GTE]            = "TOKEN_GTE",
+    [TOKEN_LTE]            = "TOKEN_LTE",
+    [TOKEN_GT]             = "TOKEN_GT",
+    [TOKEN_LT]             = "TOKEN_LT",
+    [TOKEN_PLUS]           = "TOKEN_PLUS",
+    [TOKEN_MINUS]          = "TOKEN_MINUS",
+    [TOKEN_MUL]            = "TOKEN_MUL",
+    [TOKEN_DIV]            = "TOKEN_DIV",
+    [TOKEN_ASSIGN]         = "TOKEN_ASSIGN",
+    [TOKEN_LPAREN]         = "TOKEN_LPAREN",
+    [TOKEN_RPAREN]         = "TOKEN_RPAREN",
+    [TOKEN_LBRACE]         = "TOKEN_LBRACE",
+    [TOKEN_RBRACE]         = "TOKEN_RBRACE",
+    [TOKEN_SEMICOLON]      = "TOKEN_SEMICOLON",
+    [TOKEN_COMMA]          = "TOKEN_COMMA",
+    [TOKEN_NUMBER]         = "TOKEN_NUMBER",
+    [TOKEN_IDENTIFIER]     = "TOKEN_IDENTIFIER",
+    [TOKEN_STRING_LITERAL] = "TOKEN_STRING_LITERAL",
+    [TOKEN_UNKNOWN]        = "UNKNOWN",
+};
+
+const char *const token_text[TOKEN_KIND_COUNT] = {
+    [TOKEN_IF] = "if", [TOKEN_ELSE] = "else", [TOKEN_WHILE] = "while",
+    [TOKEN_FOR] = "for", [TOKEN_INT] = "int", [TOKEN_FLOAT] = "float",
+    [TOKEN_STRING] = "string", [TOKEN_PRINT] = "print",
+    [TOKEN_RETURN] = "return",
+    [TOKEN_EQ] = "==", [TOKEN_NEQ] = "!=", [TOKEN_GTE] = ">=",
+    [TOKEN_LTE] = "<=", [TOKEN_GT] = ">", [TOKEN_LT] = "<",
+    [TOKEN_PLUS] = "+", [TOKEN_MINUS] = "-", [TOKEN_MUL] = "*",
+    [TOKEN_DIV] = "/", [TOKEN_ASSIGN] = "=",
+    [TOKEN_LPAREN] = "(", [TOKEN_RPAREN] = ")", [TOKEN_LBRACE] = "{",
+    [TOKEN_RBRACE] = "}", [TOKEN_SEMICOLON] = ";", [TOKEN_COMMA] = ",",
+};
+
+int token_has_text(enum token_kind kind)
+{
+    return kind == TOKEN_NUMBER || kind == TOKEN_IDENTIFIER ||
+           kind == TOKEN_STRING_LITERAL || kind == TOKEN_UNKNOWN;
+}
+
+void token_buffer_init(struct token_buffer *buf)
+{
+    buf->data = NULL;
+    buf->count = 0;
+    buf->capacity = 0;
+    buf->numbers = NULL;
+    buf->number_count = 0;
+    buf->number_capacity = 0;
+}
+
+void token_buffer_reserve(struct token_buffer *buf, size_t capacity)
+{
+    struct token *data;
+
+    if (capacity <= buf->capacity)
+        return;
+    data = realloc(buf->data, capacity * sizeof *data);
+    if (!data) {
+        fprintf(stderr, "minilang: out of memory for token buffer\n");
+        exit(1);
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+}
+
+void token_buffer_reserve_numbers(struct token_buffer *buf, size_t capacity)
+{
+    struct number *numbers;
+
+    if (capacity <= buf->number_capacity)
+        return;
+    numbers = realloc(buf->numbers, capacity * sizeof *numbers);
+    if (!numbers) {
+        fprintf(stderr, "minilang: out of memory for token buffer\n");
+        exit(1);
+    }
+    buf->numbers = numbers;
+    buf->number_capacity = capacity;
+}
+
+/* Double the capacity, starting at 4096 tokens. */
+void token_buffer_grow(struct token_buffer *buf)
+{
+    token_buffer_reserve(buf, buf->capacity ? buf->capacity * 2 : 4096);
+}
+
+uint32_t token_buffer_add_number(struct token_buffer *buf, const char *text,
+                                 uint32_t offset, uint32_t length)
+{
+    struct number *num;
+
+    if (buf->number_count == buf->number_capacity)
+        token_buffer_reserve_numbers(buf, buf->number_capacity ?
+                                          buf->number_capacity * 2 : 1024);
+    num = &buf->numbers[buf->number_count];
+    number_parse(text, length, num);
+    num->offset = offset;
+    return (uint32_t) buf->number_count++;
+}
+
+size_t token_buffer_numbers_before(const struct token_buffer *buf,
+                                   size_t offset)
+{
+    size_t lo = 0, hi = buf->number_count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (buf->numbers[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void token_buffer_free(struct token_buffer *buf)
+{
+    free(buf->data);
+    free(buf->numbers);
+    token_buffer_init(buf);
+}
@@ -0,0 +1,126 @@
+#ifndef MINILANG_TOKEN_H
+#define MINILANG_TOKEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "number.h"
+
+/* Token kinds: the keywords (see keyword.h), then the order of the rules
+ * in minilang.l.  The values are part of the binary token stream format,
+ * so only ever append. */
+enum token_kind {
+    TOKEN_IF = 1,
+    TOKEN_ELSE,
+    TOKEN_WHILE,
+    TOKEN_FOR,
+    TOKEN_INT,
+    TOKEN_FLOAT,
+    TOKEN_STRING,
+    TOKEN_PRINT,
+    TOKEN_RETURN,
+
+    TOKEN_EQ,
+    TOKEN_NEQ,
+    TOKEN_GTE,
+    TOKEN_LTE,
+    TOKEN_GT,
+    TOKEN_LT,
+
+    TOKEN_PLUS,
+    TOKEN_MINUS,
+    TOKEN_MUL,
+    TOKEN_DIV,
+    TOKEN_ASSIGN,
+
+    TOKEN_LPAREN,
+    TOKEN_RPAREN,
+    TOKEN_LBRACE,
+    TOKEN_RBRACE,
+    TOKEN_SEMICOLON,
+    TOKEN_COMMA,
+
+    TOKEN_NUMBER,
+    TOKEN_IDENTIFIER,
+    TOKEN_STRING_LITERAL,
+
+    TOKEN_UNKNOWN,
+
+    TOKEN_KIND_COUNT
+};
+
+/* One lexed token: what it is and where its text lives in the source.
+ * Identifiers carry their interned symbol id in `value`, string literals
+ * the id of their text without the quotes (see intern.h), and numbers the
+ * index of their converted value in the buffer's `numbers`; other kinds
+ * leave it 0, except TOKEN_UNKNOWN, which says why in a token_error. */
+struct token {
+    uint32_t kind;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t value;
+};
+
+/* What a TOKEN_UNKNOWN covers. */
+enum token_error {
+    TOKEN_ERROR_BYTES,      /* a run of bytes no token starts with, or '!' */
+    TOKEN_ERROR_STRING,     /* a '"' with no closing quote on its line */
+    TOKEN_ERROR_COMMENT     /* the "/" "*" of a block comment that never
+                             * ends; the rest of the source is skipped */
+};
+
+/* Growable array of tokens filled by the lexer, with the values of its
+ * number tokens alongside. */
+struct token_buffer {
+    struct token *data;
+    size_t count;
+    size_t capacity;
+    struct number *numbers;
+    size_t number_count;
+    size_t number_capacity;
+};
+
+extern const char *const token_names[TOKEN_KIND_COUNT];
+
+/* Source text of the keywords and punctuation, NULL for the other kinds. */
+extern const char *const token_text[TOKEN_KIND_COUNT];
+
+/* Kinds whose text is printed after the name, e.g. TOKEN_NUMBER(42). */
+int token_has_text(enum token_kind kind);
+
+void token_buffer_init(struct token_buffer *buf);
+void token_buffer_reserve(struct token_buffer *buf, size_t capacity);
+void token_buffer_grow(struct token_buffer *buf);
+void token_buffer_reserve_numbers(struct token_buffer *buf, size_t capacity);
+void token_buffer_free(struct token_buffer *buf);
+
+/* Inline so that it is compiled for the caller's instruction set: an
+ * out-of-line SSE store after the AVX2 scanner's vector code costs a state
+ * transition on every token. */
+static inline void token_buffer_push(struct token_buffer *buf,
+                                     enum token_kind kind, uint32_t offset,
+                                     uint32_t length, uint32_t value)
+{
+    struct token *tok;
+
+    if (buf->count == buf->capacity)
+        token_buffer_grow(buf);
+    tok = &buf->data[buf->count++];
+    tok->kind = kind;
+    tok->offset = offset;
+    tok->length = length;
+    tok->value = value;
+}
+
+/* Number of values in `numbers` belonging to tokens before `offset`:
+ * numbers are kept in source order, so the index where those from
+ * `offset` on begin. */
+size_t token_buffer_numbers_before(const struct token_buffer *buf,
+                                   size_t offset);
+
+/* Convert the text of a number token into `numbers` and return its index,
+ * the token's value. */
+uint32_t token_buffer_add_number(struct token_buffer *buf, const char *text,
+                                 uint32_t offset, uint32_t length);
+
+#endif
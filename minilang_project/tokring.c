@@ -0,0 +1,123 @@
+#include <sched.h>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "tokring.h"
+
+/* Busy polls before a waiting side gives up its time slice. */
+#define SPIN_LIMIT  256
+
+static void relax(unsigned *spins)
+{
+    if (++*spins < SPIN_LIMIT) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+int token_ring_init(struct token_ring *ring, size_t slots)
+{
+    size_t n = 2;
+    size_t i;
+
+    while (n < slots)
+        n *= 2;
+    ring->slots = malloc(n * sizeof *ring->slots);
+    if (!ring->slots)
+        return -1;
+    for (i = 0; i < n; i++)
+        token_buffer_init(&ring->slots[i]);
+    ring->mask = n - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->closed, 0);
+    ring->tail_seen = 0;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->cancelled, 0);
+    ring->head_seen = 0;
+    return 0;
+}
+
+void token_ring_free(struct token_ring *ring)
+{
+    size_t i;
+
+    for (i = 0; i <= ring->mask; i++)
+        token_buffer_free(&ring->slots[i]);
+    free(ring->slots);
+}
+
+struct token_buffer *token_ring_reserve(struct token_ring *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    struct token_buffer *slot;
+    unsigned spins = 0;
+
+    /* The consumer's index is only reloaded when the cached one says the
+     * ring is full, so while it keeps up the two sides touch each other's
+     * cache line once per lap rather than once per block. */
+    while (head - ring->tail_seen > ring->mask) {
+        if (atomic_load_explicit(&ring->cancelled, memory_order_relaxed))
+            return NULL;
+        ring->tail_seen = atomic_load_explicit(&ring->tail,
+                                               memory_order_acquire);
+        if (head - ring->tail_seen > ring->mask)
+            relax(&spins);
+    }
+    if (atomic_load_explicit(&ring->cancelled, memory_order_relaxed))
+        return NULL;
+    slot = &ring->slots[head & ring->mask];
+    slot->count = 0;
+    slot->number_count = 0;
+    return slot;
+}
+
+void token_ring_publish(struct token_ring *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void token_ring_close(struct token_ring *ring)
+{
+    atomic_store_explicit(&ring->closed, 1, memory_order_release);
+}
+
+struct token_buffer *token_ring_acquire(struct token_ring *ring)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned spins = 0;
+
+    while (tail == ring->head_seen) {
+        /* closed is read before head, so a head published before the
+         * close is seen */
+        int closed = atomic_load_explicit(&ring->closed,
+                                          memory_order_acquire);
+
+        ring->head_seen = atomic_load_explicit(&ring->head,
+                                               memory_order_acquire);
+        if (tail != ring->head_seen)
+            break;
+        if (closed)
+            return NULL;
+        relax(&spins);
+    }
+    return &ring->slots[tail & ring->mask];
+}
+
+void token_ring_release(struct token_ring *ring)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+void token_ring_cancel(struct token_ring *ring)
+{
+    atomic_store_explicit(&ring->cancelled, 1, memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+#ifndef MINILANG_TOKRING_H
+#define MINILANG_TOKRING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "token.h"
+
+/* Lock-free ring of token blocks from one producer thread (the lexer) to
+ * one consumer thread (whatever takes the tokens next), so the two can
+ * work on the same source at once.
+ *
+ * Each slot is a token_buffer that keeps its memory from one use to the
+ * next.  The producer fills the slot token_ring_reserve() hands it and
+ * passes it on with token_ring_publish(); the consumer gets it from
+ * token_ring_acquire() and gives it back with token_ring_release().  Only
+ * the two indices are shared, each written by one side, so neither call
+ * takes a lock.  A full ring makes the producer wait and an empty one the
+ * consumer: both spin briefly and then yield, so a lexer that runs ahead
+ * of a slow consumer holds at most `slots` blocks. */
+struct token_ring {
+    struct token_buffer *slots;
+    size_t mask;
+    /* written by the producer */
+    _Alignas(64) atomic_size_t head;    /* blocks published */
+    atomic_int closed;
+    size_t tail_seen;
+    /* written by the consumer */
+    _Alignas(64) atomic_size_t tail;    /* blocks released */
+    atomic_int cancelled;
+    size_t head_seen;
+};
+
+/* `slots` is rounded up to a power of two.  Returns -1 if out of memory. */
+int token_ring_init(struct token_ring *ring, size_t slots);
+void token_ring_free(struct token_ring *ring);
+
+/* Producer: the next empty block, waiting while the ring is full; NULL
+ * once the consumer has cancelled. */
+struct token_buffer *token_ring_reserve(struct token_ring *ring);
+void token_ring_publish(struct token_ring *ring);
+/* No more blocks will be published. */
+void token_ring_close(struct token_ring *ring);
+
+/* Consumer: the next full block, waiting while the ring is empty; NULL
+ * once it is closed and drained. */
+struct token_buffer *token_ring_acquire(struct token_ring *ring);
+void token_ring_release(struct token_ring *ring);
+/* The consumer wants no more blocks; the producer should stop. */
+void token_ring_cancel(struct token_ring *ring);
+
+#endif
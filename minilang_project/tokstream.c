@@ -0,0 +1,340 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "tokstream.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TOKSTREAM_NATIVE 0
+#else
+#define TOKSTREAM_NATIVE 1
+#endif
+
+static void put_u16(unsigned char *p, uint16_t v)
+{
+    p[0] = (unsigned char) v;
+    p[1] = (unsigned char) (v >> 8);
+}
+
+static void put_u32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char) v;
+    p[1] = (unsigned char) (v >> 8);
+    p[2] = (unsigned char) (v >> 16);
+    p[3] = (unsigned char) (v >> 24);
+}
+
+static void put_u64(unsigned char *p, uint64_t v)
+{
+    put_u32(p, (uint32_t) v);
+    put_u32(p + 4, (uint32_t) (v >> 32));
+}
+
+static uint16_t get_u16(const unsigned char *p)
+{
+    return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static uint32_t get_u32(const unsigned char *p)
+{
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 |
+           (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static uint64_t get_u64(const unsigned char *p)
+{
+    return (uint64_t) get_u32(p) | (uint64_t) get_u32(p + 4) << 32;
+}
+
+static int write_numbers(FILE *out, const struct token_buffer *tokens)
+{
+    unsigned char count[4];
+    size_t i;
+
+    put_u32(count, (uint32_t) tokens->number_count);
+    if (fwrite(count, sizeof count, 1, out) != 1)
+        return -1;
+    for (i = 0; i < tokens->number_count; i++) {
+        const struct number *num = &tokens->numbers[i];
+        unsigned char rec[TOKSTREAM_NUMBER_SIZE];
+        uint64_t bits;
+
+        memcpy(&bits, &num->as, sizeof bits);
+        put_u32(rec, num->type);
+        put_u32(rec + 4, num->offset);
+        put_u64(rec + 8, bits);
+        if (fwrite(rec, sizeof rec, 1, out) != 1)
+            return -1;
+    }
+    return 0;
+}
+
+/* Read the number records and rebase the number tokens from `first` on
+ * past the values buf already held.  The count comes from the stream, so
+ * the array grows as records arrive rather than to what it claims. */
+static int read_numbers(FILE *in, struct token_buffer *buf, size_t first,
+                        uint32_t source_size)
+{
+    unsigned char header[4];
+    size_t base = buf->number_count;
+    uint32_t count, i;
+
+    if (fread(header, sizeof header, 1, in) != 1)
+        return -1;
+    count = get_u32(header);
+    for (i = 0; i < count; i++) {
+        struct number *num;
+        unsigned char rec[TOKSTREAM_NUMBER_SIZE];
+        uint64_t bits;
+
+        if (fread(rec, sizeof rec, 1, in) != 1)
+            return -1;
+        if (buf->number_count == buf->number_capacity)
+            token_buffer_reserve_numbers(buf, buf->number_capacity ?
+                                              buf->number_capacity * 2
+                                              : 1024);
+        num = &buf->numbers[buf->number_count];
+        num->type = get_u32(rec);
+        num->offset = get_u32(rec + 4);
+        if (num->type > NUMBER_OVERFLOW || num->offset >= source_size)
+            return -1;
+        bits = get_u64(rec + 8);
+        memcpy(&num->as, &bits, sizeof bits);
+        buf->number_count++;
+    }
+    for (; first < buf->count; first++) {
+        struct token *tok = &buf->data[first];
+
+        if (tok->kind == TOKEN_NUMBER) {
+            if (tok->value >= count)
+                return -1;
+            tok->value += (uint32_t) base;
+        }
+    }
+    return 0;
+}
+
+/* Whether a token names a symbol, with a stream id for its value. */
+static int has_symbol(const struct token *tok)
+{
+    return tok->kind == TOKEN_IDENTIFIER || tok->kind == TOKEN_STRING_LITERAL;
+}
+
+/* Stream ids: the symbol ids the lexers handed out depend, with several
+ * threads, on which got to a name first, so the writer numbers the names
+ * again from 1 in the order they first occur in the tokens.  The map is
+ * an open-addressing table from symbol id to stream id, sized for the
+ * names the tokens can hold. */
+struct renumber {
+    uint32_t *symbol;       /* SYMBOL_NONE for a free entry */
+    uint32_t *id;
+    uint32_t mask;
+    uint32_t next;
+};
+
+static int renumber_init(struct renumber *r, size_t tokens)
+{
+    size_t capacity = 16;
+
+    while (capacity < 2 * tokens)
+        capacity *= 2;
+    r->symbol = calloc(capacity, sizeof *r->symbol);
+    r->id = malloc(capacity * sizeof *r->id);
+    r->mask = (uint32_t) (capacity - 1);
+    r->next = 1;
+    if (!r->symbol || !r->id) {
+        free(r->symbol);
+        free(r->id);
+        return -1;
+    }
+    return 0;
+}
+
+static uint32_t renumber(struct renumber *r, uint32_t symbol)
+{
+    uint32_t i = (symbol * 0x9E3779B1u) & r->mask;
+
+    while (r->symbol[i] != symbol) {
+        if (r->symbol[i] == SYMBOL_NONE) {
+            r->symbol[i] = symbol;
+            r->id[i] = r->next++;
+            break;
+        }
+        i = (i + 1) & r->mask;
+    }
+    return r->id[i];
+}
+
+/* The value a token has in the stream. */
+static uint32_t stream_value(struct renumber *r, const struct token *tok)
+{
+    if (has_symbol(tok))
+        return renumber(r, tok->value);
+    return tok->value;
+}
+
+/* Tokens are copied this many at a time into a block, with their stream
+ * ids, and written from there. */
+#define WRITE_BATCH 1024
+
+static int write_records(FILE *out, const struct token_buffer *tokens,
+                         struct renumber *ids)
+{
+    const struct token *tok = tokens->data;
+    size_t count = tokens->count;
+    size_t i, n;
+
+    if (TOKSTREAM_NATIVE && sizeof *tok == TOKSTREAM_RECORD_SIZE) {
+        struct token block[WRITE_BATCH];
+
+        for (i = 0; i < count; i += n) {
+            size_t j;
+
+            n = count - i < WRITE_BATCH ? count - i : WRITE_BATCH;
+            for (j = 0; j < n; j++) {
+                block[j] = tok[i + j];
+                block[j].value = stream_value(ids, &tok[i + j]);
+            }
+            if (fwrite(block, sizeof *block, n, out) != n)
+                return -1;
+        }
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        unsigned char rec[TOKSTREAM_RECORD_SIZE];
+
+        put_u32(rec, tok[i].kind);
+        put_u32(rec + 4, tok[i].offset);
+        put_u32(rec + 8, tok[i].length);
+        put_u32(rec + 12, stream_value(ids, &tok[i]));
+        if (fwrite(rec, sizeof rec, 1, out) != 1)
+            return -1;
+    }
+    return 0;
+}
+
+int tokstream_write(FILE *out, const struct token_buffer *tokens,
+                    uint32_t source_size)
+{
+    unsigned char header[TOKSTREAM_HEADER_SIZE];
+    struct renumber ids;
+    int status;
+
+    memcpy(header, TOKSTREAM_MAGIC, 4);
+    put_u16(header + 4, TOKSTREAM_VERSION);
+    put_u16(header + 6, TOKSTREAM_RECORD_SIZE);
+    put_u32(header + 8, (uint32_t) tokens->count);
+    put_u32(header + 12, source_size);
+    if (fwrite(header, sizeof header, 1, out) != 1)
+        return -1;
+    if (renumber_init(&ids, tokens->count) != 0)
+        return -1;
+    status = write_records(out, tokens, &ids);
+    if (status == 0)
+        status = write_numbers(out, tokens);
+    free(ids.symbol);
+    free(ids.id);
+    return status;
+}
+
+/* Whether a record is one tokstream_write() could have written for a
+ * source of `source_size` bytes: token_names and the printers index by
+ * the kind, the span must lie in the source, and stream ids start at 1. */
+static int valid_token(const struct token *tok, uint32_t source_size)
+{
+    return tok->kind >= TOKEN_IF && tok->kind < TOKEN_KIND_COUNT &&
+           (uint64_t) tok->offset + tok->length <= source_size &&
+           (!has_symbol(tok) || tok->value != SYMBOL_NONE);
+}
+
+/* Records are read this many at a time, and the buffer grown for each
+ * batch: a header claiming billions of tokens then fails on the first
+ * short read instead of allocating for them all. */
+#define READ_BATCH 4096
+
+static int read_tokens(FILE *in, struct token_buffer *buf, size_t first,
+                       uint32_t *size)
+{
+    unsigned char header[TOKSTREAM_HEADER_SIZE];
+    uint32_t count, source_size, i;
+
+    if (fread(header, sizeof header, 1, in) != 1)
+        return -1;
+    if (memcmp(header, TOKSTREAM_MAGIC, 4) != 0 ||
+        get_u16(header + 4) != TOKSTREAM_VERSION ||
+        get_u16(header + 6) != TOKSTREAM_RECORD_SIZE)
+        return -1;
+    count = get_u32(header + 8);
+    source_size = get_u32(header + 12);
+    *size = source_size;
+
+    if (TOKSTREAM_NATIVE && sizeof *buf->data == TOKSTREAM_RECORD_SIZE) {
+        while (count) {
+            uint32_t n = count < READ_BATCH ? count : READ_BATCH;
+
+            while (buf->capacity - buf->count < n)
+                token_buffer_grow(buf);
+            if (fread(buf->data + buf->count, sizeof *buf->data, n, in) != n)
+                return -1;
+            for (i = 0; i < n; i++)
+                if (!valid_token(&buf->data[buf->count + i], source_size))
+                    return -1;
+            buf->count += n;
+            count -= n;
+        }
+        return read_numbers(in, buf, first, source_size);
+    }
+    for (i = 0; i < count; i++) {
+        unsigned char rec[TOKSTREAM_RECORD_SIZE];
+        struct token tok;
+
+        if (fread(rec, sizeof rec, 1, in) != 1)
+            return -1;
+        tok.kind = get_u32(rec);
+        tok.offset = get_u32(rec + 4);
+        tok.length = get_u32(rec + 8);
+        tok.value = get_u32(rec + 12);
+        if (!valid_token(&tok, source_size))
+            return -1;
+        token_buffer_push(buf, (enum token_kind) tok.kind, tok.offset,
+                          tok.length, tok.value);
+    }
+    return read_numbers(in, buf, first, source_size);
+}
+
+/* The highest stream id among tokens[0, count), 0 if there is none. */
+static uint32_t last_id(const struct token *tokens, size_t count)
+{
+    uint32_t last = SYMBOL_NONE;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (has_symbol(&tokens[i]) && tokens[i].value > last)
+            last = tokens[i].value;
+    }
+    return last;
+}
+
+int tokstream_read(FILE *in, struct token_buffer *buf, uint32_t *source_size)
+{
+    size_t first = buf->count;
+    size_t numbers = buf->number_count;
+    uint32_t size, base;
+
+    if (read_tokens(in, buf, first, &size) != 0) {
+        /* leave buf holding what it held */
+        buf->count = first;
+        buf->number_count = numbers;
+        return -1;
+    }
+    /* Each stream numbers its names from 1: those of an appended one go
+     * on after the ids already held, so that no two names share one. */
+    base = last_id(buf->data, first);
+    for (; first < buf->count; first++) {
+        if (has_symbol(&buf->data[first]))
+            buf->data[first].value += base;
+    }
+    if (source_size)
+        *source_size = size;
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef MINILANG_TOKSTREAM_H
+#define MINILANG_TOKSTREAM_H
+
+#include <stdio.h>
+
+#include "token.h"
+
+/* Binary token stream written by `minilang --emit=tokens-bin`.
+ *
+ * All fields are little-endian:
+ *
+ *   offset  size  field
+ *   0       4     magic "MLTK"
+ *   4       2     format version (TOKSTREAM_VERSION)
+ *   6       2     size of one token record in bytes
+ *   8       4     number of token records
+ *   12      4     size of the lexed source in bytes
+ *   16      ...   token records: kind, offset, length, value (u32 each)
+ *   ...     4     number of number records
+ *   ...     ...   number records: type, offset (u32 each), then the value
+ *                 as a u64 (int64_t, or the bits of a double)
+ *
+ * Offsets and lengths index into the original source, which is not
+ * stored in the stream.  For identifiers and strings the token value is a
+ * symbol id, numbered from 1 in the order the names first occur in the
+ * stream rather than as the lexer threads happened to intern them, so the
+ * stream depends only on the source: within one stream equal ids mean
+ * equal names, but the names themselves are not stored either.  For
+ * numbers it indexes the number records.
+ */
+
+#define TOKSTREAM_MAGIC       "MLTK"
+#define TOKSTREAM_VERSION     3
+#define TOKSTREAM_HEADER_SIZE 16
+#define TOKSTREAM_RECORD_SIZE 16
+#define TOKSTREAM_NUMBER_SIZE 16
+
+/* Write the header and all records of `tokens`.  Returns 0 on success, -1
+ * on a write error (errno is set). */
+int tokstream_write(FILE *out, const struct token_buffer *tokens,
+                    uint32_t source_size);
+
+/* Read a stream written by tokstream_write into `buf` (which must be
+ * initialised), after any tokens it already holds, and the size of its
+ * source into `*source_size` unless that is NULL.  Returns 0 on success,
+ * -1 if the stream is truncated, has a bad magic or an unsupported
+ * version, or holds a record tokstream_write could not have written: a
+ * kind out of range, a token or number outside the source, or a symbol
+ * id of 0.  On failure buf and `*source_size` hold what they held before.
+ *
+ * The stream ids of a stream read after others go on from the highest
+ * already in buf, so that equal ids still mean equal names: the same name
+ * in two streams has two ids, as the two have two sources. */
+int tokstream_read(FILE *in, struct token_buffer *buf, uint32_t *source_size);
+
+#endif
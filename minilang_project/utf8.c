@@ -0,0 +1,313 @@
+#include <string.h>
+
+#include "simd.h"
+#include "utf8.h"
+#include "xid_table.h"
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+static int xid_bit(uint32_t cp, size_t half)
+{
+    const unsigned char *bits;
+
+    if (cp >> 8 >= XID_PAGES)
+        return 0;
+    bits = xid_bits[xid_page[cp >> 8]] + half;
+    return bits[(cp & 0xff) >> 3] >> (cp & 7) & 1;
+}
+
+int xid_start(uint32_t cp)
+{
+    return xid_bit(cp, 0);
+}
+
+int xid_continue(uint32_t cp)
+{
+    return xid_bit(cp, 32);
+}
+
+static size_t validate_scalar(const unsigned char *s, size_t pos, size_t len)
+{
+    while (pos < len) {
+        uint64_t word;
+        uint32_t cp;
+        size_t n;
+
+        if (pos + 8 <= len) {
+            memcpy(&word, s + pos, 8);
+            if (!(word & 0x8080808080808080u)) {
+                pos += 8;
+                continue;
+            }
+        }
+        if (s[pos] < 0x80) {
+            pos++;
+            continue;
+        }
+        n = utf8_decode(s, pos, len, &cp);
+        if (n == 0)
+            return pos;
+        pos += n;
+    }
+    return len;
+}
+
+/* Where to go on with the scalar check after the vector one stopped at
+ * `pos`: everything before it is well-formed except perhaps a character
+ * that starts in the last three bytes and runs on past pos. */
+static size_t resume_point(const unsigned char *s, size_t pos)
+{
+    size_t k;
+
+    for (k = 1; k <= 3 && k <= pos; k++) {
+        if (s[pos - k] < 0x80)
+            break;
+        if (s[pos - k] >= 0xc0)
+            return pos - k;
+    }
+    return pos;
+}
+
+#if SIMD_X86
+
+/* The lookup method classifies each byte pair (previous byte, this byte)
+ * by three nibbles: the high and low nibble of the previous byte and the
+ * high nibble of this one.  Each nibble indexes a 16-entry table of error
+ * bits, and a bit survives the AND of all three only when the pair really
+ * is that error.  A separate check catches the second and third
+ * continuation bytes of 3- and 4-byte sequences, which the pair tables
+ * cannot tell from an error. */
+#define TOO_SHORT       (1 << 0)    /* lead byte not followed by a
+                                     * continuation */
+#define TOO_LONG        (1 << 1)    /* continuation after ASCII */
+#define OVERLONG_3      (1 << 2)    /* E0 80..9F */
+#define TOO_LARGE       (1 << 3)    /* F4 90..BF, F5..FF */
+#define SURROGATE       (1 << 4)    /* ED A0..BF */
+#define OVERLONG_2      (1 << 5)    /* C0, C1 */
+#define TOO_LARGE_1000  (1 << 6)    /* F5..FF 80..8F */
+#define OVERLONG_4      (1 << 6)    /* F0 80..8F */
+#define TWO_CONTS       (1 << 7)    /* continuation after continuation */
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+#define BYTE_1_HIGH                                                         \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                                 \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                                 \
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,                             \
+    TOO_SHORT | OVERLONG_2,                                                 \
+    TOO_SHORT,                                                              \
+    TOO_SHORT | OVERLONG_3 | SURROGATE,                                     \
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+#define BYTE_1_LOW                                                          \
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,                           \
+    CARRY | OVERLONG_2,                                                     \
+    CARRY,                                                                  \
+    CARRY,                                                                  \
+    CARRY | TOO_LARGE,                                                      \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,                         \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+
+#define BYTE_2_HIGH                                                         \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                             \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                             \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |       \
+        OVERLONG_4,                                                         \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,             \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,              \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,              \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+
+/* Last bytes of a block that leave a sequence open: a lead byte in the
+ * last three positions that wants more than the block has left. */
+#define INCOMPLETE_TAIL (char) (0xf0 - 1), (char) (0xe0 - 1), (char) (0xc0 - 1)
+
+static inline TARGET_SSE42 __m128i check_sse42(__m128i in, __m128i prev)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+    __m128i prev2 = _mm_alignr_epi8(in, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+    __m128i b1h = _mm_shuffle_epi8(_mm_setr_epi8(BYTE_1_HIGH),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i b1l = _mm_shuffle_epi8(_mm_setr_epi8(BYTE_1_LOW),
+        _mm_and_si128(prev1, nibble));
+    __m128i b2h = _mm_shuffle_epi8(_mm_setr_epi8(BYTE_2_HIGH),
+        _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+    /* only a byte two after E0..FF or three after F0..FF keeps bit 7 */
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xe0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xf0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth),
+                                   _mm_set1_epi8((char) 0x80));
+
+    return _mm_xor_si128(must23, special);
+}
+
+static TARGET_SSE42 size_t validate_sse42(const unsigned char *s, size_t len)
+{
+    const __m128i max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, INCOMPLETE_TAIL);
+    __m128i prev = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    size_t pos = 0;
+
+    while (pos + 16 <= len) {
+        __m128i in = _mm_loadu_si128((const __m128i *) (s + pos));
+
+        if (_mm_movemask_epi8(in) == 0) {
+            error = _mm_or_si128(error, incomplete);
+        } else {
+            error = _mm_or_si128(error, check_sse42(in, prev));
+            incomplete = _mm_subs_epu8(in, max);
+        }
+        if (!_mm_testz_si128(error, error))
+            break;
+        prev = in;
+        pos += 16;
+    }
+    return validate_scalar(s, resume_point(s, pos), len);
+}
+
+static inline TARGET_AVX2 __m256i check_avx2(__m256i in, __m256i prev)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i carry = _mm256_permute2x128_si256(prev, in, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(in, carry, 15);
+    __m256i prev2 = _mm256_alignr_epi8(in, carry, 14);
+    __m256i prev3 = _mm256_alignr_epi8(in, carry, 13);
+    __m256i b1h = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(BYTE_1_HIGH, BYTE_1_HIGH),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i b1l = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(BYTE_1_LOW, BYTE_1_LOW),
+        _mm256_and_si256(prev1, nibble));
+    __m256i b2h = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(BYTE_2_HIGH, BYTE_2_HIGH),
+        _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+    __m256i third = _mm256_subs_epu8(prev2,
+                                     _mm256_set1_epi8((char) (0xe0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3,
+                                      _mm256_set1_epi8((char) (0xf0 - 0x80)));
+    __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                      _mm256_set1_epi8((char) 0x80));
+
+    return _mm256_xor_si256(must23, special);
+}
+
+static TARGET_AVX2 size_t validate_avx2(const unsigned char *s, size_t len)
+{
+    const __m256i max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, INCOMPLETE_TAIL);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    size_t pos = 0;
+
+    while (pos + 32 <= len) {
+        __m256i in = _mm256_loadu_si256((const __m256i *) (s + pos));
+
+        if (_mm256_movemask_epi8(in) == 0) {
+            error = _mm256_or_si256(error, incomplete);
+        } else {
+            error = _mm256_or_si256(error, check_avx2(in, prev));
+            incomplete = _mm256_subs_epu8(in, max);
+        }
+        if (!_mm256_testz_si256(error, error))
+            break;
+        prev = in;
+        pos += 32;
+    }
+    return validate_scalar(s, resume_point(s, pos), len);
+}
+
+#endif /* SIMD_X86 */
+
+size_t utf8_validate(const char *src, size_t len)
+{
+    const unsigned char *s = (const unsigned char *) src;
+
+#if SIMD_X86
+    switch (simd_level()) {
+    case SIMD_AVX2:
+        return validate_avx2(s, len);
+    case SIMD_SSE42:
+        return validate_sse42(s, len);
+    case SIMD_SCALAR:
+        break;
+    }
+#endif
+    return validate_scalar(s, 0, len);
+}
+
+/* Whether s[0, len), shorter than a character, can still become one. */
+static int incomplete(const unsigned char *s, size_t len)
+{
+    unsigned char buf[4] = { 0x80, 0x80, 0x80, 0x80 };
+    uint32_t cp;
+
+    if (len == 0 || len >= 4)
+        return 0;
+    memcpy(buf, s, len);
+    if (utf8_decode(buf, 0, 4, &cp) > len)
+        return 1;
+    /* E0 and F0 need a second byte above 9F resp. 8F */
+    if (len == 1) {
+        buf[1] = 0xa0;
+        return utf8_decode(buf, 0, 4, &cp) > 1;
+    }
+    return 0;
+}
+
+int utf8_stream_check(struct utf8_stream *st, const char *piece, size_t len,
+                      uint64_t *bad)
+{
+    const unsigned char *s = (const unsigned char *) piece;
+    size_t i = 0, end;
+    uint32_t cp;
+
+    if (st->failed)
+        return 1;
+    while (st->carry_len > 0 && i < len) {
+        st->carry[st->carry_len++] = s[i++];
+        if (utf8_decode(st->carry, 0, st->carry_len, &cp) ==
+            st->carry_len) {
+            st->carry_len = 0;
+        } else if (!incomplete(st->carry, st->carry_len)) {
+            break;
+        }
+    }
+    if (st->carry_len > 0 && (len == 0 || i < len ||
+                              !incomplete(st->carry, st->carry_len))) {
+        /* the carried character never got finished */
+        *bad = st->offset + i - st->carry_len;
+        st->failed = 1;
+        return 0;
+    }
+    end = i + utf8_validate(piece + i, len - i);
+    if (end < len) {
+        if (!incomplete(s + end, len - end)) {
+            *bad = st->offset + end;
+            st->failed = 1;
+            return 0;
+        }
+        memcpy(st->carry, s + end, len - end);
+        st->carry_len = len - end;
+    }
+    st->offset += len;
+    return 1;
+}
@@ -0,0 +1,87 @@
+#ifndef MINILANG_UTF8_H
+#define MINILANG_UTF8_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Sources are UTF-8.  Identifiers may use any character with the Unicode
+ * XID_Start property (or '_') first and XID_Continue after it, as in
+ * Python or Rust; string literals and comments may hold any text.  Names
+ * are compared byte for byte, without normalisation. */
+
+/* Offset of the first byte that is not part of well-formed UTF-8, or `len`
+ * if there is none.  ASCII is checked 16 or 32 bytes at a time, and other
+ * text with the vector lookup method of Keiser and Lemire ("Validating
+ * UTF-8 in less than one instruction per byte"), so the check costs a
+ * fraction of what lexing does. */
+size_t utf8_validate(const char *src, size_t len);
+
+/* Validation of a source read in pieces.  Zero-initialise, then pass
+ * every piece in order and a last one of length 0 at the end of the
+ * source.  Returns 0 and sets *bad to the offset of the first byte that is
+ * not well-formed UTF-8 as soon as there is one, after which the stream is
+ * no longer checked; a character cut by the end of a piece is carried over
+ * to the next. */
+struct utf8_stream {
+    uint64_t offset;            /* of the start of the next piece */
+    unsigned char carry[4];
+    size_t carry_len;
+    int failed;
+};
+
+int utf8_stream_check(struct utf8_stream *st, const char *piece, size_t len,
+                      uint64_t *bad);
+
+/* Whether a code point of U+0080 or above may start / continue an
+ * identifier.  ASCII is the lexer's business. */
+int xid_start(uint32_t cp);
+int xid_continue(uint32_t cp);
+
+/* Decode the character at s[pos], reading no further than s[len - 1].
+ * Returns its length and stores it in *cp, or returns 0 if the bytes there
+ * are not well-formed: a stray continuation byte, a truncated or overlong
+ * sequence, a surrogate, or a value above U+10FFFF. */
+static inline size_t utf8_decode(const unsigned char *s, size_t pos,
+                                 size_t len, uint32_t *cp)
+{
+    uint32_t c = s[pos];
+    uint32_t min;
+    size_t n, i;
+
+    if (c < 0x80) {
+        *cp = c;
+        return 1;
+    }
+    if (c < 0xc2)
+        return 0;
+    if (c < 0xe0) {
+        n = 2;
+        c &= 0x1f;
+        min = 0x80;
+    } else if (c < 0xf0) {
+        n = 3;
+        c &= 0x0f;
+        min = 0x800;
+    } else if (c < 0xf5) {
+        n = 4;
+        c &= 0x07;
+        min = 0x10000;
+    } else {
+        return 0;
+    }
+    if (len - pos < n)
+        return 0;
+    for (i = 1; i < n; i++) {
+        uint32_t b = s[pos + i];
+
+        if ((b & 0xc0) != 0x80)
+            return 0;
+        c = c << 6 | (b & 0x3f);
+    }
+    if (c < min || c > 0x10ffff || (c >= 0xd800 && c < 0xe000))
+        return 0;
+    *cp = c;
+    return n;
+}
+
+#endif
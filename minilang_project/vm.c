@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "diag.h"
+#include "vm.h"
+
+#if defined(__GNUC__)
+#define VM_COMPUTED_GOTO
+#endif
+
+/* Handlers read their operands into locals first: a store to tags[] may
+ * alias anything, and would make the compiler load them again. */
+#define OPERANDS()  a = ip->a; b = ip->b; c = ip->c
+
+/* a = b op c, for the typed opcodes: `field` is the member of register a
+ * set, and `expr` its value from regs[b] and regs[c]. */
+#define BINARY(name, field, expr)                                       \
+    CASE(name):                                                         \
+        OPERANDS();                                                     \
+        regs[a].field = (expr);                                         \
+        ip++;                                                           \
+        DISPATCH();
+
+#define ARITH_TYPED(name, op)                                           \
+    BINARY(name##_I64, i, int_##op(regs[b].i, regs[c].i))
+
+#define COMPARE_TYPED(name, op)                                         \
+    BINARY(name##_I64, i, regs[b].i op regs[c].i)                       \
+    BINARY(name##_F64, i, regs[b].f op regs[c].f)                       \
+    BINARY(name##_STR, i, str_compare(regs[b].s, regs[c].s) op 0)
+
+#define JUMP(name, cond)                                                \
+    CASE(name):                                                         \
+        if (cond)                                                       \
+            GOTO(code->insns + insn_target(ip));                        \
+        else                                                            \
+            ip++;                                                       \
+        DISPATCH();
+
+/* Compare-and-branch: jump by c if regs[a] op regs[b]. */
+#define BRANCH(name, cond)                                              \
+    CASE(name):                                                         \
+        OPERANDS();                                                     \
+        if (cond)                                                       \
+            GOTO(ip + (int16_t) c);                                     \
+        else                                                            \
+            ip++;                                                       \
+        DISPATCH();
+
+#define BRANCH_I64(name, op)    BRANCH(name, regs[a].i op regs[b].i)
+#define BRANCH_F64(name, op)    BRANCH(name, regs[a].f op regs[b].f)
+
+/* The _any opcodes, on registers tagged with their types. */
+
+/* A number register's value as a float. */
+#define NUM(r)  (tags[r] == TYPE_INT ? (double) regs[r].i : regs[r].f)
+
+/* Ints stay ints; with a float on either side both are floats. */
+#define ARITH(name, int_op, float_op)                                   \
+    CASE(name):                                                         \
+        OPERANDS();                                                     \
+        if (tags[b] == TYPE_INT && tags[c] == TYPE_INT) {               \
+            regs[a].i = int_op(regs[b].i, regs[c].i);                   \
+            tags[a] = TYPE_INT;                                         \
+        } else {                                                        \
+            regs[a].f = NUM(b) float_op NUM(c);                         \
+            tags[a] = TYPE_FLOAT;                                       \
+        }                                                               \
+        ip++;                                                           \
+        DISPATCH();
+
+#define COMPARE(name, op)                                               \
+    CASE(name):                                                         \
+        OPERANDS();                                                     \
+        if (tags[b] == TYPE_INT && tags[c] == TYPE_INT)                 \
+            regs[a].i = regs[b].i op regs[c].i;                         \
+        else if (tags[b] == TYPE_STRING)                                \
+            regs[a].i = str_compare(regs[b].s, regs[c].s) op 0;         \
+        else                                                            \
+            regs[a].i = NUM(b) op NUM(c);                               \
+        tags[a] = TYPE_INT;                                             \
+        ip++;                                                           \
+        DISPATCH();
+
+#define TRUE(r) (tags[r] == TYPE_INT ? regs[r].i != 0 : regs[r].f != 0)
+
+/* A jump taken, counting it if it goes backwards, and leaving the frame
+ * with the counts added up. */
+#define GOTO(to)                                                        \
+    do {                                                                \
+        const struct insn *to_ = (to);                                  \
+        COUNTED(back_jumps += to_ <= ip;)                               \
+        ip = to_;                                                       \
+    } while (0)
+
+#define LEAVE(status)                                                   \
+    do {                                                                \
+        COUNTED(counts->dispatches += dispatches;                       \
+                counts->back_jumps += back_jumps;)                      \
+        return status;                                                  \
+    } while (0)
+
+#define RUN_FN      run
+#define COUNTED(x)
+#include "vm_body.h"
+
+#define RUN_FN      run_counted
+#define COUNTED(x)  x
+#include "vm_body.h"
+
+int vm_run(const struct program *prog, struct vm_counts *counts)
+{
+    uint32_t count = prog->top.registers;
+    union value *regs;
+    uint8_t *tags = NULL;
+    struct arena heap;
+    int status;
+
+    if (prog->has_main && prog->main.registers > count)
+        count = prog->main.registers;
+    regs = malloc((count ? count : 1) * sizeof *regs);
+    if (prog->generic)
+        tags = malloc(count ? count : 1);
+    if (!regs || (prog->generic && !tags)) {
+        fprintf(stderr, "minilang: out of memory for registers\n");
+        exit(1);
+    }
+    arena_init(&heap);
+    if (counts) {
+        counts->dispatches = 0;
+        counts->back_jumps = 0;
+        status = run_counted(&prog->top, regs, tags, &heap, counts);
+        if (status == 0 && prog->has_main)
+            status = run_counted(&prog->main, regs, tags, &heap, counts);
+    } else {
+        status = run(&prog->top, regs, tags, &heap, NULL);
+        if (status == 0 && prog->has_main)
+            status = run(&prog->main, regs, tags, &heap, NULL);
+    }
+    arena_free(&heap);
+    free(regs);
+    free(tags);
+    return status;
+}
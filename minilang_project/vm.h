@@ -0,0 +1,32 @@
+#ifndef MINILANG_VM_H
+#define MINILANG_VM_H
+
+#include "bytecode.h"
+
+/* Run a compiled program: its statements outside functions, then main.
+ *
+ * The registers of the running frame are one flat array of values, and a
+ * frame's constants are copied into place when it starts, so every
+ * operand is read the same way.  Typed opcodes know what they read and
+ * the handlers never test a type; only a program compiled to the _any
+ * opcodes has an array of types beside the registers.  Where the
+ * compiler supports it, instructions are dispatched by computed goto: each
+ * handler ends by jumping straight to the next one's label, taken from a
+ * table indexed by opcode, so the branch predictor sees one indirect jump
+ * per handler rather than a single shared one.
+ *
+ * A runtime error, an integer division by zero, is reported through
+ * diag_error() and stops the program; returns 1 then and 0 otherwise.
+ *
+ * Given `counts`, it runs a copy of the interpreter that also counts the
+ * instructions it dispatches and the jumps it takes backwards: one at the
+ * end of each loop iteration but the last.  The copy is slower; timings
+ * are for the other. */
+struct vm_counts {
+    uint64_t dispatches;
+    uint64_t back_jumps;
+};
+
+int vm_run(const struct program *prog, struct vm_counts *counts);
+
+#endif
@@ -0,0 +1,239 @@
+/* Interpreter body for vm.c, included once as it is and once to count
+ * what it does.  The includer defines RUN_FN and COUNTED(), which keeps
+ * its argument only in the counting copy; they are undefined again at the
+ * end.  tags is NULL for code of the typed opcodes. */
+
+static int RUN_FN(const struct code *code, union value *regs, uint8_t *tags,
+                  struct arena *heap, struct vm_counts *counts)
+{
+#ifdef VM_COMPUTED_GOTO
+    static const void *const labels[OP_COUNT] = {
+#define OPCODE_LABEL(name, text, format) &&op_##name,
+        OPCODES(OPCODE_LABEL)
+#undef OPCODE_LABEL
+    };
+#define CASE(name)  op_##name
+#define DISPATCH()  COUNTED(dispatches++); goto *labels[ip->op]
+#else
+#define CASE(name)  case OP_##name
+#define DISPATCH()  COUNTED(dispatches++); goto dispatch
+#endif
+    const struct insn *ip = code->insns;
+    uint32_t a, b, c;
+    COUNTED(uint64_t dispatches = 0; uint64_t back_jumps = 0;)
+
+    (void) counts;
+    if (code->constant_count) {
+        memcpy(regs + code->variables, code->constants,
+               code->constant_count * sizeof *regs);
+        if (tags)
+            memcpy(tags + code->variables, code->constant_types,
+                   code->constant_count);
+    }
+
+#ifdef VM_COMPUTED_GOTO
+    DISPATCH();
+#else
+dispatch:
+    switch (ip->op) {
+#endif
+    CASE(MOVE):
+        OPERANDS();
+        regs[a] = regs[b];
+        ip++;
+        DISPATCH();
+    CASE(I2F):
+        OPERANDS();
+        regs[a].f = (double) regs[b].i;
+        ip++;
+        DISPATCH();
+    CASE(F2I):
+        OPERANDS();
+        regs[a].i = float_to_int(regs[b].f);
+        ip++;
+        DISPATCH();
+    CASE(NEG_I64):
+        OPERANDS();
+        regs[a].i = int_neg(regs[b].i);
+        ip++;
+        DISPATCH();
+    CASE(NEG_F64):
+        OPERANDS();
+        regs[a].f = -regs[b].f;
+        ip++;
+        DISPATCH();
+    ARITH_TYPED(ADD, add)
+    ARITH_TYPED(SUB, sub)
+    ARITH_TYPED(MUL, mul)
+    CASE(DIV_I64):
+        OPERANDS();
+        if (regs[c].i == 0) {
+            diag_error(code->offsets[ip - code->insns], "division by zero");
+            LEAVE(1);
+        }
+        regs[a].i = int_div(regs[b].i, regs[c].i);
+        ip++;
+        DISPATCH();
+    BINARY(ADD_F64, f, regs[b].f + regs[c].f)
+    BINARY(SUB_F64, f, regs[b].f - regs[c].f)
+    BINARY(MUL_F64, f, regs[b].f * regs[c].f)
+    BINARY(DIV_F64, f, regs[b].f / regs[c].f)
+    BINARY(CONCAT_STR, s, str_concat(heap, regs[b].s, regs[c].s))
+    COMPARE_TYPED(EQ, ==)
+    COMPARE_TYPED(NE, !=)
+    COMPARE_TYPED(LT, <)
+    COMPARE_TYPED(LE, <=)
+    COMPARE_TYPED(GT, >)
+    COMPARE_TYPED(GE, >=)
+    CASE(JMP):
+        GOTO(code->insns + insn_target(ip));
+        DISPATCH();
+    JUMP(JMPIF_I64, regs[ip->a].i != 0)
+    JUMP(JMPIFNOT_I64, regs[ip->a].i == 0)
+    JUMP(JMPIF_F64, regs[ip->a].f != 0)
+    JUMP(JMPIFNOT_F64, regs[ip->a].f == 0)
+    CASE(PRINT_I64):
+        print_int(regs[ip->a].i);
+        ip++;
+        DISPATCH();
+    CASE(PRINT_F64):
+        print_float(regs[ip->a].f);
+        ip++;
+        DISPATCH();
+    CASE(PRINT_STR):
+        print_str(regs[ip->a].s);
+        ip++;
+        DISPATCH();
+    CASE(RETURN):
+        LEAVE(0);
+    BRANCH_I64(JEQ_I64, ==)
+    BRANCH_I64(JNE_I64, !=)
+    BRANCH_I64(JLT_I64, <)
+    BRANCH_I64(JLE_I64, <=)
+    BRANCH_I64(JGT_I64, >)
+    BRANCH_I64(JGE_I64, >=)
+    BRANCH_F64(JEQ_F64, ==)
+    BRANCH_F64(JNE_F64, !=)
+    BRANCH_F64(JLT_F64, <)
+    BRANCH_F64(JLE_F64, <=)
+    BRANCH_F64(JGT_F64, >)
+    BRANCH_F64(JGE_F64, >=)
+    BRANCH(JNLT_F64, !(regs[a].f < regs[b].f))
+    BRANCH(JNLE_F64, !(regs[a].f <= regs[b].f))
+    BRANCH(JNGT_F64, !(regs[a].f > regs[b].f))
+    BRANCH(JNGE_F64, !(regs[a].f >= regs[b].f))
+    CASE(INC_JLT_I64):
+        OPERANDS();
+        regs[a].i = int_add(regs[a].i, 1);
+        if (regs[a].i < regs[b].i)
+            GOTO(ip + (int16_t) c);
+        else
+            ip++;
+        DISPATCH();
+    CASE(REM_I64):
+        OPERANDS();
+        if (regs[c].i == 0) {
+            diag_error(code->offsets[ip - code->insns], "division by zero");
+            LEAVE(1);
+        }
+        regs[a].i = int_rem(regs[b].i, regs[c].i);
+        ip++;
+        DISPATCH();
+
+    CASE(MOVE_ANY):
+        OPERANDS();
+        regs[a] = regs[b];
+        tags[a] = tags[b];
+        ip++;
+        DISPATCH();
+    CASE(I2F_ANY):
+        OPERANDS();
+        regs[a].f = (double) regs[b].i;
+        tags[a] = TYPE_FLOAT;
+        ip++;
+        DISPATCH();
+    CASE(F2I_ANY):
+        OPERANDS();
+        regs[a].i = float_to_int(regs[b].f);
+        tags[a] = TYPE_INT;
+        ip++;
+        DISPATCH();
+    CASE(NEG_ANY):
+        OPERANDS();
+        if (tags[b] == TYPE_INT)
+            regs[a].i = int_neg(regs[b].i);
+        else
+            regs[a].f = -regs[b].f;
+        tags[a] = tags[b];
+        ip++;
+        DISPATCH();
+    CASE(ADD_ANY):
+        OPERANDS();
+        if (tags[b] == TYPE_INT && tags[c] == TYPE_INT) {
+            regs[a].i = int_add(regs[b].i, regs[c].i);
+            tags[a] = TYPE_INT;
+        } else if (tags[b] == TYPE_STRING) {
+            regs[a].s = str_concat(heap, regs[b].s, regs[c].s);
+            tags[a] = TYPE_STRING;
+        } else {
+            regs[a].f = NUM(b) + NUM(c);
+            tags[a] = TYPE_FLOAT;
+        }
+        ip++;
+        DISPATCH();
+    ARITH(SUB_ANY, int_sub, -)
+    ARITH(MUL_ANY, int_mul, *)
+    CASE(DIV_ANY):
+        OPERANDS();
+        if (tags[b] == TYPE_INT && tags[c] == TYPE_INT) {
+            if (regs[c].i == 0) {
+                diag_error(code->offsets[ip - code->insns],
+                           "division by zero");
+                LEAVE(1);
+            }
+            regs[a].i = int_div(regs[b].i, regs[c].i);
+            tags[a] = TYPE_INT;
+        } else {
+            regs[a].f = NUM(b) / NUM(c);
+            tags[a] = TYPE_FLOAT;
+        }
+        ip++;
+        DISPATCH();
+    CASE(REM_ANY):
+        OPERANDS();
+        if (regs[c].i == 0) {
+            diag_error(code->offsets[ip - code->insns], "division by zero");
+            LEAVE(1);
+        }
+        regs[a].i = int_rem(regs[b].i, regs[c].i);
+        tags[a] = TYPE_INT;
+        ip++;
+        DISPATCH();
+    COMPARE(EQ_ANY, ==)
+    COMPARE(NE_ANY, !=)
+    COMPARE(LT_ANY, <)
+    COMPARE(LE_ANY, <=)
+    COMPARE(GT_ANY, >)
+    COMPARE(GE_ANY, >=)
+    JUMP(JMPIF_ANY, TRUE(ip->a))
+    JUMP(JMPIFNOT_ANY, !TRUE(ip->a))
+    CASE(PRINT_ANY):
+        a = ip->a;
+        if (tags[a] == TYPE_INT)
+            print_int(regs[a].i);
+        else if (tags[a] == TYPE_FLOAT)
+            print_float(regs[a].f);
+        else
+            print_str(regs[a].s);
+        ip++;
+        DISPATCH();
+#ifndef VM_COMPUTED_GOTO
+    }
+    LEAVE(0);
+#endif
+}
+
+#undef CASE
+#undef DISPATCH
+#undef RUN_FN
+#undef COUNTED
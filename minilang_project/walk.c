@@ -0,0 +1,294 @@
+#include <stdlib.h>
+
+#define ALLOC_WHAT "interpreter"
+#include "alloc.h"
+
+#include "diag.h"
+#include "intern.h"
+#include "runtime.h"
+#include "walk.h"
+
+struct tagged {
+    uint32_t type;
+    union value v;
+};
+
+struct walker {
+    const struct ast *ast;
+    const struct sema *sema;
+    const struct token *tokens;
+    const struct number *numbers;
+    struct tagged *frame;
+    const struct str **strings;     /* per symbol, made on first use */
+    struct arena heap;
+    int stop;                       /* returned, or failed */
+    int status;
+};
+
+static double as_float(struct tagged t)
+{
+    return t.type == TYPE_INT ? (double) t.v.i : t.v.f;
+}
+
+static int truth(struct tagged t)
+{
+    return t.type == TYPE_INT ? t.v.i != 0 : t.v.f != 0;
+}
+
+static struct tagged make_int(int64_t i)
+{
+    struct tagged t;
+
+    t.type = TYPE_INT;
+    t.v.i = i;
+    return t;
+}
+
+static struct tagged make_float(double f)
+{
+    struct tagged t;
+
+    t.type = TYPE_FLOAT;
+    t.v.f = f;
+    return t;
+}
+
+static struct tagged eval(struct walker *w, uint32_t node);
+
+static struct tagged binary(struct walker *w, uint32_t node)
+{
+    const struct ast *ast = w->ast;
+    const struct token *tok = &w->tokens[ast->token[node]];
+    struct tagged l = eval(w, ast->child[node]);
+    struct tagged r = eval(w, ast->next[ast->child[node]]);
+    struct tagged t;
+    int ints = l.type == TYPE_INT && r.type == TYPE_INT;
+    int cmp;
+
+    if (w->stop)
+        return l;
+    if (l.type == TYPE_STRING) {
+        if (tok->kind == TOKEN_PLUS) {
+            t.type = TYPE_STRING;
+            t.v.s = str_concat(&w->heap, l.v.s, r.v.s);
+            return t;
+        }
+        cmp = str_compare(l.v.s, r.v.s);
+        cmp = (cmp > 0) - (cmp < 0);
+    } else if (ints) {
+        cmp = (l.v.i > r.v.i) - (l.v.i < r.v.i);
+    } else {
+        cmp = (as_float(l) > as_float(r)) - (as_float(l) < as_float(r));
+        /* NaN is neither */
+        if (as_float(l) != as_float(r) && !cmp)
+            cmp = 2;
+    }
+    switch (tok->kind) {
+    case TOKEN_PLUS:
+        return ints ? make_int(int_add(l.v.i, r.v.i))
+                    : make_float(as_float(l) + as_float(r));
+    case TOKEN_MINUS:
+        return ints ? make_int(int_sub(l.v.i, r.v.i))
+                    : make_float(as_float(l) - as_float(r));
+    case TOKEN_MUL:
+        return ints ? make_int(int_mul(l.v.i, r.v.i))
+                    : make_float(as_float(l) * as_float(r));
+    case TOKEN_DIV:
+        if (!ints)
+            return make_float(as_float(l) / as_float(r));
+        if (r.v.i == 0) {
+            diag_error(tok->offset, "division by zero");
+            w->stop = 1;
+            w->status = 1;
+            return l;
+        }
+        return make_int(int_div(l.v.i, r.v.i));
+    case TOKEN_EQ:
+        return make_int(cmp == 0);
+    case TOKEN_NEQ:
+        return make_int(cmp != 0);
+    case TOKEN_LT:
+        return make_int(cmp == -1);
+    case TOKEN_LTE:
+        return make_int(cmp == -1 || cmp == 0);
+    case TOKEN_GT:
+        return make_int(cmp == 1);
+    default:
+        return make_int(cmp == 1 || cmp == 0);
+    }
+}
+
+static struct tagged eval(struct walker *w, uint32_t node)
+{
+    const struct ast *ast = w->ast;
+    const struct token *tok = &w->tokens[ast->token[node]];
+    struct tagged t;
+
+    switch (ast->kind[node]) {
+    case AST_NAME:
+        return w->frame[w->sema->slot[node]];
+    case AST_NUMBER:
+        if (w->numbers[tok->value].type == NUMBER_FLOAT)
+            return make_float(w->numbers[tok->value].as.f);
+        return make_int(w->numbers[tok->value].as.i);
+    case AST_STRING:
+        if (!w->strings[tok->value]) {
+            size_t len;
+            const char *text = symbol_name(tok->value, &len);
+
+            w->strings[tok->value] = str_make(&w->heap, text, len);
+        }
+        t.type = TYPE_STRING;
+        t.v.s = w->strings[tok->value];
+        return t;
+    case AST_NEG:
+        t = eval(w, ast->child[node]);
+        if (t.type == TYPE_INT)
+            t.v.i = int_neg(t.v.i);
+        else
+            t.v.f = -t.v.f;
+        return t;
+    default:
+        return binary(w, node);
+    }
+}
+
+/* Store `value` in the variable of slot `slot` and type `type`. */
+static void store(struct walker *w, uint32_t slot, enum type type,
+                  uint32_t value)
+{
+    struct tagged t = eval(w, value);
+
+    if (t.type != (uint32_t) type) {
+        if (type == TYPE_FLOAT)
+            t = make_float((double) t.v.i);
+        else
+            t = make_int(float_to_int(t.v.f));
+    }
+    w->frame[slot] = t;
+}
+
+static void exec(struct walker *w, uint32_t node)
+{
+    const struct ast *ast = w->ast;
+    const struct sema *sema = w->sema;
+    uint32_t child = ast->child[node];
+    uint32_t cond, step, body;
+    struct tagged t;
+
+    switch (ast->kind[node]) {
+    case AST_BLOCK:
+        for (; child && !w->stop; child = ast->next[child])
+            exec(w, child);
+        break;
+    case AST_DECL:
+        if (ast->next[child]) {
+            store(w, sema->slot[node], (enum type) sema->type[child],
+                  ast->next[child]);
+        } else {
+            t.type = sema->type[child];
+            t.v.i = 0;
+            if (t.type == TYPE_FLOAT)
+                t.v.f = 0.0;
+            else if (t.type == TYPE_STRING)
+                t.v.s = str_make(&w->heap, "", 0);
+            w->frame[sema->slot[node]] = t;
+        }
+        break;
+    case AST_ASSIGN:
+        store(w, sema->slot[child], (enum type) sema->type[child],
+              ast->next[child]);
+        break;
+    case AST_IF:
+        t = eval(w, child);
+        if (w->stop)
+            break;
+        if (truth(t))
+            exec(w, ast->next[child]);
+        else if (ast->next[ast->next[child]])
+            exec(w, ast->next[ast->next[child]]);
+        break;
+    case AST_WHILE:
+        for (;;) {
+            t = eval(w, child);
+            if (w->stop || !truth(t))
+                break;
+            exec(w, ast->next[child]);
+            if (w->stop)
+                break;
+        }
+        break;
+    case AST_FOR:
+        cond = ast->next[child];
+        step = ast->next[cond];
+        body = ast->next[step];
+        for (exec(w, child); !w->stop; exec(w, step)) {
+            if (ast->kind[cond] != AST_EMPTY) {
+                t = eval(w, cond);
+                if (w->stop || !truth(t))
+                    break;
+            }
+            exec(w, body);
+            if (w->stop)
+                break;
+        }
+        break;
+    case AST_PRINT:
+        t = eval(w, child);
+        if (w->stop)
+            break;
+        if (t.type == TYPE_INT)
+            print_int(t.v.i);
+        else if (t.type == TYPE_FLOAT)
+            print_float(t.v.f);
+        else
+            print_str(t.v.s);
+        break;
+    case AST_RETURN:
+        if (child)
+            eval(w, child);
+        w->stop = 1;
+        break;
+    case AST_EXPR:
+        eval(w, child);
+        break;
+    default:
+        break;
+    }
+}
+
+int walk_run(const struct ast *ast, const struct sema *sema)
+{
+    struct walker w;
+    uint32_t size = 0;
+    uint32_t node;
+
+    if (!ast->root)
+        return 0;
+    size = sema->slot[ast->root];
+    if (sema->main && sema->slot[sema->main] > size)
+        size = sema->slot[sema->main];
+    w.ast = ast;
+    w.sema = sema;
+    w.tokens = ast->tokens->data;
+    w.numbers = ast->tokens->numbers;
+    w.frame = xcalloc(size, sizeof *w.frame);
+    w.strings = xcalloc(symbol_count() + 1, sizeof *w.strings);
+    arena_init(&w.heap);
+    w.stop = 0;
+    w.status = 0;
+
+    for (node = ast->child[ast->root]; node && !w.stop;
+         node = ast->next[node])
+        if (ast->kind[node] != AST_FUNCTION)
+            exec(&w, node);
+    if (!w.status && sema->main) {
+        w.stop = 0;
+        exec(&w, ast->next[ast->child[sema->main]]);
+    }
+
+    arena_free(&w.heap);
+    free(w.strings);
+    free(w.frame);
+    return w.status;
+}
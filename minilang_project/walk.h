@@ -0,0 +1,18 @@
+#ifndef MINILANG_WALK_H
+#define MINILANG_WALK_H
+
+#include "ast.h"
+#include "check.h"
+
+/* Run a checked tree by walking it: the simplest interpreter there is,
+ * kept as the baseline the VM is measured against (--run=tree).
+ *
+ * Each node is evaluated by a recursive call that switches on its kind
+ * and returns the value with its type, which every operation then tests.
+ * Variables live in the slots the checker gave them, so no names are
+ * looked up.  It runs the same statements as vm_run() and prints the
+ * same output; a runtime error is reported through diag_error() and
+ * makes it return 1. */
+int walk_run(const struct ast *ast, const struct sema *sema);
+
+#endif
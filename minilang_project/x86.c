@@ -0,0 +1,1468 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_WHAT "native code"
+#include "alloc.h"
+
+#include "intern.h"
+#include "live.h"
+#include "moves.h"
+#include "x86.h"
+
+/* Registers by their number in the encoding; the xmm ones are numbered
+ * the same way, as registers of their own class. */
+enum {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+#define XMM14   14
+#define XMM15   15
+
+/* Condition codes, as the low nibble of jcc and setcc; one with its low
+ * bit flipped is its opposite. */
+enum {
+    CC_O, CC_NO, CC_B, CC_AE, CC_E, CC_NE, CC_BE, CC_A,
+    CC_S, CC_NS, CC_P, CC_NP, CC_L, CC_GE, CC_LE, CC_G,
+    CC_ALWAYS
+};
+
+/* The /digit of the arithmetic group: `op r64, r/m64` is ext * 8 + 3,
+ * `op r/m64, r64` ext * 8 + 1 and `op r/m64, imm` 0x81 or 0x83 /ext. */
+enum { ALU_ADD = 0, ALU_OR = 1, ALU_AND = 4, ALU_SUB = 5, ALU_CMP = 7 };
+
+/* The other half of a shift's opcode, 0xC1 /ext. */
+enum { SHIFT_SHL = 4, SHIFT_SHR = 5, SHIFT_SAR = 7 };
+
+/* What the code calls in the runtime, made undefined symbols on first use. */
+enum runtime {
+    RT_PRINT_INT,
+    RT_PRINT_FLOAT,
+    RT_PRINT_STR,
+    RT_STR_COMPARE,
+    RT_CONCAT,
+    RT_DIV_ZERO,
+    RT_COUNT
+};
+
+static const char *const runtime_names[RT_COUNT] = {
+    "print_int", "print_float", "print_str", "str_compare",
+    "minilang_concat", "minilang_div_zero"
+};
+
+/* Where a value is: a register of either class, a slot of the frame at
+ * disp from rbp, or, for a constant, wherever its instruction says (an
+ * immediate, or .rodata at disp once it is put there). */
+enum loc_kind { LOC_NONE, LOC_GPR, LOC_XMM, LOC_STACK, LOC_CONST, LOC_RODATA };
+
+struct loc {
+    uint8_t kind;
+    uint8_t reg;
+    int32_t disp;
+    uint32_t value;         /* the constant's instruction */
+};
+
+/* A jump to a block, its rel32 at `at` set once every block has its place. */
+struct fixup {
+    uint32_t at;
+    uint32_t block;
+};
+
+/* A conditional jump to the copies of an edge, laid out after the rest. */
+struct trampoline {
+    uint32_t at;
+    uint32_t from;
+    uint32_t to;
+};
+
+/* A jump to the call that reports a division by zero at `offset`. */
+struct stub {
+    uint32_t at;
+    uint32_t offset;
+};
+
+/* A group of values that share a register, from where it is first used
+ * to where it is last. */
+struct interval {
+    struct live_interval live;
+    unsigned char is_float;
+    unsigned char crosses;  /* a call between lo and hi */
+};
+
+struct x86 {
+    struct elf_object *obj;
+    struct elf_bytes *text;
+    const char *path;
+    struct line_index *lines;
+    struct x86_stats *stats;
+    const struct ir_func *f;
+    const struct live *live;
+    struct loc *loc;                /* of each value */
+    uint32_t *start;                /* of each block in .text */
+    uint32_t runtime[RT_COUNT];     /* symbol + 1, 0 until called */
+    uint32_t *strings;              /* .rodata offset + 1, by symbol */
+    uint64_t *float_bits;           /* constants in .rodata, hashed */
+    uint32_t *float_at;             /* offset + 1 of each, 0 for none */
+    uint32_t float_size;            /* a power of two */
+    uint32_t float_count;
+    uint32_t sign_mask;             /* offset + 1 */
+    struct fixup *fixups;
+    uint32_t fixup_count;
+    uint32_t fixup_capacity;
+    struct moves moves;
+    struct trampoline *trampolines;
+    uint32_t trampoline_count;
+    uint32_t trampoline_capacity;
+    struct stub *stubs;
+    uint32_t stub_count;
+    uint32_t stub_capacity;
+    uint32_t *calls;                /* positions, in order */
+    uint32_t call_count;
+    uint32_t call_capacity;
+    uint32_t *slot_hi;              /* where each slot's value ends */
+    uint32_t slot_count;
+    uint32_t slot_capacity;
+    unsigned char saved[5];         /* callee-saved registers used */
+    uint32_t saved_count;
+};
+
+static const unsigned char caller_saved[] = {RSI, RDI, R8, R9, R10};
+static const unsigned char callee_saved[] = {RBX, R12, R13, R14, R15};
+
+/* ---- encoding ---- */
+
+static uint32_t here(const struct x86 *c)
+{
+    return (uint32_t) c->text->len;
+}
+
+static void byte(struct x86 *c, unsigned v)
+{
+    unsigned char b = (unsigned char) v;
+
+    elf_put(c->text, &b, 1);
+}
+
+static void put_le32(struct elf_bytes *b, uint32_t v)
+{
+    unsigned char bytes[4];
+    int i;
+
+    for (i = 0; i < 4; i++)
+        bytes[i] = (unsigned char) (v >> 8 * i);
+    elf_put(b, bytes, 4);
+}
+
+static void put_le64(struct elf_bytes *b, uint64_t v)
+{
+    put_le32(b, (uint32_t) v);
+    put_le32(b, (uint32_t) (v >> 32));
+}
+
+static void imm32(struct x86 *c, uint32_t v)
+{
+    put_le32(c->text, v);
+}
+
+static void patch32(struct x86 *c, uint32_t at, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < 4; i++)
+        c->text->data[at + i] = (unsigned char) (v >> 8 * i);
+}
+
+static struct loc gpr(unsigned r)
+{
+    struct loc l = {LOC_GPR, (uint8_t) r, 0, 0};
+
+    return l;
+}
+
+static struct loc xmm(unsigned r)
+{
+    struct loc l = {LOC_XMM, (uint8_t) r, 0, 0};
+
+    return l;
+}
+
+static int same(struct loc x, struct loc y)
+{
+    if (x.kind != y.kind)
+        return 0;
+    if (x.kind == LOC_GPR || x.kind == LOC_XMM)
+        return x.reg == y.reg;
+    if (x.kind == LOC_STACK)
+        return x.disp == y.disp;
+    return x.kind == LOC_CONST && x.value == y.value;
+}
+
+/* An instruction with a ModRM operand: a `prefix` (0x66, 0xF2, 0xF3 or
+ * none), REX.W if `w`, the opcode (two bytes if it starts with 0x0F),
+ * `reg` in the reg field and `rm` the other operand, a register, a slot
+ * of the frame or .rodata.  `imm` is how many bytes of immediate the
+ * caller puts after it, which a reference to .rodata has to allow for. */
+static void op_rm(struct x86 *c, unsigned prefix, int w, unsigned opcode,
+                  unsigned reg, struct loc rm, unsigned imm)
+{
+    unsigned rex = 0x40 | (w ? 8 : 0) | (reg & 8) >> 1;
+
+    if (rm.kind == LOC_GPR || rm.kind == LOC_XMM)
+        rex |= (rm.reg & 8) >> 3;
+    if (prefix)
+        byte(c, prefix);
+    if (rex != 0x40)
+        byte(c, rex);
+    if (opcode > 0xFF)
+        byte(c, opcode >> 8);
+    byte(c, opcode & 0xFF);
+    switch (rm.kind) {
+    case LOC_GPR:
+    case LOC_XMM:
+        byte(c, 0xC0 | (reg & 7) << 3 | (rm.reg & 7));
+        break;
+    case LOC_STACK:
+        if (rm.disp == (int8_t) rm.disp) {
+            byte(c, 0x45 | (reg & 7) << 3);
+            byte(c, (unsigned) rm.disp);
+        } else {
+            byte(c, 0x85 | (reg & 7) << 3);
+            imm32(c, (uint32_t) rm.disp);
+        }
+        break;
+    default:
+        /* rip-relative; rip is past the immediate by then */
+        byte(c, 0x05 | (reg & 7) << 3);
+        elf_reloc(c->obj, here(c), ELF_RODATA_SYMBOL, ELF_R_PC32,
+                  (int64_t) rm.disp - 4 - imm);
+        imm32(c, 0);
+        break;
+    }
+}
+
+static void call(struct x86 *c, enum runtime rt)
+{
+    if (!c->runtime[rt])
+        c->runtime[rt] = elf_symbol(c->obj, runtime_names[rt],
+                                    strlen(runtime_names[rt]), ELF_UNDEF, 0,
+                                    1, 0) + 1;
+    byte(c, 0xE8);
+    elf_reloc(c->obj, here(c), c->runtime[rt] - 1, ELF_R_PLT32, -4);
+    imm32(c, 0);
+}
+
+/* A jump to a block: short if it is back to one already placed and near,
+ * else with a rel32 set later. */
+static void jump(struct x86 *c, unsigned cc, uint32_t block)
+{
+    int64_t rel;
+
+    if (c->start[block] != UINT32_MAX) {
+        rel = (int64_t) c->start[block] - (here(c) + 2);
+        if (rel == (int8_t) rel) {
+            byte(c, cc == CC_ALWAYS ? 0xEB : 0x70 + cc);
+            byte(c, (unsigned) rel);
+            return;
+        }
+    }
+    if (cc == CC_ALWAYS) {
+        byte(c, 0xE9);
+    } else {
+        byte(c, 0x0F);
+        byte(c, 0x80 + cc);
+    }
+    if (c->fixup_count == c->fixup_capacity) {
+        c->fixup_capacity = c->fixup_capacity ? c->fixup_capacity * 2 : 64;
+        c->fixups = xrealloc(c->fixups,
+                             c->fixup_capacity * sizeof *c->fixups);
+    }
+    c->fixups[c->fixup_count].at = here(c);
+    c->fixups[c->fixup_count++].block = block;
+    imm32(c, 0);
+}
+
+/* A short jump forward within an instruction's code, and its target. */
+static uint32_t jump8(struct x86 *c, unsigned cc)
+{
+    byte(c, cc == CC_ALWAYS ? 0xEB : 0x70 + cc);
+    byte(c, 0);
+    return here(c);
+}
+
+static void land8(struct x86 *c, uint32_t at)
+{
+    c->text->data[at - 1] = (unsigned char) (here(c) - at);
+}
+
+/* A jump to the report of a division by zero at `offset`. */
+static void fail(struct x86 *c, unsigned cc, uint32_t offset)
+{
+    if (cc == CC_ALWAYS) {
+        byte(c, 0xE9);
+    } else {
+        byte(c, 0x0F);
+        byte(c, 0x80 + cc);
+    }
+    if (c->stub_count == c->stub_capacity) {
+        c->stub_capacity = c->stub_capacity ? c->stub_capacity * 2 : 16;
+        c->stubs = xrealloc(c->stubs, c->stub_capacity * sizeof *c->stubs);
+    }
+    c->stubs[c->stub_count].at = here(c);
+    c->stubs[c->stub_count++].offset = offset;
+    imm32(c, 0);
+}
+
+static void shift(struct x86 *c, unsigned ext, unsigned r, unsigned count)
+{
+    op_rm(c, 0, 1, 0xC1, ext, gpr(r), 1);
+    byte(c, count);
+}
+
+/* ---- constants ---- */
+
+static uint64_t hash_bits(uint64_t key)
+{
+    key *= UINT64_C(0x9E3779B97F4A7C15);
+    return key ^ key >> 29;
+}
+
+static void grow_floats(struct x86 *c)
+{
+    uint32_t size = c->float_size ? c->float_size * 2 : 64;
+    uint64_t *bits = xrealloc(NULL, size * sizeof *bits);
+    uint32_t *at = xrealloc(NULL, size * sizeof *at);
+    uint32_t i, k;
+
+    memset(at, 0, size * sizeof *at);
+    for (i = 0; i < c->float_size; i++) {
+        if (!c->float_at[i])
+            continue;
+        for (k = (uint32_t) hash_bits(c->float_bits[i]) & (size - 1); at[k];
+             k = (k + 1) & (size - 1))
+            ;
+        bits[k] = c->float_bits[i];
+        at[k] = c->float_at[i];
+    }
+    free(c->float_bits);
+    free(c->float_at);
+    c->float_bits = bits;
+    c->float_at = at;
+    c->float_size = size;
+}
+
+static struct loc rodata(uint32_t offset)
+{
+    struct loc l = {LOC_RODATA, 0, (int32_t) offset, 0};
+
+    return l;
+}
+
+/* A float constant in .rodata, each distinct one put there once. */
+static struct loc float_const(struct x86 *c, uint64_t bits)
+{
+    uint32_t i;
+
+    if (2 * (c->float_count + 1) > c->float_size)
+        grow_floats(c);
+    for (i = (uint32_t) hash_bits(bits) & (c->float_size - 1);
+         c->float_at[i]; i = (i + 1) & (c->float_size - 1))
+        if (c->float_bits[i] == bits)
+            return rodata(c->float_at[i] - 1);
+    c->float_bits[i] = bits;
+    c->float_at[i] = (uint32_t) elf_align(&c->obj->rodata, 8, 0) + 1;
+    c->float_count++;
+    put_le64(&c->obj->rodata, bits);
+    return rodata(c->float_at[i] - 1);
+}
+
+/* A string constant as a struct str (runtime.h) in .rodata. */
+static struct loc string_const(struct x86 *c, uint32_t symbol)
+{
+    const char *text;
+    size_t len;
+
+    if (!c->strings[symbol]) {
+        text = symbol_name(symbol, &len);
+        c->strings[symbol] = (uint32_t) elf_align(&c->obj->rodata, 4, 0) + 1;
+        put_le32(&c->obj->rodata, (uint32_t) len);
+        elf_put(&c->obj->rodata, text, len);
+    }
+    return rodata(c->strings[symbol] - 1);
+}
+
+/* What xorpd flips to negate a float: the sign of the low one of two. */
+static struct loc sign_mask(struct x86 *c)
+{
+    if (!c->sign_mask) {
+        c->sign_mask = (uint32_t) elf_align(&c->obj->rodata, 16, 0) + 1;
+        put_le64(&c->obj->rodata, UINT64_C(1) << 63);
+        put_le64(&c->obj->rodata, 0);
+    }
+    return rodata(c->sign_mask - 1);
+}
+
+static uint64_t bits_of(const struct x86 *c, struct loc l)
+{
+    return ir_const_bits(c->f, l.value);
+}
+
+/* Whether `l` is an int constant that fits a sign-extended imm32. */
+static int is_imm32(const struct x86 *c, struct loc l, int32_t *imm)
+{
+    int64_t v;
+
+    if (l.kind != LOC_CONST || c->f->type[l.value] != TYPE_INT)
+        return 0;
+    v = (int64_t) bits_of(c, l);
+    *imm = (int32_t) v;
+    return v == *imm;
+}
+
+/* ---- moves ---- */
+
+/* Never by xor, which would change the flags a branch is about to test. */
+static void mov_imm(struct x86 *c, unsigned r, uint64_t v)
+{
+    if (v <= UINT32_MAX) {
+        if (r & 8)
+            byte(c, 0x41);
+        byte(c, 0xB8 + (r & 7));
+        imm32(c, (uint32_t) v);
+    } else if ((int64_t) v == (int32_t) v) {
+        op_rm(c, 0, 1, 0xC7, 0, gpr(r), 4);
+        imm32(c, (uint32_t) v);
+    } else {
+        byte(c, 0x48 | (r & 8) >> 3);
+        byte(c, 0xB8 + (r & 7));
+        put_le64(c->text, v);
+    }
+}
+
+/* An int or string value into general register r. */
+static void load(struct x86 *c, unsigned r, struct loc src)
+{
+    if (src.kind == LOC_GPR && src.reg == r)
+        return;
+    if (src.kind != LOC_CONST)
+        op_rm(c, 0, 1, 0x8B, r, src, 0);
+    else if (c->f->type[src.value] == TYPE_STRING)
+        op_rm(c, 0, 1, 0x8D, r, string_const(c, c->f->a[src.value]), 0);
+    else
+        mov_imm(c, r, bits_of(c, src));
+}
+
+static void store(struct x86 *c, struct loc dst, unsigned r)
+{
+    if (!(dst.kind == LOC_GPR && dst.reg == r))
+        op_rm(c, 0, 1, 0x89, r, dst, 0);
+}
+
+/* A float operand as the r/m of an instruction. */
+static struct loc float_rm(struct x86 *c, struct loc l)
+{
+    return l.kind == LOC_CONST ? float_const(c, bits_of(c, l)) : l;
+}
+
+/* An int operand as the r/m of an instruction: itself, or a constant
+ * loaded into `scratch`. */
+static struct loc int_rm(struct x86 *c, struct loc l, unsigned scratch)
+{
+    if (l.kind != LOC_CONST)
+        return l;
+    load(c, scratch, l);
+    return gpr(scratch);
+}
+
+static void loadf(struct x86 *c, unsigned x, struct loc src)
+{
+    if (src.kind == LOC_XMM) {
+        if (src.reg != x)
+            op_rm(c, 0x66, 0, 0x0F28, x, src, 0);          /* movapd */
+    } else {
+        op_rm(c, 0xF2, 0, 0x0F10, x, float_rm(c, src), 0); /* movsd */
+    }
+}
+
+static void storef(struct x86 *c, struct loc dst, unsigned x)
+{
+    if (dst.kind == LOC_XMM) {
+        if (dst.reg != x)
+            op_rm(c, 0x66, 0, 0x0F28, dst.reg, xmm(x), 0);
+    } else {
+        op_rm(c, 0xF2, 0, 0x0F11, x, dst, 0);
+    }
+}
+
+/* One copy, through r11 or xmm14 from a slot to another. */
+static void move(struct x86 *c, struct loc dst, struct loc src, int is_float)
+{
+    int32_t k;
+
+    if (same(dst, src))
+        return;
+    if (is_float) {
+        if (dst.kind == LOC_XMM) {
+            loadf(c, dst.reg, src);
+        } else if (src.kind == LOC_XMM) {
+            storef(c, dst, src.reg);
+        } else {
+            loadf(c, XMM14, src);
+            storef(c, dst, XMM14);
+        }
+    } else if (dst.kind == LOC_GPR) {
+        load(c, dst.reg, src);
+    } else if (src.kind == LOC_GPR) {
+        store(c, dst, src.reg);
+    } else if (is_imm32(c, src, &k)) {
+        op_rm(c, 0, 1, 0xC7, 0, dst, 4);
+        imm32(c, (uint32_t) k);
+    } else {
+        load(c, R11, src);
+        store(c, dst, R11);
+    }
+}
+
+/* ---- registers ---- */
+
+/* Whether a call is made strictly between lo and hi: what is live across
+ * it, neither an argument nor the result, has to survive it. */
+static int crosses_call(const struct x86 *c, uint32_t lo, uint32_t hi)
+{
+    uint32_t first = 0, last = c->call_count, mid;
+
+    while (first < last) {
+        mid = first + (last - first) / 2;
+        if (c->calls[mid] <= lo)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return first < c->call_count && c->calls[first] < hi;
+}
+
+/* Whether the instruction calls into the runtime. */
+static int is_call(const struct ir_func *f, uint32_t insn)
+{
+    enum ir_op op = (enum ir_op) f->op[insn];
+
+    if (op == IR_PRINT)
+        return 1;
+    if (op == IR_ADD)
+        return f->type[insn] == TYPE_STRING;
+    return op >= IR_EQ && op <= IR_GE && f->type[f->a[insn]] == TYPE_STRING;
+}
+
+static struct loc spill(struct x86 *c, uint32_t lo, uint32_t hi)
+{
+    struct loc l = {LOC_STACK, 0, 0, 0};
+    uint32_t k;
+
+    for (k = 0; k < c->slot_count; k++)
+        if (c->slot_hi[k] <= lo)
+            break;
+    if (k == c->slot_count) {
+        if (c->slot_count == c->slot_capacity) {
+            c->slot_capacity = c->slot_capacity ? c->slot_capacity * 2 : 16;
+            c->slot_hi = xrealloc(c->slot_hi,
+                                  c->slot_capacity * sizeof *c->slot_hi);
+        }
+        c->slot_count++;
+    }
+    c->slot_hi[k] = hi;
+    l.disp = -8 * (int32_t) (k + 1);
+    c->stats->spilled++;
+    return l;
+}
+
+/* Linear scan (Poletto and Sarkar) over the groups of the frame by where
+ * they start, each taking the first register of its pool that is free
+ * again: the caller-saved ones first, for they cost nothing to use, and
+ * only the callee-saved ones for a group live across a call.  With none
+ * free, whichever of it and the group holding one ends last goes to a
+ * slot of the frame.  A float live across a call always does. */
+static void allocate(struct x86 *c, const struct live *l,
+                     const struct live_groups *g)
+{
+    const struct ir_func *f = c->f;
+    struct interval *items = xrealloc(NULL, f->count * sizeof *items);
+    uint32_t owner[32] = {0};       /* interval + 1, xmm from 16 */
+    unsigned char pool[16];
+    uint32_t n = 0, i, k, v, block, insn, count, victim;
+    unsigned used = 0, r;
+
+    c->call_count = 0;
+    for (block = IR_ENTRY; block; block = f->blocks[block].next) {
+        for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+            if (!is_call(f, insn))
+                continue;
+            if (c->call_count == c->call_capacity) {
+                c->call_capacity = c->call_capacity
+                                   ? c->call_capacity * 2 : 64;
+                c->calls = xrealloc(c->calls,
+                                    c->call_capacity * sizeof *c->calls);
+            }
+            c->calls[c->call_count++] = l->pos[insn];
+        }
+    }
+    for (v = 0; v < f->count; v++) {
+        c->loc[v].kind = LOC_NONE;
+        if (!f->block[v] || f->op[v] >= IR_PRINT)
+            continue;
+        if (f->op[v] == IR_CONST) {
+            c->loc[v].kind = LOC_CONST;
+            c->loc[v].value = v;
+            continue;
+        }
+        if (g->leader[v] != v)
+            continue;
+        items[n].live.lo = g->lo[v];
+        items[n].live.hi = g->hi[v];
+        items[n].live.value = v;
+        items[n].is_float = f->type[v] == TYPE_FLOAT;
+        items[n].crosses = crosses_call(c, g->lo[v], g->hi[v]);
+        n++;
+    }
+
+    c->slot_count = 0;
+    qsort(items, n, sizeof *items, live_by_lo);
+    for (i = 0; i < n; i++) {
+        struct interval *it = &items[i];
+
+        if (it->is_float) {
+            count = it->crosses ? 0 : 14;
+            for (k = 0; k < count; k++)
+                pool[k] = (unsigned char) (16 + k);
+        } else if (it->crosses) {
+            count = sizeof callee_saved;
+            memcpy(pool, callee_saved, count);
+        } else {
+            count = sizeof caller_saved + sizeof callee_saved;
+            memcpy(pool, caller_saved, sizeof caller_saved);
+            memcpy(pool + sizeof caller_saved, callee_saved,
+                   sizeof callee_saved);
+        }
+        for (k = 0; k < count; k++)
+            if (!owner[pool[k]] ||
+                items[owner[pool[k]] - 1].live.hi <= it->live.lo)
+                break;
+        if (k == count && count) {
+            /* none free: the one that ends last gives its up */
+            for (victim = k = 0; k < count; k++)
+                if (items[owner[pool[k]] - 1].live.hi >
+                    items[owner[pool[victim]] - 1].live.hi)
+                    victim = k;
+            k = victim;
+            victim = owner[pool[k]] - 1;
+            if (items[victim].live.hi > it->live.hi)
+                c->loc[items[victim].live.value] =
+                    spill(c, items[victim].live.lo, items[victim].live.hi);
+            else
+                k = count;
+        }
+        if (k == count) {
+            c->loc[it->live.value] = spill(c, it->live.lo, it->live.hi);
+            continue;
+        }
+        r = pool[k];
+        owner[r] = i + 1;
+        c->loc[it->live.value] = r < 16 ? gpr(r) : xmm(r - 16);
+        if (r < 16)
+            used |= 1u << r;
+    }
+    free(items);
+
+    for (v = 0; v < f->count; v++)
+        if (f->block[v] && f->op[v] < IR_PRINT && f->op[v] != IR_CONST)
+            c->loc[v] = c->loc[g->leader[v]];
+    c->saved_count = 0;
+    for (k = 0; k < sizeof callee_saved; k++)
+        if (used & 1u << callee_saved[k])
+            c->saved[c->saved_count++] = callee_saved[k];
+}
+
+/* ---- code ---- */
+
+/* Flags by `op left, right` (ALU_*): a register or a slot on the left, and
+ * on the right whatever fits, with a constant as an immediate if it can
+ * be one. */
+static void alu(struct x86 *c, unsigned ext, struct loc left,
+                struct loc right)
+{
+    int32_t k;
+
+    if (is_imm32(c, right, &k)) {
+        if (ext == ALU_CMP && k == 0 && left.kind == LOC_GPR) {
+            op_rm(c, 0, 1, 0x85, left.reg, left, 0);    /* test r, r */
+        } else if (k == (int8_t) k) {
+            op_rm(c, 0, 1, 0x83, ext, left, 1);
+            byte(c, (unsigned) k);
+        } else {
+            op_rm(c, 0, 1, 0x81, ext, left, 4);
+            imm32(c, (uint32_t) k);
+        }
+    } else if (left.kind == LOC_GPR) {
+        op_rm(c, 0, 1, ext * 8 + 3, left.reg, int_rm(c, right, RCX), 0);
+    } else {
+        if (right.kind != LOC_GPR) {
+            load(c, RCX, right);
+            right = gpr(RCX);
+        }
+        op_rm(c, 0, 1, ext * 8 + 1, right.reg, left, 0);
+    }
+}
+
+static void int_binary(struct x86 *c, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+    enum ir_op op = (enum ir_op) f->op[insn];
+    struct loc dst = c->loc[insn], a = c->loc[f->a[insn]];
+    struct loc b = c->loc[f->b[insn]], t;
+    unsigned r = dst.kind == LOC_GPR ? dst.reg : RAX;
+    int32_t k;
+
+    /* a constant goes on the right, where it may be an immediate, and
+     * the result is not computed over the right operand */
+    if (op != IR_SUB && a.kind == LOC_CONST) {
+        t = a;
+        a = b;
+        b = t;
+    }
+    if (same(b, dst) && !same(a, dst)) {
+        if (op == IR_SUB) {
+            r = RAX;
+        } else {
+            t = a;
+            a = b;
+            b = t;
+        }
+    }
+    if (op == IR_MUL && is_imm32(c, b, &k)) {
+        op_rm(c, 0, 1, 0x69, r, int_rm(c, a, RAX), 4);  /* imul r, a, imm */
+        imm32(c, (uint32_t) k);
+        store(c, dst, r);
+        return;
+    }
+    load(c, r, a);
+    if (op == IR_ADD) {
+        alu(c, ALU_ADD, gpr(r), b);
+    } else if (op == IR_SUB) {
+        alu(c, ALU_SUB, gpr(r), b);
+    } else {
+        op_rm(c, 0, 1, 0x0FAF, r, int_rm(c, b, RCX), 0);
+    }
+    store(c, dst, r);
+}
+
+static void int_neg(struct x86 *c, uint32_t insn)
+{
+    struct loc dst = c->loc[insn];
+    unsigned r = dst.kind == LOC_GPR ? dst.reg : RAX;
+
+    load(c, r, c->loc[c->f->a[insn]]);
+    op_rm(c, 0, 1, 0xF7, 3, gpr(r), 0);
+    store(c, dst, r);
+}
+
+static void float_binary(struct x86 *c, uint32_t insn)
+{
+    static const unsigned char opcodes[IR_OP_COUNT] = {
+        [IR_ADD] = 0x58, [IR_SUB] = 0x5C, [IR_MUL] = 0x59, [IR_DIV] = 0x5E
+    };
+    const struct ir_func *f = c->f;
+    enum ir_op op = (enum ir_op) f->op[insn];
+    struct loc dst = c->loc[insn], a = c->loc[f->a[insn]];
+    struct loc b = c->loc[f->b[insn]], t;
+    unsigned x = dst.kind == LOC_XMM ? dst.reg : XMM15;
+
+    if (same(b, dst) && !same(a, dst)) {
+        if (op == IR_SUB || op == IR_DIV) {
+            x = XMM15;
+        } else {
+            t = a;
+            a = b;
+            b = t;
+        }
+    }
+    loadf(c, x, a);
+    op_rm(c, 0xF2, 0, 0x0F00 | opcodes[op], x, float_rm(c, b), 0);
+    storef(c, dst, x);
+}
+
+static void float_neg(struct x86 *c, uint32_t insn)
+{
+    struct loc dst = c->loc[insn];
+    unsigned x = dst.kind == LOC_XMM ? dst.reg : XMM15;
+
+    loadf(c, x, c->loc[c->f->a[insn]]);
+    op_rm(c, 0x66, 0, 0x0F57, x, sign_mask(c), 0);     /* xorpd */
+    storef(c, dst, x);
+}
+
+static void int_to_float(struct x86 *c, uint32_t insn)
+{
+    struct loc dst = c->loc[insn];
+    struct loc src = int_rm(c, c->loc[c->f->a[insn]], RAX);
+    unsigned x = dst.kind == LOC_XMM ? dst.reg : XMM15;
+
+    /* cvtsi2sd only writes the low half: clear the rest first, so as not
+     * to wait on what was there */
+    op_rm(c, 0x66, 0, 0x0F57, x, xmm(x), 0);
+    op_rm(c, 0xF2, 1, 0x0F2A, x, src, 0);
+    storef(c, dst, x);
+}
+
+/* float_to_int() without the call: cvttsd2si truncates, but makes
+ * INT64_MIN of whatever is out of range, NaN included.  NaN is made 0,
+ * and INT64_MIN from a positive float, which overflowed upwards, one
+ * less, INT64_MAX. */
+static void float_to_int(struct x86 *c, uint32_t insn)
+{
+    struct loc src = float_rm(c, c->loc[c->f->a[insn]]);
+
+    op_rm(c, 0xF2, 1, 0x0F2C, RAX, src, 0);             /* cvttsd2si */
+    op_rm(c, 0x66, 0, 0x0F57, XMM15, xmm(XMM15), 0);
+    op_rm(c, 0, 0, 0x31, RCX, gpr(RCX), 0);             /* xor ecx, ecx */
+    op_rm(c, 0x66, 0, 0x0F2E, XMM15, src, 0);           /* ucomisd 0, f */
+    op_rm(c, 0, 1, 0x0F40 | CC_P, RAX, gpr(RCX), 0);    /* NaN: 0 */
+    op_rm(c, 0, 0, 0x0F90 | CC_B, 0, gpr(RCX), 0);      /* cl = 0 < f */
+    op_rm(c, 0, 1, 0x8B, RDX, gpr(RAX), 0);
+    op_rm(c, 0, 1, 0xF7, 3, gpr(RDX), 0);               /* overflows for */
+    op_rm(c, 0, 0, 0x0F90 | CC_O, 0, gpr(RDX), 0);      /* INT64_MIN only */
+    op_rm(c, 0, 0, 0x22, RCX, gpr(RDX), 0);             /* and cl, dl */
+    op_rm(c, 0, 1, 0x2B, RAX, gpr(RCX), 0);
+    store(c, c->loc[insn], RAX);
+}
+
+/* The magic number and shift that divide by d, 2 or more, with a
+ * multiply (Hacker's Delight, 10-1). */
+static void magic(int64_t d, int64_t *m, unsigned *s)
+{
+    const uint64_t two63 = UINT64_C(1) << 63;
+    uint64_t ad = (uint64_t) d, anc = two63 - 1 - two63 % ad;
+    uint64_t q1 = two63 / anc, r1 = two63 - q1 * anc;
+    uint64_t q2 = two63 / ad, r2 = two63 - q2 * ad, delta;
+    unsigned p = 63;
+
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    *m = (int64_t) (q2 + 1);
+    *s = p - 64;
+}
+
+/* An int div or rem by a constant, which cannot overflow but by -1, nor
+ * fail but by 0: a shift for a power of two, a multiply for the other
+ * positive ones, idiv for the negative ones. */
+static void divide_const(struct x86 *c, uint32_t insn, int64_t d)
+{
+    const struct ir_func *f = c->f;
+    struct loc dst = c->loc[insn], a = c->loc[f->a[insn]];
+    int rem = f->op[insn] == IR_REM;
+    unsigned r = dst.kind == LOC_GPR ? dst.reg : RAX, k;
+    int64_t m;
+    int32_t imm;
+
+    if (d == 0) {
+        fail(c, CC_ALWAYS, f->offset[insn]);
+    } else if (d == 1 || d == -1) {
+        if (rem) {
+            mov_imm(c, r, 0);
+        } else {
+            load(c, r, a);
+            if (d == -1)
+                op_rm(c, 0, 1, 0xF7, 3, gpr(r), 0);
+        }
+        store(c, dst, r);
+    } else if (d > 0 && (d & (d - 1)) == 0) {
+        /* towards zero: add d - 1 to a negative a first */
+        for (k = 0; (UINT64_C(1) << k) != (uint64_t) d; k++)
+            ;
+        load(c, RAX, a);
+        op_rm(c, 0, 1, 0x8B, RDX, gpr(RAX), 0);
+        shift(c, SHIFT_SAR, RDX, 63);
+        shift(c, SHIFT_SHR, RDX, 64 - k);
+        if (rem) {
+            alu(c, ALU_ADD, gpr(RDX), gpr(RAX));
+            if (k <= 31) {
+                op_rm(c, 0, 1, 0x81, ALU_AND, gpr(RDX), 4);
+                imm32(c, (uint32_t) -d);
+            } else {
+                mov_imm(c, RCX, (uint64_t) -d);
+                alu(c, ALU_AND, gpr(RDX), gpr(RCX));
+            }
+            alu(c, ALU_SUB, gpr(RAX), gpr(RDX));
+        } else {
+            alu(c, ALU_ADD, gpr(RAX), gpr(RDX));
+            shift(c, SHIFT_SAR, RAX, k);
+        }
+        store(c, dst, RAX);
+    } else if (d > 0) {
+        magic(d, &m, &k);
+        load(c, RCX, a);
+        mov_imm(c, RAX, (uint64_t) m);
+        op_rm(c, 0, 1, 0xF7, 5, gpr(RCX), 0);           /* imul rcx */
+        if (m < 0)
+            alu(c, ALU_ADD, gpr(RDX), gpr(RCX));
+        if (k)
+            shift(c, SHIFT_SAR, RDX, k);
+        op_rm(c, 0, 1, 0x8B, RAX, gpr(RCX), 0);
+        shift(c, SHIFT_SHR, RAX, 63);
+        alu(c, ALU_ADD, gpr(RDX), gpr(RAX));
+        if (rem) {
+            imm = (int32_t) d;
+            if (imm == d) {
+                op_rm(c, 0, 1, 0x69, RDX, gpr(RDX), 4);
+                imm32(c, (uint32_t) imm);
+            } else {
+                mov_imm(c, RAX, (uint64_t) d);
+                op_rm(c, 0, 1, 0x0FAF, RDX, gpr(RAX), 0);
+            }
+            op_rm(c, 0, 1, 0x8B, RAX, gpr(RCX), 0);
+            alu(c, ALU_SUB, gpr(RAX), gpr(RDX));
+            store(c, dst, RAX);
+        } else {
+            store(c, dst, RDX);
+        }
+    } else {
+        load(c, RAX, a);
+        mov_imm(c, RCX, (uint64_t) d);
+        byte(c, 0x48);
+        byte(c, 0x99);                                  /* cqo */
+        op_rm(c, 0, 1, 0xF7, 7, gpr(RCX), 0);           /* idiv rcx */
+        store(c, dst, rem ? RDX : RAX);
+    }
+}
+
+/* An int div or rem as int_div() and int_rem() make it: 0 fails, both
+ * operands under 2^31 take a 32-bit div, -1 negates (or makes 0) and the
+ * rest take idiv. */
+static void divide(struct x86 *c, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+    int rem = f->op[insn] == IR_REM;
+    uint32_t wide, sign, done1, done2;
+
+    if (f->op[f->b[insn]] == IR_CONST) {
+        divide_const(c, insn, (int64_t) ir_const_bits(f, f->b[insn]));
+        return;
+    }
+    load(c, RCX, c->loc[f->b[insn]]);
+    op_rm(c, 0, 1, 0x85, RCX, gpr(RCX), 0);             /* test rcx, rcx */
+    fail(c, CC_E, f->offset[insn]);
+    load(c, RAX, c->loc[f->a[insn]]);
+    op_rm(c, 0, 1, 0x8B, RDX, gpr(RAX), 0);
+    alu(c, ALU_OR, gpr(RDX), gpr(RCX));
+    shift(c, SHIFT_SHR, RDX, 31);
+    wide = jump8(c, CC_NE);
+    op_rm(c, 0, 0, 0x31, RDX, gpr(RDX), 0);             /* xor edx, edx */
+    op_rm(c, 0, 0, 0xF7, 6, gpr(RCX), 0);               /* div ecx */
+    done1 = jump8(c, CC_ALWAYS);
+    land8(c, wide);
+    op_rm(c, 0, 1, 0x83, ALU_CMP, gpr(RCX), 1);
+    byte(c, 0xFF);
+    sign = jump8(c, CC_NE);
+    if (rem)
+        op_rm(c, 0, 0, 0x31, RDX, gpr(RDX), 0);
+    else
+        op_rm(c, 0, 1, 0xF7, 3, gpr(RAX), 0);           /* neg rax */
+    done2 = jump8(c, CC_ALWAYS);
+    land8(c, sign);
+    byte(c, 0x48);
+    byte(c, 0x99);                                      /* cqo */
+    op_rm(c, 0, 1, 0xF7, 7, gpr(RCX), 0);               /* idiv rcx */
+    land8(c, done1);
+    land8(c, done2);
+    store(c, c->loc[insn], rem ? RDX : RAX);
+}
+
+/* The two operands of a call into rdi and rsi, wherever they are. */
+static void arguments(struct x86 *c, struct loc a, struct loc b)
+{
+    if (!(a.kind == LOC_GPR && a.reg == RSI)) {
+        load(c, RSI, b);
+        load(c, RDI, a);
+    } else if (!(b.kind == LOC_GPR && b.reg == RDI)) {
+        load(c, RDI, a);
+        load(c, RSI, b);
+    } else {
+        op_rm(c, 0, 1, 0x87, RSI, gpr(RDI), 0);         /* xchg */
+    }
+}
+
+/* Flags for a compare; returns the condition on which it is true. */
+static unsigned compare(struct x86 *c, uint32_t insn)
+{
+    static const unsigned char int_cc[] = {
+        CC_E, CC_NE, CC_L, CC_LE, CC_G, CC_GE
+    };
+    static const unsigned char swapped_cc[] = {
+        CC_E, CC_NE, CC_G, CC_GE, CC_L, CC_LE
+    };
+    const struct ir_func *f = c->f;
+    enum ir_op op = (enum ir_op) f->op[insn];
+    struct loc a = c->loc[f->a[insn]], b = c->loc[f->b[insn]], t;
+    unsigned cc = int_cc[op - IR_EQ];
+
+    switch (f->type[f->a[insn]]) {
+    case TYPE_INT:
+        if (a.kind == LOC_CONST && b.kind != LOC_CONST) {
+            t = a;
+            a = b;
+            b = t;
+            cc = swapped_cc[op - IR_EQ];
+        }
+        if (a.kind == LOC_CONST) {
+            load(c, RAX, a);
+            a = gpr(RAX);
+        }
+        alu(c, ALU_CMP, a, b);
+        return cc;
+    case TYPE_FLOAT:
+        /* ucomisd is unordered for NaN, as if below and equal: only
+         * above and above-or-equal are false then, so < and <= swap */
+        if (op == IR_LT || op == IR_LE) {
+            t = a;
+            a = b;
+            b = t;
+        }
+        if (a.kind != LOC_XMM) {
+            loadf(c, XMM15, a);
+            a = xmm(XMM15);
+        }
+        op_rm(c, 0x66, 0, 0x0F2E, a.reg, float_rm(c, b), 0);
+        if (op == IR_GT || op == IR_LT)
+            return CC_A;
+        if (op == IR_GE || op == IR_LE)
+            return CC_AE;
+        if (op == IR_EQ) {
+            op_rm(c, 0, 0, 0x0F90 | CC_E, 0, gpr(RAX), 0);
+            op_rm(c, 0, 0, 0x0F90 | CC_NP, 0, gpr(RCX), 0);
+            op_rm(c, 0, 0, 0x22, RAX, gpr(RCX), 0);     /* and al, cl */
+        } else {
+            op_rm(c, 0, 0, 0x0F90 | CC_NE, 0, gpr(RAX), 0);
+            op_rm(c, 0, 0, 0x0F90 | CC_P, 0, gpr(RCX), 0);
+            op_rm(c, 0, 0, 0x0A, RAX, gpr(RCX), 0);     /* or al, cl */
+        }
+        op_rm(c, 0, 0, 0x84, RAX, gpr(RAX), 0);         /* test al, al */
+        return CC_NE;
+    default:
+        arguments(c, a, b);
+        call(c, RT_STR_COMPARE);
+        op_rm(c, 0, 0, 0x85, RAX, gpr(RAX), 0);         /* test eax, eax */
+        return cc;
+    }
+}
+
+/* Whether a compare is only tested by the branch right after it, which
+ * then makes it, and jumps on the flags. */
+static int fused(const struct x86 *c, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+    uint32_t next = f->next[insn];
+
+    return next && f->op[next] == IR_BR && f->a[next] == insn &&
+           c->live->uses[insn] == 1;
+}
+
+/* A compare made into 0 or 1. */
+static void set(struct x86 *c, uint32_t insn)
+{
+    struct loc dst = c->loc[insn];
+    unsigned r = dst.kind == LOC_GPR ? dst.reg : RAX;
+    unsigned cc = compare(c, insn);
+
+    op_rm(c, 0, 0, 0x0F90 | cc, 0, gpr(RAX), 0);        /* setcc al */
+    op_rm(c, 0, 0, 0x0FB6, r, gpr(RAX), 0);             /* movzx r32, al */
+    store(c, dst, r);
+}
+
+/* Flags for whether a value is not 0; returns the condition. */
+static unsigned test(struct x86 *c, uint32_t v)
+{
+    struct loc l = c->loc[v];
+
+    if (c->f->type[v] == TYPE_FLOAT) {
+        op_rm(c, 0x66, 0, 0x0F57, XMM15, xmm(XMM15), 0);
+        op_rm(c, 0x66, 0, 0x0F2E, XMM15, float_rm(c, l), 0);
+        op_rm(c, 0, 0, 0x0F90 | CC_NE, 0, gpr(RAX), 0);
+        op_rm(c, 0, 0, 0x0F90 | CC_P, 0, gpr(RCX), 0);
+        op_rm(c, 0, 0, 0x0A, RAX, gpr(RCX), 0);
+        op_rm(c, 0, 0, 0x84, RAX, gpr(RAX), 0);
+    } else if (l.kind == LOC_STACK) {
+        op_rm(c, 0, 1, 0x83, ALU_CMP, l, 1);
+        byte(c, 0);
+    } else {
+        l = int_rm(c, l, RAX);
+        op_rm(c, 0, 1, 0x85, l.reg, l, 0);
+    }
+    return CC_NE;
+}
+
+static void print(struct x86 *c, uint32_t insn)
+{
+    uint32_t a = c->f->a[insn];
+
+    switch (c->f->type[a]) {
+    case TYPE_INT:
+        load(c, RDI, c->loc[a]);
+        call(c, RT_PRINT_INT);
+        break;
+    case TYPE_FLOAT:
+        loadf(c, 0, c->loc[a]);
+        call(c, RT_PRINT_FLOAT);
+        break;
+    default:
+        load(c, RDI, c->loc[a]);
+        call(c, RT_PRINT_STR);
+        break;
+    }
+}
+
+/* Numbers for places, as moves.h takes them: what same() tells apart
+ * gets different numbers. */
+#define PLACE_XMM       16
+#define PLACE_STACK     32
+#define PLACE_VALUE     (UINT32_C(1) << 31)
+#define PLACE_SCRATCH   UINT32_MAX
+
+static uint32_t place(void *arg, uint32_t value)
+{
+    const struct x86 *c = arg;
+    struct loc l = c->loc[value];
+
+    switch (l.kind) {
+    case LOC_GPR:
+        return l.reg;
+    case LOC_XMM:
+        return PLACE_XMM + l.reg;
+    case LOC_STACK:
+        return PLACE_STACK + (uint32_t) -l.disp;
+    case LOC_CONST:
+        return PLACE_VALUE + l.value;
+    default:
+        return PLACE_VALUE + value;
+    }
+}
+
+/* The copies the phis of `to` take on the edge from `from`; returns how
+ * many there are, in c->moves. */
+static uint32_t edge_moves(struct x86 *c, uint32_t from, uint32_t to)
+{
+    return moves_edge(&c->moves, c->f, from, to, place, c);
+}
+
+/* A cycle of copies is broken through rax or xmm15. */
+static void emit_move(void *arg, const struct move *m)
+{
+    struct x86 *c = arg;
+    int is_float = c->f->type[m->to] == TYPE_FLOAT;
+    struct loc scratch = is_float ? xmm(XMM15) : gpr(RAX);
+
+    move(c, m->dst == PLACE_SCRATCH ? scratch : c->loc[m->to],
+         m->src == PLACE_SCRATCH ? scratch : c->loc[m->from], is_float);
+}
+
+/* The copies in c->moves, made one at a time as if all at once (see
+ * moves.h). */
+static void emit_moves(struct x86 *c)
+{
+    moves_emit(&c->moves, PLACE_SCRATCH, emit_move, c);
+}
+
+/* The copies of the edge and the jump along it, which is not needed to
+ * the block laid out next. */
+static void edge(struct x86 *c, uint32_t from, uint32_t to)
+{
+    edge_moves(c, from, to);
+    emit_moves(c);
+    if (c->f->blocks[from].next != to)
+        jump(c, CC_ALWAYS, to);
+}
+
+/* As in the bytecode: one edge falls through, or goes on after its
+ * copies; the other is taken by the conditional jump, which goes through
+ * a trampoline if both have copies.  Copies are movs, which leave the
+ * flags alone. */
+static void branch(struct x86 *c, uint32_t block, uint32_t insn)
+{
+    const struct ir_func *f = c->f;
+    const struct ir_block *b = &f->blocks[block];
+    uint32_t cond = f->a[insn];
+    uint32_t next = b->next, yes = b->succ[0], no = b->succ[1];
+    int yes_moves = edge_moves(c, block, yes) != 0;
+    int no_moves = edge_moves(c, block, no) != 0;
+    unsigned cc = f->op[cond] >= IR_EQ && f->op[cond] <= IR_GE &&
+                  fused(c, cond) ? compare(c, cond) : test(c, cond);
+
+    c->moves.count = 0;
+    if (!yes_moves && !no_moves) {
+        if (yes == next) {
+            jump(c, cc ^ 1, no);
+        } else {
+            jump(c, cc, yes);
+            if (no != next)
+                jump(c, CC_ALWAYS, no);
+        }
+    } else if (!no_moves) {
+        jump(c, cc ^ 1, no);
+        edge(c, block, yes);
+    } else if (!yes_moves) {
+        jump(c, cc, yes);
+        edge(c, block, no);
+    } else {
+        if (c->trampoline_count == c->trampoline_capacity) {
+            c->trampoline_capacity = c->trampoline_capacity
+                                     ? c->trampoline_capacity * 2 : 16;
+            c->trampolines = xrealloc(c->trampolines,
+                                      c->trampoline_capacity *
+                                      sizeof *c->trampolines);
+        }
+        byte(c, 0x0F);
+        byte(c, 0x80 + cc);
+        c->trampolines[c->trampoline_count].at = here(c);
+        c->trampolines[c->trampoline_count].from = block;
+        c->trampolines[c->trampoline_count++].to = yes;
+        imm32(c, 0);
+        edge(c, block, no);
+    }
+}
+
+/* The callee-saved registers the frame uses go above its slots. */
+static struct loc saved_slot(const struct x86 *c, uint32_t k)
+{
+    struct loc l = {LOC_STACK, 0, 0, 0};
+
+    l.disp = -8 * (int32_t) (c->slot_count + k + 1);
+    return l;
+}
+
+static void prologue(struct x86 *c)
+{
+    uint32_t size = 8 * (c->slot_count + c->saved_count), k;
+
+    size = (size + 15) & ~15u;
+    byte(c, 0x55);                                      /* push rbp */
+    op_rm(c, 0, 1, 0x89, RSP, gpr(RBP), 0);             /* mov rbp, rsp */
+    if (size) {
+        op_rm(c, 0, 1, 0x81, ALU_SUB, gpr(RSP), 4);
+        imm32(c, size);
+    }
+    for (k = 0; k < c->saved_count; k++)
+        store(c, saved_slot(c, k), c->saved[k]);
+}
+
+static void epilogue(struct x86 *c)
+{
+    uint32_t k;
+
+    for (k = 0; k < c->saved_count; k++)
+        load(c, c->saved[k], saved_slot(c, k));
+    byte(c, 0xC9);                                      /* leave */
+    byte(c, 0xC3);                                      /* ret */
+}
+
+static void block_code(struct x86 *c, uint32_t block)
+{
+    const struct ir_func *f = c->f;
+    uint32_t insn;
+    int is_float;
+
+    c->start[block] = here(c);
+    for (insn = f->blocks[block].first; insn; insn = f->next[insn]) {
+        is_float = f->type[insn] == TYPE_FLOAT;
+        switch (f->op[insn]) {
+        case IR_CONST:
+        case IR_PHI:
+            break;
+        case IR_COPY:
+            move(c, c->loc[insn], c->loc[f->a[insn]], is_float);
+            break;
+        case IR_I2F:
+            int_to_float(c, insn);
+            break;
+        case IR_F2I:
+            float_to_int(c, insn);
+            break;
+        case IR_NEG:
+            if (is_float)
+                float_neg(c, insn);
+            else
+                int_neg(c, insn);
+            break;
+        case IR_ADD:
+            if (f->type[insn] == TYPE_STRING) {
+                arguments(c, c->loc[f->a[insn]], c->loc[f->b[insn]]);
+                call(c, RT_CONCAT);
+                store(c, c->loc[insn], RAX);
+                break;
+            }
+            /* fall through */
+        case IR_SUB:
+        case IR_MUL:
+            if (is_float)
+                float_binary(c, insn);
+            else
+                int_binary(c, insn);
+            break;
+        case IR_DIV:
+        case IR_REM:
+            if (is_float)
+                float_binary(c, insn);
+            else
+                divide(c, insn);
+            break;
+        case IR_PRINT:
+            print(c, insn);
+            break;
+        case IR_JMP:
+            edge(c, block, f->blocks[block].succ[0]);
+            break;
+        case IR_BR:
+            branch(c, block, insn);
+            break;
+        case IR_RET:
+            epilogue(c);
+            break;
+        default:
+            if (!fused(c, insn))
+                set(c, insn);
+            break;
+        }
+    }
+}
+
+/* Where a division by zero at `offset` is, as diag_end() would print it. */
+static uint32_t where(struct x86 *c, uint32_t offset)
+{
+    size_t size = strlen(c->path) + 64;
+    char *text = xrealloc(NULL, size);
+    uint32_t line, column, at;
+
+    if (c->lines) {
+        line_index_lookup(c->lines, offset, &line, &column);
+        snprintf(text, size, "%s:%lu:%lu", c->path, (unsigned long) line,
+                 (unsigned long) column);
+    } else {
+        snprintf(text, size, "%s: offset %lu", c->path,
+                 (unsigned long) offset);
+    }
+    at = (uint32_t) elf_put(&c->obj->rodata, text, strlen(text) + 1);
+    free(text);
+    return at;
+}
+
+/* Compile one frame into the function `name`. */
+static void frame(struct x86 *c, const struct ir_func *f, const char *name,
+                  size_t len, int global)
+{
+    struct live l;
+    struct live_groups g;
+    uint32_t block, i, start, symbol;
+    int64_t rel;
+
+    start = (uint32_t) elf_align(c->text, 16, 0xCC);
+    symbol = elf_symbol(c->obj, name, len, ELF_TEXT, start, global, 1);
+    c->f = f;
+    c->loc = xrealloc(NULL, f->count * sizeof *c->loc);
+    c->start = xrealloc(NULL, f->block_count * sizeof *c->start);
+    memset(c->start, 0xFF, f->block_count * sizeof *c->start);
+    c->fixup_count = 0;
+    c->trampoline_count = 0;
+    c->stub_count = 0;
+
+    live_build(f, &l);
+    live_coalesce(f, &l, &g);
+    allocate(c, &l, &g);
+    live_groups_free(&g);
+    c->live = &l;
+
+    prologue(c);
+    for (block = IR_ENTRY; block; block = f->blocks[block].next)
+        block_code(c, block);
+    for (i = 0; i < c->trampoline_count; i++) {
+        struct trampoline *t = &c->trampolines[i];
+
+        patch32(c, t->at, here(c) - (t->at + 4));
+        edge_moves(c, t->from, t->to);
+        emit_moves(c);
+        jump(c, CC_ALWAYS, t->to);
+    }
+    for (i = 0; i < c->stub_count; i++) {
+        patch32(c, c->stubs[i].at, here(c) - (c->stubs[i].at + 4));
+        op_rm(c, 0, 1, 0x8D, RDI, rodata(where(c, c->stubs[i].offset)), 0);
+        call(c, RT_DIV_ZERO);
+    }
+    for (i = 0; i < c->fixup_count; i++) {
+        rel = (int64_t) c->start[c->fixups[i].block] -
+              (c->fixups[i].at + 4);
+        patch32(c, c->fixups[i].at, (uint32_t) rel);
+    }
+    c->obj->symbols[symbol].size = here(c) - start;
+
+    live_free(&l);
+    free(c->start);
+    free(c->loc);
+    c->stats->functions++;
+}
+
+void x86_compile(const struct ir_program *ir, const char *path,
+                 struct line_index *lines, struct elf_object *obj,
+                 struct x86_stats *stats)
+{
+    struct x86 c;
+    const char *name;
+    size_t len;
+    uint32_t i, symbol;
+
+    memset(&c, 0, sizeof c);
+    c.obj = obj;
+    c.text = &obj->text;
+    c.path = path;
+    c.lines = lines;
+    c.stats = stats;
+    c.strings = xcalloc((size_t) symbol_count() + 1, sizeof *c.strings);
+
+    for (i = 0; i < ir->count; i++) {
+        if (i == 0) {
+            name = "minilang_top";
+            len = strlen(name);
+        } else if (i == ir->main) {
+            name = "minilang_main";
+            len = strlen(name);
+        } else {
+            name = symbol_name(ir->funcs[i].name, &len);
+        }
+        frame(&c, &ir->funcs[i], name, len, i == 0 || i == ir->main);
+    }
+    if (!ir->main) {
+        /* nothing to run after the top level */
+        symbol = elf_symbol(obj, "minilang_main", 13, ELF_TEXT,
+                            elf_align(c.text, 16, 0xCC), 1, 1);
+        byte(&c, 0xC3);
+        obj->symbols[symbol].size = 1;
+    }
+    stats->code_bytes += c.text->len;
+
+    free(c.strings);
+    free(c.float_bits);
+    free(c.float_at);
+    free(c.fixups);
+    moves_free(&c.moves);
+    free(c.trampolines);
+    free(c.stubs);
+    free(c.calls);
+    free(c.slot_hi);
+}
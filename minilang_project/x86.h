@@ -0,0 +1,41 @@
+#ifndef MINILANG_X86_H
+#define MINILANG_X86_H
+
+#include <stdint.h>
+
+#include "elf.h"
+#include "ir.h"
+#include "lines.h"
+
+/* The native backend: every frame of an optimized IR program (ir.h)
+ * compiled to x86-64 machine code, in an ELF object (elf.h) for the
+ * System V ABI.
+ *
+ * Each value gets a register or, when there are too few, a slot in the
+ * frame, by linear scan over the groups live_coalesce() makes (live.h);
+ * a value live across a call into the runtime only gets a register the
+ * callee keeps, and floats, which have none such, go to the frame
+ * instead.  Blocks are laid out in the IR's order, with the copies phis
+ * take made on the edges as the bytecode compiler makes them.
+ *
+ * The statements outside functions become minilang_top and main becomes
+ * minilang_main, both global; the other functions, which nothing calls,
+ * are compiled all the same, under their own names as local symbols.
+ * The code calls print_int(), print_float(), print_str() and
+ * str_compare() from runtime.h and minilang_concat() and
+ * minilang_div_zero() from native.h, which also has the main() that
+ * calls the two; see README.md for the link line. */
+
+struct x86_stats {
+    uint64_t functions;
+    uint64_t code_bytes;
+    uint64_t spilled;       /* groups of values given a slot, not a register */
+};
+
+/* `path` and `lines` place the message a division by zero prints; lines
+ * may be NULL, as for diag_begin(). */
+void x86_compile(const struct ir_program *ir, const char *path,
+                 struct line_index *lines, struct elf_object *obj,
+                 struct x86_stats *stats);
+
+#endif